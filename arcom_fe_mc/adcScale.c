@@ -0,0 +1,47 @@
+/*! \file   adcScale.c
+    \brief  Fixed point scaling of the ADC readings
+
+    See adcScale.h for a description of the scaling.
+*/
+
+/* Includes */
+#include "adcScale.h"
+
+/*! Convert ADC counts to thousandths of the unit, without floating point.
+    \param counts   the raw ADC word
+    \param *scale   the conversion of the channel
+    \return the value in thousandths of the unit, truncated toward 0 */
+long adcScaleMilli(unsigned int counts, const ADC_SCALE *scale) {
+    return (scale -> fullScale * (long) counts) / ADC_SCALE_RANGE + scale -> offset;
+}
+
+/*! Convert ADC counts to a float in the unit.
+    This is the only floating point operation of a reading and is meant to be
+    done when the CAN reply is built.
+    \param counts   the raw ADC word
+    \param *scale   the conversion of the channel
+    \return the value in the unit */
+float adcScaleFloat(unsigned int counts, const ADC_SCALE *scale) {
+    return ((float) scale -> fullScale * counts / ADC_SCALE_RANGE + scale -> offset) / 1000.0;
+}
+
+/*! Convert a float in the unit to the ADC counts that would read it.
+    This is used to load simulated readings.  Values outside of the range of
+    the channel are clipped.
+    \param value    the value in the unit
+    \param *scale   the conversion of the channel
+    \return the ADC counts */
+unsigned int adcScaleCounts(float value, const ADC_SCALE *scale) {
+    float counts;
+
+    if (scale -> fullScale == 0)
+        return 0;
+
+    counts = (value * 1000.0 - scale -> offset) * ADC_SCALE_RANGE / scale -> fullScale;
+
+    if (counts <= 0.0)
+        return 0;
+    if (counts >= ADC_SCALE_RANGE - 1)
+        return (unsigned int) (ADC_SCALE_RANGE - 1);
+    return (unsigned int) (counts + 0.5);
+}
@@ -0,0 +1,51 @@
+/*! \file   adcScale.h
+    \brief  Fixed point scaling of the ADC readings
+
+    The monitor functions of the serial interfaces used to convert every raw
+    ADC word to a float as soon as it was read.  On the 16 bit target floating
+    point is emulated in software, so the conversion cost is paid on every
+    sample, including the ones read by the async process that nobody asks for.
+
+    With this module a monitor point keeps the raw ADC counts, and an
+    \ref ADC_SCALE describing the linear conversion of its channel as two
+    integers.  The counts are converted to a float only when a CAN reply is
+    built with adcScaleFloat(), or to integer thousandths of the unit with
+    adcScaleMilli() for the packed block readouts, which then need no floating
+    point at all.
+
+    For scale factors that are a whole number of thousandths, adcScaleFloat()
+    agrees with the original float expression scale*counts/range to float
+    precision.  adcScaleMilli() truncates toward 0, so it is within 1
+    thousandth of the unit of the float path. */
+
+#ifndef _ADCSCALE_H
+    #define _ADCSCALE_H
+
+    /* Defines */
+    #define ADC_SCALE_RANGE     65536L  //!< Full range of the 16 bit ADCs
+    #define ADC_SCALE_MAX       32767L  //!< Largest full scale in thousandths that can't overflow a long
+
+    //! Full scale in thousandths of the unit from a float scale factor
+    #define ADC_SCALE_MILLI(Sc) ((long)((Sc)*1000.0))
+
+    /* Typedefs */
+    //! Linear conversion of the ADC counts of a channel
+    /*! The value of a reading, in thousandths of the unit, is:
+            fullScale*counts/ADC_SCALE_RANGE+offset
+        \param fullScale    a long: value at the full ADC range, at most \ref ADC_SCALE_MAX
+        \param offset       a long: value at 0 counts */
+    typedef struct {
+        long    fullScale;  //!< Value in thousandths of the unit at the full ADC range
+        long    offset;     //!< Value in thousandths of the unit at 0 counts
+    } ADC_SCALE;
+
+    /* Prototypes */
+    /* Externs */
+    extern long adcScaleMilli(unsigned int counts, const ADC_SCALE *scale);
+    //!< Convert counts to thousandths of the unit
+    extern float adcScaleFloat(unsigned int counts, const ADC_SCALE *scale);
+    //!< Convert counts to a float in the unit
+    extern unsigned int adcScaleCounts(float value, const ADC_SCALE *scale);
+    //!< Convert a float in the unit back to counts
+
+#endif /* _ADCSCALE_H */
@@ -0,0 +1,252 @@
+/*! \file   ambsiEmulator.c
+    \brief  AMBSI link emulator
+
+    See ambsiEmulator.h for a description of the emulator.
+*/
+
+/* Includes */
+#include <i86.h>        /* MK_FP */
+#include <stdio.h>      /* printf */
+#include <string.h>     /* memcpy, memset */
+
+#include "ambsiEmulator.h"
+#include "can.h"
+#include "ppComm.h"
+#include "timer.h"
+#include "error.h"
+#include "debug.h"
+#include "globalDefinitions.h"
+
+/* Globals */
+AMBSI_EMULATOR ambsiEmulator = {{{0L, 0, {0, 0, 0, 0}}},
+                                0,
+                                0,
+                                0,
+                                AMBSI_EMULATOR_DEFAULT_TIMEOUT,
+                                0L,
+                                AMBSI_EMULATOR_IDLE,
+                                0L,
+                                0L,
+                                0L,
+                                0L};
+
+/* Statics */
+static unsigned long histogram[AMBSI_EMULATOR_BINS];    // Latency distribution
+static unsigned char nextMessage;                       // Entry of the next message to send
+static unsigned char burstLeft;                         // Messages left in the current burst
+static unsigned char inFlight = FALSE;                  // An emulated message is being handled
+static unsigned long startTime;                         // readFineTimer() at the start
+static unsigned long stopTime;                          // readFineTimer() at the end
+static unsigned long nextDue;                           // readFineTimer() when the next message is due
+static unsigned long arrival;                           // Scheduled arrival of the message in flight
+static unsigned long replyBytes;                        // Reply bytes taken, for the report
+
+/*! Start sending messages.
+    The results of the previous run are discarded.  The parallel port
+    interrupt is masked until the emulator stops.
+    \param count    messages to send, 0 to run until stopped
+    \return
+        - \ref NO_ERROR -> if no error occurred
+        - \ref ERROR    -> if no message is set up */
+int ambsiEmulatorStart(unsigned long count) {
+    unsigned char entry;
+
+    for (entry = 0; entry < AMBSI_EMULATOR_MESSAGES; entry++)
+        if (ambsiEmulator.message[entry].rca)
+            break;
+
+    if (entry == AMBSI_EMULATOR_MESSAGES) {
+        storeError(ERR_PP, ERC_COMMAND_VAL); // No AMBSI emulator message set up
+        return ERROR;
+    }
+
+    memset(histogram, 0, sizeof(histogram));
+    ambsiEmulator.count = count;
+    ambsiEmulator.sent = 0;
+    ambsiEmulator.completed = 0;
+    ambsiEmulator.timeouts = 0;
+    ambsiEmulator.maxLatency = 0;
+    replyBytes = 0;
+    nextMessage = entry;
+    burstLeft = ambsiEmulator.burst;
+
+    // The AMBSI can't get through while the emulator runs:
+    if (ambsiEmulator.state != AMBSI_EMULATOR_RUNNING)
+        PicPPIrqCtrl(DISABLE);
+
+    startTime = readFineTimer();
+    nextDue = startTime;
+    ambsiEmulator.state = AMBSI_EMULATOR_RUNNING;
+
+    #ifdef DEBUG_AMBSI_EMULATOR
+        printf("AMBSI emulator: started, %u msg/s, burst %d, count %lu\n",
+               ambsiEmulator.rate, ambsiEmulator.burst, count);
+    #endif /* DEBUG_AMBSI_EMULATOR */
+
+    return NO_ERROR;
+}
+
+/*! Stop sending messages.
+    A message already injected is still accounted for. */
+void ambsiEmulatorStop(void) {
+    if (ambsiEmulator.state != AMBSI_EMULATOR_RUNNING)
+        return;
+
+    ambsiEmulatorFinish();
+}
+
+/*! Inject the next message if it is due.
+    This is called from the main loop while no CAN message is pending. */
+void ambsiEmulatorService(void) {
+    AMBSI_EMULATOR_MESSAGE *message;
+    unsigned long now;
+
+    if (ambsiEmulator.state != AMBSI_EMULATOR_RUNNING || inFlight)
+        return;
+
+    if (ambsiEmulator.count && ambsiEmulator.sent >= ambsiEmulator.count) {
+        ambsiEmulatorFinish();
+        return;
+    }
+
+    now = readFineTimer();
+    if ((long) (now - nextDue) < 0)
+        return;
+
+    message = &ambsiEmulator.message[nextMessage];
+
+    // Same layout as the header and payload read by PPIntHandler():
+    memcpy(PPRxBuffer, &message -> rca, sizeof(message -> rca));
+    PPRxBuffer[CAN_RX_HEADER_SIZE - 1] = message -> size;
+    memcpy(&PPRxBuffer[CAN_RX_HEADER_SIZE], message -> payload, message -> size);
+    PPRxTicks = PP_BIOS_TICKS;
+
+    // Open loop: the message arrived when it was due, even if that's past
+    arrival = (ambsiEmulator.rate) ? nextDue : now;
+
+    // Schedule the next one:
+    if (ambsiEmulator.rate)
+        nextDue += FINE_TIMER_HZ / ambsiEmulator.rate;
+    else
+        nextDue = now;
+
+    if (ambsiEmulator.burst > 1 && --burstLeft == 0) {
+        nextDue += FINE_TIMER_FROM_US((unsigned long) ambsiEmulator.burstGap * 1000UL);
+        burstLeft = ambsiEmulator.burst;
+    }
+
+    do {
+        if (++nextMessage == AMBSI_EMULATOR_MESSAGES)
+            nextMessage = 0;
+    } while (!ambsiEmulator.message[nextMessage].rca);
+
+    ambsiEmulator.sent++;
+    inFlight = TRUE;
+    newCANMsg = 1;
+}
+
+/*! Take the reply of an emulated message.
+    This is called by PPWrite() with the reply in \ref PPTxBuffer.
+    \param length   reply bytes
+    \return TRUE if the reply belongs to an emulated message and must not go
+            to the port */
+int ambsiEmulatorReply(unsigned char length) {
+    if (!inFlight)
+        return FALSE;
+
+    replyBytes += length;
+    return TRUE;
+}
+
+/*! Account for the end of an emulated message.
+    This is called by PPClear() at the end of CANMessageHandler().
+    \return TRUE if the message was emulated, so there is no interrupt to
+            clear */
+int ambsiEmulatorDone(void) {
+    unsigned long latency;
+    unsigned int bin;
+
+    if (!inFlight)
+        return FALSE;
+
+    latency = FINE_TIMER_TO_US(readFineTimer() - arrival);
+    inFlight = FALSE;
+
+    bin = (latency / AMBSI_EMULATOR_BIN_US < AMBSI_EMULATOR_BINS) ? (unsigned int) (latency / AMBSI_EMULATOR_BIN_US) :
+                                                                     AMBSI_EMULATOR_BINS - 1;
+    histogram[bin]++;
+
+    if (latency > ambsiEmulator.maxLatency)
+        ambsiEmulator.maxLatency = latency;
+    if (latency > (unsigned long) ambsiEmulator.timeout * 1000UL)
+        ambsiEmulator.timeouts++;
+    ambsiEmulator.completed++;
+
+    return TRUE;
+}
+
+/*! Time since the start in ms, up to the end of the run if it is over. */
+unsigned long ambsiEmulatorElapsed(void) {
+    if (ambsiEmulator.state == AMBSI_EMULATOR_IDLE)
+        return 0;
+
+    return FINE_TIMER_TO_US(((ambsiEmulator.state == AMBSI_EMULATOR_RUNNING) ? readFineTimer() : stopTime) - startTime) / 1000UL;
+}
+
+/*! Sustained message rate in messages per second. */
+float ambsiEmulatorRate(void) {
+    unsigned long elapsed = ambsiEmulatorElapsed();
+
+    if (elapsed == 0)
+        return 0.0;
+
+    return ambsiEmulator.completed * 1000.0 / elapsed;
+}
+
+/*! Latency below which a fraction of the messages completed.
+    \param permille     the fraction in thousandths, e.g. 990 for 99%
+    \return the upper edge of the histogram bin in us, or the longest latency
+            if it falls in the last bin */
+unsigned long ambsiEmulatorPercentile(unsigned int permille) {
+    unsigned long target, total = 0;
+    unsigned int bin;
+
+    if (ambsiEmulator.completed == 0)
+        return 0;
+
+    // Round up, so the 100% percentile is the longest latency:
+    target = (ambsiEmulator.completed * permille + 999UL) / 1000UL;
+
+    for (bin = 0; bin < AMBSI_EMULATOR_BINS - 1; bin++) {
+        total += histogram[bin];
+        if (total >= target)
+            return (unsigned long) (bin + 1) * AMBSI_EMULATOR_BIN_US;
+    }
+
+    return ambsiEmulator.maxLatency;
+}
+
+/*! Print the results. */
+void ambsiEmulatorReport(void) {
+    printf("AMBSI emulator: %s\n",
+           (ambsiEmulator.state == AMBSI_EMULATOR_RUNNING) ? "running" :
+           (ambsiEmulator.state == AMBSI_EMULATOR_DONE) ? "done" : "never run");
+    printf(" sent:%lu completed:%lu timeouts(>%u ms):%lu reply bytes:%lu\n",
+           ambsiEmulator.sent, ambsiEmulator.completed, ambsiEmulator.timeout, ambsiEmulator.timeouts, replyBytes);
+    printf(" elapsed:%lu ms rate:%.1f msg/s\n",
+           ambsiEmulatorElapsed(), ambsiEmulatorRate());
+    printf(" latency us: p50:%lu p99:%lu p99.9:%lu max:%lu\n",
+           ambsiEmulatorPercentile(500), ambsiEmulatorPercentile(990),
+           ambsiEmulatorPercentile(999), ambsiEmulator.maxLatency);
+}
+
+/* End the run and give the link back to the AMBSI */
+static void ambsiEmulatorFinish(void) {
+    stopTime = readFineTimer();
+    ambsiEmulator.state = AMBSI_EMULATOR_DONE;
+    PicPPIrqCtrl(ENABLE);
+
+    #ifdef DEBUG_AMBSI_EMULATOR
+        printf("AMBSI emulator: stopped after %lu messages\n", ambsiEmulator.completed);
+    #endif /* DEBUG_AMBSI_EMULATOR */
+}
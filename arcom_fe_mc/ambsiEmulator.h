@@ -0,0 +1,109 @@
+/*! \file   ambsiEmulator.h
+    \brief  AMBSI link emulator
+
+    The emulator stands in for the AMBSI on the parallel port link so the
+    message rate the firmware can sustain can be measured on the bench,
+    without a CAN bus.  While it runs, the parallel port interrupt is masked
+    and the emulator injects the messages itself: it fills \ref PPRxBuffer and
+    raises \ref newCANMsg as PPIntHandler() would.  The message goes through
+    CANMessageHandler() and the whole handler tree; PPWrite() and PPClear()
+    hand the reply and the end of the message back to the emulator instead
+    of the port.
+
+    Up to \ref AMBSI_EMULATOR_MESSAGES monitor or control messages are sent
+    in turn at a fixed rate, optionally in bursts separated by a gap.  The
+    schedule is open loop: when the firmware falls behind, the messages queue
+    up as they would on the AMBSI side.  The latency of a message runs from
+    its scheduled arrival to PPClear(), so it includes the wait for the async
+    pass in progress.  A message is counted as a timeout when its latency is
+    longer than the AMBSI would wait.
+
+    Times are taken with readFineTimer().  The latency distribution is kept
+    in \ref AMBSI_EMULATOR_BINS bins of \ref AMBSI_EMULATOR_BIN_US.
+
+    The emulator is set up and read through special RCAs, so on the bench
+    it is driven through the TCP M&C service:
+        - SET_AMBSI_EMU_MESSAGE n:  4 bytes RCA and 0 to 4 bytes payload,
+                                    RCA 0 to disable the entry
+        - SET_AMBSI_EMU_RATE:   rate in messages/s (2 bytes, 0 as fast as
+                                possible), burst length (1), gap between
+                                bursts in ms (2), timeout in ms (2)
+        - SET_AMBSI_EMU_RUN:    1 to start, 0 to stop, optionally followed by
+                                the number of messages to send (4 bytes)
+        - GET_AMBSI_EMU_STATE:  state, messages completed, timeouts
+        - GET_AMBSI_EMU_RATE:   sustained rate, elapsed time
+        - GET_AMBSI_EMU_LATENCY: median, 99%, 99.9% and max latency
+    The 'l' console command prints the same figures. */
+
+#ifndef _AMBSIEMULATOR_H
+    #define _AMBSIEMULATOR_H
+
+    /* Extra includes */
+    /* CAN_MESSAGE_PAYLOAD_SIZE */
+    #ifndef _CAN_H
+        #include "can.h"
+    #endif /* _CAN_H */
+
+    /* Defines */
+    #define AMBSI_EMULATOR_MESSAGES         8       //!< Messages sent in turn
+    #define AMBSI_EMULATOR_PAYLOAD_SIZE     4       //!< Largest control payload
+    #define AMBSI_EMULATOR_BINS             256     //!< Latency histogram bins, the last one holds all longer latencies
+    #define AMBSI_EMULATOR_BIN_US           250     //!< Width of a latency bin in us
+    #define AMBSI_EMULATOR_DEFAULT_TIMEOUT  100     //!< Default AMBSI timeout in ms
+
+    /* Emulator state */
+    #define AMBSI_EMULATOR_IDLE             0       //!< Never run
+    #define AMBSI_EMULATOR_RUNNING          1       //!< Sending messages
+    #define AMBSI_EMULATOR_DONE             2       //!< Stopped, results ready
+
+    /* Typedefs */
+    //! One message of the emulated traffic
+    typedef struct {
+        unsigned long   rca;                                    //!< RCA, 0 if unused
+        unsigned char   size;                                   //!< Payload size, 0 for a monitor message
+        unsigned char   payload[AMBSI_EMULATOR_PAYLOAD_SIZE];   //!< Control payload
+    } AMBSI_EMULATOR_MESSAGE;
+
+    //! AMBSI emulator setup, state and results
+    typedef struct {
+        AMBSI_EMULATOR_MESSAGE  message[AMBSI_EMULATOR_MESSAGES];   //!< Messages sent in turn
+        unsigned int            rate;           //!< Messages per second, 0 as fast as possible
+        unsigned char           burst;          //!< Messages per burst, 0 or 1 for no bursts
+        unsigned int            burstGap;       //!< Gap between bursts in ms
+        unsigned int            timeout;        //!< Latency in ms counted as an AMBSI timeout
+        unsigned long           count;          //!< Messages to send, 0 until stopped
+        unsigned char           state;          //!< One of the AMBSI_EMULATOR_* states
+        unsigned long           sent;           //!< Messages injected
+        unsigned long           completed;      //!< Messages handled
+        unsigned long           timeouts;       //!< Messages that took longer than the timeout
+        unsigned long           maxLatency;     //!< Longest latency in us
+    } AMBSI_EMULATOR;
+
+    /* Globals */
+    /* Externs */
+    extern AMBSI_EMULATOR ambsiEmulator; //!< AMBSI emulator setup, state and results
+
+    /* Prototypes */
+    /* Statics */
+    static void ambsiEmulatorFinish(void);
+    /* Externs */
+    extern int ambsiEmulatorStart(unsigned long count);
+    //!< Start sending messages
+    extern void ambsiEmulatorStop(void);
+    //!< Stop sending messages
+    extern void ambsiEmulatorService(void);
+    //!< Inject the next message if it is due
+    extern int ambsiEmulatorReply(unsigned char length);
+    //!< Take the reply of an emulated message
+    extern int ambsiEmulatorDone(void);
+    //!< Account for the end of an emulated message
+    extern unsigned long ambsiEmulatorElapsed(void);
+    //!< Time since the start in ms
+    extern float ambsiEmulatorRate(void);
+    //!< Sustained message rate
+    extern unsigned long ambsiEmulatorPercentile(unsigned int permille);
+    //!< Latency percentile in us
+    extern void ambsiEmulatorReport(void);
+    //!< Print the results
+
+#endif /* _AMBSIEMULATOR_H */
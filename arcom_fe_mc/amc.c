@@ -11,6 +11,7 @@
 #include <stdio.h>      /* printf */
 
 #include "frontend.h"
+#include "lastControl.h"
 #include "error.h"
 #include "loSerialInterface.h"
 #include "debug.h"
@@ -258,7 +259,7 @@ static void drainBVoltageHandler(void){
     /* If control (size !=0) */
     if(CAN_SIZE){
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lo.amc.lastDrainBVoltage)
+        SAVE_LAST_CONTROL_MESSAGE()
 
         /* Extract the float from the can message */
         changeEndian(CONV_CHR_ADD,
@@ -268,7 +269,7 @@ static void drainBVoltageHandler(void){
            and return the error state then return. */
         if(setAmc(AMC_DRAIN_B_VOLTAGE)==ERROR){
             /* Store the ERROR state in the last control message variable */
-            frontend.cartridge[currentModule].lo.amc.lastDrainBVoltage.status=ERROR;
+            CAN_LAST_CONTROL.status=ERROR;
 
             return;
         }
@@ -280,7 +281,7 @@ static void drainBVoltageHandler(void){
     /* If monitor on control RCA */
     if(currentClass==CONTROL_CLASS){ // If monitor on a control RCA
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lo.amc.lastDrainBVoltage)
+        RETURN_LAST_CONTROL_MESSAGE()
 
         return;
     }
@@ -367,12 +368,12 @@ static void multiplierDVoltageHandler(void){
     /* If control (size !=0) */
     if(CAN_SIZE){
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lo.amc.lastMultiplierDVoltage);
+        SAVE_LAST_CONTROL_MESSAGE();
         /* Set the AMC multiplier D voltage. If an error occurs then store the state
            and return the error state then return. */
         if(setAmc(AMC_MULTIPLIER_D_VOLTAGE)==ERROR){
             /* Store the ERROR state in the last control message variable */
-            frontend.cartridge[currentModule].lo.amc.lastMultiplierDVoltage.status=ERROR;
+            CAN_LAST_CONTROL.status=ERROR;
             return;
         }
 
@@ -383,7 +384,7 @@ static void multiplierDVoltageHandler(void){
     /* If monitor on control RCA */
     if(currentClass==CONTROL_CLASS){ // If monitor on a control RCA
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lo.amc.lastMultiplierDVoltage)
+        RETURN_LAST_CONTROL_MESSAGE()
         return;
     }
 
@@ -456,7 +457,7 @@ static void gateEVoltageHandler(void){
     /* If control (size !=0) */
     if(CAN_SIZE){
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lo.amc.lastGateEVoltage);
+        SAVE_LAST_CONTROL_MESSAGE();
 
         /* Extract the float from the can message */
         changeEndian(CONV_CHR_ADD,
@@ -466,7 +467,7 @@ static void gateEVoltageHandler(void){
            and return the error state then return. */
         if(setAmc(AMC_GATE_E_VOLTAGE)==ERROR){
             /* Store the ERROR state in the last control message variable */
-            frontend.cartridge[currentModule].lo.amc.lastGateEVoltage.status=ERROR;
+            CAN_LAST_CONTROL.status=ERROR;
             return;
         }
 
@@ -477,7 +478,7 @@ static void gateEVoltageHandler(void){
     /* If monitor on control RCA */
     if(currentClass==CONTROL_CLASS){ // If monitor on a control RCA
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lo.amc.lastGateEVoltage)
+        RETURN_LAST_CONTROL_MESSAGE()
         return;
     }
 
@@ -515,7 +516,7 @@ static void drainEVoltageHandler(void){
     /* If control (size !=0) */
     if(CAN_SIZE){
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lo.amc.lastDrainEVoltage)
+        SAVE_LAST_CONTROL_MESSAGE()
 
         /* Extract the float from the can message */
         changeEndian(CONV_CHR_ADD,
@@ -525,7 +526,7 @@ static void drainEVoltageHandler(void){
            and return the error state then return. */
         if(setAmc(AMC_DRAIN_E_VOLTAGE)==ERROR){
             /* Store the ERROR state in the last control message variable */
-            frontend.cartridge[currentModule].lo.amc.lastDrainEVoltage.status=ERROR;
+            CAN_LAST_CONTROL.status=ERROR;
 
             return;
         }
@@ -537,7 +538,7 @@ static void drainEVoltageHandler(void){
     /* If monitor on control RCA */
     if(currentClass==CONTROL_CLASS){ // If monitor on a control RCA
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lo.amc.lastDrainEVoltage)
+        RETURN_LAST_CONTROL_MESSAGE()
         return;
     }
 
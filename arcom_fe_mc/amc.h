@@ -85,19 +85,7 @@
                                             current.
         \param      supplyVoltage5V         This contains the most recent
                                             read-back value for the 5V supply
-                                            voltage.
-        \param      lastDrainBVoltage       This contains a copy of the last
-                                            issued control message to the B
-                                            drain voltage.
-        \param      lastMultiplierDVoltage  This contains a copy of the last
-                                            issued control message to the D
-                                            multiplier voltage.
-        \param      lastGateEVoltage        This contains a copy of the last
-                                            issued control message to the E
-                                            gate voltage.
-        \param      lastDrainEVoltage       This contains a copy of the last
-                                            issued control message to the E
-                                            drain voltage. */
+                                            voltage. */
     typedef struct {
         //! MC A Gate Voltage
         /*! This is the MC A gate voltage (in V). */
@@ -135,22 +123,6 @@
         //! MC E Drain  Current
         /*! This is the MC E drain current (in mA). */
         float   drainECurrent;
-        //! Last control message: MC B drain voltage
-        /*! This is the content of the last control message sent to the MC B
-            drain voltage. */
-        LAST_CONTROL_MESSAGE    lastDrainBVoltage;
-        //! Last control message: MC multiplier D voltage
-        /*! This is the content of the last control message sent to the MC
-            multiplier D voltage. */
-        LAST_CONTROL_MESSAGE    lastMultiplierDVoltage;
-        //! Last control message: MC E gate voltage
-        /*! This is the content of the last control message sent to the MC E
-            gate voltage. */
-        LAST_CONTROL_MESSAGE    lastGateEVoltage;
-        //! Last control message: MC E drain voltage
-        /*! This is the content of the last control message sent to the MC E
-            drain voltage. */
-        LAST_CONTROL_MESSAGE    lastDrainEVoltage;
 
     } AMC;
 
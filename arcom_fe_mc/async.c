@@ -14,6 +14,16 @@
 #include "frontend.h"
 #include "error.h"
 #include "debug.h"
+#include "can.h"
+#include "owb.h"
+#include "handlerContext.h"
+#include "flightRecorder.h"
+#include "sensorStats.h"
+#include "loLock.h"
+#include "sisSweep.h"
+#include "loPaSweep.h"
+#include "canTrace.h"
+#include "setpointQueue.h"
 
 /* Globals */
 ASYNC_STATE asyncState = ASYNC_CRYOSTAT; /*!< This variable contains the current status
@@ -22,12 +32,53 @@ ASYNC_STATE asyncState = ASYNC_CRYOSTAT; /*!< This variable contains the current
 
 
 /* Statics */
+static HANDLER_CONTEXT asyncContext; // Addressing of the async functions between passes
+static const HANDLER asyncEngines[] = {
+    setpointQueueAsync,     // Coalesced setpoints first, so they land before any async operation started after them
+    flightRecorderAsync,    // The flight recorder samples at every pass, not in turn with the subsystems
+    sensorStatsAsync,
+    loLockAsync,
+    sisSweepAsync,
+    loPaSweepAsync,
+    sisMagnetRampAsync,
+    canTraceAsync,
+    asyncStep               // One step of the current subsystem, none while turned off
+};
+static unsigned char nextEngine = 0; // Engine to run first at the next pass
+
+#define ASYNC_ENGINES   (sizeof(asyncEngines) / sizeof(asyncEngines[0]))
 
 /* Executes async operations. This could be in its own module. */
 /*! This function handles the async operations. These are tasks the FEMC will
-    execute while idle between can messages. */
+    execute while idle between can messages.
+    The async functions run in their own \ref HANDLER_CONTEXT so that the
+    CAN messages handled between two passes don't change the addressing of an
+    async operation in progress, and vice versa.
+    Each pass runs every engine once, in order, but returns as soon as a CAN
+    message arrives. The next pass picks up at the engine that didn't run, so
+    the last ones are not starved under load. Turning the async process off
+    only stops the subsystem steps: the other engines keep running, so that
+    the coalesced setpoints still reach the hardware and the operations in
+    progress complete. */
 void async(void){
 
+    /* The addressing left by the last CAN message */
+    HANDLER_CONTEXT canContext;
+    unsigned char cnt;
+
+    handlerContextSwitch(&canContext, &asyncContext);
+    for(cnt=0; cnt<ASYNC_ENGINES && !newCANMsg; cnt++){
+        asyncEngines[nextEngine]();
+        if(++nextEngine==ASYNC_ENGINES){
+            nextEngine=0;
+        }
+    }
+    handlerContextSwitch(&asyncContext, &canContext);
+}
+
+/* Run one step of the current async subsystem */
+static void asyncStep(void){
+
     /* Switch to the correct subsystem */
     switch(asyncState){
         /* Run the cryostat async functions */
@@ -71,12 +122,46 @@ void async(void){
                     break;
                 case ASYNC_DONE:
                 case ERROR:
-                    asyncState=ASYNC_CRYOSTAT;
+                    asyncState=ASYNC_IF_SWITCH;
+                    break;
+                default:
+                    break;
+            }
+            break;
+        /* Run the IF switch async functions */
+        case ASYNC_IF_SWITCH:
+            switch(ifSwitchAsync()){
+                case NO_ERROR:
+                    return;
+                    break;
+                case ASYNC_DONE:
+                case ERROR:
+                    asyncState=ASYNC_POWER_DIS;
+                    break;
+                default:
+                    break;
+            }
+            break;
+        /* Run the power distribution async functions */
+        case ASYNC_POWER_DIS:
+            switch(powerDistributionAsync()){
+                case NO_ERROR:
+                    return;
+                    break;
+                case ASYNC_DONE:
+                case ERROR:
+                    asyncState=ASYNC_OWB;
                     break;
                 default:
                     break;
             }
             break;
+        /* Run the background OWB search, if one was requested. One step per
+           pass so it doesn't hold up the other subsystems. */
+        case ASYNC_OWB:
+            owbAsync();
+            asyncState=ASYNC_CRYOSTAT;
+            break;
         /* Turn off the async functions */
         case ASYNC_OFF:
             asyncState=ASYNC_OFF;
@@ -22,12 +22,18 @@
         \param ASYNC_CRYOSTAT   the process is handling the cryostat
         \param ASYNC_CARTRIDGE  the process is handling the cartridges
         \param ASYNC_FETIM      the process is handling the FETIM
+        \param ASYNC_IF_SWITCH  the process is handling the IF switch
+        \param ASYNC_POWER_DIS  the process is handling the power distribution
+        \param ASYNC_OWB        the process is searching the one wire bus
         \param ASYNC_OFF        the process is turned off
         \param ASYNC_ON         the process is starting */
     typedef enum {
         ASYNC_CRYOSTAT,
         ASYNC_CARTRIDGE,
         ASYNC_FETIM,
+        ASYNC_IF_SWITCH,
+        ASYNC_POWER_DIS,
+        ASYNC_OWB,
         ASYNC_OFF,
         ASYNC_ON
     } ASYNC_STATE; //!< Current state of the async process
@@ -41,6 +47,8 @@
 
 
     /* Prototypes */
+    /* Statics */
+    static void asyncStep(void); // Run one step of the current async subsystem
     /* Externs */
     extern void async(void); //!< This function takes care of the async operations
 
@@ -14,6 +14,7 @@
 
 #include "debug.h"
 #include "frontend.h"
+#include "lastControl.h"
 #include "globalDefinitions.h"
 #include "error.h"
 #include "cryostatSerialInterface.h"
@@ -56,7 +57,7 @@ static void enableHandler(void){
     /* If control (size !=0) */
     if(CAN_SIZE){
          // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.cryostat.backingPump.lastEnable)
+        SAVE_LAST_CONTROL_MESSAGE()
 
         /* If turning the backing pump off, then shut down the hardware that is
            biased by the backing pump: turbo, gate and solenoid valve. */
@@ -82,7 +83,7 @@ static void enableHandler(void){
         if(setBackingPumpEnable(CAN_BYTE?BACKING_PUMP_ENABLE:
                                          BACKING_PUMP_DISABLE)==ERROR){
             /* Store the ERROR state in the last control message variable */
-            frontend.cryostat.backingPump.lastEnable.status=ERROR;
+            CAN_LAST_CONTROL.status=ERROR;
             return;
         }
 
@@ -93,7 +94,7 @@ static void enableHandler(void){
     /* If monitor on a control RCA */
     if(currentClass==CONTROL_CLASS){
         // Return the last control message and status:
-        RETURN_LAST_CONTROL_MESSAGE(frontend.cryostat.backingPump.lastEnable)
+        RETURN_LAST_CONTROL_MESSAGE()
         return;
     }
 
@@ -41,9 +41,7 @@
                                 \em not a read back from the hardware but just a
                                 register holding the last issued control:
                                     - \ref BACKING_PUMP_DISABLE -> Disable/OFF
-                                    - \ref BACKING_PUMP_ENABLE -> Enable/ON
-        \param      lastEnable  This contains a copy of the last issued control
-                                message to the state of the backing pump. */
+                                    - \ref BACKING_PUMP_ENABLE -> Enable/ON */
      typedef struct {
         //! Backing pump state
         /*! This is the state of the backing pump:
@@ -53,10 +51,6 @@
                         value is the one stored by the software after a control
                         command has been issued. */
         unsigned char   enable;
-        //! Last control message: backing pump state
-        /*! This is the content of the last control message sent to the backing
-            pump state. */
-        LAST_CONTROL_MESSAGE    lastEnable;
     } BACKING_PUMP;
 
     /* Globals */
@@ -23,6 +23,7 @@
 #include "biasSerialInterface.h"
 #include "error.h"
 #include "serialInterface.h"
+#include "serialProfile.h"
 #include "timer.h"
 #include "frontend.h"
 #include "debug.h"
@@ -125,6 +126,19 @@ static float temperatureConversion(float voltage){
 	return temperature;
 }
 
+/* Bias analog monitor request.
+   This function profiles the analog monitor cycle below. See serialProfile.h. */
+static int getBiasAnalogMonitor(void){
+
+    int ret;
+
+    serialProfileBegin(SERIAL_PROFILE_BIAS_ANALOG);
+    ret=getBiasAnalogMonitorCycle();
+    serialProfileEnd(SERIAL_PROFILE_BIAS_ANALOG, ret);
+
+    return ret;
+}
+
 /* BIAS analog monitor request core.
    This function performs the core operations that are common to all the analog
    monitor request for the BIAS module:
@@ -137,7 +151,7 @@ static float temperatureConversion(float voltage){
 
    If an error happens during the process it will return ERROR, otherwise
    NO_ERROR will be returned. */
-static int getBiasAnalogMonitor(void){
+static int getBiasAnalogMonitorCycle(void){
 
     /* A temporary variable to deal with the timer. */
     int timedOut;
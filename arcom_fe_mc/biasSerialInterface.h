@@ -546,6 +546,7 @@
     /* Prototypes */
     /* Statics */
     static int getBiasAnalogMonitor(void); // Perform core analog monitor functions
+    static int getBiasAnalogMonitorCycle(void); // Analog monitor cycle, without the profiling
     static float temperatureConversion(float voltage); // Perform voltage to temperature conversion
 
     /* Externs */
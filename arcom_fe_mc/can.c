@@ -12,6 +12,7 @@
 #include <stdlib.h>     /* system */
 #include <string.h>     /* memcpy */
 #include <stdio.h>      /* printf */
+#include <time.h>       /* clock */
 
 #include "ppComm.h"
 #include "version.h"
@@ -26,6 +27,20 @@
 #include "owb.h"
 #include "globalOperations.h"
 #include "globalDefinitions.h"
+#include "startupProfile.h"
+#include "flightRecorder.h"
+#include "sensorStats.h"
+#include "deadband.h"
+#include "loLock.h"
+#include "sisSweep.h"
+#include "loPaSweep.h"
+#include "pdSerialInterface.h"
+#include "serialProfile.h"
+#include "canTrace.h"
+#include "ambsiEmulator.h"
+#include "setpointQueue.h"
+#include "controlElision.h"
+#include "memoryUsage.h"
 
 /* Globals */
 /* Externs */
@@ -67,6 +82,8 @@ static HANDLER      modulesHandler[MODULES_NUMBER]={cartridgeHandler,   // Cartr
                                                     lprHandler,
                                                     fetimHandler}; // The modules handler array is initialized
 
+static unsigned char localRequest=FALSE;  // TRUE while handling a request from CANRequestHandler()
+
 // Bytes to return for GET_PPCOMM_TIME, can be overridden by SET_PPCOMM_BYTES:
 static unsigned char getPPCommBytes[8] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
 
@@ -88,13 +105,43 @@ void CANMessageHandler(void){
 
     receiveCANMessage(); // Build the CAN message from the incoming data
 
+    canTraceBegin();
+    CANDispatch(); // Handle the message
+    canTraceEnd();
+
+    /* Clear the new message flag */
+    newCANMsg=0;
+
+    /* After handling the message, the firmware is ready to receive more
+       messages. The parallel port IRQ is cleared. */
+    PPClear();
+
+    return;
+}
+
+/*! This function handles a request already stored in \ref CANMessage by a
+    source other than the AMBSI, like the TCP M&C service.
+
+    The request goes through the same handlers as a CAN message, but nothing
+    is read from or written to the parallel port, so a CAN message arriving
+    meanwhile is left pending for \ref CANMessageHandler. The reply to a
+    monitor request is left in \ref CANMessage with the status byte appended,
+    as it would have been sent to the AMBSI. */
+void CANRequestHandler(void){
+
+    localRequest=TRUE;
+    CANDispatch();
+    localRequest=FALSE;
+}
+
+/* Decode the RCA in CANMessage and call the class handler */
+static void CANDispatch(void){
+
     /* Redirect to the correct class handler depending on the RCA */
     currentClass=(CAN_ADDRESS&CLASSES_RCA_MASK)>>CLASSES_MASK_SHIFT;
     /* Check if the addressed class exist */
     if(currentClass>=CLASSES_NUMBER){
         storeError(ERR_CAN, ERC_RCA_CLASS);     // Error: RCA class outside allowed range
-        newCANMsg=0; // Clear the new message flag
-        PPClear(); // Clear the interrupt
         return;
     }
     /* If in range call the function and let the handler figure out if the
@@ -102,17 +149,6 @@ void CANMessageHandler(void){
        Adding the initializing status variable allows to use different pointers
        while in intialization mode respect to the standard operation. */
     (classesHandler[currentClass])(); // Call the appropriate handler
-
-    /* Clear the new message flag */
-    newCANMsg=0;
-
-    /* After handling the message, the firmware is ready to receive more
-       messages. The parallel port IRQ is cleared. */
-    PPClear();
-
-    return;
-
-
 }
 
 /* Standard message handler. */
@@ -518,10 +554,582 @@ static void specialRCAsHandler(void){
                 }
                 break;
 
+            case GET_STARTUP_PROFILE_SIZE: // 0x2001A -> Returns the size of the startup profile
+                #ifdef DEBUG_CAN
+                    printf("  0x%lX->GET_STARTUP_PROFILE_SIZE\n\n",
+                           GET_STARTUP_PROFILE_SIZE);
+                #endif /* DEBUG_CAN */
+                {
+                    // The first entry is the whole initialization():
+                    unsigned long total = (startupProfileEntries) ? startupProfile[0].duration
+                                                                  : STARTUP_PROFILE_RUNNING;
+                    CAN_DATA(0)=startupProfileEntries;
+                    CAN_DATA(1)=(unsigned char)(total>>24);
+                    CAN_DATA(2)=(unsigned char)(total>>16);
+                    CAN_DATA(3)=(unsigned char)(total>>8);
+                    CAN_DATA(4)=(unsigned char)(total);
+                    CAN_SIZE=5;
+                }
+                break;
+
+            case GET_RECORDER_STATE: // 0x2001B -> Returns the flight recorder state
+                #ifdef DEBUG_CAN
+                    printf("  0x%lX->GET_RECORDER_STATE\n\n",
+                           GET_RECORDER_STATE);
+                #endif /* DEBUG_CAN */
+                CAN_DATA(0)=flightRecorder.state;
+                CAN_DATA(1)=flightRecorder.channels;
+                CAN_DATA(2)=(unsigned char)(flightRecorder.samples>>8);
+                CAN_DATA(3)=(unsigned char)(flightRecorder.samples);
+                CAN_DATA(4)=(unsigned char)(flightRecorder.triggerPosition>>8);
+                CAN_DATA(5)=(unsigned char)(flightRecorder.triggerPosition);
+                CAN_DATA(6)=(unsigned char)(flightRecorder.readIndex>>8);
+                CAN_DATA(7)=(unsigned char)(flightRecorder.readIndex);
+                CAN_SIZE=CAN_FULL_SIZE;
+                break;
+
+            case GET_RECORDER_SAMPLE: // 0x2001C -> Returns the next recorded value
+                #ifdef DEBUG_CAN
+                    printf("  0x%lX->GET_RECORDER_SAMPLE\n\n",
+                           GET_RECORDER_SAMPLE);
+                #endif /* DEBUG_CAN */
+                {
+                    /* Value, status and 24 bits time in ms. All 0xFF when
+                       there is nothing left to read. */
+                    unsigned long time;
+                    if(flightRecorderRead(&CAN_DATA(0), &CAN_DATA(4), &time)==ERROR){
+                        memset(&CAN_DATA(0), 0xFF, CAN_FULL_SIZE);
+                    } else {
+                        CAN_DATA(5)=(unsigned char)(time>>16);
+                        CAN_DATA(6)=(unsigned char)(time>>8);
+                        CAN_DATA(7)=(unsigned char)(time);
+                    }
+                    CAN_SIZE=CAN_FULL_SIZE;
+                }
+                break;
+
+            case GET_STATS_WINDOW: // 0x2001D -> Returns the statistics window length and period
+                #ifdef DEBUG_CAN
+                    printf("  0x%lX->GET_STATS_WINDOW\n\n",
+                           GET_STATS_WINDOW);
+                #endif /* DEBUG_CAN */
+                CAN_DATA(0)=(unsigned char)(sensorStats.windowLength>>24);
+                CAN_DATA(1)=(unsigned char)(sensorStats.windowLength>>16);
+                CAN_DATA(2)=(unsigned char)(sensorStats.windowLength>>8);
+                CAN_DATA(3)=(unsigned char)(sensorStats.windowLength);
+                CAN_DATA(4)=(unsigned char)(sensorStats.windowPeriod>>8);
+                CAN_DATA(5)=(unsigned char)(sensorStats.windowPeriod);
+                CAN_DATA(6)=STATS_CHANNELS_NUMBER;
+                CAN_SIZE=7;
+                break;
+
+            case GET_NEXT_CHANGE: // 0x2001E -> Returns the next channel that moved beyond its deadband
+                #ifdef DEBUG_CAN
+                    printf("  0x%lX->GET_NEXT_CHANGE\n\n",
+                           GET_NEXT_CHANGE);
+                #endif /* DEBUG_CAN */
+                {
+                    /* Channel and float value. All 0xFF when nothing changed. */
+                    float value;
+                    CAN_DATA(0)=deadbandNextChange(&value);
+                    if(CAN_DATA(0)==DEADBAND_NO_CHANGE){
+                        memset(&CAN_DATA(1), 0xFF, CAN_FLOAT_SIZE);
+                    } else {
+                        CONV_FLOAT=value;
+                        changeEndian(&CAN_DATA(1), CONV_CHR_ADD);
+                    }
+                    CAN_SIZE=CAN_FLOAT_SIZE+1;
+                }
+                break;
+
+            case GET_LO_LOCK_STATE: // 0x2001F -> Returns the LO lock engine state
+                #ifdef DEBUG_CAN
+                    printf("  0x%lX->GET_LO_LOCK_STATE\n\n",
+                           GET_LO_LOCK_STATE);
+                #endif /* DEBUG_CAN */
+                CAN_DATA(0)=loLock.state;
+                CAN_DATA(1)=loLock.band;
+                CAN_DATA(2)=(unsigned char)(loLock.yto>>8);
+                CAN_DATA(3)=(unsigned char)(loLock.yto);
+                CONV_FLOAT=loLock.correctionVoltage;
+                changeEndian(&CAN_DATA(4), CONV_CHR_ADD);
+                CAN_SIZE=CAN_FULL_SIZE;
+                break;
+
+            case GET_SIS_SWEEP_STATE: // 0x20020 -> Returns the SIS sweep state
+                #ifdef DEBUG_CAN
+                    printf("  0x%lX->GET_SIS_SWEEP_STATE\n\n",
+                           GET_SIS_SWEEP_STATE);
+                #endif /* DEBUG_CAN */
+                /* The junction is numbered as the SET_SIS_SWEEP RCAs */
+                CAN_DATA(0)=sisSweep.state;
+                CAN_DATA(1)=sisSweep.band*SIS_SWEEP_JUNCTIONS+sisSweep.junction;
+                CAN_DATA(2)=(unsigned char)(sisSweep.points>>8);
+                CAN_DATA(3)=(unsigned char)(sisSweep.points);
+                CAN_DATA(4)=(unsigned char)(sisSweep.measured>>8);
+                CAN_DATA(5)=(unsigned char)(sisSweep.measured);
+                CAN_DATA(6)=(unsigned char)(sisSweep.readIndex>>8);
+                CAN_DATA(7)=(unsigned char)(sisSweep.readIndex);
+                CAN_SIZE=CAN_FULL_SIZE;
+                break;
+
+            case GET_SIS_SWEEP_POINT: // 0x20021 -> Returns the next SIS sweep point
+                #ifdef DEBUG_CAN
+                    printf("  0x%lX->GET_SIS_SWEEP_POINT\n\n",
+                           GET_SIS_SWEEP_POINT);
+                #endif /* DEBUG_CAN */
+                {
+                    /* Voltage and current. All 0xFF when there is nothing
+                       left to read. */
+                    SIS_SWEEP_POINT point;
+                    if(sisSweepRead(&point)==ERROR){
+                        memset(&CAN_DATA(0), 0xFF, CAN_FULL_SIZE);
+                    } else {
+                        CONV_FLOAT=point.voltage;
+                        changeEndian(CAN_DATA_ADD, CONV_CHR_ADD);
+                        CONV_FLOAT=point.current;
+                        changeEndian(&CAN_DATA(4), CONV_CHR_ADD);
+                    }
+                    CAN_SIZE=CAN_FULL_SIZE;
+                }
+                break;
+
+            case GET_LO_PA_SWEEP_STATE: // 0x20022 -> Returns the LO PA sweep state
+                #ifdef DEBUG_CAN
+                    printf("  0x%lX->GET_LO_PA_SWEEP_STATE\n\n",
+                           GET_LO_PA_SWEEP_STATE);
+                #endif /* DEBUG_CAN */
+                /* The PA channel is numbered as the SET_LO_PA_SWEEP RCAs */
+                CAN_DATA(0)=loPaSweep.state;
+                CAN_DATA(1)=loPaSweep.band*POLARIZATIONS_NUMBER+loPaSweep.polarization;
+                CAN_DATA(2)=(unsigned char)(loPaSweep.points>>8);
+                CAN_DATA(3)=(unsigned char)(loPaSweep.points);
+                CAN_DATA(4)=(unsigned char)(loPaSweep.measured>>8);
+                CAN_DATA(5)=(unsigned char)(loPaSweep.measured);
+                CAN_DATA(6)=(unsigned char)(loPaSweep.readIndex>>8);
+                CAN_DATA(7)=(unsigned char)(loPaSweep.readIndex);
+                CAN_SIZE=CAN_FULL_SIZE;
+                break;
+
+            case GET_LO_PA_SWEEP_POINT: // 0x20023 -> Returns the next LO PA sweep point
+                #ifdef DEBUG_CAN
+                    printf("  0x%lX->GET_LO_PA_SWEEP_POINT\n\n",
+                           GET_LO_PA_SWEEP_POINT);
+                #endif /* DEBUG_CAN */
+                {
+                    /* Drain voltage and response. All 0xFF when there is
+                       nothing left to read. */
+                    LO_PA_SWEEP_POINT point;
+                    if(loPaSweepReadPoint(&point)==ERROR){
+                        memset(&CAN_DATA(0), 0xFF, CAN_FULL_SIZE);
+                    } else {
+                        CONV_FLOAT=point.drainVoltage;
+                        changeEndian(CAN_DATA_ADD, CONV_CHR_ADD);
+                        CONV_FLOAT=point.response;
+                        changeEndian(&CAN_DATA(4), CONV_CHR_ADD);
+                    }
+                    CAN_SIZE=CAN_FULL_SIZE;
+                }
+                break;
+
+            case GET_SIS_MAGNET_RAMP_STATE: // 0x20024 -> Returns the SIS magnet ramp state
+                #ifdef DEBUG_CAN
+                    printf("  0x%lX->GET_SIS_MAGNET_RAMP_STATE\n\n",
+                           GET_SIS_MAGNET_RAMP_STATE);
+                #endif /* DEBUG_CAN */
+                CAN_DATA(0)=sisMagnetRamp.state;
+                CAN_DATA(1)=sisMagnetRamp.magnet;
+                CAN_DATA(2)=(unsigned char)(sisMagnetRamp.steps>>8);
+                CAN_DATA(3)=(unsigned char)(sisMagnetRamp.steps);
+                CONV_FLOAT=sisMagnetRamp.setpoint;
+                changeEndian(&CAN_DATA(4), CONV_CHR_ADD);
+                CAN_SIZE=CAN_FULL_SIZE;
+                break;
+
+            case GET_CAN_TRACE_STATE: // 0x20025 -> Returns the CAN trace state
+                #ifdef DEBUG_CAN
+                    printf("  0x%lX->GET_CAN_TRACE_STATE\n\n",
+                           GET_CAN_TRACE_STATE);
+                #endif /* DEBUG_CAN */
+                CAN_DATA(0)=canTrace.state;
+                CAN_DATA(1)=canTrace.dumpOnError;
+                CAN_DATA(2)=(unsigned char)(canTrace.records>>8);
+                CAN_DATA(3)=(unsigned char)(canTrace.records);
+                CAN_DATA(4)=(unsigned char)(canTrace.recorded>>24);
+                CAN_DATA(5)=(unsigned char)(canTrace.recorded>>16);
+                CAN_DATA(6)=(unsigned char)(canTrace.recorded>>8);
+                CAN_DATA(7)=(unsigned char)(canTrace.recorded);
+                CAN_SIZE=CAN_FULL_SIZE;
+                break;
+
+            case GET_AMBSI_EMU_STATE: // 0x20026 -> Returns the AMBSI emulator state
+                #ifdef DEBUG_CAN
+                    printf("  0x%lX->GET_AMBSI_EMU_STATE\n\n",
+                           GET_AMBSI_EMU_STATE);
+                #endif /* DEBUG_CAN */
+                CAN_DATA(0)=ambsiEmulator.state;
+                CAN_DATA(1)=(unsigned char)(ambsiEmulator.completed>>24);
+                CAN_DATA(2)=(unsigned char)(ambsiEmulator.completed>>16);
+                CAN_DATA(3)=(unsigned char)(ambsiEmulator.completed>>8);
+                CAN_DATA(4)=(unsigned char)(ambsiEmulator.completed);
+                CAN_DATA(5)=(unsigned char)(ambsiEmulator.timeouts>>16);
+                CAN_DATA(6)=(unsigned char)(ambsiEmulator.timeouts>>8);
+                CAN_DATA(7)=(unsigned char)(ambsiEmulator.timeouts);
+                CAN_SIZE=CAN_FULL_SIZE;
+                break;
+
+            case GET_AMBSI_EMU_RATE: // 0x20027 -> Returns the AMBSI emulator message rate
+                {
+                    unsigned long elapsed=ambsiEmulatorElapsed();
+
+                    #ifdef DEBUG_CAN
+                        printf("  0x%lX->GET_AMBSI_EMU_RATE\n\n",
+                               GET_AMBSI_EMU_RATE);
+                    #endif /* DEBUG_CAN */
+                    CONV_FLOAT=ambsiEmulatorRate();
+                    changeEndian(CAN_DATA_ADD, CONV_CHR_ADD);
+                    CAN_DATA(4)=(unsigned char)(elapsed>>24);
+                    CAN_DATA(5)=(unsigned char)(elapsed>>16);
+                    CAN_DATA(6)=(unsigned char)(elapsed>>8);
+                    CAN_DATA(7)=(unsigned char)(elapsed);
+                    CAN_SIZE=CAN_FULL_SIZE;
+                }
+                break;
+
+            case GET_AMBSI_EMU_LATENCY: // 0x20028 -> Returns the AMBSI emulator latency percentiles
+                {
+                    /* Median, 99%, 99.9% and max, in units of 0.1 ms */
+                    static const unsigned int permille[4]={500, 990, 999, 1000};
+                    unsigned long latency;
+                    unsigned char cnt;
+
+                    #ifdef DEBUG_CAN
+                        printf("  0x%lX->GET_AMBSI_EMU_LATENCY\n\n",
+                               GET_AMBSI_EMU_LATENCY);
+                    #endif /* DEBUG_CAN */
+                    for(cnt=0;
+                        cnt<4;
+                        cnt++){
+                        latency=ambsiEmulatorPercentile(permille[cnt])/100UL;
+                        if(latency>0xFFFFUL){
+                            latency=0xFFFFUL;
+                        }
+                        CAN_DATA(2*cnt)=(unsigned char)(latency>>8);
+                        CAN_DATA(2*cnt+1)=(unsigned char)(latency);
+                    }
+                    CAN_SIZE=CAN_FULL_SIZE;
+                }
+                break;
+
+            case GET_SETPOINT_COALESCE: // 0x20029 -> Returns the setpoint coalescing state and counters
+                #ifdef DEBUG_CAN
+                    printf("  0x%lX->GET_SETPOINT_COALESCE\n\n",
+                           GET_SETPOINT_COALESCE);
+                #endif /* DEBUG_CAN */
+                CAN_DATA(0)=setpointQueue.enable;
+                CAN_DATA(1)=setpointQueue.pending;
+                CAN_DATA(2)=(unsigned char)(setpointQueue.coalesced>>16);
+                CAN_DATA(3)=(unsigned char)(setpointQueue.coalesced>>8);
+                CAN_DATA(4)=(unsigned char)(setpointQueue.coalesced);
+                CAN_DATA(5)=(unsigned char)(setpointQueue.applied>>16);
+                CAN_DATA(6)=(unsigned char)(setpointQueue.applied>>8);
+                CAN_DATA(7)=(unsigned char)(setpointQueue.applied);
+                CAN_SIZE=CAN_FULL_SIZE;
+                break;
+
+            case GET_CONTROL_ELISION: // 0x2002A -> Returns the control elision state and counters
+                #ifdef DEBUG_CAN
+                    printf("  0x%lX->GET_CONTROL_ELISION\n\n",
+                           GET_CONTROL_ELISION);
+                #endif /* DEBUG_CAN */
+                CAN_DATA(0)=controlElision.enable;
+                CAN_DATA(1)=(unsigned char)(controlElision.checked>>16);
+                CAN_DATA(2)=(unsigned char)(controlElision.checked>>8);
+                CAN_DATA(3)=(unsigned char)(controlElision.checked);
+                CAN_DATA(4)=(unsigned char)(controlElision.elided>>24);
+                CAN_DATA(5)=(unsigned char)(controlElision.elided>>16);
+                CAN_DATA(6)=(unsigned char)(controlElision.elided>>8);
+                CAN_DATA(7)=(unsigned char)(controlElision.elided);
+                CAN_SIZE=CAN_FULL_SIZE;
+                break;
+
+            case GET_MEMORY_HEAP: // 0x2002B -> Returns the heap free bytes, largest free block and free blocks
+                #ifdef DEBUG_CAN
+                    printf("  0x%lX->GET_MEMORY_HEAP\n\n",
+                           GET_MEMORY_HEAP);
+                #endif /* DEBUG_CAN */
+                if(memoryHeapWalk()==ERROR){
+                    CAN_STATUS = ERROR;
+                }
+                CAN_DATA(0)=(unsigned char)(memoryHeap.freeBytes>>16);
+                CAN_DATA(1)=(unsigned char)(memoryHeap.freeBytes>>8);
+                CAN_DATA(2)=(unsigned char)(memoryHeap.freeBytes);
+                CAN_DATA(3)=(unsigned char)(memoryHeap.largestFree>>16);
+                CAN_DATA(4)=(unsigned char)(memoryHeap.largestFree>>8);
+                CAN_DATA(5)=(unsigned char)(memoryHeap.largestFree);
+                CAN_DATA(6)=(unsigned char)(memoryHeap.freeBlocks>>8);
+                CAN_DATA(7)=(unsigned char)(memoryHeap.freeBlocks);
+                CAN_SIZE=CAN_FULL_SIZE;
+                break;
+
+            case GET_MEMORY_STACK: // 0x2002C -> Returns the painted, least free and free stack and the free DOS memory
+                #ifdef DEBUG_CAN
+                    printf("  0x%lX->GET_MEMORY_STACK\n\n",
+                           GET_MEMORY_STACK);
+                #endif /* DEBUG_CAN */
+                memoryStackCheck();
+                memoryHeapWalk();
+                CAN_DATA(0)=(unsigned char)(memoryStack.painted>>8);
+                CAN_DATA(1)=(unsigned char)(memoryStack.painted);
+                CAN_DATA(2)=(unsigned char)(memoryStack.leastFree>>8);
+                CAN_DATA(3)=(unsigned char)(memoryStack.leastFree);
+                CAN_DATA(4)=(unsigned char)(memoryStack.free>>8);
+                CAN_DATA(5)=(unsigned char)(memoryStack.free);
+                CAN_DATA(6)=(unsigned char)(memoryHeap.dosFree>>8);
+                CAN_DATA(7)=(unsigned char)(memoryHeap.dosFree);
+                CAN_SIZE=CAN_FULL_SIZE;
+                break;
+
             /* This will take care also of all the monitor request on
                special CAN control RCAs. It should be replaced by a proper
                structure as the one used for standard RCAs */
             default:
+                /* Startup profile entries: phase, band, start and duration in ms.
+                   Times are 24 bits, 0xFFFFFF for a phase that never ended. */
+                if(CAN_ADDRESS >= GET_STARTUP_PROFILE_ENTRY &&
+                   CAN_ADDRESS < GET_STARTUP_PROFILE_ENTRY + STARTUP_PROFILE_ENTRIES)
+                {
+                    STARTUP_PROFILE_ENTRY *entry = &startupProfile[(unsigned char) (CAN_ADDRESS - GET_STARTUP_PROFILE_ENTRY)];
+
+                    #ifdef DEBUG_CAN
+                        printf("  0x%lX->GET_STARTUP_PROFILE_ENTRY[%d]\n\n",
+                               CAN_ADDRESS,
+                               (int) (CAN_ADDRESS - GET_STARTUP_PROFILE_ENTRY));
+                    #endif /* DEBUG_CAN */
+
+                    /* Entry not recorded: return all 0xFF */
+                    if(CAN_ADDRESS - GET_STARTUP_PROFILE_ENTRY >= startupProfileEntries){
+                        memset(&CAN_DATA(0), 0xFF, CAN_FULL_SIZE);
+                        CAN_SIZE=CAN_FULL_SIZE;
+                        break;
+                    }
+
+                    CAN_DATA(0)=(*entry).phase;
+                    CAN_DATA(1)=(*entry).band;
+                    CAN_DATA(2)=(unsigned char)((*entry).start>>16);
+                    CAN_DATA(3)=(unsigned char)((*entry).start>>8);
+                    CAN_DATA(4)=(unsigned char)((*entry).start);
+                    CAN_DATA(5)=(unsigned char)((*entry).duration>>16);
+                    CAN_DATA(6)=(unsigned char)((*entry).duration>>8);
+                    CAN_DATA(7)=(unsigned char)((*entry).duration);
+                    CAN_SIZE=CAN_FULL_SIZE;
+                    break;
+                }
+
+                /* Power distribution rails cached by the async sweep, four
+                   blocks per band: blocks 0-2 hold two channels each, voltage
+                   in mV and current in mA as signed 16 bits; block 3 holds
+                   the age of the sweep in ms and the module enable state. */
+                if(CAN_ADDRESS >= GET_PD_RAILS &&
+                   CAN_ADDRESS < GET_PD_RAILS + PD_MODULES_NUMBER * PD_RAILS_BLOCKS)
+                {
+                    unsigned char module = (unsigned char) (CAN_ADDRESS - GET_PD_RAILS) / PD_RAILS_BLOCKS;
+                    unsigned char block = (unsigned char) (CAN_ADDRESS - GET_PD_RAILS) % PD_RAILS_BLOCKS;
+                    PD_MODULE *pdModule = &frontend.powerDistribution.pdModule[module];
+
+                    #ifdef DEBUG_CAN
+                        printf("  0x%lX->GET_PD_RAILS[%d][%d]\n\n",
+                               CAN_ADDRESS,
+                               module,
+                               block);
+                    #endif /* DEBUG_CAN */
+
+                    /* Module never swept: return all 0xFF */
+                    if((*pdModule).railsCache.time == 0){
+                        memset(&CAN_DATA(0), 0xFF, CAN_FULL_SIZE);
+                        CAN_SIZE=CAN_FULL_SIZE;
+                        break;
+                    }
+
+                    if(block == PD_RAILS_BLOCKS - 1){
+                        unsigned long age = clock() - (*pdModule).railsCache.time;
+
+                        CAN_DATA(0)=(unsigned char)(age>>24);
+                        CAN_DATA(1)=(unsigned char)(age>>16);
+                        CAN_DATA(2)=(unsigned char)(age>>8);
+                        CAN_DATA(3)=(unsigned char)(age);
+                        CAN_DATA(4)=(*pdModule).enable;
+                        CAN_SIZE=5;
+                    } else {
+                        unsigned char channel, rail;
+                        int value;
+
+                        /* Integer mV and mA straight from the ADC counts */
+                        for(channel = 0; channel < PD_RAILS_PER_BLOCK; channel++){
+                            rail = block * PD_RAILS_PER_BLOCK + channel;
+
+                            value = (int) adcScaleMilli((*pdModule).railsCache.rail[rail].voltage, &pdVoltageScale[rail]);
+                            CAN_DATA(4 * channel) = (unsigned char) (value >> 8);
+                            CAN_DATA(4 * channel + 1) = (unsigned char) value;
+                            value = (int) adcScaleMilli((*pdModule).railsCache.rail[rail].current, &pdCurrentScale[rail]);
+                            CAN_DATA(4 * channel + 2) = (unsigned char) (value >> 8);
+                            CAN_DATA(4 * channel + 3) = (unsigned char) value;
+                        }
+                        CAN_SIZE=CAN_FULL_SIZE;
+                    }
+
+                    /* A failed reading in the sweep, or a module turned off since */
+                    if((*pdModule).railsCache.status != NO_ERROR){
+                        CAN_STATUS = (*pdModule).railsCache.status;
+                    } else if((*pdModule).enable == PD_MODULE_DISABLE){
+                        CAN_STATUS = HARDW_BLKD_ERR;
+                    }
+                    break;
+                }
+
+                /* Serial profile counters, three blocks per operation:
+                   calls and errors, mux transactions and busy polls, time in ms. */
+                if(CAN_ADDRESS >= GET_SERIAL_PROFILE &&
+                   CAN_ADDRESS < GET_SERIAL_PROFILE + SERIAL_PROFILE_OPERATIONS * SERIAL_PROFILE_BLOCKS)
+                {
+                    unsigned char operation = (unsigned char) (CAN_ADDRESS - GET_SERIAL_PROFILE) / SERIAL_PROFILE_BLOCKS;
+                    SERIAL_PROFILE_ENTRY *entry = &serialProfile[operation];
+                    unsigned long first, second;
+
+                    #ifdef DEBUG_CAN
+                        printf("  0x%lX->GET_SERIAL_PROFILE[%d]\n\n",
+                               CAN_ADDRESS,
+                               operation);
+                    #endif /* DEBUG_CAN */
+
+                    switch((unsigned char) (CAN_ADDRESS - GET_SERIAL_PROFILE) % SERIAL_PROFILE_BLOCKS){
+                        case 0:
+                            first=(*entry).calls;
+                            second=(*entry).errors;
+                            break;
+                        case 1:
+                            first=(*entry).transactions;
+                            second=(*entry).busyPolls;
+                            break;
+                        default:
+                            first=(*entry).time;
+                            second=0;
+                            break;
+                    }
+
+                    CAN_DATA(0)=(unsigned char)(first>>24);
+                    CAN_DATA(1)=(unsigned char)(first>>16);
+                    CAN_DATA(2)=(unsigned char)(first>>8);
+                    CAN_DATA(3)=(unsigned char)(first);
+                    CAN_DATA(4)=(unsigned char)(second>>24);
+                    CAN_DATA(5)=(unsigned char)(second>>16);
+                    CAN_DATA(6)=(unsigned char)(second>>8);
+                    CAN_DATA(7)=(unsigned char)(second);
+                    CAN_SIZE=CAN_FULL_SIZE;
+                    break;
+                }
+
+                /* Commands elided for one module */
+                if(CAN_ADDRESS >= GET_CONTROL_ELIDED &&
+                   CAN_ADDRESS < GET_CONTROL_ELIDED + MODULES_NUMBER)
+                {
+                    unsigned long elided = controlElision.elidedModule[CAN_ADDRESS - GET_CONTROL_ELIDED];
+
+                    #ifdef DEBUG_CAN
+                        printf("  0x%lX->GET_CONTROL_ELIDED\n\n",
+                               CAN_ADDRESS);
+                    #endif /* DEBUG_CAN */
+
+                    CAN_DATA(0)=(unsigned char)(elided>>24);
+                    CAN_DATA(1)=(unsigned char)(elided>>16);
+                    CAN_DATA(2)=(unsigned char)(elided>>8);
+                    CAN_DATA(3)=(unsigned char)(elided);
+                    CAN_SIZE=4;
+                    break;
+                }
+
+                /* Heap held by one memory account */
+                if(CAN_ADDRESS >= GET_MEMORY_ACCOUNT &&
+                   CAN_ADDRESS < GET_MEMORY_ACCOUNT + MEMORY_ACCOUNTS_NUMBER)
+                {
+                    MEMORY_ACCOUNT *account = &memoryAccount[CAN_ADDRESS - GET_MEMORY_ACCOUNT];
+
+                    #ifdef DEBUG_CAN
+                        printf("  0x%lX->GET_MEMORY_ACCOUNT\n\n",
+                               CAN_ADDRESS);
+                    #endif /* DEBUG_CAN */
+
+                    CAN_DATA(0)=(unsigned char)((*account).bytes>>16);
+                    CAN_DATA(1)=(unsigned char)((*account).bytes>>8);
+                    CAN_DATA(2)=(unsigned char)((*account).bytes);
+                    CAN_DATA(3)=(unsigned char)((*account).blocks>>8);
+                    CAN_DATA(4)=(unsigned char)((*account).blocks);
+                    CAN_DATA(5)=(unsigned char)((*account).peak>>16);
+                    CAN_DATA(6)=(unsigned char)((*account).peak>>8);
+                    CAN_DATA(7)=(unsigned char)((*account).peak);
+                    CAN_SIZE=CAN_FULL_SIZE;
+                    break;
+                }
+
+                /* Sensor statistics of the last closed window: two floats
+                   or the sample count, depending on the RCA block. */
+                if(CAN_ADDRESS >= GET_STATS_MIN_MAX &&
+                   CAN_ADDRESS < GET_STATS_COUNT + STATS_CHANNELS_NUMBER)
+                {
+                    unsigned int offset = (unsigned int) (CAN_ADDRESS - GET_STATS_MIN_MAX);
+                    unsigned char channel = (unsigned char) (offset & 0x7F);
+                    STATS_RESULT *result = &sensorStats.result[channel];
+
+                    #ifdef DEBUG_CAN
+                        printf("  0x%lX->GET_STATS[%d]\n\n",
+                               CAN_ADDRESS,
+                               channel);
+                    #endif /* DEBUG_CAN */
+
+                    if(channel < STATS_CHANNELS_NUMBER){
+                        switch(CAN_ADDRESS - channel){
+                            case GET_STATS_MIN_MAX:
+                                CONV_FLOAT=(*result).min;
+                                changeEndian(CAN_DATA_ADD, CONV_CHR_ADD);
+                                CONV_FLOAT=(*result).max;
+                                changeEndian(&CAN_DATA(4), CONV_CHR_ADD);
+                                CAN_SIZE=CAN_FULL_SIZE;
+                                break;
+                            case GET_STATS_MEAN_STD:
+                                CONV_FLOAT=(*result).mean;
+                                changeEndian(CAN_DATA_ADD, CONV_CHR_ADD);
+                                CONV_FLOAT=(*result).stdDev;
+                                changeEndian(&CAN_DATA(4), CONV_CHR_ADD);
+                                CAN_SIZE=CAN_FULL_SIZE;
+                                break;
+                            default:
+                                CAN_DATA(0)=(unsigned char)((*result).count>>24);
+                                CAN_DATA(1)=(unsigned char)((*result).count>>16);
+                                CAN_DATA(2)=(unsigned char)((*result).count>>8);
+                                CAN_DATA(3)=(unsigned char)((*result).count);
+                                CAN_SIZE=4;
+                                break;
+                        }
+                        break;
+                    }
+                }
+
+                /* Deadband of a statistics channel */
+                if(CAN_ADDRESS >= GET_DEADBAND &&
+                   CAN_ADDRESS < GET_DEADBAND + STATS_CHANNELS_NUMBER)
+                {
+                    #ifdef DEBUG_CAN
+                        printf("  0x%lX->GET_DEADBAND[%d]\n\n",
+                               CAN_ADDRESS,
+                               (int) (CAN_ADDRESS - GET_DEADBAND));
+                    #endif /* DEBUG_CAN */
+
+                    CONV_FLOAT=deadband[(unsigned char) (CAN_ADDRESS - GET_DEADBAND)];
+                    changeEndian(CAN_DATA_ADD, CONV_CHR_ADD);
+                    CAN_SIZE=CAN_FLOAT_SIZE;
+                    break;
+                }
+
                 #ifdef DEBUG_CAN
                     printf("  Out of Range!\n\n");
                 #endif /* DEBUG_CAN */
@@ -615,7 +1223,7 @@ static void specialRCAsHandler(void){
                     printf("  0x%lX->SET_READ_ESN\n\n",
                            SET_READ_ESN);
                 #endif /* DEBUG_CAN */
-                owbGetEsn();
+                owbRequestSearch(); // Performed in the background by owbAsync()
                 device=0; // Clears device index
                 break;
 
@@ -721,7 +1329,337 @@ static void specialRCAsHandler(void){
                 }
                 break;
 
+            case SET_RECORDER_CHANNEL + 0:
+            case SET_RECORDER_CHANNEL + 1:
+            case SET_RECORDER_CHANNEL + 2:
+            case SET_RECORDER_CHANNEL + 3:
+                #ifdef DEBUG_CAN
+                    printf("  0x%lX->SET_RECORDER_CHANNEL\n\n",
+                           CAN_ADDRESS);
+                #endif /* DEBUG_CAN */
+                {
+                    unsigned long rca=((unsigned long)CAN_DATA(0)<<24)|
+                                      ((unsigned long)CAN_DATA(1)<<16)|
+                                      ((unsigned long)CAN_DATA(2)<<8)|
+                                      (unsigned long)CAN_DATA(3);
+                    /* Only monitor RCAs can be recorded. 0 disables the channel. */
+                    if(CAN_SIZE!=CAN_FLOAT_SIZE || rca>=BASE_SPECIAL_CONTROL_RCA ||
+                       (rca>=BASE_CONTROL_RCA && rca<BASE_SPECIAL_MONITOR_RCA)){
+                        storeError(ERR_FLIGHT_RECORDER, ERC_COMMAND_VAL); // Not a monitor RCA
+                        break;
+                    }
+                    flightRecorder.rca[(unsigned char)(CAN_ADDRESS-SET_RECORDER_CHANNEL)]=rca;
+                }
+                break;
+
+            case SET_RECORDER_PERIOD: // 0x21044 -> Sets the flight recorder sample period
+                #ifdef DEBUG_CAN
+                    printf("  0x%lX->SET_RECORDER_PERIOD\n\n",
+                           SET_RECORDER_PERIOD);
+                #endif /* DEBUG_CAN */
+                flightRecorder.period=((unsigned int)CAN_DATA(0)<<8)|CAN_DATA(1);
+                break;
+
+            case SET_RECORDER_TRIGGER: // 0x21045 -> Sets the flight recorder trigger
+                #ifdef DEBUG_CAN
+                    printf("  0x%lX->SET_RECORDER_TRIGGER\n\n",
+                           SET_RECORDER_TRIGGER);
+                #endif /* DEBUG_CAN */
+                {
+                    unsigned int postTrigger=((unsigned int)CAN_DATA(6)<<8)|CAN_DATA(7);
+                    /* The trigger sample must still be in the buffer when the capture stops */
+                    if(CAN_SIZE!=CAN_FULL_SIZE || CAN_DATA(0)>=FLIGHT_RECORDER_TRIGGER_MODES ||
+                       CAN_DATA(1)>=FLIGHT_RECORDER_CHANNELS || postTrigger>=FLIGHT_RECORDER_SAMPLES){
+                        storeError(ERR_FLIGHT_RECORDER, ERC_COMMAND_VAL); // Trigger setting out of range
+                        break;
+                    }
+                    flightRecorder.triggerMode=CAN_DATA(0);
+                    flightRecorder.triggerChannel=CAN_DATA(1);
+                    changeEndian(CONV_CHR_ADD, &CAN_DATA(2));
+                    flightRecorder.triggerLevel=CONV_FLOAT;
+                    flightRecorder.postTrigger=postTrigger;
+                }
+                break;
+
+            case SET_RECORDER_ARM: // 0x21046 -> Starts or stops a flight recorder capture
+                #ifdef DEBUG_CAN
+                    printf("  0x%lX->SET_RECORDER_ARM\n\n",
+                           SET_RECORDER_ARM);
+                #endif /* DEBUG_CAN */
+                if(CAN_BYTE){
+                    flightRecorderArm();
+                } else {
+                    flightRecorderStop();
+                }
+                break;
+
+            case SET_RECORDER_REWIND: // 0x21047 -> Restarts the flight recorder readout
+                #ifdef DEBUG_CAN
+                    printf("  0x%lX->SET_RECORDER_REWIND\n\n",
+                           SET_RECORDER_REWIND);
+                #endif /* DEBUG_CAN */
+                flightRecorder.readIndex=0;
+                break;
+
+            case SET_STATS_LATCH: // 0x21048 -> Closes the statistics window
+                #ifdef DEBUG_CAN
+                    printf("  0x%lX->SET_STATS_LATCH\n\n",
+                           SET_STATS_LATCH);
+                #endif /* DEBUG_CAN */
+                sensorStatsLatch();
+                break;
+
+            case SET_STATS_WINDOW: // 0x21049 -> Sets the automatic statistics window period
+                #ifdef DEBUG_CAN
+                    printf("  0x%lX->SET_STATS_WINDOW\n\n",
+                           SET_STATS_WINDOW);
+                #endif /* DEBUG_CAN */
+                sensorStatsSetWindow(((unsigned int)CAN_DATA(0)<<8)|CAN_DATA(1));
+                break;
+
+            case SET_DEADBAND_RESET: // 0x2104A -> Reports every statistics channel again
+                #ifdef DEBUG_CAN
+                    printf("  0x%lX->SET_DEADBAND_RESET\n\n",
+                           SET_DEADBAND_RESET);
+                #endif /* DEBUG_CAN */
+                deadbandReset();
+                break;
+
+            case SET_LO_LOCK_ABORT: // 0x2104B -> Stops the LO lock engine
+                #ifdef DEBUG_CAN
+                    printf("  0x%lX->SET_LO_LOCK_ABORT\n\n",
+                           SET_LO_LOCK_ABORT);
+                #endif /* DEBUG_CAN */
+                loLockAbort();
+                break;
+
+            case SET_LO_PA_SWEEP_TARGET: // 0x2104C -> Sets the response current where the LO PA sweeps stop
+                #ifdef DEBUG_CAN
+                    printf("  0x%lX->SET_LO_PA_SWEEP_TARGET\n\n",
+                           SET_LO_PA_SWEEP_TARGET);
+                #endif /* DEBUG_CAN */
+                changeEndian(CONV_CHR_ADD, CAN_DATA_ADD);
+                loPaSweep.target=CONV_FLOAT;
+                break;
+
+            case SET_SIS_MAGNET_RAMP_ABORT: // 0x2104D -> Stops the SIS magnet ramp or deflux
+                #ifdef DEBUG_CAN
+                    printf("  0x%lX->SET_SIS_MAGNET_RAMP_ABORT\n\n",
+                           SET_SIS_MAGNET_RAMP_ABORT);
+                #endif /* DEBUG_CAN */
+                sisMagnetRampAbort();
+                break;
+
+            case SET_SERIAL_PROFILE_RESET: // 0x2104E -> Clears the serial profile counters
+                #ifdef DEBUG_CAN
+                    printf("  0x%lX->SET_SERIAL_PROFILE_RESET\n\n",
+                           SET_SERIAL_PROFILE_RESET);
+                #endif /* DEBUG_CAN */
+                serialProfileReset();
+                break;
+
+            case SET_CAN_TRACE_ARM: // 0x2104F -> Starts or stops a CAN trace
+                #ifdef DEBUG_CAN
+                    printf("  0x%lX->SET_CAN_TRACE_ARM\n\n",
+                           SET_CAN_TRACE_ARM);
+                #endif /* DEBUG_CAN */
+                canTraceArm(CAN_BYTE);
+                break;
+
+            case SET_CAN_TRACE_DUMP: // 0x2105A -> Writes the CAN trace to the flash disk
+                #ifdef DEBUG_CAN
+                    printf("  0x%lX->SET_CAN_TRACE_DUMP\n\n",
+                           SET_CAN_TRACE_DUMP);
+                #endif /* DEBUG_CAN */
+                canTraceRequestDump();
+                break;
+
+            case SET_AMBSI_EMU_RATE: // 0x2105B -> Sets the AMBSI emulator message rate
+                #ifdef DEBUG_CAN
+                    printf("  0x%lX->SET_AMBSI_EMU_RATE\n\n",
+                           SET_AMBSI_EMU_RATE);
+                #endif /* DEBUG_CAN */
+                if(CAN_SIZE<7){
+                    storeError(ERR_PP, ERC_COMMAND_VAL); // AMBSI emulator rate settings incomplete
+                    break;
+                }
+                ambsiEmulator.rate=((unsigned int)CAN_DATA(0)<<8)|CAN_DATA(1);
+                ambsiEmulator.burst=CAN_DATA(2);
+                ambsiEmulator.burstGap=((unsigned int)CAN_DATA(3)<<8)|CAN_DATA(4);
+                ambsiEmulator.timeout=((unsigned int)CAN_DATA(5)<<8)|CAN_DATA(6);
+                break;
+
+            case SET_AMBSI_EMU_RUN: // 0x2105C -> Starts or stops the AMBSI emulator
+                #ifdef DEBUG_CAN
+                    printf("  0x%lX->SET_AMBSI_EMU_RUN\n\n",
+                           SET_AMBSI_EMU_RUN);
+                #endif /* DEBUG_CAN */
+                if(!CAN_BYTE){
+                    ambsiEmulatorStop();
+                } else {
+                    /* Optional number of messages to send */
+                    ambsiEmulatorStart((CAN_SIZE<5) ? 0L :
+                                       ((unsigned long)CAN_DATA(1)<<24)|((unsigned long)CAN_DATA(2)<<16)|
+                                       ((unsigned long)CAN_DATA(3)<<8)|CAN_DATA(4));
+                }
+                break;
+
+            case SET_SETPOINT_COALESCE: // 0x2105D -> Enables or disables the coalescing of analog setpoints
+                #ifdef DEBUG_CAN
+                    printf("  0x%lX->SET_SETPOINT_COALESCE\n\n",
+                           SET_SETPOINT_COALESCE);
+                #endif /* DEBUG_CAN */
+                setpointQueueEnable(CAN_BYTE);
+                break;
+
+            case SET_CONTROL_ELISION: // 0x2105E -> Enables or disables the elision of repeated control commands
+                #ifdef DEBUG_CAN
+                    printf("  0x%lX->SET_CONTROL_ELISION\n\n",
+                           SET_CONTROL_ELISION);
+                #endif /* DEBUG_CAN */
+                controlElisionEnable(CAN_BYTE);
+                break;
+
+            case SET_LO_LOCK + 0:
+            case SET_LO_LOCK + 1:
+            case SET_LO_LOCK + 2:
+            case SET_LO_LOCK + 3:
+            case SET_LO_LOCK + 4:
+            case SET_LO_LOCK + 5:
+            case SET_LO_LOCK + 6:
+            case SET_LO_LOCK + 7:
+            case SET_LO_LOCK + 8:
+            case SET_LO_LOCK + 9:
+                #ifdef DEBUG_CAN
+                    printf("  0x%lX->SET_LO_LOCK\n\n",
+                           CAN_ADDRESS);
+                #endif /* DEBUG_CAN */
+                if(CAN_SIZE!=CAN_FULL_SIZE){
+                    storeError(ERR_LO_LOCK, ERC_COMMAND_VAL); // Lock settings incomplete
+                    break;
+                }
+                loLockStart((unsigned char)(CAN_ADDRESS-SET_LO_LOCK), CAN_DATA_ADD);
+                break;
+
             default:
+                /* AMBSI emulator message: RCA and up to 4 bytes of control payload */
+                if(CAN_ADDRESS >= SET_AMBSI_EMU_MESSAGE &&
+                   CAN_ADDRESS < SET_AMBSI_EMU_MESSAGE + AMBSI_EMULATOR_MESSAGES)
+                {
+                    AMBSI_EMULATOR_MESSAGE *message = &ambsiEmulator.message[(unsigned char) (CAN_ADDRESS - SET_AMBSI_EMU_MESSAGE)];
+
+                    #ifdef DEBUG_CAN
+                        printf("  0x%lX->SET_AMBSI_EMU_MESSAGE[%d]\n\n",
+                               CAN_ADDRESS,
+                               (int) (CAN_ADDRESS - SET_AMBSI_EMU_MESSAGE));
+                    #endif /* DEBUG_CAN */
+
+                    if(CAN_SIZE<4 || ambsiEmulator.state==AMBSI_EMULATOR_RUNNING){
+                        storeError(ERR_PP, ERC_COMMAND_VAL); // AMBSI emulator message incomplete or emulator running
+                        break;
+                    }
+                    (*message).rca=((unsigned long)CAN_DATA(0)<<24)|((unsigned long)CAN_DATA(1)<<16)|
+                                   ((unsigned long)CAN_DATA(2)<<8)|CAN_DATA(3);
+                    (*message).size=CAN_SIZE-4;
+                    memcpy((*message).payload, &CAN_DATA(4), (*message).size);
+                    break;
+                }
+
+                /* LO PA sweep of a PA channel: start, stop, step, response and settle time */
+                if(CAN_ADDRESS >= SET_LO_PA_SWEEP &&
+                   CAN_ADDRESS < SET_LO_PA_SWEEP + CARTRIDGES_NUMBER * POLARIZATIONS_NUMBER)
+                {
+                    unsigned char channel = (unsigned char) (CAN_ADDRESS - SET_LO_PA_SWEEP);
+
+                    #ifdef DEBUG_CAN
+                        printf("  0x%lX->SET_LO_PA_SWEEP[%d]\n\n",
+                               CAN_ADDRESS,
+                               channel);
+                    #endif /* DEBUG_CAN */
+
+                    if(CAN_SIZE!=CAN_FULL_SIZE){
+                        storeError(ERR_LO_PA_SWEEP, ERC_COMMAND_VAL); // Sweep settings incomplete
+                        break;
+                    }
+                    loPaSweepStart(channel / POLARIZATIONS_NUMBER,
+                                   channel % POLARIZATIONS_NUMBER,
+                                   CAN_DATA_ADD);
+                    break;
+                }
+
+                /* SIS magnet ramp or deflux: magnets are numbered band*4+magnet */
+                if((CAN_ADDRESS >= SET_SIS_MAGNET_RAMP &&
+                    CAN_ADDRESS < SET_SIS_MAGNET_RAMP + CARTRIDGES_NUMBER * SIS_MAGNET_JUNCTIONS) ||
+                   (CAN_ADDRESS >= SET_SIS_MAGNET_DEFLUX &&
+                    CAN_ADDRESS < SET_SIS_MAGNET_DEFLUX + CARTRIDGES_NUMBER * SIS_MAGNET_JUNCTIONS))
+                {
+                    unsigned char deflux = (CAN_ADDRESS >= SET_SIS_MAGNET_DEFLUX);
+                    unsigned char magnet = (unsigned char) (CAN_ADDRESS - ((deflux) ? SET_SIS_MAGNET_DEFLUX : SET_SIS_MAGNET_RAMP));
+
+                    #ifdef DEBUG_CAN
+                        printf("  0x%lX->SET_SIS_MAGNET_%s[%d]\n\n",
+                               CAN_ADDRESS,
+                               (deflux) ? "DEFLUX" : "RAMP",
+                               magnet);
+                    #endif /* DEBUG_CAN */
+
+                    if(CAN_SIZE!=CAN_FULL_SIZE){
+                        storeError(ERR_SIS_MAGNET, ERC_COMMAND_VAL); // Ramp settings incomplete
+                        break;
+                    }
+                    if(deflux){
+                        sisMagnetDefluxStart(magnet / SIS_MAGNET_JUNCTIONS,
+                                             magnet % SIS_MAGNET_JUNCTIONS,
+                                             CAN_DATA_ADD);
+                    } else {
+                        sisMagnetRampStart(magnet / SIS_MAGNET_JUNCTIONS,
+                                           magnet % SIS_MAGNET_JUNCTIONS,
+                                           CAN_DATA_ADD);
+                    }
+                    break;
+                }
+
+                /* SIS I-V sweep of a junction: start, stop, step and settle time */
+                if(CAN_ADDRESS >= SET_SIS_SWEEP &&
+                   CAN_ADDRESS < SET_SIS_SWEEP + CARTRIDGES_NUMBER * SIS_SWEEP_JUNCTIONS)
+                {
+                    unsigned char junction = (unsigned char) (CAN_ADDRESS - SET_SIS_SWEEP);
+
+                    #ifdef DEBUG_CAN
+                        printf("  0x%lX->SET_SIS_SWEEP[%d]\n\n",
+                               CAN_ADDRESS,
+                               junction);
+                    #endif /* DEBUG_CAN */
+
+                    if(CAN_SIZE!=CAN_FULL_SIZE){
+                        storeError(ERR_SIS_SWEEP, ERC_COMMAND_VAL); // Sweep settings incomplete
+                        break;
+                    }
+                    sisSweepStart(junction / SIS_SWEEP_JUNCTIONS,
+                                  junction % SIS_SWEEP_JUNCTIONS,
+                                  CAN_DATA_ADD);
+                    break;
+                }
+
+                /* Deadband of a statistics channel, in the units of the sensor */
+                if(CAN_ADDRESS >= SET_DEADBAND &&
+                   CAN_ADDRESS < SET_DEADBAND + STATS_CHANNELS_NUMBER)
+                {
+                    #ifdef DEBUG_CAN
+                        printf("  0x%lX->SET_DEADBAND[%d]\n\n",
+                               CAN_ADDRESS,
+                               (int) (CAN_ADDRESS - SET_DEADBAND));
+                    #endif /* DEBUG_CAN */
+
+                    changeEndian(CONV_CHR_ADD, CAN_DATA_ADD);
+                    if(CAN_SIZE!=CAN_FLOAT_SIZE || CONV_FLOAT<0.0){
+                        storeError(ERR_CAN, ERC_COMMAND_VAL); // Deadband out of range
+                        break;
+                    }
+                    deadband[(unsigned char) (CAN_ADDRESS - SET_DEADBAND)]=CONV_FLOAT;
+                    break;
+                }
+
                 #ifdef DEBUG_CAN
                     printf("  Out of Range!\n\n");
                 #endif /* DEBUG_CAN */
@@ -802,6 +1740,11 @@ static void sendCANMessage(int appendStatusByte){
         printf("\n");
     #endif /* DEBUG_CAN */
 
+    /* A local request picks up the reply from CANMessage */
+    if(localRequest){
+        return;
+    }
+
     // Zero the payload buffer:
     memset(PPTxBuffer, 0, CAN_TX_MAX_PAYLOAD_SIZE);
     // Copy in the payload bytes:
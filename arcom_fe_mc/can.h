@@ -123,6 +123,34 @@
     #define GET_FE_MODE                 0x2000EL    //!< \b BASE+0x0E -> Returns the current FE operating mode
     #define GET_TCPIP_ADDRESS           0x2000FL    //!< \b BASE+0x0E -> Returns the IP address of the FEMC module ethernet port
     #define GET_LO_PA_LIMITS_TABLE_ESN  0x20010L    //!< \b BASE+0x10 through 0x19 return the PA LIMITS table ESN for band 1-10
+    #define GET_STARTUP_PROFILE_SIZE    0x2001AL    //!< \b BASE+0x1A -> Returns the number of startup profile entries and the total startup time in ms
+    #define GET_RECORDER_STATE          0x2001BL    //!< \b BASE+0x1B -> Returns the flight recorder state, channels, samples, trigger position and readout position
+    #define GET_RECORDER_SAMPLE         0x2001CL    //!< \b BASE+0x1C -> Returns the next recorded value, its status and time
+    #define GET_STATS_WINDOW            0x2001DL    //!< \b BASE+0x1D -> Returns the length in ms of the last closed statistics window and the window period in s
+    #define GET_NEXT_CHANGE             0x2001EL    //!< \b BASE+0x1E -> Returns the next statistics channel that moved beyond its deadband and its value
+    #define GET_LO_LOCK_STATE           0x2001FL    //!< \b BASE+0x1F -> Returns the LO lock engine state, band, YTO coarse tune and correction voltage
+    #define GET_SIS_SWEEP_STATE         0x20020L    //!< \b BASE+0x20 -> Returns the SIS sweep state, junction, points, measured points and readout position
+    #define GET_SIS_SWEEP_POINT         0x20021L    //!< \b BASE+0x21 -> Returns the next SIS sweep point: voltage and current
+    #define GET_LO_PA_SWEEP_STATE       0x20022L    //!< \b BASE+0x22 -> Returns the LO PA sweep state, PA channel, points, measured points and readout position
+    #define GET_LO_PA_SWEEP_POINT       0x20023L    //!< \b BASE+0x23 -> Returns the next LO PA sweep point: drain voltage and response current
+    #define GET_SIS_MAGNET_RAMP_STATE   0x20024L    //!< \b BASE+0x24 -> Returns the SIS magnet ramp state, magnet, steps done and current setpoint
+    #define GET_CAN_TRACE_STATE         0x20025L    //!< \b BASE+0x25 -> Returns the CAN trace state, dump on error, records in the ring and messages recorded
+    #define GET_AMBSI_EMU_STATE         0x20026L    //!< \b BASE+0x26 -> Returns the AMBSI emulator state, messages completed and timeouts
+    #define GET_AMBSI_EMU_RATE          0x20027L    //!< \b BASE+0x27 -> Returns the AMBSI emulator sustained message rate and elapsed time
+    #define GET_AMBSI_EMU_LATENCY       0x20028L    //!< \b BASE+0x28 -> Returns the AMBSI emulator median, 99%, 99.9% and max latency
+    #define GET_SETPOINT_COALESCE       0x20029L    //!< \b BASE+0x29 -> Returns the setpoint coalescing enable, pending, replaced and applied setpoints
+    #define GET_CONTROL_ELISION         0x2002AL    //!< \b BASE+0x2A -> Returns the control elision enable, commands checked and commands elided
+    #define GET_MEMORY_HEAP             0x2002BL    //!< \b BASE+0x2B -> Returns the free bytes in the heap, the largest free block and the free blocks
+    #define GET_MEMORY_STACK            0x2002CL    //!< \b BASE+0x2C -> Returns the painted stack, the least and current free stack and the free DOS memory
+    #define GET_STARTUP_PROFILE_ENTRY   0x20040L    //!< \b BASE+0x40 through 0x7F return the startup profile entries 0-63
+    #define GET_PD_RAILS                0x20080L    //!< \b BASE+0x80 through 0xA7 return block 0-3 of the cached power distribution rails of band 1-10
+    #define GET_SERIAL_PROFILE          0x200B0L    //!< \b BASE+0xB0 through 0xC7 return block 0-2 of the serial profile counters of operation 0-7
+    #define GET_CONTROL_ELIDED          0x200C8L    //!< \b BASE+0xC8 through 0xD6 return the commands elided for module 0-14
+    #define GET_MEMORY_ACCOUNT          0x200D7L    //!< \b BASE+0xD7 through 0xDD return the bytes, blocks and peak bytes of memory account 0-6
+    #define GET_STATS_MIN_MAX           0x20100L    //!< \b BASE+0x100 through 0x17F return the min and max of statistics channel 0-127
+    #define GET_STATS_MEAN_STD          0x20180L    //!< \b BASE+0x180 through 0x1FF return the mean and standard deviation of statistics channel 0-127
+    #define GET_STATS_COUNT             0x20200L    //!< \b BASE+0x200 through 0x27F return the number of samples of statistics channel 0-127
+    #define GET_DEADBAND                0x20280L    //!< \b BASE+0x280 through 0x2FF return the deadband of statistics channel 0-127
     #define LAST_SPECIAL_MONITOR_RCA    (BASE_SPECIAL_MONITOR_RCA+0x00FFF)  // Last possible special monitor RCA
     /* Control */
     //! \b 0x21000 -> Base address for the special control RCAs
@@ -139,6 +167,31 @@
     #define SET_READ_ESN                0x2100FL    //!< \b BASE+0x0F -> Forces the firmware to read again the ESN available on the OWB
     #define SET_LO_CLEAR_PA_LIMITS      0x21020L    //!< \b BASE+0x20 through 0x29 clear the PA LIMITS table for band 1-10
     #define SET_LO_SET_PA_LIMITS_ENTRY  0x21030L    //!< \b BASE+0x30 through 0x39 upload a PA LIMITS table entry for band 1-10
+    #define SET_RECORDER_CHANNEL        0x21040L    //!< \b BASE+0x40 through 0x43 select the monitor RCA of flight recorder channel 0-3
+    #define SET_RECORDER_PERIOD         0x21044L    //!< \b BASE+0x44 -> Sets the flight recorder sample period in ms
+    #define SET_RECORDER_TRIGGER        0x21045L    //!< \b BASE+0x45 -> Sets the flight recorder trigger mode, channel, level and post-trigger samples
+    #define SET_RECORDER_ARM            0x21046L    //!< \b BASE+0x46 -> Starts (1) or stops (0) a flight recorder capture
+    #define SET_RECORDER_REWIND         0x21047L    //!< \b BASE+0x47 -> Restarts the flight recorder readout from the oldest sample
+    #define SET_STATS_LATCH             0x21048L    //!< \b BASE+0x48 -> Closes the statistics window and starts a new one
+    #define SET_STATS_WINDOW            0x21049L    //!< \b BASE+0x49 -> Sets the automatic statistics window period in s, 0 for SET_STATS_LATCH only
+    #define SET_DEADBAND_RESET          0x2104AL    //!< \b BASE+0x4A -> Makes GET_NEXT_CHANGE return every statistics channel again
+    #define SET_LO_LOCK_ABORT           0x2104BL    //!< \b BASE+0x4B -> Stops the LO lock engine
+    #define SET_LO_PA_SWEEP_TARGET      0x2104CL    //!< \b BASE+0x4C -> Sets the response current where the LO PA sweeps stop, 0 for none
+    #define SET_SIS_MAGNET_RAMP_ABORT   0x2104DL    //!< \b BASE+0x4D -> Stops the SIS magnet ramp or deflux
+    #define SET_SERIAL_PROFILE_RESET    0x2104EL    //!< \b BASE+0x4E -> Clears the serial profile counters
+    #define SET_CAN_TRACE_ARM           0x2104FL    //!< \b BASE+0x4F -> Stops (0) or starts a CAN trace, written out on error (2) or on request (1)
+    #define SET_LO_LOCK                 0x21050L    //!< \b BASE+0x50 through 0x59 start the LO lock engine for band 1-10
+    #define SET_CAN_TRACE_DUMP          0x2105AL    //!< \b BASE+0x5A -> Writes the CAN trace to the flash disk
+    #define SET_AMBSI_EMU_RATE          0x2105BL    //!< \b BASE+0x5B -> Sets the AMBSI emulator message rate, burst length, burst gap and timeout
+    #define SET_AMBSI_EMU_RUN           0x2105CL    //!< \b BASE+0x5C -> Starts (1) or stops (0) the AMBSI emulator
+    #define SET_SETPOINT_COALESCE       0x2105DL    //!< \b BASE+0x5D -> Enables (1) or disables (0) the coalescing of analog setpoints
+    #define SET_CONTROL_ELISION         0x2105EL    //!< \b BASE+0x5E -> Enables (1) or disables (0) the elision of repeated control commands
+    #define SET_LO_PA_SWEEP             0x21060L    //!< \b BASE+0x60 through 0x73 start an LO PA sweep of band 1-10, polarization 0-1
+    #define SET_AMBSI_EMU_MESSAGE       0x21074L    //!< \b BASE+0x74 through 0x7B set the RCA and payload of AMBSI emulator message 0-7
+    #define SET_SIS_SWEEP               0x21100L    //!< \b BASE+0x100 through 0x127 start an SIS I-V sweep of band 1-10, junction 0-3
+    #define SET_SIS_MAGNET_RAMP         0x21140L    //!< \b BASE+0x140 through 0x167 ramp an SIS magnet of band 1-10, magnet 0-3 to a target current
+    #define SET_SIS_MAGNET_DEFLUX       0x21180L    //!< \b BASE+0x180 through 0x1A7 deflux an SIS magnet of band 1-10, magnet 0-3
+    #define SET_DEADBAND                0x21080L    //!< \b BASE+0x80 through 0xFF set the deadband of statistics channel 0-127
     #define LAST_SPECIAL_CONTROL_RCA    (BASE_SPECIAL_CONTROL_RCA+0x00FFF)  // Last possible special monitor RCA
 
 
@@ -184,7 +237,8 @@
         used to store the last issued control command for a particular RCA.
         This is needed because in case a monitor request is received on a
         control RCA, the returned message should contain the last issued
-        control message.
+        control message. The messages are kept by RCA in the store of
+        lastControl.h.
         \param  size    an unsigned char
         \param  data[]  an unsigned char
         \param  status  an unsigned char */
@@ -204,18 +258,6 @@
         unsigned char   status;
     } LAST_CONTROL_MESSAGE;
 
-    //! A macro to save the incoming control message into a LAST_CONTROL_MESSAGE struct
-    //!  then reset its status to NO_ERROR prior to command processing.
-    //!  This pattern is repeated all over the code!
-    #define SAVE_LAST_CONTROL_MESSAGE(target) { \
-        memcpy(&target, &CAN_SIZE, CAN_LAST_CONTROL_MESSAGE_SIZE); \
-        target.status = NO_ERROR; }
-
-    //! A macro to return the last control message and status.
-    //!  This pattern is repeated all over the code!
-    #define RETURN_LAST_CONTROL_MESSAGE(source) { \
-        memcpy(&CAN_SIZE, &source, CAN_LAST_CONTROL_MESSAGE_SIZE); }
-
     /* Globals */
     /* Externs */
     extern volatile unsigned char newCANMsg;    //!< Notifier to the main program that a new CAN message has arrived
@@ -228,6 +270,7 @@
     /* A function to build CANMessage with the incoming data */
     static void receiveCANMessage(void);
     static void sendCANMessage(int appendStatusByte);
+    static void CANDispatch(void);
     /* All the handlers for the different messages */
     /* Classes */
     static void standardRCAsHandler(void);
@@ -235,5 +278,6 @@
     static void initHandler(void);
     /* Externs */
     extern void CANMessageHandler(void); //!< This function deals with the incoming can message
+    extern void CANRequestHandler(void); //!< This function deals with a request already stored in CANMessage
 
 #endif /* _CAN_H */
@@ -0,0 +1,278 @@
+/*! \file   canTrace.c
+    \brief  CAN traffic trace
+
+    See canTrace.h for a description of the trace and of the file format.
+*/
+
+/* Includes */
+#include <i86.h>        /* MK_FP */
+#include <stdio.h>      /* printf, fopen, fwrite, remove */
+#include <string.h>     /* memcpy, memset */
+
+#include "canTrace.h"
+#include "can.h"
+#include "ppComm.h"
+#include "timer.h"
+#include "error.h"
+#include "memoryUsage.h"
+#include "debug.h"
+#include "globalDefinitions.h"
+
+/* Globals */
+CAN_TRACE canTrace = {CAN_TRACE_IDLE,
+                      FALSE,
+                      CAN_TRACE_DUMP_NONE,
+                      0,
+                      0L};
+
+/* Statics */
+static unsigned char (*buffer)[CAN_TRACE_RECORD_SIZE] = NULL;  // Allocated at the first trace
+static unsigned int nextRecord;                                 // Ring index of the next record to write
+static unsigned char *record = NULL;                            // Record of the message being handled
+static unsigned long lastArrival;                               // readFineTimer() at the previous message
+static unsigned long handlerStart;                              // readFineTimer() at the start of the current message
+static unsigned long errorsAtStart;                             // errorTotal at the start of the current message
+static FILE *dumpFile = NULL;                                   // Trace file being written, NULL if none
+static unsigned int dumpOldest;                                 // Ring index of the oldest record to write
+static unsigned int dumpWritten;                                // Records written to the file so far
+
+/*! Start or stop a trace.
+    Starting discards the previous trace and abandons a dump in progress.
+    \param mode     one of the CAN_TRACE_ARM_* defines
+    \return
+        - \ref NO_ERROR -> if no error occurred
+        - \ref ERROR    -> if something wrong happened */
+int canTraceArm(unsigned char mode) {
+    switch (mode) {
+        case CAN_TRACE_ARM_STOP:
+            if (canTrace.state == CAN_TRACE_RECORDING)
+                canTrace.state = (canTrace.records) ? CAN_TRACE_FROZEN : CAN_TRACE_IDLE;
+            return NO_ERROR;
+
+        case CAN_TRACE_ARM_START:
+        case CAN_TRACE_ARM_ON_ERROR:
+            break;
+
+        default:
+            storeError(ERR_CAN_TRACE, ERC_COMMAND_VAL); // Arm mode out of range
+            return ERROR;
+    }
+
+    if (!buffer) {
+        buffer = (unsigned char (*)[CAN_TRACE_RECORD_SIZE]) memoryAlloc(MEMORY_CAN_TRACE, CAN_TRACE_RECORDS * CAN_TRACE_RECORD_SIZE);
+        if (!buffer) {
+            storeError(ERR_CAN_TRACE, ERC_NO_MEMORY); // Out of memory for the trace ring
+            return ERROR;
+        }
+    }
+
+    if (dumpFile)
+        canTraceDumpAbort();
+
+    canTrace.dumpOnError = (mode == CAN_TRACE_ARM_ON_ERROR);
+    canTrace.dumpPending = CAN_TRACE_DUMP_NONE;
+    canTrace.records = 0;
+    canTrace.recorded = 0;
+    nextRecord = 0;
+    record = NULL;
+    canTrace.state = CAN_TRACE_RECORDING;
+
+    #ifdef DEBUG_CAN_TRACE
+        printf("CAN trace: armed%s\n", (canTrace.dumpOnError) ? ", dump on error" : "");
+    #endif /* DEBUG_CAN_TRACE */
+
+    return NO_ERROR;
+}
+
+/*! Record the arrival of a CAN message.
+    This is called by CANMessageHandler() once the message is in
+    \ref CANMessage, before it is handled.  Nothing is recorded while the file is written. */
+void canTraceBegin(void) {
+    unsigned long ticks;
+
+    if (canTrace.state != CAN_TRACE_RECORDING || dumpFile)
+        return;
+
+    handlerStart = readFineTimer();
+    ticks = PP_BIOS_TICKS;
+    errorsAtStart = errorTotal;
+
+    record = buffer[nextRecord];
+    canTracePutWord(&record[0], CAN_ADDRESS, 4);
+    record[4] = CAN_SIZE;
+    record[5] = 0;
+    memset(&record[6], 0, CAN_TRACE_PAYLOAD_SIZE);
+    if (CAN_SIZE != CAN_MONITOR)
+        memcpy(&record[6], CAN_DATA_ADD, (CAN_SIZE < CAN_TRACE_PAYLOAD_SIZE) ? CAN_SIZE : CAN_TRACE_PAYLOAD_SIZE);
+    record[14] = NO_ERROR;
+
+    // The first message of a trace has no previous one:
+    canTracePutWord(&record[15],
+                    (canTrace.recorded) ? canTraceTime(FINE_TIMER_TO_US(handlerStart - lastArrival) / 1000UL) : CAN_TRACE_TIME_MAX,
+                    2);
+    lastArrival = handlerStart;
+
+    // The tick count wraps at midnight:
+    canTracePutWord(&record[17],
+                    (ticks >= PPRxTicks) ? canTraceTime((ticks - PPRxTicks) * CAN_TRACE_TICK_MS) : 0,
+                    2);
+}
+
+/*! Record the outcome of a CAN message.
+    This is called by CANMessageHandler() after the message is handled and,
+    for a monitor message, the reply is sent. */
+void canTraceEnd(void) {
+    if (!record)
+        return;
+
+    // The reply as sent to the AMBSI, with the status byte if it was appended:
+    if (record[4] == CAN_MONITOR) {
+        record[5] = CAN_SIZE;
+        memcpy(&record[6], CAN_DATA_ADD, (CAN_SIZE < CAN_TRACE_PAYLOAD_SIZE) ? CAN_SIZE : CAN_TRACE_PAYLOAD_SIZE);
+    }
+    record[14] = CAN_STATUS;
+    canTracePutWord(&record[19], canTraceTime(FINE_TIMER_TO_US(readFineTimer() - handlerStart)), 2);
+    record = NULL;
+
+    if (++nextRecord == CAN_TRACE_RECORDS)
+        nextRecord = 0;
+    if (canTrace.records < CAN_TRACE_RECORDS)
+        canTrace.records++;
+    canTrace.recorded++;
+
+    // Keep the messages that led to the error:
+    if (canTrace.dumpOnError && errorTotal != errorsAtStart) {
+        canTrace.state = CAN_TRACE_FROZEN;
+        canTrace.dumpPending = CAN_TRACE_DUMP_ERROR;
+    }
+}
+
+/*! Write out the trace at the next async pass.
+    Recording goes on meanwhile, if it is running.
+    \return
+        - \ref NO_ERROR -> if no error occurred
+        - \ref ERROR    -> if there is nothing to write out */
+int canTraceRequestDump(void) {
+    if (canTrace.records == 0) {
+        storeError(ERR_CAN_TRACE, ERC_COMMAND_VAL); // No CAN trace to write out
+        return ERROR;
+    }
+
+    canTrace.dumpPending = CAN_TRACE_DUMP_REQUEST;
+    return NO_ERROR;
+}
+
+/*! Write the next chunk of the trace if a dump is pending.
+    This is called at every pass of the async loop, between CAN messages.
+    The first pass creates the file and writes the header, the following
+    ones \ref CAN_TRACE_DUMP_CHUNK records each and the last one closes the
+    file.  Recording is held off meanwhile, so the ring doesn't change. */
+void canTraceAsync(void) {
+    int status;
+
+    if (!dumpFile) {
+        if (canTrace.dumpPending != CAN_TRACE_DUMP_NONE && canTraceDumpOpen() == ERROR)
+            canTrace.dumpPending = CAN_TRACE_DUMP_NONE;
+        return;
+    }
+
+    if (dumpWritten < canTrace.records) {
+        if (canTraceDumpChunk() == ERROR) {
+            canTraceDumpAbort();
+            canTrace.dumpPending = CAN_TRACE_DUMP_NONE;
+            storeError(ERR_CAN_TRACE, ERC_FLASH_ERROR); // Error writing the CAN trace file
+        }
+        return;
+    }
+
+    status = canTraceDumpClose();
+    canTrace.dumpPending = CAN_TRACE_DUMP_NONE;
+
+    if (status == ERROR) {
+        storeError(ERR_CAN_TRACE, ERC_FLASH_ERROR); // Error writing the CAN trace file
+        return;
+    }
+
+    #ifdef DEBUG_CAN_TRACE
+        printf("CAN trace: %u messages written to %s\n", canTrace.records, CAN_TRACE_FILE);
+    #endif /* DEBUG_CAN_TRACE */
+}
+
+/* Create the file and write the header */
+static int canTraceDumpOpen(void) {
+    unsigned char header[CAN_TRACE_HEADER_SIZE];
+
+    canTracePutWord(&header[0], CAN_TRACE_MAGIC, 4);
+    canTracePutWord(&header[4], CAN_TRACE_VERSION, 2);
+    canTracePutWord(&header[6], canTrace.records, 2);
+    canTracePutWord(&header[8], canTrace.recorded, 4);
+    header[12] = canTrace.dumpPending;
+
+    dumpFile = fopen(CAN_TRACE_FILE, "wb");
+    if (!dumpFile) {
+        storeError(ERR_CAN_TRACE, ERC_FLASH_ERROR); // Error creating the CAN trace file
+        return ERROR;
+    }
+
+    if (fwrite(header, CAN_TRACE_HEADER_SIZE, 1, dumpFile) != 1) {
+        canTraceDumpAbort();
+        storeError(ERR_CAN_TRACE, ERC_FLASH_ERROR); // Error writing the CAN trace file
+        return ERROR;
+    }
+
+    dumpOldest = (canTrace.records < CAN_TRACE_RECORDS) ? 0 : nextRecord;
+    dumpWritten = 0;
+
+    return NO_ERROR;
+}
+
+/* Write the next records, from the oldest to the newest, up to the end of the ring */
+static int canTraceDumpChunk(void) {
+    unsigned int slot = dumpOldest + dumpWritten;
+    unsigned int count = canTrace.records - dumpWritten;
+
+    if (slot >= CAN_TRACE_RECORDS)
+        slot -= CAN_TRACE_RECORDS;
+    if (count > CAN_TRACE_RECORDS - slot)
+        count = CAN_TRACE_RECORDS - slot;
+    if (count > CAN_TRACE_DUMP_CHUNK)
+        count = CAN_TRACE_DUMP_CHUNK;
+
+    if (fwrite(buffer[slot], CAN_TRACE_RECORD_SIZE, count, dumpFile) != count)
+        return ERROR;
+
+    dumpWritten += count;
+    return NO_ERROR;
+}
+
+/* Close the file, removing it if the last writes failed */
+static int canTraceDumpClose(void) {
+    int status = fclose(dumpFile);
+
+    dumpFile = NULL;
+    if (status != 0) {
+        remove(CAN_TRACE_FILE);
+        return ERROR;
+    }
+    return NO_ERROR;
+}
+
+/* Close and remove a partly written file */
+static void canTraceDumpAbort(void) {
+    fclose(dumpFile);
+    dumpFile = NULL;
+    remove(CAN_TRACE_FILE);
+}
+
+/* Store a value in big endian order */
+static void canTracePutWord(unsigned char *field, unsigned long value, unsigned char size) {
+    while (size--) {
+        field[size] = (unsigned char) value;
+        value >>= 8;
+    }
+}
+
+/* Saturate a time to a record field */
+static unsigned int canTraceTime(unsigned long time) {
+    return (time < CAN_TRACE_TIME_MAX) ? (unsigned int) time : CAN_TRACE_TIME_MAX;
+}
@@ -0,0 +1,106 @@
+/*! \file   canTrace.h
+    \brief  CAN traffic trace
+
+    The CAN trace records every message handled by CANMessageHandler() into a
+    RAM ring of \ref CAN_TRACE_RECORDS fixed size records, so the request mix
+    that led to a problem on the AMBSI side can be captured under real load
+    and played back later.  Requests from other sources, like the TCP M&C
+    service, are not recorded.
+
+    The ring is written to \ref CAN_TRACE_FILE on the flash disk on request
+    or, if armed for it, when handling a message stores an error.  In that
+    case recording stops so the file holds the messages that led to the
+    error.  The file is written from the async loop, never while a message
+    is being handled, \ref CAN_TRACE_DUMP_CHUNK records per pass so a
+    dump doesn't hold up the CAN messages.  Messages handled while the file
+    is being written are not recorded.
+
+    The file starts with a header, followed by the records from the oldest to
+    the newest.  Multi-byte fields are in big endian order as on the CAN bus:
+        - header:   magic (4 bytes), version (2), records in the file (2),
+                    messages recorded since armed (4), reason (1)
+        - record:   RCA (4), request size (1), reply size (1), payload (8),
+                    status (1), inter-arrival time (2), wait (2), duration (2)
+
+    The payload is the request payload for a control message and the reply
+    for a monitor message, as sent to the AMBSI with the status byte appended
+    if it fits.  The wait is the time from the parallel port
+    interrupt to the start of the handler, spent finishing the current async
+    pass.  The inter-arrival time is in ms and the duration in us, both
+    measured with the fine timer.  The wait is in ms, with the resolution of
+    the DOS timer tick.  All times are saturated at 0xFFFF.
+
+    The trace is read off the flash disk by FTP and replayed from a host by
+    can_trace_python/FEMCCanTraceReplay.py through the TCP M&C service.
+
+    Control, through the special RCAs:
+        - SET_CAN_TRACE_ARM:    0 to stop, 1 to start a new trace,
+                                2 to start one that is written out on error
+        - SET_CAN_TRACE_DUMP:   write the ring to the flash disk now
+        - GET_CAN_TRACE_STATE:  state, dump on error, records, messages */
+
+#ifndef _CANTRACE_H
+    #define _CANTRACE_H
+
+    /* Defines */
+    #define CAN_TRACE_RECORDS           1024            //!< Size of the ring
+    #define CAN_TRACE_PAYLOAD_SIZE      8               //!< Payload bytes kept for each message
+    #define CAN_TRACE_RECORD_SIZE       21              //!< Bytes in a record, see the layout above
+    #define CAN_TRACE_HEADER_SIZE       13              //!< Bytes in the file header
+    #define CAN_TRACE_FILE              "CANTRACE.BIN"  //!< Trace file on the flash disk
+    #define CAN_TRACE_MAGIC             0x43545243UL    //!< "CTRC"
+    #define CAN_TRACE_VERSION           2               //!< Change when the file layout changes
+    #define CAN_TRACE_TIME_MAX          0xFFFF          //!< Saturated time field
+    #define CAN_TRACE_TICK_MS           55              //!< ms per BIOS timer tick, rounded
+    #define CAN_TRACE_DUMP_CHUNK        32              //!< Records written to the file at each async pass
+
+    /* Trace state */
+    #define CAN_TRACE_IDLE              0               //!< Nothing recorded
+    #define CAN_TRACE_RECORDING         1               //!< Recording the CAN messages
+    #define CAN_TRACE_FROZEN            2               //!< Stopped, ready to be written out
+
+    /* Dump reasons */
+    #define CAN_TRACE_DUMP_NONE         0               //!< No dump pending
+    #define CAN_TRACE_DUMP_REQUEST      1               //!< Requested with SET_CAN_TRACE_DUMP
+    #define CAN_TRACE_DUMP_ERROR        2               //!< An error was stored while handling a message
+
+    /* Arm modes */
+    #define CAN_TRACE_ARM_STOP          0               //!< Stop recording
+    #define CAN_TRACE_ARM_START         1               //!< Start a new trace
+    #define CAN_TRACE_ARM_ON_ERROR      2               //!< Start a new trace, written out on error
+
+    /* Typedefs */
+    //! CAN trace setup and state
+    typedef struct {
+        unsigned char   state;          //!< One of the CAN_TRACE_* states
+        unsigned char   dumpOnError;    //!< Write out and stop at the first error
+        unsigned char   dumpPending;    //!< One of the CAN_TRACE_DUMP_* reasons
+        unsigned int    records;        //!< Records in the ring
+        unsigned long   recorded;       //!< Messages recorded since armed
+    } CAN_TRACE;
+
+    /* Globals */
+    /* Externs */
+    extern CAN_TRACE canTrace; //!< CAN trace setup and state
+
+    /* Prototypes */
+    /* Statics */
+    static void canTracePutWord(unsigned char *field, unsigned long value, unsigned char size);
+    static unsigned int canTraceTime(unsigned long time);
+    static int canTraceDumpOpen(void);
+    static int canTraceDumpChunk(void);
+    static int canTraceDumpClose(void);
+    static void canTraceDumpAbort(void);
+    /* Externs */
+    extern int canTraceArm(unsigned char mode);
+    //!< Start or stop a trace
+    extern void canTraceBegin(void);
+    //!< Record the arrival of a CAN message
+    extern void canTraceEnd(void);
+    //!< Record the outcome of a CAN message
+    extern int canTraceRequestDump(void);
+    //!< Write out the trace at the next async pass
+    extern void canTraceAsync(void);
+    //!< Write the next chunk of the trace if a dump is pending
+
+#endif /* _CANTRACE_H */
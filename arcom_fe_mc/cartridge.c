@@ -10,6 +10,7 @@
 #include <stdio.h>      /* printf */
 
 #include "frontend.h"
+#include "lastControl.h"
 #include "error.h"
 #include "debug.h"
 #include "biasSerialInterface.h"
@@ -18,6 +19,9 @@
 #include "pdSerialInterface.h"
 #include "timer.h"
 #include "serialMux.h"
+#include "configImage.h"
+#include "startupProfile.h"
+#include "controlElision.h"
 
 /* Statics */
 static HANDLER cartridgeSubsystemHandler[CARTRIDGE_SUBSYSTEMS_NUMBER]={biasSubsystemHandler,
@@ -205,6 +209,9 @@ int cartridgeStop(unsigned char cartridge){
     /* Force clear STANDBY2 mode */
     frontend.cartridge[cartridge].standby2 = FALSE;
 
+    /* The hardware no longer holds the commanded values */
+    controlEpochAdvance(cartridge);
+
     #ifdef DEBUG_INIT
         printf("  done!\n\n");
     #endif  // DEBUG_INIT
@@ -225,7 +232,7 @@ int cartridgeStartup(void){
     /* Few variables to help load the data from the configuration file */
     CFG_STRUCT dataIn;
     float resistor=0.0;
-    unsigned char sensor;
+    unsigned char sensor, phase;
 
     /* A variable to hold the section names of the cartridge configuration file
        where the temperature sensors offsets can be found. */
@@ -456,29 +463,34 @@ int cartridgeStartup(void){
         printf("  - Temperature sensor offsets!\n"); 
     #endif // DEBUG_STARTUP
 
-    /* Cartridge temp sensors offsets */
-    for(sensor = 0;
-        sensor < CARTRIDGE_TEMP_SENSORS_NUMBER;
-        sensor++)
-    {
-        dataIn.Name=SENSOR_OFFSET_KEY;
-        dataIn.VarType=Cfg_Float;
-        dataIn.DataPtr=&frontend.cartridge[currentModule].cartridgeTemp[sensor].offset;
-
-        /* Access configuration file, if error, skip the configuration. */
-        if(myReadCfg(frontend.cartridge[currentModule].configFile,
-                     SENSOR_OFFSET_SECTION(sensor),
-                     &dataIn,
-                     SENSOR_OFFSET_EXPECTED) != NO_ERROR)
+    /* Cartridge temp sensors offsets, unless already loaded from the
+       configuration image */
+    if(!configImageLoaded) {
+        phase = startupProfileBegin(STARTUP_PHASE_CARTRIDGE_INI, currentModule);
+        for(sensor = 0;
+            sensor < CARTRIDGE_TEMP_SENSORS_NUMBER;
+            sensor++)
         {
-            printf("Error reading cartridge:%d sensor:%d\n", currentModule, sensor);
+            dataIn.Name=SENSOR_OFFSET_KEY;
+            dataIn.VarType=Cfg_Float;
+            dataIn.DataPtr=&frontend.cartridge[currentModule].cartridgeTemp[sensor].offset;
+
+            /* Access configuration file, if error, skip the configuration. */
+            if(myReadCfg(frontend.cartridge[currentModule].configFile,
+                         SENSOR_OFFSET_SECTION(sensor),
+                         &dataIn,
+                         SENSOR_OFFSET_EXPECTED) != NO_ERROR)
+            {
+                printf("Error reading cartridge:%d sensor:%d\n", currentModule, sensor);
+            }
+            #ifdef DEBUG_STARTUP
+                printf("    - Sensor %d [%s] offset=%f\n",
+                        sensor,
+                        SENSOR_OFFSET_SECTION(sensor),
+                        frontend.cartridge[currentModule].cartridgeTemp[sensor].offset);
+            #endif /* DEBUG_STARTUP */
         }
-        #ifdef DEBUG_STARTUP
-            printf("    - Sensor %d [%s] offset=%f\n",
-                    sensor,
-                    SENSOR_OFFSET_SECTION(sensor),
-                    frontend.cartridge[currentModule].cartridgeTemp[sensor].offset);
-        #endif /* DEBUG_STARTUP */
+        startupProfileEnd(phase);
     }
 
     #ifdef DEBUG_STARTUP    
@@ -504,6 +516,9 @@ int cartridgeInit(unsigned char cartridge){
        to the selected cartridge. */
     currentModule = cartridge;
 
+    /* The commands received before the power up are no longer applied */
+    controlEpochAdvance(cartridge);
+
     /* Check if the receiver is outfitted with the cartridge */
     if(frontend.cartridge[currentModule].available==UNAVAILABLE) {
         storeError(ERR_CARTRIDGE, ERC_MODULE_ABSENT); //Cartridge not installed
@@ -578,6 +593,10 @@ int cartridgeAsync(void){
         ASYNC_CARTRIDGE_INIT,
         ASYNC_CARTRIDGE_GO_STANDBY2
     } asyncCartridgeTask = ASYNC_CARTRIDGE_IDLE;
+
+    /* The last control message of the power enable, if it was commanded */
+    LAST_CONTROL_MESSAGE *lastEnable;
+
     /* Address the current async cartridge */
     currentModule=currentAsyncCartridge;
 
@@ -627,8 +646,10 @@ int cartridgeAsync(void){
                            module that there was an urecoverable error with the
                            initialization and allow for a restart of the cartridge. */
                         /* Store the Error state in the last control message variable */
-                        frontend.powerDistribution.pdModule[currentAsyncCartridge].
-                            lastEnable.status=ERROR;
+                        lastEnable=lastControlFind(PD_MODULE_ENABLE_RCA(currentAsyncCartridge));
+                        if(lastEnable!=NULL){
+                            (*lastEnable).status=ERROR;
+                        }
 
                         /* Set the state of the cartridge to 'error' */
                         frontend.cartridge[currentAsyncCartridge].
@@ -643,8 +664,10 @@ int cartridgeAsync(void){
                     /*  If it worked. Mark the catridge as off. */
                     if(cartridgeStop(currentAsyncCartridge)==ERROR){
                         /* Store the Error state in the last control message variable */
-                        frontend.powerDistribution.pdModule[currentAsyncCartridge].
-                            lastEnable.status=ERROR;
+                        lastEnable=lastControlFind(PD_MODULE_ENABLE_RCA(currentAsyncCartridge));
+                        if(lastEnable!=NULL){
+                            (*lastEnable).status=ERROR;
+                        }
                     }
 
                     /* Decrease the number of currently turned on cartridges. */
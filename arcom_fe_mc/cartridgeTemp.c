@@ -12,6 +12,7 @@
 
 #include "error.h"
 #include "frontend.h"
+#include "lastControl.h"
 #include "debug.h"
 #include "globalDefinitions.h"
 #include "biasSerialInterface.h"
@@ -67,8 +68,7 @@ static void tempOffsetHandler(void) {
     /* If control message (size !=0) */
     if(CAN_SIZE){
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].
-            cartridgeTemp[currentCartridgeTempSubsystemModule].lastOffset)
+        SAVE_LAST_CONTROL_MESSAGE()
 
         /* Extract the floating data from the CAN message */
         changeEndian(CONV_CHR_ADD, CAN_DATA_ADD);
@@ -83,8 +83,7 @@ static void tempOffsetHandler(void) {
     /* If monitor on control RCA */
     if(currentClass == CONTROL_CLASS){
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].
-            cartridgeTemp[currentCartridgeTempSubsystemModule].lastOffset)
+        RETURN_LAST_CONTROL_MESSAGE()
         return;
     }
 
@@ -60,8 +60,6 @@
         /*! This is the offset (in K) respect to the standard calibration
             curve which is applied to all the sensors in the cartridge. */
         float                   offset;
-        //! Last control message: set offset
-        LAST_CONTROL_MESSAGE    lastOffset;
     } CARTRIDGE_TEMP;
 
 
@@ -0,0 +1,245 @@
+/*! \file   configImage.c
+    \brief  Precompiled binary configuration image
+
+    See configImage.h for a description of the image and when it is used.
+*/
+
+/* Includes */
+#include <stdio.h>      /* fopen, fread, fwrite, remove */
+#include <string.h>     /* memcpy */
+#include <sys/stat.h>   /* stat */
+
+#include "configImage.h"
+#include "frontend.h"
+#include "error.h"
+#include "memoryUsage.h"
+#include "debug.h"
+#include "globalDefinitions.h"
+
+/* Globals */
+unsigned char configImageLoaded = FALSE;
+
+/* Statics */
+static CONFIG_IMAGE_BODY imageBody;     // Static to keep it off the small DOS stack
+static unsigned int checksumSum1, checksumSum2;
+
+// Restart the running Fletcher-16 checksum:
+static void configImageChecksumReset(void) {
+    checksumSum1 = 0;
+    checksumSum2 = 0;
+}
+
+// Add a block of data to the running Fletcher-16 checksum:
+static void configImageChecksumAdd(const void *data, unsigned int size) {
+    const unsigned char *bytes = (const unsigned char *) data;
+
+    while (size--) {
+        checksumSum1 = (checksumSum1 + *bytes++) % 255;
+        checksumSum2 = (checksumSum2 + checksumSum1) % 255;
+    }
+}
+
+static unsigned int configImageChecksum(void) {
+    return (checksumSum2 << 8) | checksumSum1;
+}
+
+// Stamp all the source INI files with their current size and modification time:
+static void configImageStampSources(CONFIG_IMAGE_STAMP *stamp) {
+    struct stat info;
+    const char *name;
+    unsigned char source;
+
+    for (source = 0; source < CONFIG_IMAGE_SOURCES_NUMBER; source++) {
+        if (source == 0)
+            name = FRONTEND_CONF_FILE;
+        else if (source == 1)
+            name = CRYO_CONF_FILE;
+        else if (source & 1)
+            name = frontend.cartridge[(source - 2) / 2].lo.configFile;
+        else
+            name = frontend.cartridge[(source - 2) / 2].configFile;
+
+        if (stat(name, &info) == 0) {
+            stamp[source].size = info.st_size;
+            stamp[source].modified = info.st_mtime;
+        } else {
+            stamp[source].size = -1;
+            stamp[source].modified = 0;
+        }
+    }
+}
+
+/*! Load the configuration from the image file.
+    This must be called after the cartridge and WCA configuration file names
+    are known.  Nothing is changed in the frontend variable unless the whole
+    image is valid and was compiled from the current INI files.  On success
+    \ref configImageLoaded is set and the startup functions skip their INI
+    parsing.
+    \return
+        - \ref NO_ERROR -> if the configuration was loaded from the image
+        - \ref ERROR    -> if the INI files have to be parsed instead */
+int configImageLoad(void) {
+    FILE *file;
+    CONFIG_IMAGE_HEADER header;
+    CONFIG_IMAGE_STAMP current[CONFIG_IMAGE_SOURCES_NUMBER];
+    MAX_SAFE_LO_PA_ENTRY *table[CARTRIDGES_NUMBER];
+    unsigned char band, sensor, entries, valid;
+
+    configImageLoaded = FALSE;
+
+    for (band = 0; band < CARTRIDGES_NUMBER; band++)
+        table[band] = NULL;
+
+    file = fopen(CONFIG_IMAGE_FILE, "rb");
+    if (!file) {
+        #ifdef DEBUG_STARTUP
+            printf("Config image: %s not found\n", CONFIG_IMAGE_FILE);
+        #endif /* DEBUG_STARTUP */
+        return ERROR;
+    }
+
+    valid = (fread(&header, sizeof(header), 1, file) == 1
+             && header.magic == CONFIG_IMAGE_MAGIC
+             && header.version == CONFIG_IMAGE_VERSION);
+
+    // Check that none of the INI files changed since the image was compiled:
+    if (valid) {
+        configImageStampSources(current);
+        valid = (memcmp(current, header.source, sizeof(current)) == 0);
+    }
+
+    // The fixed part in a single read:
+    if (valid)
+        valid = (fread(&imageBody, sizeof(imageBody), 1, file) == 1);
+
+    if (valid) {
+        configImageChecksumReset();
+        configImageChecksumAdd(&imageBody, sizeof(imageBody));
+    }
+
+    // The LO PA limits tables, straight into their final buffers:
+    for (band = 0; valid && band < CARTRIDGES_NUMBER; band++) {
+        entries = imageBody.band[band].paLimitsEntries;
+        if (entries > 0) {
+            table[band] = (MAX_SAFE_LO_PA_ENTRY *) memoryAlloc(MEMORY_LO_PA_LIMITS, entries * sizeof(MAX_SAFE_LO_PA_ENTRY));
+            if (!table[band]) {
+                storeError(ERR_LO, ERC_NO_MEMORY); // Out of memory for the LO PA limits table
+                valid = FALSE;
+            } else if (fread(table[band], sizeof(MAX_SAFE_LO_PA_ENTRY), entries, file) != entries) {
+                valid = FALSE;
+            } else {
+                configImageChecksumAdd(table[band], entries * sizeof(MAX_SAFE_LO_PA_ENTRY));
+            }
+        }
+    }
+
+    if (valid)
+        valid = (configImageChecksum() == header.checksum && fgetc(file) == EOF);
+
+    fclose(file);
+
+    if (!valid) {
+        for (band = 0; band < CARTRIDGES_NUMBER; band++)
+            memoryFree(MEMORY_LO_PA_LIMITS, table[band]);
+
+        printf("Config image: %s is stale or damaged, loading INI files\n", CONFIG_IMAGE_FILE);
+        return ERROR;
+    }
+
+    // Everything checked out.  Copy the values to the frontend variable:
+    for (band = 0; band < CARTRIDGES_NUMBER; band++) {
+        for (sensor = 0; sensor < CARTRIDGE_TEMP_SENSORS_NUMBER; sensor++)
+            frontend.cartridge[band].cartridgeTemp[sensor].offset = imageBody.band[band].tempOffset[sensor];
+
+        frontend.cartridge[band].lo.pa.hasTeledynePa = imageBody.band[band].hasTeledynePa;
+        frontend.cartridge[band].lo.pa.teledyneCollectorByte[0] = imageBody.band[band].teledyneCollectorByte[0];
+        frontend.cartridge[band].lo.pa.teledyneCollectorByte[1] = imageBody.band[band].teledyneCollectorByte[1];
+
+        frontend.cartridge[band].lo.maxSafeLoPaTable = table[band];
+        frontend.cartridge[band].lo.maxSafeLoPaTableSize = imageBody.band[band].paLimitsEntries;
+        frontend.cartridge[band].lo.allocatedLoPaTableSize = imageBody.band[band].paLimitsEntries;
+        memcpy(frontend.cartridge[band].lo.maxSafeLoPaESN, imageBody.band[band].paLimitsESN, SERIAL_NUMBER_SIZE);
+    }
+
+    for (sensor = 0; sensor < TVO_SENSORS_NUMBER; sensor++) {
+        memcpy(frontend.cryostat.cryostatTemp[sensor].coeff, imageBody.tvoCoeff[sensor], sizeof(imageBody.tvoCoeff[sensor]));
+        frontend.cryostat.cryostatTemp[sensor].nextCoeff = 0;
+    }
+
+    configImageLoaded = TRUE;
+
+    printf("Config image: configuration loaded from %s\n", CONFIG_IMAGE_FILE);
+
+    return NO_ERROR;
+}
+
+/*! Compile the configuration loaded from the INI files into the image file.
+    This must be called after all the startup functions parsed the INI files.
+    A partially written image is removed so the next boot falls back to the
+    INI files.
+    \return
+        - \ref NO_ERROR -> if no error occurred
+        - \ref ERROR    -> if something wrong happened */
+int configImageWrite(void) {
+    FILE *file;
+    CONFIG_IMAGE_HEADER header;
+    unsigned char band, sensor, entries, valid;
+
+    // Gather the values from the frontend variable:
+    for (band = 0; band < CARTRIDGES_NUMBER; band++) {
+        for (sensor = 0; sensor < CARTRIDGE_TEMP_SENSORS_NUMBER; sensor++)
+            imageBody.band[band].tempOffset[sensor] = frontend.cartridge[band].cartridgeTemp[sensor].offset;
+
+        imageBody.band[band].hasTeledynePa = frontend.cartridge[band].lo.pa.hasTeledynePa;
+        imageBody.band[band].teledyneCollectorByte[0] = frontend.cartridge[band].lo.pa.teledyneCollectorByte[0];
+        imageBody.band[band].teledyneCollectorByte[1] = frontend.cartridge[band].lo.pa.teledyneCollectorByte[1];
+
+        imageBody.band[band].paLimitsEntries =
+            (frontend.cartridge[band].lo.maxSafeLoPaTable) ? frontend.cartridge[band].lo.maxSafeLoPaTableSize : 0;
+        memcpy(imageBody.band[band].paLimitsESN, frontend.cartridge[band].lo.maxSafeLoPaESN, SERIAL_NUMBER_SIZE);
+    }
+
+    for (sensor = 0; sensor < TVO_SENSORS_NUMBER; sensor++)
+        memcpy(imageBody.tvoCoeff[sensor], frontend.cryostat.cryostatTemp[sensor].coeff, sizeof(imageBody.tvoCoeff[sensor]));
+
+    configImageChecksumReset();
+    configImageChecksumAdd(&imageBody, sizeof(imageBody));
+    for (band = 0; band < CARTRIDGES_NUMBER; band++) {
+        entries = imageBody.band[band].paLimitsEntries;
+        if (entries > 0)
+            configImageChecksumAdd(frontend.cartridge[band].lo.maxSafeLoPaTable, entries * sizeof(MAX_SAFE_LO_PA_ENTRY));
+    }
+
+    header.magic = CONFIG_IMAGE_MAGIC;
+    header.version = CONFIG_IMAGE_VERSION;
+    header.checksum = configImageChecksum();
+    configImageStampSources(header.source);
+
+    file = fopen(CONFIG_IMAGE_FILE, "wb");
+    if (!file) {
+        storeError(ERR_INI, ERC_FLASH_ERROR); // Error creating the configuration image
+        return ERROR;
+    }
+
+    valid = (fwrite(&header, sizeof(header), 1, file) == 1
+             && fwrite(&imageBody, sizeof(imageBody), 1, file) == 1);
+
+    for (band = 0; valid && band < CARTRIDGES_NUMBER; band++) {
+        entries = imageBody.band[band].paLimitsEntries;
+        if (entries > 0)
+            valid = (fwrite(frontend.cartridge[band].lo.maxSafeLoPaTable, sizeof(MAX_SAFE_LO_PA_ENTRY), entries, file) == entries);
+    }
+
+    if (fclose(file) != 0)
+        valid = FALSE;
+
+    if (!valid) {
+        remove(CONFIG_IMAGE_FILE);
+        storeError(ERR_INI, ERC_FLASH_ERROR); // Error writing the configuration image
+        return ERROR;
+    }
+
+    printf("Config image: compiled %s\n", CONFIG_IMAGE_FILE);
+
+    return NO_ERROR;
+}
@@ -0,0 +1,85 @@
+/*! \file   configImage.h
+    \brief  Precompiled binary configuration image
+
+    Parsing frontend.ini, the ten CARTn.INI, the ten WCAn.INI and CRYO.INI
+    through the text INI parser is the slowest part of the boot.  After a boot
+    from the INI files the values that were loaded are saved in FECONFIG.BIN,
+    laid out like the runtime structures.  The next boot loads them back with
+    a handful of reads instead.
+
+    The image header stores the size and modification time of every INI file
+    it was compiled from.  If any of them changed, or the version or checksum
+    do not match, the image is ignored, the INI files are parsed as before and
+    a new image is compiled. */
+
+#ifndef _CONFIGIMAGE_H
+    #define _CONFIGIMAGE_H
+
+    /* Extra includes */
+    /* CARTRIDGE_TEMP_SENSORS_NUMBER */
+    #ifndef _CARTRIDGETEMP_H
+        #include "cartridgeTemp.h"
+    #endif /* _CARTRIDGETEMP_H */
+
+    /* TVO_SENSORS_NUMBER, TVO_COEFFS_NUMBER */
+    #ifndef _CRYOSTATTEMP_H
+        #include "cryostatTemp.h"
+    #endif /* _CRYOSTATTEMP_H */
+
+    /* CARTRIDGES_NUMBER */
+    #ifndef _CARTRIDGE_H
+        #include "cartridge.h"
+    #endif /* _CARTRIDGE_H */
+
+    /* Defines */
+    #define CONFIG_IMAGE_FILE       "FECONFIG.BIN"  // Image file on the flash disk
+    #define CONFIG_IMAGE_MAGIC      0x46454349UL    // "FECI"
+    #define CONFIG_IMAGE_VERSION    1               // Bump when the image layout changes
+    /* Source INI files: frontend.ini, CRYO.INI, then CARTn.INI and WCAn.INI for each band */
+    #define CONFIG_IMAGE_SOURCES_NUMBER (2 + 2 * CARTRIDGES_NUMBER)
+
+    /* Typedefs */
+    //! Size and modification time of one source INI file
+    /*! A missing file is recorded with size -1. */
+    typedef struct {
+        long    size;
+        long    modified;
+    } CONFIG_IMAGE_STAMP;
+
+    //! Configuration image header
+    typedef struct {
+        unsigned long       magic;      //!< Always CONFIG_IMAGE_MAGIC
+        unsigned int        version;    //!< CONFIG_IMAGE_VERSION at compile time
+        unsigned int        checksum;   //!< Fletcher-16 of everything after the header
+        CONFIG_IMAGE_STAMP  source[CONFIG_IMAGE_SOURCES_NUMBER]; //!< INI files the image was compiled from
+    } CONFIG_IMAGE_HEADER;
+
+    //! Per band configuration loaded from CARTn.INI and WCAn.INI
+    /*! The MAX_SAFE_LO_PA_ENTRY tables follow the fixed part of the image in
+        band order, paLimitsEntries entries each. */
+    typedef struct {
+        float           tempOffset[CARTRIDGE_TEMP_SENSORS_NUMBER];  //!< cartridgeTemp[].offset
+        unsigned char   hasTeledynePa;                              //!< lo.pa.hasTeledynePa
+        unsigned char   teledyneCollectorByte[2];                   //!< lo.pa.teledyneCollectorByte[]
+        unsigned char   paLimitsEntries;                            //!< lo.maxSafeLoPaTableSize
+        char            paLimitsESN[SERIAL_NUMBER_SIZE];            //!< lo.maxSafeLoPaESN
+    } CONFIG_IMAGE_BAND;
+
+    //! Fixed part of the configuration image
+    typedef struct {
+        CONFIG_IMAGE_BAND   band[CARTRIDGES_NUMBER];
+        float               tvoCoeff[TVO_SENSORS_NUMBER][TVO_COEFFS_NUMBER]; //!< cryostatTemp[].coeff
+    } CONFIG_IMAGE_BODY;
+
+    /* Globals */
+    /* Externs */
+    extern unsigned char configImageLoaded; //!< TRUE if this boot was configured from the image
+
+    /* Prototypes */
+    /* Externs */
+    extern int configImageLoad(void);
+    //!< Load the configuration from the image if it is current
+    extern int configImageWrite(void);
+    //!< Compile the configuration loaded from the INI files into the image
+
+#endif /* _CONFIGIMAGE_H */
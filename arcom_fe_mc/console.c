@@ -24,6 +24,9 @@
 #include "async.h"
 #include "owb.h"
 #include "ppComm.h"
+#include "serialProfile.h"
+#include "ambsiEmulator.h"
+#include "memoryUsage.h"
 
 /* Globals */
 /* Externs */
@@ -243,6 +246,12 @@ static void parseBuffer(void){
                 // Enable interrupts
             }
             break;
+        case 'b': // *** 'b' -> Serial profile report ***
+            serialProfileReport();
+            break;
+        case 'l': // *** 'l' -> AMBSI link emulator report ***
+            ambsiEmulatorReport();
+            break;
         case 'p': // *** 'p' -> LO PA_LIMITS tables report ***
             loPaLimitsTablesReport();
             break;             
@@ -252,6 +261,9 @@ static void parseBuffer(void){
         case 't': // *** 't' -> FE and cartridges configuration report ***
             feAndCartridgesConfigurationReport();
             break;            
+        case 'u': // *** 'u' -> Memory usage report ***
+            memoryUsageReport();
+            break;
         case 'o': // *** 'o' -> Parallel port status report ***
             PPStatusReport();
             break;
@@ -269,6 +281,7 @@ static void parseBuffer(void){
             printf(" ' -> retypes last command\n");
             printf(" \" -> repeats last command\n");
             printf(" a<CR> -> enables/disables the async process (DEBUG only)\n");
+            printf(" b<CR> -> serial profile report (comma separated)\n");
             printf(" c RCA q data<CR> -> Send a control command, where:\n");
             printf("         RCA is the Relative CAN Address in dec or hex (0x...) format\n");
             printf("         q is the qualifier for the payload:\n");
@@ -279,11 +292,13 @@ static void parseBuffer(void){
             printf(" d<CR> -> disable console\n");
             printf(" e<CR> -> reads and display ESNs on the OWB\n");
             printf(" i<CR> -> display version information\n");
+            printf(" l<CR> -> AMBSI link emulator report\n");
             printf(" m RCA<cr> -> send a monitor request, where:\n");
             printf("         RCA is the Relative CAN Address in dec or hex (0x...) format\n");
             printf(" p<CR> -> LO PA_LIMITS tables report\n");
             printf(" s<CR> -> cryostat sensor tables report\n");
             printf(" t<CR> -> FE and cartridges configuration report\n");
+            printf(" u<CR> -> memory usage report\n");
             printf(" o<CR> -> Parallel port status report\n");
             printf(" q<CR> -> quit\n");
             printf(" r<CR> -> restart\n");
@@ -0,0 +1,78 @@
+/*! \file   controlElision.c
+    \brief  Elision of repeated control commands
+
+    See controlElision.h for a description of the elision.
+*/
+
+/* Includes */
+#include <stdio.h>      /* printf */
+#include <string.h>     /* memcmp, memset */
+
+#include "controlElision.h"
+#include "lastControl.h"
+#include "error.h"
+#include "debug.h"
+#include "globalDefinitions.h"
+
+/* Globals */
+CONTROL_ELISION controlElision = {FALSE,
+                                  0L,
+                                  0L,
+                                  {0L}};
+
+/*! Check if the control message being handled can be skipped.
+    This is called by a control handler before it saves the message.
+    \return
+        - TRUE  -> if the same command was already applied: the handler
+                   returns without writing the hardware
+        - FALSE -> if the command has to be handled */
+int controlElide(void) {
+    const LAST_CONTROL_MESSAGE *last;  // Saved in the current epoch of the module
+
+    if (!controlElision.enable)
+        return FALSE;
+
+    controlElision.checked++;
+
+    last = lastControlFindCurrent(CAN_ADDRESS);
+    if (last == NULL
+        || last -> status != NO_ERROR
+        || last -> size != CAN_SIZE
+        || memcmp(last -> data, CAN_DATA_ADD, CAN_SIZE) != 0)
+    {
+        return FALSE;
+    }
+
+    controlElision.elided++;
+    controlElision.elidedModule[currentModule]++;
+
+    #ifdef DEBUG_CONTROL_ELISION
+        printf("Control elision: 0x%lX elided\n", CAN_ADDRESS);
+    #endif /* DEBUG_CONTROL_ELISION */
+
+    return TRUE;
+}
+
+/*! Invalidate the last control messages of a module.
+    This is called whenever the hardware of the module may no longer hold
+    the values last commanded, so the next command is always applied.
+    \param module   the module, as decoded from the RCA */
+void controlEpochAdvance(unsigned char module) {
+    lastControlEpochAdvance(module);
+}
+
+/*! Enable or disable elision.
+    Enabling clears the counters.
+    \param enable   TRUE to skip the repeated commands */
+void controlElisionEnable(unsigned char enable) {
+    if (enable && !controlElision.enable) {
+        controlElision.checked = 0L;
+        controlElision.elided = 0L;
+        memset(controlElision.elidedModule, 0, sizeof(controlElision.elidedModule));
+    }
+    controlElision.enable = (enable) ? TRUE : FALSE;
+
+    #ifdef DEBUG_CONTROL_ELISION
+        printf("Control elision: %s\n", (controlElision.enable) ? "enabled" : "disabled");
+    #endif /* DEBUG_CONTROL_ELISION */
+}
@@ -0,0 +1,68 @@
+/*! \file   controlElision.h
+    \brief  Elision of repeated control commands
+
+    Supervisory software periodically re-asserts the setpoints it already
+    sent.  When elision is enabled, a control message whose payload matches
+    the \ref LAST_CONTROL_MESSAGE of its RCA is not written to the hardware
+    again, provided that the last command succeeded and that its module was
+    not power cycled or reset since.  The last control message is left as it
+    is, so the command reads back as successful.
+
+    Every module has an epoch, advanced by controlEpochAdvance() when the
+    hardware may no longer hold the commanded values:
+        - a cartridge is initialized after power on, or switched off
+        - a cartridge enters or leaves STANDBY2
+        - a sweep or ramp engine takes over the bias or the LO PA of a
+          cartridge
+    A message received in an older epoch is never elided.  The store of the
+    last control messages keeps one bit per RCA for the messages saved by
+    SAVE_LAST_CONTROL_MESSAGE in the current epoch, see lastControl.h.
+
+    Only the handlers of controls that plainly write a setpoint check for
+    elision:
+        - SIS mixer bias voltage and SIS magnet current
+        - LNA stage drain voltage and drain current, LNA enable
+        - LO PA gate voltage
+        - IF channel attenuation, only if the attenuator still holds the
+          value, since the all channels control sets it too
+    The LO PA drain voltage is not elided since its safe limit depends on
+    the YTO tuning, which may have changed since.
+
+    Control and monitor, through the special RCAs:
+        - SET_CONTROL_ELISION:  1 to enable elision, 0 to disable it
+        - GET_CONTROL_ELISION:  enabled, commands checked (3 bytes), commands
+                                elided (4 bytes)
+        - GET_CONTROL_ELIDED:   commands elided for each module (4 bytes) */
+
+#ifndef _CONTROLELISION_H
+    #define _CONTROLELISION_H
+
+    /* Extra includes */
+    /* LAST_CONTROL_MESSAGE and MODULES_NUMBER */
+    #ifndef _CAN_H
+        #include "can.h"
+    #endif /* _CAN_H */
+
+    /* Typedefs */
+    //! Control elision setup and counters
+    typedef struct {
+        unsigned char   enable;                 //!< Skip the commands matching the last one
+        unsigned long   checked;                //!< Commands checked while enabled
+        unsigned long   elided;                 //!< Commands not written to the hardware
+        unsigned long   elidedModule[MODULES_NUMBER]; //!< Commands elided for each module
+    } CONTROL_ELISION;
+
+    /* Globals */
+    /* Externs */
+    extern CONTROL_ELISION controlElision; //!< Control elision setup and counters
+
+    /* Prototypes */
+    /* Externs */
+    extern int controlElide(void);
+    //!< Check if the current control message can be skipped
+    extern void controlEpochAdvance(unsigned char module);
+    //!< Invalidate the last control messages of a module
+    extern void controlElisionEnable(unsigned char enable);
+    //!< Enable or disable elision
+
+#endif /* _CONTROLELISION_H */
@@ -13,10 +13,15 @@
 #include "debug.h"
 #include "error.h"
 #include "frontend.h"
+#include "lastControl.h"
 #include "cryostatSerialInterface.h"
 #include "iniWrapper.h"
 #include "async.h"
 #include "timer.h"
+#include "nvJournal.h"
+#include "configImage.h"
+#include "startupProfile.h"
+#include "sensorStats.h"
 
 #define MACRO_TVO_SENSOR_NAMES {"CRYOCOOLER_4K",    \
                                 "PLATE_4K_LINK_1",  \
@@ -128,7 +133,7 @@ void cryostatHandler(void){
 int cryostatStartup(void) {
     FILE *file;
     CFG_STRUCT  dataIn;
-    unsigned char sensor, sensorNo[32];
+    unsigned char sensor, phase, sensorNo[32];
     /* A variable to hold the section names of the cryostat configuration file
        where the TVO coefficients can be found. */
     char sensors[TVO_SENSORS_NUMBER+1][TVO_SEC_NAME_SIZE] = MACRO_TVO_SENSOR_NAMES;
@@ -175,42 +180,43 @@ int cryostatStartup(void) {
     #endif
 
     /* CRYO.INI file name, no longer loaded from INI */
-    strcpy(frontend.cryostat.configFile, "CRYO.INI");
+    strcpy(frontend.cryostat.configFile, CRYO_CONF_FILE);
 
     /* Cryostat cold head hours file, no longer loaded from INI */
     strcpy(frontend.cryostat.coldHeadHoursFile, "CRYO_HRS.INI");
 
-    // Read the cold head hours:
-    /* Configure the read array */
-    dataIn.Name = CRYO_HOURS_KEY;
-    dataIn.VarType = Cfg_Ulong;
-    dataIn.DataPtr = &frontend.cryostat.coldHeadHours;
-
     // Start assuming read cold head hours will succeed:
     frontend.cryostat.coldHeadHoursDirty = 0;
 
+    // Read the cold head hours from the NV journal:
+    if (nvJournalRead(NV_KEY_COLD_HEAD_HOURS, &frontend.cryostat.coldHeadHours) != NO_ERROR) {
+
+        // Not journaled yet.  Migrate from the legacy cold head hours file:
+        /* Configure the read array */
+        dataIn.Name = CRYO_HOURS_KEY;
+        dataIn.VarType = Cfg_Ulong;
+        dataIn.DataPtr = &frontend.cryostat.coldHeadHours;
+
+        // Check whether the cold head hours file exists
+        if (file = fopen(frontend.cryostat.coldHeadHoursFile, "r")) {
+            fclose(file);
+
+            // Read the previous hours from the config file:
+            //  if error, assume 0 hours.
+            if (myReadCfg(frontend.cryostat.coldHeadHoursFile,
+                          CRYO_HOURS_FILE_SECTION,
+                          &dataIn,
+                          CRYO_HOURS_FILE_EXPECTED) != NO_ERROR) 
+            {
+                frontend.cryostat.coldHeadHours = 0;
+            }
+        } else {
+            frontend.cryostat.coldHeadHours = 0;
+        }
 
-    // Check whether the cold head hours file exists
-    if (file = fopen(frontend.cryostat.coldHeadHoursFile, "r")) {
-        fclose(file);
-    } else {
-        // no, create it:
-        file = fopen(frontend.cryostat.coldHeadHoursFile, "w");
-        fprintf(file, "[%s]\n", CRYO_HOURS_FILE_SECTION);
-        fclose(file);
-        // Set the dirty bit since hours is by definition zero:
-        frontend.cryostat.coldHeadHoursDirty = 1;
-    }
-
-    // Read the previous hours from the config file:
-    //  if error, assume 0 hours and set the dirty bit.
-    if (myReadCfg(frontend.cryostat.coldHeadHoursFile,
-                  CRYO_HOURS_FILE_SECTION,
-                  &dataIn,
-                  CRYO_HOURS_FILE_EXPECTED) != NO_ERROR) 
-    {
-        frontend.cryostat.coldHeadHours = 0;
+        // Set the dirty bit so the value gets journaled:
         frontend.cryostat.coldHeadHoursDirty = 1;
+        frontendWriteNVMemory();
     }
 
     printf("Cryostat - Cold head hours: %lu\n", frontend.cryostat.coldHeadHours);
@@ -225,55 +231,62 @@ int cryostatStartup(void) {
        sensors. The PRT sensors are hardcoded in the software. The TVO
        coefficient are loaded from the configuration file. */
     /* Read the coefficients */
-    for(sensor = 0; sensor < TVO_SENSORS_NUMBER; sensor++) {
-
-        /* Configure the read array to get the TVO sensor number */
-        dataIn.Name=TVO_NO_KEY;
-        dataIn.VarType=Cfg_String;
-        dataIn.DataPtr=sensorNo;
-
-        /* Access configuration file, if error, skip the configuration. */
-        if(myReadCfg(frontend.cryostat.configFile,
-                     TVO_NO_SECTION(sensor),
-                     &dataIn,
-                     TVO_NO_EXPECTED)!=NO_ERROR){
-            return NO_ERROR;
-        }
-
-        /* Print sensor information */
-        #ifdef DEBUG_STARTUP
-            printf("  - Loading coefficients for TVO sensor: %d...\n     [%s]\n     TVO_NO: %s\n",
-                   sensor, sensors[sensor], sensorNo);
-        #endif
-
-        /* Configure the read array to get the coefficient array */
-        dataIn.Name=TVO_COEFFS_KEY;
-        dataIn.VarType=Cfg_F_Array;
-        dataIn.DataPtr=frontend.cryostat.cryostatTemp[sensor].coeff;
-
-        /* Access configuration file, if error, skip the configuration. */
-        if(myReadCfg(frontend.cryostat.configFile,
-                     TVO_COEFFS_SECTION(sensor),
-                     &dataIn,
-                     TVO_COEFFS_EXPECTED)!=NO_ERROR){
-            return NO_ERROR;
-        }
+    /* Unless already loaded from the configuration image */
+    if(!configImageLoaded) {
+        phase = startupProfileBegin(STARTUP_PHASE_CRYOSTAT_INI, STARTUP_PROFILE_NO_BAND);
+        for(sensor = 0; sensor < TVO_SENSORS_NUMBER; sensor++) {
+
+            /* Configure the read array to get the TVO sensor number */
+            dataIn.Name=TVO_NO_KEY;
+            dataIn.VarType=Cfg_String;
+            dataIn.DataPtr=sensorNo;
+
+            /* Access configuration file, if error, skip the configuration. */
+            if(myReadCfg(frontend.cryostat.configFile,
+                         TVO_NO_SECTION(sensor),
+                         &dataIn,
+                         TVO_NO_EXPECTED)!=NO_ERROR){
+                startupProfileEnd(phase);
+                return NO_ERROR;
+            }
 
-        /* Print sensor coefficients */
-        #ifdef DEBUG_STARTUP
-            for(frontend.cryostat.cryostatTemp[sensor].nextCoeff = 0;
-                frontend.cryostat.cryostatTemp[sensor].nextCoeff < TVO_COEFFS_NUMBER;
-                frontend.cryostat.cryostatTemp[sensor].nextCoeff++)
-            {
-                printf("      a%d = %f\n",
-                       frontend.cryostat.cryostatTemp[sensor].nextCoeff, 
-                       frontend.cryostat.cryostatTemp[sensor].coeff[frontend.cryostat.cryostatTemp[sensor].nextCoeff]);
+            /* Print sensor information */
+            #ifdef DEBUG_STARTUP
+                printf("  - Loading coefficients for TVO sensor: %d...\n     [%s]\n     TVO_NO: %s\n",
+                       sensor, sensors[sensor], sensorNo);
+            #endif
+
+            /* Configure the read array to get the coefficient array */
+            dataIn.Name=TVO_COEFFS_KEY;
+            dataIn.VarType=Cfg_F_Array;
+            dataIn.DataPtr=frontend.cryostat.cryostatTemp[sensor].coeff;
+
+            /* Access configuration file, if error, skip the configuration. */
+            if(myReadCfg(frontend.cryostat.configFile,
+                         TVO_COEFFS_SECTION(sensor),
+                         &dataIn,
+                         TVO_COEFFS_EXPECTED)!=NO_ERROR){
+                startupProfileEnd(phase);
+                return NO_ERROR;
             }
-            printf("    done!\n"); // TVO coefficients
-        #endif /* DEBUG_STARTUP */
 
-        /* Initialize next coeff to read to zero */
-        frontend.cryostat.cryostatTemp[sensor].nextCoeff = 0;
+            /* Print sensor coefficients */
+            #ifdef DEBUG_STARTUP
+                for(frontend.cryostat.cryostatTemp[sensor].nextCoeff = 0;
+                    frontend.cryostat.cryostatTemp[sensor].nextCoeff < TVO_COEFFS_NUMBER;
+                    frontend.cryostat.cryostatTemp[sensor].nextCoeff++)
+                {
+                    printf("      a%d = %f\n",
+                           frontend.cryostat.cryostatTemp[sensor].nextCoeff, 
+                           frontend.cryostat.cryostatTemp[sensor].coeff[frontend.cryostat.cryostatTemp[sensor].nextCoeff]);
+                }
+                printf("    done!\n"); // TVO coefficients
+            #endif /* DEBUG_STARTUP */
+
+            /* Initialize next coeff to read to zero */
+            frontend.cryostat.cryostatTemp[sensor].nextCoeff = 0;
+        }
+        startupProfileEnd(phase);
     }
 
     /* The vaccum controller power up state is ON. This allows to monitor the
@@ -403,7 +416,7 @@ void coldHeadHoursHandler(void) {
     /* If control (size !=0) */
     if(CAN_SIZE){
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.cryostat.lastColdHeadHours)
+        SAVE_LAST_CONTROL_MESSAGE()
 
         /* Extract the unsigned int from the CAN message. */
         changeEndianInt(CONV_CHR_ADD, CAN_DATA_ADD);
@@ -425,7 +438,7 @@ void coldHeadHoursHandler(void) {
     /* If monitor on control RCA */
     if(currentClass==CONTROL_CLASS){
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.cryostat.lastColdHeadHours)
+        RETURN_LAST_CONTROL_MESSAGE()
         return;
     }
     
@@ -487,6 +500,8 @@ int cryostatAsync(void){
                         printf("Async -> Cryostat -> ASYNC_CRYO_GET_TEMP(%d)\n", currentAsyncCryoTempModule);
                     #endif /* DEBUG_CRYOSTAT_ASYNC */
                     asyncCryoTempError[currentAsyncCryoTempModule]=NO_ERROR;
+                    sensorStatsUpdate(STATS_CRYO_TEMP+currentAsyncCryoTempModule,
+                                      frontend.cryostat.cryostatTemp[currentAsyncCryoTempModule].temp);
                     break;
                 case ERROR:
                     break;
@@ -518,6 +533,8 @@ int cryostatAsync(void){
                         printf("Async -> Cryostat -> ASYNC_CRYO_GET_PRES(%d)\n", currentAsyncVacuumControllerModule);
                     #endif /* DEBUG_CRYOSTAT_ASYNC */
                     asyncVacuumControllerError[currentAsyncVacuumControllerModule]=NO_ERROR;
+                    sensorStatsUpdate(STATS_VACUUM+currentAsyncVacuumControllerModule,
+                                      frontend.cryostat.vacuumController.vacuumSensor[currentAsyncVacuumControllerModule].pressure);
                     break;
                 case ERROR:
                     break;
@@ -680,6 +697,9 @@ int cryostatAsyncLogHours(void) {
             if (cnt >= 2) {
                 frontend.cryostat.coldHeadHours++;
                 frontend.cryostat.coldHeadHoursDirty = 1;
+
+                // Journal the new value.  This is a single small append:
+                frontendWriteNVMemory();
             }
 
             asyncCryoLogHoursState = ASYNC_CRYO_LOG_HOURS_SET_TIMER;
@@ -60,6 +60,7 @@
     #define CRYO_HRDW_REV1              1
     /* Configuration data info */
     #define CRYO_CONF_FILE_SECTION      "CRYO"  // Section containing the cryostat configuration file info
+    #define CRYO_CONF_FILE              "CRYO.INI"  // Cryostat configuration file, no longer loaded from INI
 
     #define CRYO_AVAIL_KEY              "AVAILABLE" // Key containing the availability of the cryostat
     #define CRYO_AVAIL_EXPECTED         1
@@ -187,9 +188,6 @@
         //! Cold head hours need to be written to NV memory?
         unsigned char       coldHeadHoursDirty;
 
-        //! Last cold head reset message
-        LAST_CONTROL_MESSAGE    lastColdHeadHours;
-
         //! Configuration File
         /*! This contains the configuration file name as extracted from the
             frontend configuration file. */
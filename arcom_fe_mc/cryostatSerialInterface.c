@@ -29,6 +29,7 @@
 #include "debug.h"
 #include "frontend.h"
 #include "serialInterface.h"
+#include "serialProfile.h"
 #include "timer.h"
 #include "async.h"
 #include "can.h"
@@ -38,6 +39,19 @@
 /* Statics */
 CRYO_REGISTERS cryoRegisters;
 
+/* Cryostat analog monitor request.
+   This function profiles the analog monitor cycle below. See serialProfile.h. */
+static int getCryoAnalogMonitor(void){
+
+    int ret;
+
+    serialProfileBegin(SERIAL_PROFILE_CRYO_ANALOG);
+    ret=getCryoAnalogMonitorCycle();
+    serialProfileEnd(SERIAL_PROFILE_CRYO_ANALOG, ret);
+
+    return ret;
+}
+
 /* CRYO analog monitor request core.
    This function performs the core operation that are common to all the analog
    monitor requests for the CRYO module:
@@ -52,7 +66,7 @@ CRYO_REGISTERS cryoRegisters;
    NO_ERROR will be returned. It will return ASYNC_DONE once all the step
    necessary to measure the temperature are completed and the data is stored in
    the fronted variable. */
-static int getCryoAnalogMonitor(void){
+static int getCryoAnalogMonitorCycle(void){
 
     /* A static enum to track the state of the asynchronous readout */
     static enum {
@@ -390,6 +390,7 @@
     /* Prototypes */
     /* Statics */
     static int getCryoAnalogMonitor(void); // Perform core analog monitor functions
+    static int getCryoAnalogMonitorCycle(void); // Analog monitor cycle, without the profiling
 
     /* Externs */
     extern int setBackingPumpEnable(unsigned char enable); //!< This function enables/disables/ the backing pump
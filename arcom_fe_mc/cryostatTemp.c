@@ -12,6 +12,7 @@
 
 #include "debug.h"
 #include "frontend.h"
+#include "lastControl.h"
 #include "can.h"
 #include "error.h"
 #include "cryostatSerialInterface.h"
@@ -137,7 +138,7 @@ static void sequentialCoeffHandler(void) {
     /* If control (size !=0) */
     if (CAN_SIZE) {
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.cryostat.cryostatTemp[currentCryostatModule].lastCommand)
+        SAVE_LAST_CONTROL_MESSAGE()
 
         /* Extract the coefficient order byte */
         coeff = CAN_DATA(4);
@@ -147,7 +148,7 @@ static void sequentialCoeffHandler(void) {
             storeError(ERR_CRYOSTAT_TEMP, ERC_COMMAND_VAL);
 
             /* Store the error in the last control message variable */
-            frontend.cryostat.cryostatTemp[currentCryostatModule].lastCommand.status = CON_ERROR_RNG;
+            CAN_LAST_CONTROL.status = CON_ERROR_RNG;
 
             /* Reset the last order to a legal value */
             frontend.cryostat.cryostatTemp[currentCryostatModule].nextCoeff = TVO_COEFF_0;
@@ -166,7 +167,7 @@ static void sequentialCoeffHandler(void) {
     /* If monitor on control RCA */
     if (currentClass==CONTROL_CLASS){
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.cryostat.cryostatTemp[currentCryostatModule].lastCommand)
+        RETURN_LAST_CONTROL_MESSAGE()
         return;
     }
 
@@ -199,14 +200,14 @@ void specificCoeffHandler(unsigned int sensor, unsigned int coeff) {
         storeError(ERR_CRYOSTAT_TEMP, ERC_COMMAND_VAL);
 
         /* Store the error in the last control message variable */
-        frontend.cryostat.cryostatTemp[currentCryostatModule].lastCommand.status = CON_ERROR_RNG;
+        CAN_LAST_CONTROL.status = CON_ERROR_RNG;
         return;
     }
 
     /* If control (size !=0) */
     if (CAN_SIZE) {
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.cryostat.cryostatTemp[sensor].lastCommand)
+        SAVE_LAST_CONTROL_MESSAGE()
 
         /* Extract the float from the can message. */
         changeEndian(CONV_CHR_ADD, CAN_DATA_ADD);
@@ -219,7 +220,7 @@ void specificCoeffHandler(unsigned int sensor, unsigned int coeff) {
     /* If monitor on control RCA */
     if (currentClass==CONTROL_CLASS){
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.cryostat.cryostatTemp[sensor].lastCommand)
+        RETURN_LAST_CONTROL_MESSAGE()
         return;
     }
 
@@ -96,8 +96,6 @@
         //! Last or next TVO coefficient order to monitor:
         unsigned char nextCoeff;
 
-        //! Last control message: value
-        LAST_CONTROL_MESSAGE lastCommand;
     } CRYOSTAT_TEMP;
 
     /* Globals */
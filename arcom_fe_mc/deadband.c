@@ -0,0 +1,164 @@
+/*! \file   deadband.c
+    \brief  Deadband change notification
+
+    See deadband.h for a description of the change notification.
+*/
+
+/* Includes */
+#include <math.h>       /* fabs */
+
+#include "deadband.h"
+#include "frontend.h"
+#include "pdSerialInterface.h"
+#include "globalDefinitions.h"
+
+/* Globals */
+float deadband[STATS_CHANNELS_NUMBER] = {DEADBAND_DEFAULT_CRYO_TEMP,  // Cryostat temperatures
+                                         DEADBAND_DEFAULT_CRYO_TEMP,
+                                         DEADBAND_DEFAULT_CRYO_TEMP,
+                                         DEADBAND_DEFAULT_CRYO_TEMP,
+                                         DEADBAND_DEFAULT_CRYO_TEMP,
+                                         DEADBAND_DEFAULT_CRYO_TEMP,
+                                         DEADBAND_DEFAULT_CRYO_TEMP,
+                                         DEADBAND_DEFAULT_CRYO_TEMP,
+                                         DEADBAND_DEFAULT_CRYO_TEMP,
+                                         DEADBAND_DEFAULT_CRYO_TEMP,
+                                         DEADBAND_DEFAULT_CRYO_TEMP,
+                                         DEADBAND_DEFAULT_CRYO_TEMP,
+                                         DEADBAND_DEFAULT_CRYO_TEMP,
+                                         DEADBAND_DEFAULT_VACUUM,     // Vacuum pressures
+                                         DEADBAND_DEFAULT_VACUUM,
+                                         DEADBAND_DEFAULT_EXT_TEMP,   // FETIM external temperatures
+                                         DEADBAND_DEFAULT_EXT_TEMP,
+                                         DEADBAND_DEFAULT_HE2_PRESS,  // FETIM He2 pressure
+                                         DEADBAND_DEFAULT_PD_CURRENT, // Power distribution rail currents
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT,
+                                         DEADBAND_DEFAULT_PD_CURRENT};
+
+/* Statics */
+static float lastReported[STATS_CHANNELS_NUMBER];   // Value when the channel was last returned
+static unsigned char lastReportedValid = FALSE;     // lastReported[] is initialized
+static unsigned char nextChannel = 0;               // Where the next search starts
+
+/* The cached value of a channel, as stored by the async functions */
+static float deadbandValue(unsigned char channel) {
+    if (channel < STATS_VACUUM)
+        return frontend.cryostat.cryostatTemp[channel - STATS_CRYO_TEMP].temp;
+    if (channel < STATS_FETIM_EXT_TEMP)
+        return frontend.cryostat.vacuumController.vacuumSensor[channel - STATS_VACUUM].pressure;
+    if (channel < STATS_HE2_PRESS)
+        return frontend.fetim.compressor.temp[channel - STATS_FETIM_EXT_TEMP].temp;
+    if (channel < STATS_PD_CURRENT)
+        return frontend.fetim.compressor.he2Press.pressure;
+    channel -= STATS_PD_CURRENT;
+    return adcScaleFloat(frontend.powerDistribution.pdModule[channel / PD_CHANNELS_NUMBER].
+                             pdChannel[channel % PD_CHANNELS_NUMBER].current,
+                         &pdCurrentScale[channel % PD_CHANNELS_NUMBER]);
+}
+
+/*! Find the next channel that moved beyond its deadband.
+    The search starts after the channel returned last, so a channel that
+    keeps changing doesn't hide the others.  The returned channel's value
+    becomes the reference for its next change.
+    Every channel is reported once at the first call.
+    \param *value   receives the current value of the channel
+    \return the channel or \ref DEADBAND_NO_CHANGE */
+unsigned char deadbandNextChange(float *value) {
+    unsigned char count, channel;
+    float current;
+
+    if (!lastReportedValid) {
+        for (channel = 0; channel < STATS_CHANNELS_NUMBER; channel++)
+            lastReported[channel] = FLOAT_UNINIT;
+        lastReportedValid = TRUE;
+    }
+
+    for (count = 0; count < STATS_CHANNELS_NUMBER; count++) {
+        channel = nextChannel;
+        if (++nextChannel == STATS_CHANNELS_NUMBER)
+            nextChannel = 0;
+
+        current = deadbandValue(channel);
+
+        // Entering or leaving an error state is always a change:
+        if (lastReported[channel] == FLOAT_UNINIT
+            || (current != lastReported[channel]
+                && (current == FLOAT_ERROR || lastReported[channel] == FLOAT_ERROR
+                    || fabs(current - lastReported[channel]) > deadband[channel])))
+        {
+            if (current == FLOAT_UNINIT)
+                continue;   // Not measured yet
+
+            lastReported[channel] = current;
+            *value = current;
+            return channel;
+        }
+    }
+
+    return DEADBAND_NO_CHANGE;
+}
+
+/*! Report every channel again.
+    The next calls to deadbandNextChange() return all the channels with a
+    valid value, starting from channel 0. */
+void deadbandReset(void) {
+    lastReportedValid = FALSE;
+    nextChannel = 0;
+}
@@ -0,0 +1,48 @@
+/*! \file   deadband.h
+    \brief  Deadband change notification
+
+    Each of the async monitored sensors of sensorStats.h has a deadband.  The
+    GET_NEXT_CHANGE special monitor RCA returns, one per request, the next
+    sensor whose cached value moved by more than its deadband since it was
+    last returned, or a "no more changes" sentinel.  A monitoring client can
+    then follow every change of the front end with one request per change
+    instead of polling all the sensors.
+
+    The sensors are numbered as the STATS_* channels.  Deadbands are
+    absolute, in the units of the sensor, and are set with SET_DEADBAND.
+    SET_DEADBAND_RESET makes every sensor be returned again, e.g. when a new
+    client connects. */
+
+#ifndef _DEADBAND_H
+    #define _DEADBAND_H
+
+    /* Extra includes */
+    /* STATS_CHANNELS_NUMBER */
+    #ifndef _SENSORSTATS_H
+        #include "sensorStats.h"
+    #endif /* _SENSORSTATS_H */
+
+    /* Defines */
+    #define DEADBAND_NO_CHANGE          0xFF    //!< Channel returned when nothing changed
+
+    /* Default deadbands */
+    #define DEADBAND_DEFAULT_CRYO_TEMP  0.1     //!< K
+    #define DEADBAND_DEFAULT_VACUUM     1.0E-7  //!< mbar
+    #define DEADBAND_DEFAULT_EXT_TEMP   0.5     //!< C
+    #define DEADBAND_DEFAULT_HE2_PRESS  0.01    //!< MPa
+    #define DEADBAND_DEFAULT_PD_CURRENT 0.01    //!< A
+
+    /* Globals */
+    /* Externs */
+    extern float deadband[STATS_CHANNELS_NUMBER]; //!< Deadband of each channel
+
+    /* Prototypes */
+    /* Statics */
+    static float deadbandValue(unsigned char channel);
+    /* Externs */
+    extern unsigned char deadbandNextChange(float *value);
+    //!< Find the next channel that moved beyond its deadband
+    extern void deadbandReset(void);
+    //!< Report every channel again
+
+#endif /* _DEADBAND_H */
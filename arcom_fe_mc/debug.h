@@ -42,12 +42,28 @@
         // #define DEBUG_OWB                   // Turn on one wire bus debugging
         // #define DEBUG_PPCOM                 // Turn on the parallel port communication debugging
         // #define DEBUG_MSG_LOOP              // Turn on debugging the main() message loop
+        // #define DEBUG_TCP_MC                // Turn on the TCP M&C service debugging
+        // #define PP_BENCHMARK                // Time the parallel port interrupt and PPWrite(), shown by the 'o' console command
+        // #define PP_BYTE_IO                  // Byte at a time parallel port I/O instead of the string I/O fast path, to compare
+        // #define DEBUG_FLIGHT_RECORDER       // Turn on the flight recorder debugging
+        // #define DEBUG_LO_LOCK               // Turn on the LO lock engine debugging
+        // #define DEBUG_SIS_SWEEP             // Turn on the SIS I-V sweep debugging
+        // #define DEBUG_LO_PA_SWEEP           // Turn on the LO PA sweep debugging
+        // #define DEBUG_SIS_MAGNET_RAMP       // Turn on the SIS magnet ramp and deflux debugging
+        // #define DEBUG_CAN_TRACE             // Turn on the CAN trace debugging
+        // #define DEBUG_AMBSI_EMULATOR        // Turn on the AMBSI link emulator debugging
+        // #define DEBUG_SETPOINT_QUEUE        // Turn on the setpoint coalescing debugging
+        // #define DEBUG_CONTROL_ELISION       // Turn on the control elision debugging
+        // #define DEBUG_LAST_CONTROL          // Turn on the last control message store debugging
+        // #define DEBUG_MEMORY_USAGE          // Turn on the memory usage instrumentation debugging
         // #define DEBUG_INIT                  // Turn on initialization debugging
         // #define DEBUG                       // Turn on all the rest and error reporting
         #define ERROR_REPORT                // Uncomment this line to enable the console error report
 
         // #define DEBUG_CRYOSTAT_ASYNC        // Turn on cryotat async debugging
         // #define DEBUG_FETIM_ASYNC           // Turn on the FETIM async debugging
+        // #define DEBUG_IFSWITCH_ASYNC        // Turn on the IF switch async debugging
+        // #define DEBUG_POWERDIS_ASYNC        // Turn on the power distribution async debugging
         // #define DEBUG_GO_STANDBY2           // Turn on debugging the STANDBY2 transition
     
     #else /* If we are NOT developing: for release build */
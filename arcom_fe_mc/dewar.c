@@ -13,6 +13,7 @@
 
 #include "debug.h"
 #include "frontend.h"
+#include "lastControl.h"
 #include "fetimSerialInterface.h"
 #include "error.h"
 
@@ -58,29 +59,18 @@ static void n2FillHandler(void){
     /* If control (size !=0) */
     if(CAN_SIZE){
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.
-                                   fetim.
-                                    dewar.
-                                     lastN2Fill)
+        SAVE_LAST_CONTROL_MESSAGE()
 
         /* Overwrite the last control message status with the default NO_ERROR
            status. */
-        frontend.
-         fetim.
-          dewar.
-           lastN2Fill.
-            status=NO_ERROR;
+        CAN_LAST_CONTROL.status=NO_ERROR;
 
         /* Change the status of the backing pump according to the content of the
            CAN message. */
         if(setN2FillEnable(CAN_BYTE?N2_FILL_ENABLE:
                                     N2_FILL_DISABLE)==ERROR){
             /* Store the ERROR state in the last control message variable */
-            frontend.
-             fetim.
-              dewar.
-               lastN2Fill.
-                status=ERROR;
+            CAN_LAST_CONTROL.status=ERROR;
 
             return;
         }
@@ -92,10 +82,7 @@ static void n2FillHandler(void){
     /* If monitor on a control RCA */
     if(currentClass==CONTROL_CLASS){
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.
-                                     fetim.
-                                      dewar.
-                                       lastN2Fill)
+        RETURN_LAST_CONTROL_MESSAGE()
         return;
     }
 
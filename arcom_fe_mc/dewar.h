@@ -37,9 +37,7 @@
                                 but just a register holding the last issued
                                 control:
                                     - 0 -> OFF
-                                    - 1 -> ON
-        \param      lastN2Fill  This contains a copy of the last issued control
-                                message for the n2Fill. */
+                                    - 1 -> ON */
     typedef struct {
         //! FETIM N2 Fill system
         /*! This is the state of the N2 fill system:
@@ -49,10 +47,6 @@
                         value is the one stored by the software after a control
                         command has ben issued. */
         unsigned char   n2Fill;
-        //! Last control message: FETIM N2 fill
-        /*! This is the content of the last control message sent to the N2 fill
-            state. */
-        LAST_CONTROL_MESSAGE    lastN2Fill;
     } DEWAR;
 
     /* Globals */
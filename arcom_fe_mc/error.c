@@ -8,10 +8,11 @@
     occour during the operation of the ARCOM Pegasus board.*/
 
 /* Includes */
-#include <stdlib.h>     /* malloc */
+#include <stdlib.h>     /* exit */
 #include <stdio.h>      /* printf */
 
 #include "error.h"
+#include "memoryUsage.h"
 #include "debug.h"
 #include "ppComm.h"
 #include "frontend.h"
@@ -26,15 +27,17 @@ unsigned char errorOldest=0; /*!< This variable stores the current index to the
 unsigned int * errorHistory; /*!< This is a pointer to the array that will
                                   contain the error history if the malloc
                                   succeeds. */
+unsigned long errorTotal=0;  /*!< This variable counts all the errors stored
+                                  since startup, even with the error routine
+                                  disabled. */
 
 /* Statics */
 static unsigned int errorNoErrorHistory=1;
 static unsigned char errorOn=0;
-static unsigned long errorTotal=0;
 
 #ifdef ERROR_REPORT
 
-    static char *moduleNames[0x41] = {
+    static char *moduleNames[0x4A] = {
         "Error",                                // 0x00
         "unassigned",
         "Parallel Port",
@@ -99,8 +102,16 @@ static unsigned long errorTotal=0;
         "FETIM Interlock Flow",
         "FETIM Interlock Glitch",
         "FETIM External Temperature",
-        "FETIM He2 Pressure"                    // 0x40
-        "Teledyne PA"
+        "FETIM He2 Pressure",                   // 0x40
+        "Teledyne PA",
+        "TCP M&C",
+        "Flight Recorder",
+        "LO Lock Engine",
+        "SIS I-V Sweep",
+        "LO PA Sweep",
+        "CAN Trace",
+        "Last Control",
+        "Memory Usage"
     };
 
 #endif // ERROR_REPORT
@@ -118,7 +129,8 @@ int errorInit(void) {
     #endif /* DEBUG_STARTUP */
 
     // If error initializing the error array, disable error reporting and notify
-    errorHistory=(unsigned int *)malloc(ERROR_HISTORY_LENGTH*sizeof(unsigned int));
+    errorHistory=(unsigned int *)memoryAlloc(MEMORY_ERROR_HISTORY,
+                                             ERROR_HISTORY_LENGTH*sizeof(unsigned int));
     if(errorHistory==NULL){
         errorOn = 0;
 
@@ -162,7 +174,10 @@ int errorStop(void){
     #endif /* DEBUG_STARTUP */ 
 
     // Free allocated memory
-    free(errorHistory);
+    if(errorHistory!=&errorNoErrorHistory){
+        memoryFree(MEMORY_ERROR_HISTORY,
+                   errorHistory);
+    }
 
     #ifdef DEBUG_STARTUP
         printf("done!\n");
@@ -342,6 +357,11 @@ void storeError(unsigned char moduleNo, unsigned char errorNo) {
                         "Error: The command vaue is out of range");
                 break;
 
+            case ERC_HARDWARE_CHANGED:  // Installed hardware differs from the stored list
+                sprintf(error,
+                        "Warning: The installed hardware differs from the stored list");
+                break;
+
             case ERC_FPGA_NOT_READY:
                 sprintf(error,
                         "Critical Error: Serial Mux - FPGA not ready");
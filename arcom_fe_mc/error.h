@@ -100,6 +100,14 @@
     #define ERR_FETIM_EXT_TEMP      0x3F //!< Error in the FETIM external temperature module
     #define ERR_COMP_HE2_PRESS      0x40 //!< Error in the FETIM compressor He2 pressure module
     #define ERR_TELEDYNE_PA         0x41 //!< Error in the Teledyne PA configuration module
+    #define ERR_TCP_MC              0x42 //!< Error in the TCP M&C service module
+    #define ERR_FLIGHT_RECORDER     0x43 //!< Error in the flight recorder module
+    #define ERR_LO_LOCK             0x44 //!< Error in the LO lock engine module
+    #define ERR_SIS_SWEEP           0x45 //!< Error in the SIS I-V sweep module
+    #define ERR_LO_PA_SWEEP         0x46 //!< Error in the LO PA sweep module
+    #define ERR_CAN_TRACE           0x47 //!< Error in the CAN trace module
+    #define ERR_LAST_CONTROL        0x48 //!< Error in the last control message store module
+    #define ERR_MEMORY_USAGE        0x49 //!< Error in the memory usage instrumentation module
     /* Error codes - shared by all modules */
     #define ERC_NO_MEMORY           0x01 //!< Not enough memory
     #define ERC_02                  0x02 //!<
@@ -122,12 +130,14 @@
     #define ERC_RCA_CLASS           0x13 //!< RCA class out of range
     #define ERC_RCA_RANGE           0x14 //!< RCA out of range
     #define ERC_COMMAND_VAL         0x15 //!< Command value out of range
+    #define ERC_HARDWARE_CHANGED    0x16 //!< Installed hardware differs from the stored list
 
     /* Globals */
     /* Externs */
     extern unsigned char errorNewest;    //!< A global to keep track of the newest error index
     extern unsigned char errorOldest;    //!< A global to keep track of the oldest error index
     extern unsigned int * errorHistory;  //!< A global pointer to the error history
+    extern unsigned long errorTotal;     //!< A global to count all the errors stored since startup
 
     /* Prototypes */
     /* Statics */
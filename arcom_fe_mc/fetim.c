@@ -16,6 +16,7 @@
 #include "fetimSerialInterface.h"
 #include "async.h"
 #include "globalOperations.h"
+#include "sensorStats.h"
 
 
 
@@ -172,6 +173,8 @@ int fetimAsync(void){
                     break;
                 case ASYNC_DONE:
                     asyncFetimExtTempError[currentAsyncFetimExtTempModule]=NO_ERROR;
+                    sensorStatsUpdate(STATS_FETIM_EXT_TEMP+currentAsyncFetimExtTempModule,
+                                      frontend.fetim.compressor.temp[currentAsyncFetimExtTempModule].temp);
                     break;
                 case ERROR:
                     break;
@@ -203,6 +206,8 @@ int fetimAsync(void){
                     break;
                 case ASYNC_DONE:
                     asyncFetimHePressError=NO_ERROR;
+                    sensorStatsUpdate(STATS_HE2_PRESS,
+                                      frontend.fetim.compressor.he2Press.pressure);
                     break;
                 case ERROR:
                     break;
@@ -20,6 +20,7 @@
 #include <stdio.h>      /* printf */
 
 #include "serialInterface.h"
+#include "serialProfile.h"
 #include "error.h"
 #include "debug.h"
 #include "frontend.h"
@@ -609,9 +610,21 @@ int getFetimDigital(unsigned char port){
 }
 
 
-/* Read the parallel ADC */
+/* Read the parallel ADC, profiled. See serialProfile.h. */
 int getFetimParallelMonitor(void){
 
+    int ret;
+
+    serialProfileBegin(SERIAL_PROFILE_FETIM_PARALLEL);
+    ret=getFetimParallelMonitorCycle();
+    serialProfileEnd(SERIAL_PROFILE_FETIM_PARALLEL, ret);
+
+    return ret;
+}
+
+/* Read the parallel ADC */
+static int getFetimParallelMonitorCycle(void){
+
     /* A variable to hold the incoming parallel ADC data */
     int tempParAdcValue = 0x0000;
 
@@ -660,9 +673,21 @@ int getFetimParallelMonitor(void){
 
 
 
-/* Read the serial ADC */
+/* Run one step of the serial ADC readout, profiled. See serialProfile.h. */
 int getFetimSerialMonitor(void){
 
+    int ret;
+
+    serialProfileBegin(SERIAL_PROFILE_FETIM_SERIAL);
+    ret=getFetimSerialMonitorCycle();
+    serialProfileEnd(SERIAL_PROFILE_FETIM_SERIAL, ret);
+
+    return ret;
+}
+
+/* Read the serial ADC */
+static int getFetimSerialMonitorCycle(void){
+
     /* A static enum to track the state of the asynchronous readout */
     static enum {
         ASYNC_FETIM_SERIAL_BREG,
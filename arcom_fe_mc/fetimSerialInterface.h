@@ -519,6 +519,8 @@
     /* Statics */
     static int getFetimParallelMonitor(void); // Perform core analog monitor functions for the parallel ADC
     static int getFetimSerialMonitor(void); // Perform core analog monitor functions for the serial ADC
+    static int getFetimParallelMonitorCycle(void); // Parallel ADC read, without the profiling
+    static int getFetimSerialMonitorCycle(void); // Serial ADC read step, without the profiling
     /* Externs */
     extern int getInterlockTemp(void); //!< This function monitors the interlock internal temperature sensors.
     extern int getInterlockFlow(void); //!< This function monitors the interlock airflow sensors.
@@ -0,0 +1,236 @@
+/*! \file   flightRecorder.c
+    \brief  High rate monitor capture
+
+    See flightRecorder.h for a description of the recorder.
+*/
+
+/* Includes */
+#include <stdio.h>      /* printf */
+#include <string.h>     /* memcpy, memcmp, memset */
+#include <time.h>       /* clock */
+
+#include "flightRecorder.h"
+#include "can.h"
+#include "timer.h"
+#include "error.h"
+#include "memoryUsage.h"
+#include "debug.h"
+#include "globalDefinitions.h"
+
+/* Globals */
+FLIGHT_RECORDER flightRecorder = {{0L, 0L, 0L, 0L},
+                                  0,
+                                  FLIGHT_RECORDER_TRIGGER_NONE,
+                                  0,
+                                  0.0,
+                                  0,
+                                  FLIGHT_RECORDER_IDLE,
+                                  0,
+                                  0,
+                                  FLIGHT_RECORDER_NO_TRIGGER,
+                                  0};
+
+/* Statics */
+static FLIGHT_RECORDER_SAMPLE *buffer = NULL;                   // Allocated at the first capture
+static unsigned long armedRca[FLIGHT_RECORDER_CHANNELS];        // Enabled channels of the current capture
+static unsigned char armedTriggerChannel;                       // Trigger channel in armedRca[]
+static unsigned int nextSample;                                 // Ring index of the next sample to write
+static unsigned long samplesWritten;                            // Samples written since armed
+static unsigned long triggerSample;                             // Value of samplesWritten for the trigger sample
+static unsigned int postTriggerLeft;                            // Samples left to record after the trigger
+static unsigned char lastTriggerValue[FLIGHT_RECORDER_VALUE_SIZE]; // Previous value for the CHANGE trigger
+static clock_t armTime;
+
+/*! Start a new capture with the current setup.
+    The previous capture is discarded.
+    \return
+        - \ref NO_ERROR -> if no error occurred
+        - \ref ERROR    -> if something wrong happened */
+int flightRecorderArm(void) {
+    unsigned char channel;
+
+    if (!buffer) {
+        buffer = (FLIGHT_RECORDER_SAMPLE *) memoryAlloc(MEMORY_FLIGHT_RECORDER, FLIGHT_RECORDER_SAMPLES * sizeof(FLIGHT_RECORDER_SAMPLE));
+        if (!buffer) {
+            storeError(ERR_FLIGHT_RECORDER, ERC_NO_MEMORY); // Out of memory for the capture buffer
+            return ERROR;
+        }
+    }
+
+    // Pack the enabled channels together:
+    flightRecorder.channels = 0;
+    armedTriggerChannel = FLIGHT_RECORDER_CHANNELS;
+    for (channel = 0; channel < FLIGHT_RECORDER_CHANNELS; channel++) {
+        if (flightRecorder.rca[channel]) {
+            if (channel == flightRecorder.triggerChannel)
+                armedTriggerChannel = flightRecorder.channels;
+            armedRca[flightRecorder.channels++] = flightRecorder.rca[channel];
+        }
+    }
+
+    if (flightRecorder.channels == 0
+        || (flightRecorder.triggerMode != FLIGHT_RECORDER_TRIGGER_NONE
+            && armedTriggerChannel == FLIGHT_RECORDER_CHANNELS))
+    {
+        storeError(ERR_FLIGHT_RECORDER, ERC_COMMAND_VAL); // No channel to record or trigger channel disabled
+        return ERROR;
+    }
+
+    flightRecorder.samples = 0;
+    flightRecorder.triggerPosition = FLIGHT_RECORDER_NO_TRIGGER;
+    flightRecorder.readIndex = 0;
+    nextSample = 0;
+    samplesWritten = 0;
+    armTime = clock();
+
+    stopAsyncTimer(TIMER_FLIGHT_RECORDER);
+    flightRecorder.state = FLIGHT_RECORDER_RECORDING;
+
+    #ifdef DEBUG_FLIGHT_RECORDER
+        printf("Flight recorder: armed, %d channels, period %u ms\n", flightRecorder.channels, flightRecorder.period);
+    #endif /* DEBUG_FLIGHT_RECORDER */
+
+    return NO_ERROR;
+}
+
+/*! Stop the capture in progress.
+    The samples recorded so far are kept for readout. */
+void flightRecorderStop(void) {
+    if (flightRecorder.state != FLIGHT_RECORDER_RECORDING && flightRecorder.state != FLIGHT_RECORDER_TRIGGERED)
+        return;
+
+    stopAsyncTimer(TIMER_FLIGHT_RECORDER);
+    flightRecorder.state = (flightRecorder.samples) ? FLIGHT_RECORDER_FROZEN : FLIGHT_RECORDER_IDLE;
+}
+
+/*! Record a sample if one is due.
+    This is called at every pass of the async loop, in the async handler
+    context, so the monitor requests don't disturb a CAN message. */
+void flightRecorderAsync(void) {
+    if (flightRecorder.state != FLIGHT_RECORDER_RECORDING && flightRecorder.state != FLIGHT_RECORDER_TRIGGERED)
+        return;
+
+    if (flightRecorder.period) {
+        if (queryAsyncTimer(TIMER_FLIGHT_RECORDER) == TIMER_RUNNING)
+            return;
+        startAsyncTimer(TIMER_FLIGHT_RECORDER, flightRecorder.period, TRUE);
+    }
+
+    flightRecorderSample();
+}
+
+/*! Read out the next recorded value.
+    Values are returned from the oldest sample to the newest and, within a
+    sample, in channel order.  Only a stopped capture can be read.
+    \param *value   receives the \ref FLIGHT_RECORDER_VALUE_SIZE payload bytes
+    \param *status  receives the status of the monitor request
+    \param *time    receives the time of the sample in ms since armed
+    \return
+        - \ref NO_ERROR -> if a value was returned
+        - \ref ERROR    -> if there is nothing left to read */
+int flightRecorderRead(unsigned char *value, unsigned char *status, unsigned long *time) {
+    unsigned int oldest, sample;
+    unsigned char channel;
+
+    if (flightRecorder.state != FLIGHT_RECORDER_FROZEN)
+        return ERROR;
+
+    if (flightRecorder.readIndex >= flightRecorder.samples * flightRecorder.channels)
+        return ERROR;
+
+    oldest = (flightRecorder.samples < FLIGHT_RECORDER_SAMPLES) ? 0 : nextSample;
+    sample = (oldest + flightRecorder.readIndex / flightRecorder.channels) % FLIGHT_RECORDER_SAMPLES;
+    channel = flightRecorder.readIndex % flightRecorder.channels;
+
+    memcpy(value, buffer[sample].value[channel], FLIGHT_RECORDER_VALUE_SIZE);
+    *status = buffer[sample].status[channel];
+    *time = buffer[sample].time;
+
+    flightRecorder.readIndex++;
+    return NO_ERROR;
+}
+
+/* Read all the channels into the next ring buffer slot and handle the trigger */
+static void flightRecorderSample(void) {
+    FLIGHT_RECORDER_SAMPLE *sample = &buffer[nextSample];
+    unsigned char channel;
+
+    sample -> time = clock() - armTime;
+
+    for (channel = 0; channel < flightRecorder.channels; channel++) {
+        CAN_ADDRESS = armedRca[channel];
+        CAN_SIZE = CAN_MONITOR;
+        CAN_STATUS = NO_ERROR;
+        CANRequestHandler();
+
+        memset(sample -> value[channel], 0, FLIGHT_RECORDER_VALUE_SIZE);
+        memcpy(sample -> value[channel],
+               CAN_DATA_ADD,
+               (CAN_SIZE < FLIGHT_RECORDER_VALUE_SIZE) ? CAN_SIZE : FLIGHT_RECORDER_VALUE_SIZE);
+        sample -> status[channel] = CAN_STATUS;
+    }
+
+    if (++nextSample == FLIGHT_RECORDER_SAMPLES)
+        nextSample = 0;
+    if (flightRecorder.samples < FLIGHT_RECORDER_SAMPLES)
+        flightRecorder.samples++;
+    samplesWritten++;
+
+    if (flightRecorder.state == FLIGHT_RECORDER_RECORDING) {
+        if (!flightRecorderTriggered(sample))
+            return;
+
+        #ifdef DEBUG_FLIGHT_RECORDER
+            printf("Flight recorder: triggered at %lu ms\n", sample -> time);
+        #endif /* DEBUG_FLIGHT_RECORDER */
+
+        triggerSample = samplesWritten - 1;
+        postTriggerLeft = flightRecorder.postTrigger;
+        flightRecorder.state = FLIGHT_RECORDER_TRIGGERED;
+    } else if (postTriggerLeft) {
+        postTriggerLeft--;
+    }
+
+    if (postTriggerLeft)
+        return;
+
+    // Post-trigger samples done.  Freeze the buffer:
+    flightRecorder.triggerPosition = (unsigned int) (triggerSample - (samplesWritten - flightRecorder.samples));
+    flightRecorder.state = FLIGHT_RECORDER_FROZEN;
+    stopAsyncTimer(TIMER_FLIGHT_RECORDER);
+}
+
+/* Check the trigger channel of a new sample against the trigger condition */
+static int flightRecorderTriggered(const FLIGHT_RECORDER_SAMPLE *sample) {
+    const unsigned char *value;
+    int fired = FALSE;
+
+    if (flightRecorder.triggerMode == FLIGHT_RECORDER_TRIGGER_NONE)
+        return FALSE;
+
+    value = sample -> value[armedTriggerChannel];
+
+    switch (flightRecorder.triggerMode) {
+        case FLIGHT_RECORDER_TRIGGER_ABOVE:
+        case FLIGHT_RECORDER_TRIGGER_BELOW:
+            // Monitor floats are big endian on the CAN bus:
+            changeEndian(CONV_CHR_ADD, (unsigned char *) value);
+            if (flightRecorder.triggerMode == FLIGHT_RECORDER_TRIGGER_ABOVE)
+                fired = (CONV_FLOAT > flightRecorder.triggerLevel);
+            else
+                fired = (CONV_FLOAT < flightRecorder.triggerLevel);
+            break;
+
+        case FLIGHT_RECORDER_TRIGGER_CHANGE:
+            // The first sample sets the reference value:
+            fired = (samplesWritten > 1
+                     && memcmp(value, lastTriggerValue, FLIGHT_RECORDER_VALUE_SIZE) != 0);
+            memcpy(lastTriggerValue, value, FLIGHT_RECORDER_VALUE_SIZE);
+            break;
+
+        default:
+            break;
+    }
+
+    return fired;
+}
@@ -0,0 +1,85 @@
+/*! \file   flightRecorder.h
+    \brief  High rate monitor capture
+
+    The flight recorder samples up to \ref FLIGHT_RECORDER_CHANNELS monitor
+    RCAs into a RAM ring buffer, from the async loop, as fast as the serial
+    interfaces allow or at a fixed period.  Each point is read through
+    CANRequestHandler(), so any standard monitor RCA can be recorded.
+
+    An optional trigger on one of the channels stops the recording after a
+    programmable number of post-trigger samples, keeping the history that led
+    to the event in the buffer.  The capture is then read out one value at a
+    time through the GET_RECORDER_SAMPLE special monitor RCA.
+
+    Control, through the SET_RECORDER_* special control RCAs:
+        - channel n:    the 4 bytes monitor RCA to sample, 0 to disable it
+        - period:       2 bytes in ms, 0 to sample at every async pass
+        - trigger:      mode, channel, float level (4 bytes), post-trigger samples (2 bytes)
+        - arm:          1 to start a new capture, 0 to stop it
+        - rewind:       restart the readout from the oldest sample */
+
+#ifndef _FLIGHTRECORDER_H
+    #define _FLIGHTRECORDER_H
+
+    /* Defines */
+    #define FLIGHT_RECORDER_CHANNELS        4       //!< Monitor points recorded together
+    #define FLIGHT_RECORDER_SAMPLES         1024    //!< Size of the ring buffer
+    #define FLIGHT_RECORDER_VALUE_SIZE      4       //!< Payload bytes kept for each point
+
+    /* Recorder state */
+    #define FLIGHT_RECORDER_IDLE            0       //!< Nothing recorded
+    #define FLIGHT_RECORDER_RECORDING       1       //!< Recording, waiting for the trigger
+    #define FLIGHT_RECORDER_TRIGGERED       2       //!< Recording the post-trigger samples
+    #define FLIGHT_RECORDER_FROZEN          3       //!< Capture complete, ready for readout
+
+    /* Trigger modes */
+    #define FLIGHT_RECORDER_TRIGGER_NONE    0       //!< Record until stopped
+    #define FLIGHT_RECORDER_TRIGGER_ABOVE   1       //!< Float value rises above the level
+    #define FLIGHT_RECORDER_TRIGGER_BELOW   2       //!< Float value falls below the level
+    #define FLIGHT_RECORDER_TRIGGER_CHANGE  3       //!< Value changes, e.g. an unlock detect latch
+    #define FLIGHT_RECORDER_TRIGGER_MODES   4
+
+    #define FLIGHT_RECORDER_NO_TRIGGER      0xFFFF  //!< Trigger position before the trigger fired
+
+    /* Typedefs */
+    //! One sample of all the recorded channels
+    typedef struct {
+        unsigned long   time;                                                   //!< ms since the recorder was armed
+        unsigned char   value[FLIGHT_RECORDER_CHANNELS][FLIGHT_RECORDER_VALUE_SIZE]; //!< Payload as returned on the CAN bus
+        unsigned char   status[FLIGHT_RECORDER_CHANNELS];                      //!< Status of the monitor request
+    } FLIGHT_RECORDER_SAMPLE;
+
+    //! Flight recorder setup and state
+    typedef struct {
+        unsigned long   rca[FLIGHT_RECORDER_CHANNELS];  //!< Configured monitor RCAs, 0 if unused
+        unsigned int    period;                         //!< Sample period in ms, 0 for every async pass
+        unsigned char   triggerMode;                    //!< One of the FLIGHT_RECORDER_TRIGGER_* defines
+        unsigned char   triggerChannel;                 //!< Configured channel the trigger looks at
+        float           triggerLevel;                   //!< Level for the ABOVE and BELOW modes
+        unsigned int    postTrigger;                    //!< Samples to record after the trigger
+        unsigned char   state;                          //!< One of the FLIGHT_RECORDER_* states
+        unsigned char   channels;                       //!< Channels in the current capture
+        unsigned int    samples;                        //!< Samples in the buffer
+        unsigned int    triggerPosition;                //!< Readout position of the trigger sample
+        unsigned int    readIndex;                      //!< Next value to read out
+    } FLIGHT_RECORDER;
+
+    /* Globals */
+    /* Externs */
+    extern FLIGHT_RECORDER flightRecorder; //!< Flight recorder setup and state
+
+    /* Prototypes */
+    /* Statics */
+    static void flightRecorderSample(void);
+    static int flightRecorderTriggered(const FLIGHT_RECORDER_SAMPLE *sample);
+    /* Externs */
+    extern int flightRecorderArm(void);
+    //!< Start a new capture
+    extern void flightRecorderStop(void);
+    //!< Stop the capture in progress
+    extern void flightRecorderAsync(void);
+    //!< Record a sample if one is due
+    extern int flightRecorderRead(unsigned char *value, unsigned char *status, unsigned long *time);
+    //!< Read out the next recorded value
+
+#endif /* _FLIGHTRECORDER_H */
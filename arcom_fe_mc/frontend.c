@@ -14,6 +14,9 @@
 #include "frontend.h"
 #include "error.h"
 #include "iniWrapper.h"
+#include "nvJournal.h"
+#include "configImage.h"
+#include "startupProfile.h"
 #include "debug.h"
 
 #include "sockets/include/compiler.h"
@@ -57,6 +60,7 @@ int frontendStop(void){
         - \ref NO_ERROR -> if no error occurred
         - \ref ERROR    -> if something wrong happened */
 int frontendInit(void){
+    unsigned char phase;
 
     #ifdef CHECK_HW_AVAIL
         CFG_STRUCT dataIn;
@@ -135,6 +139,12 @@ int frontendInit(void){
 
     #endif // CHECK_HW_AVAIL
 
+    /* Load the INI values from the binary configuration image if it is
+       current.  If not, the startup functions parse the INI files. */
+    phase = startupProfileBegin(STARTUP_PHASE_CONFIG_IMAGE_LOAD, STARTUP_PROFILE_NO_BAND);
+    configImageLoad();
+    startupProfileEnd(phase);
+
     /* Perform CCA and LO startup */
     for(currentModule = 0;
         currentModule < CARTRIDGES_NUMBER;
@@ -143,41 +153,70 @@ int frontendInit(void){
         if(frontend.cartridge[currentModule].available) {
 
             /* Perform cartridge startup configuration */
+            phase = startupProfileBegin(STARTUP_PHASE_CARTRIDGE_STARTUP, currentModule);
             if(cartridgeStartup()==ERROR){
+                startupProfileEnd(phase);
                 return ERROR;
             }
+            startupProfileEnd(phase);
 
             /* Perform LO startup configuration */
+            phase = startupProfileBegin(STARTUP_PHASE_LO_STARTUP, currentModule);
             if(loStartup()==ERROR){
+                startupProfileEnd(phase);
                 return ERROR;
             }
+            startupProfileEnd(phase);
         }
     }
 
     /* Initialize the LPR */
+    phase = startupProfileBegin(STARTUP_PHASE_LPR_STARTUP, STARTUP_PROFILE_NO_BAND);
     if(lprStartup()==ERROR){
+        startupProfileEnd(phase);
         return ERROR;
     }
+    startupProfileEnd(phase);
 
     /* Initialize the cryostat system */
+    phase = startupProfileBegin(STARTUP_PHASE_CRYOSTAT_STARTUP, STARTUP_PROFILE_NO_BAND);
     if(cryostatStartup()==ERROR){
+        startupProfileEnd(phase);
         return ERROR;
     }
+    startupProfileEnd(phase);
 
     /* Initialize the power distribution system */
+    phase = startupProfileBegin(STARTUP_PHASE_POWER_DIS_STARTUP, STARTUP_PROFILE_NO_BAND);
     if(powerDistributionStartup()==ERROR){
+        startupProfileEnd(phase);
         return ERROR;
     }
+    startupProfileEnd(phase);
 
     /* Initialize the IF switch system */
+    phase = startupProfileBegin(STARTUP_PHASE_IF_SWITCH_STARTUP, STARTUP_PROFILE_NO_BAND);
     if(ifSwitchStartup()==ERROR){
+        startupProfileEnd(phase);
         return ERROR;
     }
+    startupProfileEnd(phase);
 
     /* Initialize the FETIM system */
+    phase = startupProfileBegin(STARTUP_PHASE_FETIM_STARTUP, STARTUP_PROFILE_NO_BAND);
     if(fetimStartup()==ERROR){
+        startupProfileEnd(phase);
         return ERROR;
     }
+    startupProfileEnd(phase);
+
+    /* Compile the INI values into the configuration image for the next boot.
+       Failing to do so is not fatal: the INI files will be parsed again. */
+    if(!configImageLoaded){
+        phase = startupProfileBegin(STARTUP_PHASE_CONFIG_IMAGE_WRITE, STARTUP_PROFILE_NO_BAND);
+        configImageWrite();
+        startupProfileEnd(phase);
+    }
 
     #ifdef DEBUG_INIT
         printf("done!\n\n");
@@ -201,21 +240,17 @@ int frontendInitIPAddress(void) {
 }
 
 int frontendWriteNVMemory(void) {
-    char buf[20];
     #ifdef DEBUG_CRYOSTAT_ASYNC
         printf("frontend -> frontendWriteNVMemory\n");
     #endif /* DEBUG_CRYOSTAT_ASYNC */
 
     if (frontend.cryostat.coldHeadHoursDirty != 0) {
-        sprintf(buf, "%lu", frontend.cryostat.coldHeadHours);
-        // Write the current number of hours back to the cryostat hours log file:
-        UpdateCfg(frontend.cryostat.coldHeadHoursFile,
-             CRYO_HOURS_FILE_SECTION,
-             CRYO_HOURS_KEY,
-             buf);
+        // Append the current number of hours to the NV journal:
+        if (nvJournalWrite(NV_KEY_COLD_HEAD_HOURS, frontend.cryostat.coldHeadHours) == ERROR)
+            return ERROR;
         frontend.cryostat.coldHeadHoursDirty = 0;
         #ifdef DEBUG_CRYOSTAT_ASYNC
-            printf("frontend -> frontendWriteNVMemory wrote %s hours\n", buf);
+            printf("frontend -> frontendWriteNVMemory wrote %lu hours\n", frontend.cryostat.coldHeadHours);
         #endif /* DEBUG_CRYOSTAT_ASYNC */
     }
     return NO_ERROR;
@@ -273,6 +308,7 @@ int feAndCartridgesConfigurationReport(void) {
                 frontend.cartridge[band].cartridgeTemp[5].offset);
         }
     }
+    startupProfileReport();
     printf("\n");
     return NO_ERROR;
 }
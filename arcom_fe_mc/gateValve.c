@@ -13,6 +13,7 @@
 
 #include "debug.h"
 #include "frontend.h"
+#include "lastControl.h"
 #include "globalDefinitions.h"
 #include "error.h"
 #include "cryostatSerialInterface.h"
@@ -53,10 +54,7 @@ static void stateHandler(void){
     /* If control (size !=0) */
     if(CAN_SIZE){
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.
-                                   cryostat.
-                                    gateValve.
-                                     lastState)
+        SAVE_LAST_CONTROL_MESSAGE()
 
         /* Check if the backing pump is enabled. If it's not then the electronics to
            control the gate valve is off. In that case, return the HARDW_BLKD_ERR
@@ -67,11 +65,7 @@ static void stateHandler(void){
               enable==BACKING_PUMP_DISABLE)
         {
             storeError(ERR_GATE_VALVE, ERC_MODULE_POWER); //Backing Pump off -> Gate valve disabled
-            frontend.
-             cryostat.
-              gateValve.
-               lastState.
-                status=HARDW_BLKD_ERR; // Store the status in the last control message
+            CAN_LAST_CONTROL.status=HARDW_BLKD_ERR; // Store the status in the last control message
             return;
         }
 
@@ -79,11 +73,7 @@ static void stateHandler(void){
         if(getGateValveState()==ERROR){
             /* If error while monitoring, store the status in the last control
                message */
-            frontend.
-             cryostat.
-              gateValve.
-               lastState.
-                status=ERROR; // Store the status in the last control message
+            CAN_LAST_CONTROL.status=ERROR; // Store the status in the last control message
 
             return;
         }
@@ -96,11 +86,7 @@ static void stateHandler(void){
 
             storeError(ERR_GATE_VALVE, ERC_HARDWARE_WAIT); //Valve still moving -> Wait unil stopped
 
-            frontend.
-             cryostat.
-              gateValve.
-               lastState.
-                status=HARDW_BLKD_ERR; // Store the status in the last control message
+            CAN_LAST_CONTROL.status=HARDW_BLKD_ERR; // Store the status in the last control message
 
             return;
         }
@@ -110,11 +96,7 @@ static void stateHandler(void){
         if(setGateValveState(CAN_BYTE?GATE_VALVE_OPEN:
                                       GATE_VALVE_CLOSE)==ERROR){
             /* Store the ERROR state in the last control message variable */
-            frontend.
-             cryostat.
-              gateValve.
-               lastState.
-                status=ERROR;
+            CAN_LAST_CONTROL.status=ERROR;
 
             return;
         }
@@ -126,10 +108,7 @@ static void stateHandler(void){
     /* If monitor on a control RCA */
     if(currentClass==CONTROL_CLASS){
         // Return the last control message and status:
-        RETURN_LAST_CONTROL_MESSAGE(frontend.
-                                     cryostat.
-                                      gateValve.
-                                       lastState)
+        RETURN_LAST_CONTROL_MESSAGE()
         return;
     }
 
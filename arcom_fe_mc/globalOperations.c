@@ -17,6 +17,10 @@
 #include "debug.h"
 #include "ppComm.h"
 #include "serialMux.h"
+#include "nvJournal.h"
+#include "startupProfile.h"
+#include "tcpMC.h"
+#include "lastControl.h"
 
 /* Initialization */
 /*! This function takes care of initializing all the subsystem of the system.
@@ -24,29 +28,69 @@
         - \ref NO_ERROR -> if no error occurred
         - \ref ERROR    -> if something wrong happened */
 int initialization(void) {
+    unsigned char profile, phase;
+
+    profile = startupProfileBegin(STARTUP_PHASE_INITIALIZATION, STARTUP_PROFILE_NO_BAND);
+
     #ifdef DEBUG_STARTUP
         printf("Initializing...\n\n");
     #endif
 
+    /* Program the PC timer chip for the fine timer */
+    fineTimerInit();
+
     /* Initialize the error library */
+    phase = startupProfileBegin(STARTUP_PHASE_ERROR_INIT, STARTUP_PROFILE_NO_BAND);
     if (errorInit() == ERROR) {
+        startupProfileEnd(phase);
+        startupProfileEnd(profile);
         return ERROR;
     }
+    startupProfileEnd(phase);
+
+    /* Allocate the last control messages while the heap is still whole. If
+       it fails, the error is stored and the controls are still executed. */
+    lastControlInit();
+
+    /* Recover the counters stored in the NV journal on the flash disk */
+    phase = startupProfileBegin(STARTUP_PHASE_NV_JOURNAL_INIT, STARTUP_PROFILE_NO_BAND);
+    if (nvJournalInit() == ERROR) {
+        startupProfileEnd(phase);
+        startupProfileEnd(profile);
+        return ERROR;
+    }
+    startupProfileEnd(phase);
 
     /* Initialize the Serial Mux board */
+    phase = startupProfileBegin(STARTUP_PHASE_SERIAL_MUX_INIT, STARTUP_PROFILE_NO_BAND);
     if (serialMuxInit() == ERROR) {
+        startupProfileEnd(phase);
+        startupProfileEnd(profile);
         return ERROR;
     }
+    startupProfileEnd(phase);
 
     /* One wire bus initialization */
     #ifdef OWB
+        phase = startupProfileBegin(STARTUP_PHASE_OWB_INIT, STARTUP_PROFILE_NO_BAND);
         if (owbInit() == ERROR) {
+            startupProfileEnd(phase);
+            startupProfileEnd(profile);
             return ERROR;
         }
-
-        if (owbGetEsn() == ERROR) {
+        startupProfileEnd(phase);
+
+        /* Use the ESNs found by the last search right away and verify them
+           in the background.  Without a stored list, search the bus now. */
+        phase = startupProfileBegin(STARTUP_PHASE_OWB_GET_ESN, STARTUP_PROFILE_NO_BAND);
+        if (owbLoadEsns() == NO_ERROR) {
+            owbRequestSearch();
+        } else if (owbGetEsn() == ERROR) {
+            startupProfileEnd(phase);
+            startupProfileEnd(profile);
             return ERROR;
         }
+        startupProfileEnd(phase);
     #endif /* OWB */
 
     /* Switch to maintenance while initializing frontend and before enabling interrupt. */
@@ -56,19 +100,32 @@ int initialization(void) {
        communication is fully established with the AMBSI. */
 
     /* Initialize the frontend */
+    phase = startupProfileBegin(STARTUP_PHASE_FRONTEND_INIT, STARTUP_PROFILE_NO_BAND);
     if (frontendInit() == ERROR) {
+        startupProfileEnd(phase);
+        startupProfileEnd(profile);
         return ERROR;
     }
+    startupProfileEnd(phase);
 
     /* Initialize the parallel port communication.
        Up to this point, interrupts have been practically disabled. */
+    phase = startupProfileBegin(STARTUP_PHASE_PP_OPEN, STARTUP_PROFILE_NO_BAND);
     if (PPOpen() == ERROR) {
+        startupProfileEnd(phase);
+        startupProfileEnd(profile);
         return ERROR;
     }
+    startupProfileEnd(phase);
+
+    /* Start the TCP M&C service. Without it only the CAN bus is served. */
+    tcpMCStart();
 
     /* Switch to operational mode */
     frontend.mode = OPERATIONAL_MODE;
 
+    startupProfileEnd(profile);
+
     #ifdef DEBUG_STARTUP
         printf("End initialization!\n\n");
     #endif
@@ -91,6 +148,9 @@ int shutDown(void) {
     /* Shut down the parallel port communication */
     PPClose();
 
+    /* Shut down the TCP M&C service */
+    tcpMCStop();
+
     /* Shut down the frontend */
     frontendStop();
 
@@ -0,0 +1,98 @@
+/*! \file   handlerContext.c
+    \brief  Saved addressing state of the handler tree
+
+    See handlerContext.h for a description of the context.
+*/
+
+/* Includes */
+#include <string.h>     /* memcpy */
+
+#include "handlerContext.h"
+#include "frontend.h"
+#include "globalDefinitions.h"
+
+/*! Copy the addressing globals into a context.
+    \param *context the context to fill */
+void handlerContextSave(HANDLER_CONTEXT *context) {
+    context -> message = CANMessage;
+    context -> convert = convert;
+    context -> module = currentModule;
+    context -> rcaClass = currentClass;
+    context -> cartridgeSubsystem = currentCartridgeSubsystem;
+    context -> biasModule = currentBiasModule;
+    context -> polarizationModule = currentPolarizationModule;
+    context -> sidebandModule = currentSidebandModule;
+    context -> sisModule = currentSisModule;
+    context -> sisMagnetModule = currentSisMagnetModule;
+    context -> lnaModule = currentLnaModule;
+    context -> lnaStageModule = currentLnaStageModule;
+    context -> loAndTempModule = currentLoAndTempModule;
+    context -> loModule = currentLoModule;
+    context -> paModule = currentPaModule;
+    context -> paChannelModule = currentPaChannelModule;
+    context -> cartridgeTempSubsystem = currentCartridgeTempSubsystemModule;
+    context -> ifSwitchModule = currentIfSwitchModule;
+    context -> powerDistributionModule = currentPowerDistributionModule;
+    context -> pdModuleModule = currentPdModuleModule;
+    context -> pdChannelModule = currentPdChannelModule;
+    context -> pllModule = currentPllModule;
+    context -> ytoModule = currentYtoModule;
+    context -> polDacModule = currentPolDacModule;
+    context -> polSpecialMsgsModule = currentPolSpecialMsgsModule;
+    context -> ifChannelModule = currentIfChannelModule;
+    memcpy(context -> ifChannelPolarization, currentIfChannelPolarization, sizeof(context -> ifChannelPolarization));
+    memcpy(context -> ifChannelSideband, currentIfChannelSideband, sizeof(context -> ifChannelSideband));
+    context -> cryostatModule = currentCryostatModule;
+    context -> lprModule = currentLprModule;
+    context -> fetimModule = currentFetimModule;
+    context -> compressorModule = currentCompressorModule;
+    context -> interlockTempModule = currentInterlockTempModule;
+    context -> interlockFlowModule = currentInterlockFlowModule;
+}
+
+/*! Copy a context back into the addressing globals.
+    \param *context the context to restore */
+void handlerContextRestore(const HANDLER_CONTEXT *context) {
+    CANMessage = context -> message;
+    convert = context -> convert;
+    currentModule = context -> module;
+    currentClass = context -> rcaClass;
+    currentCartridgeSubsystem = context -> cartridgeSubsystem;
+    currentBiasModule = context -> biasModule;
+    currentPolarizationModule = context -> polarizationModule;
+    currentSidebandModule = context -> sidebandModule;
+    currentSisModule = context -> sisModule;
+    currentSisMagnetModule = context -> sisMagnetModule;
+    currentLnaModule = context -> lnaModule;
+    currentLnaStageModule = context -> lnaStageModule;
+    currentLoAndTempModule = context -> loAndTempModule;
+    currentLoModule = context -> loModule;
+    currentPaModule = context -> paModule;
+    currentPaChannelModule = context -> paChannelModule;
+    currentCartridgeTempSubsystemModule = context -> cartridgeTempSubsystem;
+    currentIfSwitchModule = context -> ifSwitchModule;
+    currentPowerDistributionModule = context -> powerDistributionModule;
+    currentPdModuleModule = context -> pdModuleModule;
+    currentPdChannelModule = context -> pdChannelModule;
+    currentPllModule = context -> pllModule;
+    currentYtoModule = context -> ytoModule;
+    currentPolDacModule = context -> polDacModule;
+    currentPolSpecialMsgsModule = context -> polSpecialMsgsModule;
+    currentIfChannelModule = context -> ifChannelModule;
+    memcpy(currentIfChannelPolarization, context -> ifChannelPolarization, sizeof(context -> ifChannelPolarization));
+    memcpy(currentIfChannelSideband, context -> ifChannelSideband, sizeof(context -> ifChannelSideband));
+    currentCryostatModule = context -> cryostatModule;
+    currentLprModule = context -> lprModule;
+    currentFetimModule = context -> fetimModule;
+    currentCompressorModule = context -> compressorModule;
+    currentInterlockTempModule = context -> interlockTempModule;
+    currentInterlockFlowModule = context -> interlockFlowModule;
+}
+
+/*! Save the current context and restore another one.
+    \param *save    receives the current context
+    \param *load    the context to restore */
+void handlerContextSwitch(HANDLER_CONTEXT *save, const HANDLER_CONTEXT *load) {
+    handlerContextSave(save);
+    handlerContextRestore(load);
+}
@@ -0,0 +1,88 @@
+/*! \file   handlerContext.h
+    \brief  Saved addressing state of the handler tree
+
+    The handlers and the serial interface functions find the addressed
+    hardware through globals: \ref currentModule, \ref currentClass, the
+    current*Module index of every level of the handler tree the serial
+    interface functions address the hardware through, the IF channel
+    polarization and sideband of each IF switch module, the received
+    \ref CANMessage and the \ref convert buffer.  Anything that addresses the
+    hardware outside of a CAN request, like the async functions, overwrites
+    them.
+
+    A HANDLER_CONTEXT holds a copy of all of them.  Code that has to address
+    the hardware on its own behalf saves the context it was called with,
+    restores its own, and swaps them back before returning.  This way the
+    async functions and the CAN message handler each find their own addressing
+    untouched when they resume, whatever ran in between.
+
+    This is a save and restore of the globals, not a context passed to the
+    handlers: the handlers and the serial interface functions still read the
+    globals.  Each switch copies the whole structure twice, and a field has to
+    be added here for every new current*Module global.  Passing a context
+    pointer down the handler tree would remove both, at the cost of changing
+    the signature of every handler. */
+
+#ifndef _HANDLERCONTEXT_H
+    #define _HANDLERCONTEXT_H
+
+    /* Extra includes */
+    /* CAN_MESSAGE */
+    #ifndef _CAN_H
+        #include "can.h"
+    #endif /* _CAN_H */
+
+    /* IF_CHANNELS_NUMBER */
+    #ifndef _IFSWITCH_H
+        #include "ifSwitch.h"
+    #endif /* _IFSWITCH_H */
+
+    /* Typedefs */
+    //! Copy of the addressing state of the handler tree
+    typedef struct {
+        CAN_MESSAGE     message;                //!< CANMessage
+        CONVERSION      convert;                //!< convert
+        unsigned char   module;                 //!< currentModule
+        unsigned char   rcaClass;               //!< currentClass
+        unsigned char   cartridgeSubsystem;     //!< currentCartridgeSubsystem
+        unsigned char   biasModule;             //!< currentBiasModule
+        unsigned char   polarizationModule;     //!< currentPolarizationModule
+        unsigned char   sidebandModule;         //!< currentSidebandModule
+        unsigned char   sisModule;              //!< currentSisModule
+        unsigned char   sisMagnetModule;        //!< currentSisMagnetModule
+        unsigned char   lnaModule;              //!< currentLnaModule
+        unsigned char   lnaStageModule;         //!< currentLnaStageModule
+        unsigned char   loAndTempModule;        //!< currentLoAndTempModule
+        unsigned char   loModule;               //!< currentLoModule
+        unsigned char   paModule;               //!< currentPaModule
+        unsigned char   paChannelModule;        //!< currentPaChannelModule
+        unsigned char   cartridgeTempSubsystem; //!< currentCartridgeTempSubsystemModule
+        unsigned char   ifSwitchModule;         //!< currentIfSwitchModule
+        unsigned char   powerDistributionModule;//!< currentPowerDistributionModule
+        unsigned char   pdModuleModule;         //!< currentPdModuleModule
+        unsigned char   pdChannelModule;        //!< currentPdChannelModule
+        unsigned char   pllModule;              //!< currentPllModule
+        unsigned char   ytoModule;              //!< currentYtoModule
+        unsigned char   polDacModule;           //!< currentPolDacModule
+        unsigned char   polSpecialMsgsModule;   //!< currentPolSpecialMsgsModule
+        unsigned char   ifChannelModule;        //!< currentIfChannelModule
+        unsigned char   ifChannelPolarization[IF_CHANNELS_NUMBER]; //!< currentIfChannelPolarization
+        unsigned char   ifChannelSideband[IF_CHANNELS_NUMBER];     //!< currentIfChannelSideband
+        unsigned char   cryostatModule;         //!< currentCryostatModule
+        unsigned char   lprModule;              //!< currentLprModule
+        unsigned char   fetimModule;            //!< currentFetimModule
+        unsigned char   compressorModule;       //!< currentCompressorModule
+        unsigned char   interlockTempModule;    //!< currentInterlockTempModule
+        unsigned char   interlockFlowModule;    //!< currentInterlockFlowModule
+    } HANDLER_CONTEXT;
+
+    /* Prototypes */
+    /* Externs */
+    extern void handlerContextSave(HANDLER_CONTEXT *context);
+    //!< Copy the addressing globals into a context
+    extern void handlerContextRestore(const HANDLER_CONTEXT *context);
+    //!< Copy a context back into the addressing globals
+    extern void handlerContextSwitch(HANDLER_CONTEXT *save, const HANDLER_CONTEXT *load);
+    //!< Save the current context and restore another one
+
+#endif /* _HANDLERCONTEXT_H */
@@ -13,8 +13,10 @@
 
 #include "error.h"
 #include "frontend.h"
+#include "lastControl.h"
 #include "ifSerialInterface.h"
 #include "ifSwitch.h"
+#include "controlElision.h"
 #include "debug.h"
 #include "globalDefinitions.h"
 
@@ -73,12 +75,21 @@ void attenuationHandler(void){
 
     /* If control (size!=0) */
     if(CAN_SIZE){
+        /* Skip the command if the same attenuation is already applied. The
+           attenuator may have been set since by the all channels control,
+           so the written attenuation has to match too. */
+        if((frontend.ifSwitch.attenuationWritten&(0x01<<currentIfSwitchModule))
+           && frontend.
+               ifSwitch.
+                ifChannel[currentIfChannelPolarization[currentIfSwitchModule]]
+                         [currentIfChannelSideband[currentIfSwitchModule]].
+                 attenuation==CAN_BYTE
+           && controlElide()){
+            return;
+        }
+
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.
-                                   ifSwitch.
-                                    ifChannel[currentIfChannelPolarization[currentIfSwitchModule]]
-                                             [currentIfChannelSideband[currentIfSwitchModule]].
-                                     lastAttenuation)
+        SAVE_LAST_CONTROL_MESSAGE()
 
         /* Since the payload is just a byte, there is no need to conver the
            received data from the can message to any particular format, the
@@ -87,12 +98,7 @@ void attenuationHandler(void){
             storeError(ERR_IF_CHANNEL, ERC_COMMAND_VAL); //Attenuation set value out of range
 
             /* Store error in the last control message variable */
-            frontend.
-             ifSwitch.
-              ifChannel[currentIfChannelPolarization[currentIfSwitchModule]]
-                       [currentIfChannelSideband[currentIfSwitchModule]].
-               lastAttenuation.
-                status=CON_ERROR_RNG;
+            CAN_LAST_CONTROL.status=CON_ERROR_RNG;
 
             return;
         }
@@ -101,12 +107,7 @@ void attenuationHandler(void){
            state and then return. */
         if(setIfChannelAttenuation()==ERROR){
             /* Store the Error state in the last control message variable */
-            frontend.
-             ifSwitch.
-              ifChannel[currentIfChannelPolarization[currentIfSwitchModule]]
-                       [currentIfChannelSideband[currentIfSwitchModule]].
-               lastAttenuation.
-                status=ERROR;
+            CAN_LAST_CONTROL.status=ERROR;
 
             return;
         }
@@ -118,11 +119,7 @@ void attenuationHandler(void){
     /* If monitor on control RCA */
     if(currentClass==CONTROL_CLASS){ // If monitor on a control RCA
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.
-                                     ifSwitch.
-                                      ifChannel[currentIfChannelPolarization[currentIfSwitchModule]]
-                                               [currentIfChannelSideband[currentIfSwitchModule]].
-                                       lastAttenuation)
+        RETURN_LAST_CONTROL_MESSAGE()
         return;
     }
 
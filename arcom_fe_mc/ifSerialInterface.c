@@ -24,6 +24,7 @@
 #include "ifSerialInterface.h"
 #include "error.h"
 #include "serialInterface.h"
+#include "serialProfile.h"
 #include "timer.h"
 #include "frontend.h"
 #include "debug.h"
@@ -33,6 +34,19 @@
 /* Statics */
 IF_REGISTERS ifRegisters;
 
+/* IF switch analog monitor request.
+   This function profiles the analog monitor cycle below. See serialProfile.h. */
+static int getIfAnalogMonitor(void){
+
+    int ret;
+
+    serialProfileBegin(SERIAL_PROFILE_IF_ANALOG);
+    ret=getIfAnalogMonitorCycle();
+    serialProfileEnd(SERIAL_PROFILE_IF_ANALOG, ret);
+
+    return ret;
+}
+
 /* IF switch analog monitor request core.
    This function performs the core operations that are common to all the analog
    monitor request for the IF switch module:
@@ -45,7 +59,7 @@ IF_REGISTERS ifRegisters;
 
    If an error happens during he process it will return ERROR, otherwise
    NO_ERROR will be returned. */
-static int getIfAnalogMonitor(void){
+static int getIfAnalogMonitorCycle(void){
 
     /* A temporary variable to deal with the timer. */
     int timedOut;
@@ -507,6 +521,9 @@ int setIfChannelAttenuation(void){
       ifChannel[currentIfChannelPolarization[currentIfSwitchModule]]
                [currentIfChannelSideband[currentIfSwitchModule]].
        attenuation=CAN_BYTE;
+    frontend.
+     ifSwitch.
+      attenuationWritten|=(0x01<<currentIfSwitchModule);
 
     return NO_ERROR;
 }
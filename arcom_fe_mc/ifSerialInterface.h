@@ -285,6 +285,7 @@
     /* Prototypes */
     /* Statics */
     static int getIfAnalogMonitor(void); // Perform core analog monitor functions
+    static int getIfAnalogMonitorCycle(void); // Analog monitor cycle, without the profiling
 
     /* Externs */
     extern int setIfTempServoEnable(unsigned char enable); //!< This function enables/disables the IF switch temperature servo
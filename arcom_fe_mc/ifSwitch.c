@@ -13,7 +13,9 @@
 
 #include "error.h"
 #include "frontend.h"
+#include "lastControl.h"
 #include "ifSerialInterface.h"
+#include "async.h"
 #include "debug.h"
 
 /* Globals */
@@ -36,7 +38,15 @@ static HANDLER  ifSwitchModulesHandler[IF_SWITCH_MODULES_NUMBER]={ifChannelHandl
                                                                   ifChannelHandler,
                                                                   ifChannelHandler,
                                                                   bandSelectHandler,
-                                                                  allChannelsHandler};
+                                                                  allChannelsHandler,
+                                                                  allChannelsTempHandler};
+/* Async snapshot of the IF channel temperatures: status of the last reading
+   of each channel. The temperatures are in the frontend variable. */
+static unsigned char currentAsyncIfChannelModule=0;
+static int asyncIfChannelTempError[IF_CHANNELS_NUMBER]={ERROR,
+                                                        ERROR,
+                                                        ERROR,
+                                                        ERROR};
 
 /* IF Switch handler */
 /*! This function will be called by the CAN message handler when the received
@@ -73,7 +83,7 @@ void bandSelectHandler(void) {
     /* If control (size!=0) */
     if(CAN_SIZE){
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.ifSwitch.lastBandSelect)
+        SAVE_LAST_CONTROL_MESSAGE()
 
         /* Since the payload is just a byte, there is no need to conver the
            received data from the can message to any particular format, the
@@ -82,7 +92,7 @@ void bandSelectHandler(void) {
             storeError(ERR_IF_SWITCH, ERC_COMMAND_VAL); //Selected band set value out of range
 
             /* Store error in the last control message variable */
-            frontend.ifSwitch.lastBandSelect.status = CON_ERROR_RNG;
+            CAN_LAST_CONTROL.status = CON_ERROR_RNG;
             return;
         }
 
@@ -90,7 +100,7 @@ void bandSelectHandler(void) {
            return. */
         if(setIfSwitchBandSelect() == ERROR) {
             /* Store the error state in the last control message variable */
-            frontend.ifSwitch.lastBandSelect.status=ERROR;
+            CAN_LAST_CONTROL.status=ERROR;
             return;
         }
 
@@ -101,7 +111,7 @@ void bandSelectHandler(void) {
     /* If monitor on control RCA */
     if(currentClass==CONTROL_CLASS){ // If monitor on control RCA
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.ifSwitch.lastBandSelect)
+        RETURN_LAST_CONTROL_MESSAGE()
         return;
     }
 
@@ -122,27 +132,37 @@ void allChannelsHandler(void) {
     /* If control (size!=0) */
     if (CAN_SIZE) {
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.ifSwitch.lastAllChannelsAtten)
+        SAVE_LAST_CONTROL_MESSAGE()
 
-        // Set all four IF switch attenuators:
+        // Range check all four attenuations before changing any of them:
         for (currentIfSwitchModule = 0; currentIfSwitchModule < IF_CHANNELS_NUMBER; currentIfSwitchModule++)
         {
-            // Range check:
             if (checkRange(IF_CHANNEL_SET_ATTENUATION_MIN, CAN_DATA(currentIfSwitchModule), IF_CHANNEL_SET_ATTENUATION_MAX))
             {
                 storeError(ERR_IF_SWITCH, ERC_COMMAND_VAL); //Attenuation set value out of range
 
                 /* Store error in the last control message variable */
-                frontend.ifSwitch.lastAllChannelsAtten.status = CON_ERROR_RNG;
+                CAN_LAST_CONTROL.status = CON_ERROR_RNG;
                 return;
             }
+        }
+
+        // Set the IF switch attenuators whose value changes:
+        for (currentIfSwitchModule = 0; currentIfSwitchModule < IF_CHANNELS_NUMBER; currentIfSwitchModule++)
+        {
+            if ((frontend.ifSwitch.attenuationWritten & (0x01 << currentIfSwitchModule))
+                && frontend.ifSwitch.ifChannel[currentIfChannelPolarization[currentIfSwitchModule]]
+                                              [currentIfChannelSideband[currentIfSwitchModule]].attenuation == CAN_DATA(currentIfSwitchModule))
+            {
+                continue;
+            }
             // Copy the attenuation for the current module being set to CAN_BYTE:
             CAN_BYTE = CAN_DATA(currentIfSwitchModule);
 
             // Set the current attenuator using CAN_BYTE:
             if (setIfChannelAttenuation() == ERROR) {
                 /* Store the Error state in the last control message variable */
-                frontend.ifSwitch.lastAllChannelsAtten.status = ERROR;
+                CAN_LAST_CONTROL.status = ERROR;
                 // bail out early if error:
                 return;
             }
@@ -154,7 +174,7 @@ void allChannelsHandler(void) {
     /* If monitor on control RCA */
     if (currentClass==CONTROL_CLASS) { // If monitor on control RCA
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.ifSwitch.lastAllChannelsAtten)
+        RETURN_LAST_CONTROL_MESSAGE()
         return;
     }
 
@@ -168,6 +188,92 @@ void allChannelsHandler(void) {
     CAN_SIZE = IF_CHANNELS_NUMBER;
 }
 
+/* All channels temperature handler */
+/* This function returns the temperature of the four IF channels from the
+   snapshot kept up to date by ifSwitchAsync(), without reading the ADC. Each
+   temperature is a big endian signed 16 bit in 0.01 C, or
+   IF_ALL_CHANNELS_TEMP_NO_DATA if the last reading of the channel failed.
+   The four temperatures fill the payload, so there is no room for the status
+   byte: a failed channel is only reported by its value. */
+void allChannelsTempHandler(void) {
+    unsigned char channel;
+    int temp;
+
+    #ifdef DEBUG_IFSWITCH
+        printf("  All Channels Temp\n");
+    #endif /* DEBUG_IFSWITCH */
+
+    /* If control (size!=0) store error and return. No control messages are
+       allowed on this RCA. */
+    if (CAN_SIZE) {
+        storeError(ERR_IF_SWITCH, ERC_RCA_RANGE); //Control message out of range
+        return;
+    }
+
+    /* If monitor on control RCA return error since there are no control
+       messages allowed on this RCA. */
+    if (currentClass==CONTROL_CLASS) { // If monitor on control RCA
+        storeError(ERR_IF_SWITCH, ERC_RCA_RANGE); //Monitor message out of range
+        /* Store the state in the outgoing CAN message */
+        CAN_STATUS = MON_CAN_RNG;
+        return;
+    }
+
+    /* If monitor on monitor RCA */
+    for (channel = 0; channel < IF_CHANNELS_NUMBER; channel++) {
+        if (asyncIfChannelTempError[channel] == NO_ERROR) {
+            temp = (int) (IF_ALL_CHANNELS_TEMP_SCALE *
+                          frontend.ifSwitch.ifChannel[currentIfChannelPolarization[channel]]
+                                                     [currentIfChannelSideband[channel]].assemblyTemp);
+        } else {
+            temp = IF_ALL_CHANNELS_TEMP_NO_DATA;
+        }
+        CAN_DATA(2 * channel) = (unsigned char) (temp >> 8);
+        CAN_DATA(2 * channel + 1) = (unsigned char) temp;
+    }
+    CAN_SIZE = CAN_FULL_SIZE;
+}
+
+/* IF Switch async */
+/*! This function reads the temperature of one IF channel at every call, so
+    that the all channels temperature monitor can be answered from memory.
+    \return
+        - \ref NO_ERROR     -> if more channels are left to read
+        - \ref ASYNC_DONE   -> if all the channels were read */
+int ifSwitchAsync(void) {
+
+    /* Address the IF switch channel */
+    currentModule=IF_SWITCH_MODULE;
+    currentIfSwitchModule=currentAsyncIfChannelModule;
+
+    /* On revision 0 of the hardware, the temperature can only be read while
+       the temperature servo is enabled. */
+    if ((frontend.ifSwitch.ifChannel[currentIfChannelPolarization[currentIfSwitchModule]]
+                                    [currentIfChannelSideband[currentIfSwitchModule]].ifTempServo.enable==IF_TEMP_SERVO_DISABLE)
+        && (frontend.ifSwitch.hardwRevision==IF_SWITCH_HRDW_REV0))
+    {
+        asyncIfChannelTempError[currentIfSwitchModule]=HARDW_BLKD_ERR;
+    } else {
+        asyncIfChannelTempError[currentIfSwitchModule]=getIfChannelTemp();
+    }
+
+    #ifdef DEBUG_IFSWITCH_ASYNC
+        printf("Async -> IF Switch -> Temp%d=%f (%d)\n",
+               currentIfSwitchModule,
+               frontend.ifSwitch.ifChannel[currentIfChannelPolarization[currentIfSwitchModule]]
+                                          [currentIfChannelSideband[currentIfSwitchModule]].assemblyTemp,
+               asyncIfChannelTempError[currentIfSwitchModule]);
+    #endif /* DEBUG_IFSWITCH_ASYNC */
+
+    /* Next channel, if wrap around, we're done */
+    if (++currentAsyncIfChannelModule==IF_CHANNELS_NUMBER) {
+        currentAsyncIfChannelModule=0;
+        return ASYNC_DONE;
+    }
+
+    return NO_ERROR;
+}
+
 /* IF Switch initialization */
 /*! This function performs all the necessary initialization for the IF switch
     system. These are executed only once at startup.
@@ -60,13 +60,18 @@
     #define WAY9                            12
 
     /* Submodule definitions */
-    #define IF_SWITCH_MODULES_NUMBER        (IF_CHANNELS_NUMBER+2)  // See list below
+    #define IF_SWITCH_MODULES_NUMBER        (IF_CHANNELS_NUMBER+3)  // See list below
     #define IF_SWITCH_MODULES_RCA_MASK      0x0001C                 /* Mask to extract the submodule number:
                                                                        0-3  -> ifChannelHandler
                                                                        4    -> bandSelectHandler
-                                                                       5    -> allChannelHandler */
+                                                                       5    -> allChannelHandler
+                                                                       6    -> allChannelsTempHandler */
     #define IF_SWITCH_MODULES_MASK_SHIFT    2                       // Bits right shift for the submodules mask
 
+    /* All channels temperature monitor */
+    #define IF_ALL_CHANNELS_TEMP_SCALE      100.0                   // The temperatures are returned in 0.01 C
+    #define IF_ALL_CHANNELS_TEMP_NO_DATA    0x8000                  // Returned for a channel without a valid reading
+
     /* Typedefs */
     //! Current state of the IF switch system
     typedef struct {
@@ -89,11 +94,11 @@
         //! Selected cartridge
         /*! This is the currently cartridge selected by the IF switch. */
         unsigned char   bandSelect;
-        //! Last control message: band select
-        /*! This is the content of the last control message sent to the band
-            select. */
-        LAST_CONTROL_MESSAGE    lastBandSelect;
-        LAST_CONTROL_MESSAGE    lastAllChannelsAtten;
+        //! Attenuations written
+        /*! Bit n is set once the attenuation of IF channel n was written to
+            the hardware. Until then the stored attenuation is not the
+            hardware state. */
+        unsigned char   attenuationWritten;
     } IF_SWITCH;
 
     /* Globals */
@@ -105,8 +110,10 @@
     /* Statics */
     static void bandSelectHandler(void);
     static void allChannelsHandler(void);
+    static void allChannelsTempHandler(void);
     /* Externs */
     extern void ifSwitchHandler(void); //!< This function deals with the incoming CAN message
     extern int ifSwitchStartup(void); //!< This function deals with the initialization of the IF switch system
+    extern int ifSwitchAsync(void); //!< This function deals with the asynchronous monitor of the IF switch
 
 #endif /* _IFSWITCH_H */
@@ -13,6 +13,7 @@
 
 #include "error.h"
 #include "frontend.h"
+#include "lastControl.h"
 #include "ifSerialInterface.h"
 #include "debug.h"
 
@@ -56,24 +57,13 @@ static void enableHandler(void){
     /* If control (size!=0) */
     if(CAN_SIZE){
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.
-                                   ifSwitch.
-                                    ifChannel[currentIfChannelPolarization[currentIfSwitchModule]]
-                                             [currentIfChannelSideband[currentIfSwitchModule]].
-                                     ifTempServo.
-                                      lastEnable)
+        SAVE_LAST_CONTROL_MESSAGE()
 
         /* Check that the CAN_BYTE is a legal value for enable/disable */
         if(CAN_BYTE!=IF_TEMP_SERVO_ENABLE && CAN_BYTE!=IF_TEMP_SERVO_DISABLE){
             storeError(ERR_IF_CHANNEL, ERC_COMMAND_VAL); //Bad command for servo enable/disable
             /* Store the ERROR state in the last control message variable */
-            frontend.
-             ifSwitch.
-              ifChannel[currentIfChannelPolarization[currentIfSwitchModule]]
-                       [currentIfChannelSideband[currentIfSwitchModule]].
-               ifTempServo.
-                lastEnable.
-                 status=ERROR;
+            CAN_LAST_CONTROL.status=ERROR;
             return;
         }
         
@@ -82,13 +72,7 @@ static void enableHandler(void){
         if(setIfTempServoEnable(CAN_BYTE?IF_TEMP_SERVO_ENABLE:
                                          IF_TEMP_SERVO_DISABLE)==ERROR){
             /* Store the ERROR state in the last control message variable */
-            frontend.
-             ifSwitch.
-              ifChannel[currentIfChannelPolarization[currentIfSwitchModule]]
-                       [currentIfChannelSideband[currentIfSwitchModule]].
-               ifTempServo.
-                lastEnable.
-                 status=ERROR;
+            CAN_LAST_CONTROL.status=ERROR;
 
             return;
         }
@@ -100,12 +84,7 @@ static void enableHandler(void){
     /* If monitor on a control RCA */
     if(currentClass==CONTROL_CLASS){
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.
-                                     ifSwitch.
-                                      ifChannel[currentIfChannelPolarization[currentIfSwitchModule]]
-                                               [currentIfChannelSideband[currentIfSwitchModule]].
-                                       ifTempServo.
-                                        lastEnable)
+        RETURN_LAST_CONTROL_MESSAGE()
         return;
     }
 
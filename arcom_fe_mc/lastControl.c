@@ -0,0 +1,210 @@
+/*! \file   lastControl.c
+    \brief  Store of the last control messages
+
+    See lastControl.h for a description of the store.
+*/
+
+/* Includes */
+#include <stdio.h>      /* printf */
+#include <string.h>     /* memcpy, memset */
+
+#include "lastControl.h"
+#include "error.h"
+#include "memoryUsage.h"
+#include "debug.h"
+#include "globalDefinitions.h"
+
+/* Globals */
+LAST_CONTROL_STORE lastControlStore = {0,
+                                       0,
+                                       0L,
+                                       0L};
+
+/* Statics */
+static LAST_CONTROL_ENTRY *table = NULL;            // Allocated by lastControlInit()
+static unsigned char current[(LAST_CONTROL_SLOTS + 7) / 8]; // Slots saved in the current epoch of their module
+static LAST_CONTROL_MESSAGE scratch;                // Used when the table is full
+static const LAST_CONTROL_MESSAGE none = {0};       // Returned for an RCA never commanded
+
+/*! Allocate the table.
+    This is called once at startup, before any control message.
+    \return
+        - NO_ERROR  -> if no error occurred
+        - ERROR     -> if the table couldn't be allocated: every control
+                       message then goes to the scratch entry */
+int lastControlInit(void) {
+    unsigned int slot;
+
+    table = (LAST_CONTROL_ENTRY *) memoryAlloc(MEMORY_LAST_CONTROL, LAST_CONTROL_SLOTS * sizeof(LAST_CONTROL_ENTRY));
+    if (table == NULL) {
+        storeError(ERR_LAST_CONTROL, ERC_NO_MEMORY); // Out of memory for the last control messages
+        return ERROR;
+    }
+
+    for (slot = 0; slot < LAST_CONTROL_SLOTS; slot++)
+        table[slot].key = LAST_CONTROL_EMPTY;
+    memset(current, 0, sizeof(current));
+    lastControlStore.slots = LAST_CONTROL_SLOTS;
+
+    #ifdef DEBUG_LAST_CONTROL
+        printf("Last control: %u slots, %u bytes\n",
+               lastControlStore.slots,
+               lastControlFootprint());
+    #endif /* DEBUG_LAST_CONTROL */
+
+    return NO_ERROR;
+}
+
+/*! Return the last control message of an RCA, if any.
+    \param rca      the control RCA
+    \return
+        - the last control message
+        - NULL if no control message was received on the RCA */
+LAST_CONTROL_MESSAGE *lastControlFind(unsigned long rca) {
+    LAST_CONTROL_ENTRY *entry;
+
+    if (table == NULL)
+        return NULL;
+
+    entry = lastControlSlot((unsigned int) rca);
+    return (entry -> key == LAST_CONTROL_EMPTY) ? NULL : &entry -> message;
+}
+
+/*! Return the last control message of an RCA saved in the current epoch.
+    \param rca      the control RCA
+    \return
+        - the last control message, if saved by lastControlSave() since the
+          last controlEpochAdvance() of the module of the RCA
+        - NULL otherwise */
+const LAST_CONTROL_MESSAGE *lastControlFindCurrent(unsigned long rca) {
+    LAST_CONTROL_ENTRY *entry;
+    unsigned int slot;
+
+    if (table == NULL)
+        return NULL;
+
+    entry = lastControlSlot((unsigned int) rca);
+    slot = (unsigned int)(entry - table);
+    if (entry -> key == LAST_CONTROL_EMPTY
+        || !(current[slot >> 3] & (1 << (slot & 7))))
+    {
+        return NULL;
+    }
+    return &entry -> message;
+}
+
+/*! Mark the last control messages of a module as saved in an older epoch.
+    This is called by controlEpochAdvance().
+    \param module   the module, as decoded from the RCA */
+void lastControlEpochAdvance(unsigned char module) {
+    unsigned int slot;
+
+    if (table == NULL)
+        return;
+
+    for (slot = 0; slot < LAST_CONTROL_SLOTS; slot++) {
+        if (table[slot].key != LAST_CONTROL_EMPTY
+            && ((table[slot].key & MODULES_RCA_MASK) >> MODULES_MASK_SHIFT) == module)
+        {
+            current[slot >> 3] &= ~(1 << (slot & 7));
+        }
+    }
+}
+
+/*! Return the last control message of an RCA, creating it if needed.
+    A new message is zeroed, as the embedded messages were at startup.
+    \param rca      the control RCA
+    \return the last control message */
+LAST_CONTROL_MESSAGE *lastControlMessage(unsigned long rca) {
+    LAST_CONTROL_ENTRY *entry = lastControlEntry((unsigned int) rca);
+
+    if (entry == NULL) {
+        memset(&scratch, 0, sizeof(scratch));
+        return &scratch;
+    }
+    return &entry -> message;
+}
+
+/*! Save the control message being handled for its RCA.
+    Its status is reset to NO_ERROR prior to command processing and it is
+    marked as saved in the current epoch of its module. */
+void lastControlSave(void) {
+    LAST_CONTROL_ENTRY *entry = lastControlEntry((unsigned int) CAN_ADDRESS);
+    LAST_CONTROL_MESSAGE *last = (entry == NULL) ? &scratch : &entry -> message;
+    unsigned int slot;
+
+    memcpy(last, &CAN_SIZE, CAN_LAST_CONTROL_MESSAGE_SIZE);
+    last -> status = NO_ERROR;
+
+    if (entry != NULL) {
+        slot = (unsigned int)(entry - table);
+        current[slot >> 3] |= 1 << (slot & 7);
+    }
+}
+
+/*! Return the last control message and status of the RCA being handled.
+    An RCA never commanded returns an empty payload with NO_ERROR, without
+    taking a slot. */
+void lastControlReturn(void) {
+    const LAST_CONTROL_MESSAGE *last = lastControlFind(CAN_ADDRESS);
+
+    memcpy(&CAN_SIZE, (last == NULL) ? &none : last, CAN_LAST_CONTROL_MESSAGE_SIZE);
+}
+
+/*! Bytes taken by the store once allocated.
+    \return the size of the table and of the epoch bits */
+unsigned int lastControlFootprint(void) {
+    return LAST_CONTROL_SLOTS * sizeof(LAST_CONTROL_ENTRY) + sizeof(current);
+}
+
+/* Return the slot holding a key or the free slot where it goes */
+static LAST_CONTROL_ENTRY *lastControlSlot(unsigned int key) {
+    // Multiplicative hashing: 40503 is 2^16 divided by the golden ratio
+    unsigned int slot = (unsigned int)((key * 40503U) & 0xFFFFU) % LAST_CONTROL_SLOTS;
+
+    lastControlStore.lookups++;
+    for (;;) {
+        lastControlStore.probes++;
+        if (table[slot].key == key || table[slot].key == LAST_CONTROL_EMPTY)
+            return &table[slot];
+        if (++slot == LAST_CONTROL_SLOTS)
+            slot = 0;
+    }
+}
+
+/* Return the slot holding a key, creating the entry if needed.
+   NULL if the table is full or couldn't be allocated. */
+static LAST_CONTROL_ENTRY *lastControlEntry(unsigned int key) {
+    LAST_CONTROL_ENTRY *entry;
+    unsigned int slot;
+
+    if (table == NULL) {
+        storeError(ERR_LAST_CONTROL, ERC_NO_MEMORY); // Out of memory for the last control messages
+        return NULL;
+    }
+
+    entry = lastControlSlot(key);
+    if (entry -> key != LAST_CONTROL_EMPTY)
+        return entry;
+
+    // Keep one free slot to end the probes
+    if (lastControlStore.entries >= LAST_CONTROL_SLOTS - 1) {
+        storeError(ERR_LAST_CONTROL, ERC_NO_MEMORY); // Out of memory for the last control messages
+        return NULL;
+    }
+
+    entry -> key = key;
+    memset(&entry -> message, 0, sizeof(LAST_CONTROL_MESSAGE));
+    slot = (unsigned int)(entry - table);
+    current[slot >> 3] &= ~(1 << (slot & 7));
+    lastControlStore.entries++;
+
+    #ifdef DEBUG_LAST_CONTROL
+        printf("Last control: 0x%X stored, %u/%u\n",
+               key,
+               lastControlStore.entries,
+               lastControlStore.slots);
+    #endif /* DEBUG_LAST_CONTROL */
+
+    return entry;
+}
@@ -0,0 +1,107 @@
+/*! \file   lastControl.h
+    \brief  Store of the last control messages
+
+    A monitor request on a control RCA returns the last control message
+    received on that RCA, with the status of its execution.  Instead of a
+    \ref LAST_CONTROL_MESSAGE embedded in the \ref FRONTEND structure for
+    each of the control points, which with ten cartridges takes about 10 KB
+    mostly for controls that are never used, the messages are kept in an
+    open addressed hash table keyed by the RCA.  An entry is only created
+    when a control message is first received on an RCA.
+
+    The table of \ref LAST_CONTROL_SLOTS slots is allocated once at startup,
+    before the heap gets fragmented, and never grows.  It is sized so that the
+    store takes less memory than the embedded records did: it holds one RCA
+    less than its slots, since one free slot ends the linear probes.  Entries
+    are never removed.  If the table is full, the message goes to a scratch
+    entry and ERC_NO_MEMORY is stored.  Code that only reads a last control
+    message uses lastControlFind(), so that only the RCAs actually commanded
+    take a slot.
+
+    The messages are not stamped with an epoch of their module: one bit per
+    slot, outside the entries, tells the messages saved since the last
+    controlEpochAdvance() of their module, for controlElide().
+
+    The RCA is the key as received, so an RCA with bits the handlers ignore
+    doesn't share the record of its canonical RCA.
+
+    The handlers go through the macros below, which address the RCA of the
+    message being handled.  Code handling a control point on behalf of
+    another request builds the RCA of the control point and calls
+    lastControlMessage() itself.
+
+    The firmware reports the footprint of the store and of the records it
+    replaces with the version information, at startup and on the 'i'
+    console command. */
+
+#ifndef _LASTCONTROL_H
+    #define _LASTCONTROL_H
+
+    /* Extra includes */
+    /* LAST_CONTROL_MESSAGE */
+    #ifndef _CAN_H
+        #include "can.h"
+    #endif /* _CAN_H */
+
+    /* Defines */
+    #define LAST_CONTROL_SLOTS          680     //!< Slots in the table, less memory than the \ref LAST_CONTROL_EMBEDDED records
+    #define LAST_CONTROL_EMPTY          0xFFFF  //!< Key of a free slot, in the unused module F
+    #define LAST_CONTROL_EMBEDDED       837     //!< Control points with a LAST_CONTROL_MESSAGE in FRONTEND before the store
+
+    //! The last control message of the RCA being handled
+    /*! The entry is created if there is none yet. */
+    #define CAN_LAST_CONTROL    (*lastControlMessage(CAN_ADDRESS))
+
+    //! A macro to save the incoming control message for its RCA
+    //!  then reset its status to NO_ERROR prior to command processing.
+    //!  This pattern is repeated all over the code!
+    #define SAVE_LAST_CONTROL_MESSAGE() { \
+        lastControlSave(); }
+
+    //! A macro to return the last control message and status of the RCA.
+    //!  This pattern is repeated all over the code!
+    #define RETURN_LAST_CONTROL_MESSAGE() { \
+        lastControlReturn(); }
+
+    /* Typedefs */
+    //! Slot of the last control message store
+    typedef struct {
+        unsigned int            key;        //!< Low 16 bits of the control RCA, \ref LAST_CONTROL_EMPTY if free
+        LAST_CONTROL_MESSAGE    message;    //!< Last control message received on the RCA
+    } LAST_CONTROL_ENTRY;
+
+    //! Last control message store state
+    typedef struct {
+        unsigned int    slots;      //!< Slots in the table, 0 if it couldn't be allocated
+        unsigned int    entries;    //!< RCAs stored
+        unsigned long   probes;     //!< Slots visited by the lookups
+        unsigned long   lookups;    //!< Lookups
+    } LAST_CONTROL_STORE;
+
+    /* Globals */
+    /* Externs */
+    extern LAST_CONTROL_STORE lastControlStore; //!< Last control message store state
+
+    /* Prototypes */
+    /* Statics */
+    static LAST_CONTROL_ENTRY *lastControlSlot(unsigned int key);
+    static LAST_CONTROL_ENTRY *lastControlEntry(unsigned int key);
+    /* Externs */
+    extern int lastControlInit(void);
+    //!< Allocate the table
+    extern LAST_CONTROL_MESSAGE *lastControlFind(unsigned long rca);
+    //!< Return the last control message of an RCA, NULL if none
+    extern const LAST_CONTROL_MESSAGE *lastControlFindCurrent(unsigned long rca);
+    //!< Return the last control message of an RCA if saved in the current epoch
+    extern void lastControlEpochAdvance(unsigned char module);
+    //!< Mark the last control messages of a module as saved in an older epoch
+    extern LAST_CONTROL_MESSAGE *lastControlMessage(unsigned long rca);
+    //!< Return the last control message of an RCA, creating it if needed
+    extern void lastControlSave(void);
+    //!< Save the control message being handled
+    extern void lastControlReturn(void);
+    //!< Return the last control message in the CAN message
+    extern unsigned int lastControlFootprint(void);
+    //!< Bytes taken by the store once allocated
+
+#endif /* _LASTCONTROL_H */
@@ -12,7 +12,9 @@
 
 #include "error.h"
 #include "frontend.h"
+#include "lastControl.h"
 #include "biasSerialInterface.h"
+#include "controlElision.h"
 #include "debug.h"
 
 /* Globals */
@@ -66,9 +68,13 @@ static void enableHandler(void){
 
     /* If it's a control message (size !=0) */
     if(CAN_SIZE){
+        /* Skip the command if the LNA is already in the same state */
+        if(controlElide()){
+            return;
+        }
+
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].polarization[currentBiasModule].
-                                      sideband[currentPolarizationModule].lna.lastEnable)
+        SAVE_LAST_CONTROL_MESSAGE()
 
         // If we are in STANDBY2 mode, return HARDW_BLKD_ERR
         if (frontend.
@@ -76,8 +82,7 @@ static void enableHandler(void){
               standby2) 
         {
             /* Store the ERROR state in the last control message variable */
-            frontend.cartridge[currentModule].polarization[currentBiasModule].
-                sideband[currentPolarizationModule].lna.lastEnable.status=HARDW_BLKD_ERR;
+            CAN_LAST_CONTROL.status=HARDW_BLKD_ERR;
             return;
         }
 
@@ -85,8 +90,7 @@ static void enableHandler(void){
            message. */
         if (setLnaBiasEnable(CAN_BYTE ? LNA_BIAS_ENABLE : LNA_BIAS_DISABLE) == ERROR) {
             /* Store the ERROR state in the last control message variable */
-            frontend.cartridge[currentModule].polarization[currentBiasModule].
-                sideband[currentPolarizationModule].lna.lastEnable.status=ERROR;
+            CAN_LAST_CONTROL.status=ERROR;
             return;
         }
 
@@ -104,8 +108,7 @@ static void enableHandler(void){
     /* If it's a monitor message on a control RCA */
     if(currentClass==CONTROL_CLASS){
         // Return the last control message and status:
-        RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].polarization[currentBiasModule].
-                                        sideband[currentPolarizationModule].lna.lastEnable)
+        RETURN_LAST_CONTROL_MESSAGE()
         return;
     }
 
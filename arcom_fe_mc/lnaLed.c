@@ -13,6 +13,7 @@
 
 #include "error.h"
 #include "frontend.h"
+#include "lastControl.h"
 #include "biasSerialInterface.h"
 #include "debug.h"
 
@@ -54,11 +55,7 @@ static void enableHandler(void){
      /* If contro (size !=0) */
     if(CAN_SIZE){
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.
-                                   cartridge[currentModule].
-                                    polarization[currentBiasModule].
-                                     lnaLed.
-                                      lastEnable)
+        SAVE_LAST_CONTROL_MESSAGE()
 
         // If we are in STANDBY2 mode, return HARDW_BLKD_ERR
         if (frontend.
@@ -66,12 +63,7 @@ static void enableHandler(void){
               standby2) 
         {
             /* Store the ERROR state in the last control message variable */
-            frontend.
-             cartridge[currentModule].
-              polarization[currentBiasModule].
-               lnaLed.
-                lastEnable.
-                 status=HARDW_BLKD_ERR;
+            CAN_LAST_CONTROL.status=HARDW_BLKD_ERR;
                 
             return;
         }
@@ -81,12 +73,7 @@ static void enableHandler(void){
         if(setLnaLedEnable(CAN_BYTE?LNA_LED_ENABLE:
                                     LNA_LED_DISABLE)==ERROR){
            /* Store the ERROR state in the last control message variable */
-           frontend.
-            cartridge[currentModule].
-             polarization[currentBiasModule].
-              lnaLed.
-               lastEnable.
-                status=ERROR;
+           CAN_LAST_CONTROL.status=ERROR;
 
            return;
         }
@@ -98,11 +85,7 @@ static void enableHandler(void){
     /* If monitor on a control RCA */
     if(currentClass==CONTROL_CLASS){
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.
-                                     cartridge[currentModule].
-                                      polarization[currentBiasModule].
-                                       lnaLed.
-                                        lastEnable)
+        RETURN_LAST_CONTROL_MESSAGE()
         return;
     }
 
@@ -43,10 +43,6 @@
                         value is the one stored by the software after a control
                         command has been issued.*/
         unsigned char   enable;
-        //! Last control message: LNA led state
-        /*! This is the content of the last control message sent to the LNA led
-            state. */
-        LAST_CONTROL_MESSAGE    lastEnable;
     } LNA_LED;
 
     /* Globals */
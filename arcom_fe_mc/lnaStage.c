@@ -14,7 +14,9 @@
 #include "error.h"
 #include "can.h"
 #include "frontend.h"
+#include "lastControl.h"
 #include "biasSerialInterface.h"
+#include "controlElision.h"
 #include "debug.h"
 
 /* Globals */
@@ -62,14 +64,13 @@ static void drainVoltageHandler(void){
 
     /* If control (size !=0) */
     if(CAN_SIZE){
+        /* Skip the command if the same voltage is already applied */
+        if(controlElide()){
+            return;
+        }
+
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.
-                                   cartridge[currentModule].
-                                    polarization[currentBiasModule].
-                                     sideband[currentPolarizationModule].
-                                      lna.
-                                       stage[currentLnaModule].
-                                        lastDrainVoltage)
+        SAVE_LAST_CONTROL_MESSAGE()
 
         /* Extract the float from the can message. */
         changeEndian(CONV_CHR_ADD,
@@ -81,14 +82,7 @@ static void drainVoltageHandler(void){
               standby2) 
         {            
             /* Store the ERROR state in the last control message variable */
-            frontend.
-             cartridge[currentModule].
-              polarization[currentBiasModule].
-               sideband[currentPolarizationModule].
-                lna.
-                 stage[currentLnaModule].
-                  lastDrainVoltage.
-                   status=HARDW_BLKD_ERR;
+            CAN_LAST_CONTROL.status=HARDW_BLKD_ERR;
             
             return;
         }
@@ -97,14 +91,7 @@ static void drainVoltageHandler(void){
            then return. */
         if(setLnaStage()==ERROR){
             /* Store the ERROR state in the last control message varibale */
-            frontend.
-             cartridge[currentModule].
-              polarization[currentBiasModule].
-               sideband[currentPolarizationModule].
-                lna.
-                 stage[currentLnaModule].
-                  lastDrainVoltage.
-                   status=ERROR;
+            CAN_LAST_CONTROL.status=ERROR;
 
             return;
         }
@@ -116,13 +103,7 @@ static void drainVoltageHandler(void){
     /* If monitor on control RCA */
     if(currentClass==CONTROL_CLASS){
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.
-                                     cartridge[currentModule].
-                                      polarization[currentBiasModule].
-                                       sideband[currentPolarizationModule].
-                                        lna.
-                                         stage[currentLnaModule].
-                                          lastDrainVoltage)
+        RETURN_LAST_CONTROL_MESSAGE()
         return;
     }
 
@@ -173,14 +154,13 @@ static void drainCurrentHandler(void){
 
     /* If control (size !=0) */
     if(CAN_SIZE){
+        /* Skip the command if the same current is already applied */
+        if(controlElide()){
+            return;
+        }
+
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.
-                                   cartridge[currentModule].
-                                    polarization[currentBiasModule].
-                                     sideband[currentPolarizationModule].
-                                      lna.
-                                       stage[currentLnaModule].
-                                        lastDrainCurrent)
+        SAVE_LAST_CONTROL_MESSAGE()
 
         /* Extract the float from the can message. */
         changeEndian(CONV_CHR_ADD,
@@ -192,14 +172,7 @@ static void drainCurrentHandler(void){
               standby2) 
         {
             /* Store the ERROR state in the last control message variable */
-            frontend.
-             cartridge[currentModule].
-              polarization[currentBiasModule].
-               sideband[currentPolarizationModule].
-                lna.
-                 stage[currentLnaModule].
-                  lastDrainCurrent.
-                   status=HARDW_BLKD_ERR;
+            CAN_LAST_CONTROL.status=HARDW_BLKD_ERR;
             
             return;
         }
@@ -207,14 +180,7 @@ static void drainCurrentHandler(void){
            return the error state then return. */
         if(setLnaStage()==ERROR){
             /* Store the ERROR state in the last control message varibale */
-            frontend.
-             cartridge[currentModule].
-              polarization[currentBiasModule].
-               sideband[currentPolarizationModule].
-                lna.
-                 stage[currentLnaModule].
-                  lastDrainCurrent.
-                   status=ERROR;
+            CAN_LAST_CONTROL.status=ERROR;
 
             return;
         }
@@ -226,13 +192,7 @@ static void drainCurrentHandler(void){
     /* If monitor on control RCA */
     if(currentClass==CONTROL_CLASS){ // If monitor on a control RCA
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.
-                                     cartridge[currentModule].
-                                      polarization[currentBiasModule].
-                                       sideband[currentPolarizationModule].
-                                        lna.
-                                         stage[currentLnaModule].
-                                          lastDrainCurrent)
+        RETURN_LAST_CONTROL_MESSAGE()
         return;
     }
 
@@ -7,16 +7,21 @@
     This file contains all the functions necessary to handle LO events. */
 
 /* Includes */
-#include <stdlib.h>     /* malloc */
+#include <stdlib.h>     /* atof, atoi */
 #include <stdio.h>      /* printf & sscanf */
 #include <string.h>     /* memset & strtok */
 
 #include "error.h"
+#include "memoryUsage.h"
 #include "frontend.h"
+#include "lastControl.h"
 #include "debug.h"
 #include "serialInterface.h"
 #include "loSerialInterface.h"
 #include "iniWrapper.h"
+#include "configImage.h"
+#include "startupProfile.h"
+#include "handlerContext.h"
 
 /* Globals */
 /* Externs */
@@ -112,7 +117,7 @@ int loInit(void){
         - \ref NO_ERROR -> if no error occurred
         - \ref ERROR    -> if something wrong happened */
 int loZeroPaDrainVoltage(void) {
-    unsigned char *lastCommandData;
+    LAST_CONTROL_MESSAGE *lastCommand;
 
     /* Set the PA's drain voltage to 0. The mapping from channel to actual
        polarization is not relevant since we are zeroing all of them. */
@@ -133,12 +138,12 @@ int loZeroPaDrainVoltage(void) {
         return ERROR;
     }
 
-    // make a pointer to the data word in the last commanded PA drain voltage:
-    lastCommandData = &(frontend.cartridge[currentModule].lo.pa.paChannel[currentPaModule].
-                            lastDrainVoltage.data);
+    // find the last commanded PA drain voltage, if it was ever commanded:
+    lastCommand = lastControlFind(PA_CHANNEL_DRAIN_VOLTAGE_RCA(currentModule, currentPaModule));
 
     // save the zero we just sent as the last commanded value:
-    changeEndian(lastCommandData, CONV_CHR_ADD);
+    if (lastCommand != NULL)
+        changeEndian((*lastCommand).data, CONV_CHR_ADD);
 
     #ifdef DEBUG_INIT
         printf("       done!\n"); // Channel A
@@ -154,12 +159,12 @@ int loZeroPaDrainVoltage(void) {
         return ERROR;
     }
 
-    // make a pointer to the data word in the last commanded PA drain voltage:
-    lastCommandData = &(frontend.cartridge[currentModule].lo.pa.paChannel[currentPaModule].
-                            lastDrainVoltage.data);
+    // find the last commanded PA drain voltage, if it was ever commanded:
+    lastCommand = lastControlFind(PA_CHANNEL_DRAIN_VOLTAGE_RCA(currentModule, currentPaModule));
 
     // save the zero we just sent as the last commanded value:
-    changeEndian(lastCommandData, CONV_CHR_ADD);
+    if (lastCommand != NULL)
+        changeEndian((*lastCommand).data, CONV_CHR_ADD);
 
     #ifdef DEBUG_INIT
         printf("       done!\n"); // Channel B
@@ -242,6 +247,7 @@ int loZeroYtoCoarseTuning(void) {
         - \ref ERROR    -> if something wrong happened */
 int loStartup(void) {
     CFG_STRUCT dataIn;
+    unsigned char phase;
 
     #ifdef DEBUG_STARTUP
         printf(" LO %d configuration file: %s\n",
@@ -262,24 +268,29 @@ int loStartup(void) {
         printf("    done!\n"); // PLL loop bandwidth
     #endif /* DEBUG_STARTUP */
     
-    /* Read hasTeledynePA from configuration file. */
-    frontend.cartridge[currentModule].lo.pa.hasTeledynePa = 0;
-    dataIn.Name = LO_PA_TELEDYNE_KEY;
-    dataIn.VarType = Cfg_Boolean;
-    dataIn.DataPtr = &frontend.cartridge[currentModule].lo.pa.hasTeledynePa;
-    ReadCfg(frontend.cartridge[currentModule].lo.configFile, LO_PA_SECTION, &dataIn);
-
-    frontend.cartridge[currentModule].lo.pa.teledyneCollectorByte[0] = 255;
-    dataIn.Name = LO_PA_TELEDYNE_COLL_POL0;
-    dataIn.VarType = Cfg_Byte;
-    dataIn.DataPtr = &frontend.cartridge[currentModule].lo.pa.teledyneCollectorByte[0];
-    ReadCfg(frontend.cartridge[currentModule].lo.configFile, LO_PA_SECTION, &dataIn);
-
-    frontend.cartridge[currentModule].lo.pa.teledyneCollectorByte[1] = 255;
-    dataIn.Name = LO_PA_TELEDYNE_COLL_POL1;
-    dataIn.VarType = Cfg_Byte;
-    dataIn.DataPtr = &frontend.cartridge[currentModule].lo.pa.teledyneCollectorByte[1];
-    ReadCfg(frontend.cartridge[currentModule].lo.configFile, LO_PA_SECTION, &dataIn);
+    /* Unless already loaded from the configuration image... */
+    if(!configImageLoaded) {
+        phase = startupProfileBegin(STARTUP_PHASE_LO_INI, currentModule);
+
+        /* Read hasTeledynePA from configuration file. */
+        frontend.cartridge[currentModule].lo.pa.hasTeledynePa = 0;
+        dataIn.Name = LO_PA_TELEDYNE_KEY;
+        dataIn.VarType = Cfg_Boolean;
+        dataIn.DataPtr = &frontend.cartridge[currentModule].lo.pa.hasTeledynePa;
+        ReadCfg(frontend.cartridge[currentModule].lo.configFile, LO_PA_SECTION, &dataIn);
+
+        frontend.cartridge[currentModule].lo.pa.teledyneCollectorByte[0] = 255;
+        dataIn.Name = LO_PA_TELEDYNE_COLL_POL0;
+        dataIn.VarType = Cfg_Byte;
+        dataIn.DataPtr = &frontend.cartridge[currentModule].lo.pa.teledyneCollectorByte[0];
+        ReadCfg(frontend.cartridge[currentModule].lo.configFile, LO_PA_SECTION, &dataIn);
+
+        frontend.cartridge[currentModule].lo.pa.teledyneCollectorByte[1] = 255;
+        dataIn.Name = LO_PA_TELEDYNE_COLL_POL1;
+        dataIn.VarType = Cfg_Byte;
+        dataIn.DataPtr = &frontend.cartridge[currentModule].lo.pa.teledyneCollectorByte[1];
+        ReadCfg(frontend.cartridge[currentModule].lo.configFile, LO_PA_SECTION, &dataIn);
+    }
 
     #ifdef DEBUG_STARTUP
         printf("  - Teledyne PA=%d\n", frontend.cartridge[currentModule].lo.pa.hasTeledynePA);
@@ -291,14 +302,18 @@ int loStartup(void) {
         printf("    - Loading max safe power limits\n");
     #endif
 
-    frontend.cartridge[currentModule].lo.maxSafeLoPaTable = NULL;
-    frontend.cartridge[currentModule].lo.maxSafeLoPaTableSize = 0;
-    frontend.cartridge[currentModule].lo.allocatedLoPaTableSize = 0;
-    #ifdef DEBUG_PA_LIMITS
-        printf("maxSafeLoPaTable reset for band %d\n", currentModule + 1);
-    #endif
+    /* Unless already loaded from the configuration image... */
+    if(!configImageLoaded) {
+        frontend.cartridge[currentModule].lo.maxSafeLoPaTable = NULL;
+        frontend.cartridge[currentModule].lo.maxSafeLoPaTableSize = 0;
+        frontend.cartridge[currentModule].lo.allocatedLoPaTableSize = 0;
+        #ifdef DEBUG_PA_LIMITS
+            printf("maxSafeLoPaTable reset for band %d\n", currentModule + 1);
+        #endif
 
-    loLoadPaLimitsTable(currentModule);
+        loLoadPaLimitsTable(currentModule);
+        startupProfileEnd(phase);
+    }
 
     #ifdef DEBUG_STARTUP
         printf("      done!\n"); // max safe power
@@ -360,7 +375,7 @@ int loResetPaLimitsTable(unsigned char band) {
                 frontend.cartridge[band].lo.maxSafeLoPaTableSize,
                 frontend.cartridge[band].lo.allocatedLoPaTableSize);
     #endif
-    free (frontend.cartridge[band].lo.maxSafeLoPaTable);
+    memoryFree(MEMORY_LO_PA_LIMITS, frontend.cartridge[band].lo.maxSafeLoPaTable);
     frontend.cartridge[band].lo.maxSafeLoPaTable = NULL;
     frontend.cartridge[band].lo.maxSafeLoPaTableSize = 0;
     frontend.cartridge[band].lo.allocatedLoPaTableSize = 0;
@@ -403,7 +418,7 @@ void loLoadPaLimitsTable(unsigned char band) {
     /* Allocate the max safe LO PA entries table. */
     if (tableSize > 0) {
         frontend.cartridge[band].lo.maxSafeLoPaTable = 
-            (MAX_SAFE_LO_PA_ENTRY *) malloc(tableSize * sizeof(MAX_SAFE_LO_PA_ENTRY));
+            (MAX_SAFE_LO_PA_ENTRY *) memoryAlloc(MEMORY_LO_PA_LIMITS, tableSize * sizeof(MAX_SAFE_LO_PA_ENTRY));
         
         /* if allocation succeeeded... */
         if (!frontend.cartridge[band].lo.maxSafeLoPaTable) {
@@ -559,7 +574,7 @@ int loAddPaLimitsEntry(unsigned char band, unsigned char pol, unsigned int ytoTu
 
     // Check for empty table:
     if (!table) {
-        table = (MAX_SAFE_LO_PA_ENTRY *) malloc(allocSize * sizeof(MAX_SAFE_LO_PA_ENTRY));
+        table = (MAX_SAFE_LO_PA_ENTRY *) memoryAlloc(MEMORY_LO_PA_LIMITS, allocSize * sizeof(MAX_SAFE_LO_PA_ENTRY));
         if (!table) {
             storeError(ERR_LO, ERC_NO_MEMORY);
             loResetPaLimitsTable(band);
@@ -604,7 +619,7 @@ int loAddPaLimitsEntry(unsigned char band, unsigned char pol, unsigned int ytoTu
             if (tableSize == allocatedSize) {
                 // yes.  Alocate a table larger by allocSize:
                 allocatedSize += allocSize;
-                table = (MAX_SAFE_LO_PA_ENTRY *) malloc(allocatedSize * sizeof(MAX_SAFE_LO_PA_ENTRY));
+                table = (MAX_SAFE_LO_PA_ENTRY *) memoryAlloc(MEMORY_LO_PA_LIMITS, allocatedSize * sizeof(MAX_SAFE_LO_PA_ENTRY));
                 if (!table) {
                     storeError(ERR_LO, ERC_NO_MEMORY);
                     loResetPaLimitsTable(band);
@@ -615,7 +630,7 @@ int loAddPaLimitsEntry(unsigned char band, unsigned char pol, unsigned int ytoTu
                 // Copy the old table to the front of the new:
                 memcpy(table, frontend.cartridge[band].lo.maxSafeLoPaTable, tableSize * sizeof(MAX_SAFE_LO_PA_ENTRY));
                 // Free the old table and store the new:
-                free(frontend.cartridge[band].lo.maxSafeLoPaTable);
+                memoryFree(MEMORY_LO_PA_LIMITS, frontend.cartridge[band].lo.maxSafeLoPaTable);
                 frontend.cartridge[band].lo.maxSafeLoPaTable = table;
                 // Update the allocated size:
                 frontend.cartridge[band].lo.allocatedLoPaTableSize = allocatedSize;
@@ -820,9 +835,9 @@ int limitSafePaDrainVoltage(unsigned char paModule) {
 int limitSafeYtoTuning(){
     MAX_SAFE_LO_PA_ENTRY *entry;
     unsigned int yto = CONV_UINT(0);
-    long int backup = CONV_LONGINT;     // backup copy of the conversion buffer
+    HANDLER_CONTEXT context;            // addressing of the YTO request being handled
     float vd0, vd1;
-    unsigned char *lastCommandData;
+    LAST_CONTROL_MESSAGE *lastCommand;
     int ret0 = NO_ERROR;
     int ret1 = NO_ERROR;
     
@@ -839,27 +854,28 @@ int limitSafeYtoTuning(){
         return NO_ERROR;
     }
 
-    // make a pointer to the data word in the last commanded Pol0 PA drain voltage:
+    // the PA channels are addressed below on behalf of the YTO request:
+    handlerContextSave(&context);
+
+    // find the last commanded Pol0 PA drain voltage, zero if never commanded:
     currentPaModule=PA_CHANNEL_A;
-    lastCommandData = &(frontend.
-                         cartridge[currentModule].
-                          lo.
-                           pa.
-                            paChannel[currentPaChannel()].
-                             lastDrainVoltage.
-                              data);
+    lastCommand = lastControlFind(PA_CHANNEL_DRAIN_VOLTAGE_RCA(currentModule,
+                                                               currentPaModule));
 
     // get the last commanded setting:
-    changeEndian(CONV_CHR_ADD, lastCommandData);
-    vd0 = CONV_FLOAT;
+    vd0 = 0.0;
+    if (lastCommand != NULL) {
+        changeEndian(CONV_CHR_ADD, (*lastCommand).data);
+        vd0 = CONV_FLOAT;
+    }
     
     // if we are about to exceed the max pol0 VD at the new yto tuning...
-    if (vd0 > (*entry).maxVD0) {
+    if (lastCommand != NULL && vd0 > (*entry).maxVD0) {
         // use the max setting instead:
         CONV_FLOAT=(*entry).maxVD0;
 
         // save it back as the last commanded value
-        changeEndian(lastCommandData, CONV_CHR_ADD);
+        changeEndian((*lastCommand).data, CONV_CHR_ADD);
 
         // send the command to reduce the LO PA drain voltage:
         currentPaChannelModule=PA_CHANNEL_DRAIN_VOLTAGE;
@@ -869,27 +885,25 @@ int limitSafeYtoTuning(){
             ret0 = HARDW_BLKD_ERR;
     }
 
-    // make a pointer to the data word in the last commanded Pol1 PA drain voltage:
+    // find the last commanded Pol1 PA drain voltage, zero if never commanded:
     currentPaModule=PA_CHANNEL_B;
-    lastCommandData = &(frontend.
-                         cartridge[currentModule].
-                          lo.
-                           pa.
-                            paChannel[currentPaChannel()].
-                             lastDrainVoltage.
-                              data);
+    lastCommand = lastControlFind(PA_CHANNEL_DRAIN_VOLTAGE_RCA(currentModule,
+                                                               currentPaModule));
 
     // get the last commanded setting:
-    changeEndian(CONV_CHR_ADD, lastCommandData);
-    vd1 = CONV_FLOAT;
+    vd1 = 0.0;
+    if (lastCommand != NULL) {
+        changeEndian(CONV_CHR_ADD, (*lastCommand).data);
+        vd1 = CONV_FLOAT;
+    }
 
     // if we are about to exceed the max pol0 VD at the new yto tuning...
-    if (vd1 > (*entry).maxVD1) {
+    if (lastCommand != NULL && vd1 > (*entry).maxVD1) {
         // use the max setting instead:
         CONV_FLOAT=(*entry).maxVD1;
 
         // save it back as the last commanded value
-        changeEndian(lastCommandData, CONV_CHR_ADD);
+        changeEndian((*lastCommand).data, CONV_CHR_ADD);
 
         // send the command to reduce the LO PA drain voltage:
         currentPaChannelModule=PA_CHANNEL_DRAIN_VOLTAGE;
@@ -903,8 +917,8 @@ int limitSafeYtoTuning(){
         printf("maxVD0=%.2f maxVD1=%.2f vd0=%.2f vd1=%.2f\n", (*entry).maxVD0, (*entry).maxVD1, vd0, vd1);
     #endif
 
-    // restore the conversion buffer to its prior state:
-    CONV_LONGINT = backup;
+    // restore the conversion buffer and the addressing to their prior state:
+    handlerContextRestore(&context);
 
     // return any error which was seen:
     if (ret0 == ERROR || ret1 == ERROR)
@@ -0,0 +1,281 @@
+/*! \file   loLock.c
+    \brief  On-board LO lock engine
+
+    See loLock.h for a description of the lock sequence.
+*/
+
+/* Includes */
+#include <math.h>       /* fabs */
+#include <stdio.h>      /* printf */
+
+#include "loLock.h"
+#include "frontend.h"
+#include "loSerialInterface.h"
+#include "handlerContext.h"
+#include "timer.h"
+#include "error.h"
+#include "debug.h"
+#include "globalDefinitions.h"
+
+/* Globals */
+LO_LOCK loLock = {LO_LOCK_IDLE,
+                  0,
+                  0,
+                  0,
+                  1,
+                  0,
+                  LO_LOCK_DEFAULT_SETTLE_TIME,
+                  0.1 * LO_LOCK_DEFAULT_WINDOW,
+                  0,
+                  0.0};
+
+/* Statics */
+static enum {
+    LO_LOCK_PHASE_SETUP,        // Set the loop and null the integrator
+    LO_LOCK_PHASE_TUNE,         // Set the YTO for the next search step
+    LO_LOCK_PHASE_DETECT,       // Read the lock detect voltage, integrator nulled
+    LO_LOCK_PHASE_CHECK,        // Read the lock detect voltage, integrator operating
+    LO_LOCK_PHASE_CORRECTION    // Read the correction voltage and center it
+} lockPhase = LO_LOCK_PHASE_SETUP;
+static signed char centerDirection;     // YTO counts per centering step, 0 before the first
+static unsigned char centerSteps;       // Centering steps done
+static float lastCorrection;            // |correction voltage| before the last centering step
+
+/*! Start a lock sequence.
+    The sequence in progress, if any, is abandoned.
+    \param band         cartridge 0-9 to lock
+    \param *settings    the 8 bytes SET_LO_LOCK payload, see loLock.h
+    \return
+        - \ref NO_ERROR -> if no error occurred
+        - \ref ERROR    -> if something wrong happened */
+int loLockStart(unsigned char band, const unsigned char *settings) {
+    unsigned int ytoLow = ((unsigned int) settings[0] << 8) | settings[1];
+    unsigned int ytoHigh = ((unsigned int) settings[2] << 8) | settings[3];
+
+    if (ytoLow > ytoHigh || ytoHigh > YTO_COARSE_SET_MAX) {
+        storeError(ERR_LO_LOCK, ERC_COMMAND_VAL); // YTO search range out of range
+        return ERROR;
+    }
+
+    if (frontend.cartridge[band].available == UNAVAILABLE) {
+        storeError(ERR_LO_LOCK, ERC_MODULE_ABSENT); // Cartridge not installed
+        return ERROR;
+    }
+
+    if (frontend.cartridge[band].state != CARTRIDGE_READY) {
+        storeError(ERR_LO_LOCK, ERC_MODULE_POWER); // Cartridge not powered or not initialized
+        return ERROR;
+    }
+
+    stopAsyncTimer(TIMER_LO_LOCK);
+
+    loLock.band = band;
+    loLock.ytoLow = ytoLow;
+    loLock.ytoHigh = ytoHigh;
+    loLock.ytoStep = (settings[4]) ? settings[4] : 1;
+    loLock.loopSettings = settings[5];
+    loLock.settleTime = (settings[6]) ? settings[6] : LO_LOCK_DEFAULT_SETTLE_TIME;
+    loLock.window = 0.1 * ((settings[7]) ? settings[7] : LO_LOCK_DEFAULT_WINDOW);
+    loLock.yto = ytoLow;
+    loLock.correctionVoltage = FLOAT_UNINIT;
+
+    lockPhase = LO_LOCK_PHASE_SETUP;
+    loLock.state = LO_LOCK_SEARCHING;
+
+    #ifdef DEBUG_LO_LOCK
+        printf("LO lock: band %d, YTO %u-%u step %d\n", band + 1, ytoLow, ytoHigh, loLock.ytoStep);
+    #endif /* DEBUG_LO_LOCK */
+
+    return NO_ERROR;
+}
+
+/*! Stop the lock sequence in progress.
+    The YTO and the loop are left as they are. */
+void loLockAbort(void) {
+    if (loLock.state != LO_LOCK_SEARCHING
+        && loLock.state != LO_LOCK_ACQUIRING
+        && loLock.state != LO_LOCK_CENTERING)
+        return;
+
+    stopAsyncTimer(TIMER_LO_LOCK);
+    loLock.state = LO_LOCK_ABORTED;
+}
+
+/*! Run one step of the lock sequence.
+    This is called at every pass of the async loop.  Nothing is done while
+    the hardware settles after a YTO step. */
+void loLockAsync(void) {
+    HANDLER_CONTEXT context;
+    int ret;
+
+    if (loLock.state != LO_LOCK_SEARCHING
+        && loLock.state != LO_LOCK_ACQUIRING
+        && loLock.state != LO_LOCK_CENTERING)
+        return;
+
+    // The cartridge was turned off in the meantime:
+    if (frontend.cartridge[loLock.band].state != CARTRIDGE_READY) {
+        stopAsyncTimer(TIMER_LO_LOCK);
+        loLock.state = LO_LOCK_ABORTED;
+        return;
+    }
+
+    if (queryAsyncTimer(TIMER_LO_LOCK) == TIMER_RUNNING)
+        return;
+
+    // Address the band being locked without disturbing the other async functions:
+    handlerContextSave(&context);
+    currentModule = loLock.band;
+    ret = loLockStep();
+    handlerContextRestore(&context);
+
+    if (ret == ERROR) {
+        storeError(ERR_LO_LOCK, ERC_HARDWARE_ERROR); // Hardware error during the lock sequence
+        stopAsyncTimer(TIMER_LO_LOCK);
+        loLock.state = LO_LOCK_FAILED;
+    }
+}
+
+/* Perform the hardware operation of the current phase */
+static int loLockStep(void) {
+    float lockDetect;
+
+    switch (lockPhase) {
+        case LO_LOCK_PHASE_SETUP:
+            if (setLoopBandwidthSelect((loLock.loopSettings & LO_LOCK_ALTERNATE_BANDWIDTH) ?
+                                            PLL_LOOP_BANDWIDTH_ALTERNATE : PLL_LOOP_BANDWIDTH_DEFAULT) == ERROR)
+                return ERROR;
+            if (setSidebandLockPolaritySelect((loLock.loopSettings & LO_LOCK_USB_POLARITY) ?
+                                                PLL_SIDEBAND_LOCK_POLARITY_USB : PLL_SIDEBAND_LOCK_POLARITY_LSB) == ERROR)
+                return ERROR;
+            if (setNullLoopIntegrator(PLL_NULL_LOOP_INTEGRATOR_NULL) == ERROR)
+                return ERROR;
+            lockPhase = LO_LOCK_PHASE_TUNE;
+            break;
+
+        case LO_LOCK_PHASE_TUNE:
+            if (loLockSetYto(loLock.yto) == ERROR)
+                return ERROR;
+            lockPhase = LO_LOCK_PHASE_DETECT;
+            break;
+
+        case LO_LOCK_PHASE_DETECT:
+            if (getPll(PLL_LOCK_DETECT_VOLTAGE) == ERROR)
+                return ERROR;
+            lockDetect = frontend.cartridge[loLock.band].lo.pll.lockDetectVoltage;
+
+            if (lockDetect < LO_LOCK_DETECT_THRESHOLD) {
+                loLockNextSearchStep();
+                break;
+            }
+
+            #ifdef DEBUG_LO_LOCK
+                printf("LO lock: lock detect %.2fV at YTO %u\n", lockDetect, loLock.yto);
+            #endif /* DEBUG_LO_LOCK */
+
+            // Close the loop and give it the settle time to pull in:
+            if (setNullLoopIntegrator(PLL_NULL_LOOP_INTEGRATOR_OPERATE) == ERROR)
+                return ERROR;
+            startAsyncTimer(TIMER_LO_LOCK, loLock.settleTime, FALSE);
+            centerDirection = 0;
+            centerSteps = 0;
+            loLock.state = LO_LOCK_ACQUIRING;
+            lockPhase = LO_LOCK_PHASE_CHECK;
+            break;
+
+        case LO_LOCK_PHASE_CHECK:
+            if (getPll(PLL_LOCK_DETECT_VOLTAGE) == ERROR)
+                return ERROR;
+            lockDetect = frontend.cartridge[loLock.band].lo.pll.lockDetectVoltage;
+
+            if (lockDetect < LO_LOCK_DETECT_THRESHOLD) {
+                // The lock didn't hold.  Open the loop and keep searching:
+                if (setNullLoopIntegrator(PLL_NULL_LOOP_INTEGRATOR_NULL) == ERROR)
+                    return ERROR;
+                loLock.state = LO_LOCK_SEARCHING;
+                loLockNextSearchStep();
+                break;
+            }
+            lockPhase = LO_LOCK_PHASE_CORRECTION;
+            break;
+
+        case LO_LOCK_PHASE_CORRECTION:
+            if (getPll(PLL_CORRECTION_VOLTAGE) == ERROR)
+                return ERROR;
+            loLock.correctionVoltage = frontend.cartridge[loLock.band].lo.pll.correctionVoltage;
+
+            // Centered, or as centered as the range allows:
+            if (fabs(loLock.correctionVoltage) > loLock.window && centerSteps < LO_LOCK_CENTER_STEPS) {
+                // Move the YTO against the correction.  Reverse if that made it worse:
+                if (centerDirection == 0)
+                    centerDirection = (loLock.correctionVoltage > 0.0) ? 1 : -1;
+                else if (fabs(loLock.correctionVoltage) > lastCorrection)
+                    centerDirection = -centerDirection;
+                lastCorrection = fabs(loLock.correctionVoltage);
+
+                if ((centerDirection > 0 && loLock.yto < loLock.ytoHigh)
+                    || (centerDirection < 0 && loLock.yto > loLock.ytoLow))
+                {
+                    if (loLockSetYto(loLock.yto + centerDirection) == ERROR)
+                        return ERROR;
+                    centerSteps++;
+                    loLock.state = LO_LOCK_CENTERING;
+                    lockPhase = LO_LOCK_PHASE_CHECK;
+                    break;
+                }
+            }
+
+            // Start monitoring the lock from here:
+            if (setClearUnlockDetectLatch() == ERROR)
+                return ERROR;
+            loLock.state = LO_LOCK_LOCKED;
+
+            #ifdef DEBUG_LO_LOCK
+                printf("LO lock: locked at YTO %u, correction %.2fV\n", loLock.yto, loLock.correctionVoltage);
+            #endif /* DEBUG_LO_LOCK */
+            break;
+
+        default:
+            return ERROR;
+            break;
+    }
+
+    return NO_ERROR;
+}
+
+/* Tune the YTO the way a YTO coarse tune control does and wait for it to settle */
+static int loLockSetYto(unsigned int yto) {
+    int ret;
+
+    // If not in TROUBLESHOOTING mode, check that the LO PA setting is safe for the new YTO tuning:
+    CONV_UINT(0) = yto;
+    if (frontend.mode != TROUBLESHOOTING_MODE) {
+        ret = limitSafeYtoTuning();
+        if (ret == ERROR)
+            return ERROR;
+        if (ret == HARDW_BLKD_ERR)
+            storeError(ERR_YTO, ERC_HARDWARE_BLOCKED); //LO PA drain voltages were limited before YTO tuning
+    }
+
+    if (setYtoCoarseTune() == ERROR)
+        return ERROR;
+
+    loLock.yto = yto;
+    startAsyncTimer(TIMER_LO_LOCK, loLock.settleTime, FALSE);
+
+    return NO_ERROR;
+}
+
+/* Move the search to the next YTO step or give up at the end of the range */
+static void loLockNextSearchStep(void) {
+    if (loLock.ytoHigh - loLock.yto < loLock.ytoStep) {
+        #ifdef DEBUG_LO_LOCK
+            printf("LO lock: no lock in YTO %u-%u\n", loLock.ytoLow, loLock.ytoHigh);
+        #endif /* DEBUG_LO_LOCK */
+        loLock.state = LO_LOCK_FAILED;
+        return;
+    }
+
+    loLock.yto += loLock.ytoStep;
+    lockPhase = LO_LOCK_PHASE_TUNE;
+}
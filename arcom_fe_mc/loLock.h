@@ -0,0 +1,84 @@
+/*! \file   loLock.h
+    \brief  On-board LO lock engine
+
+    The lock engine locks the PLL of one WCA without the CAN ping-pong of
+    the lock sequence.  It is started by the SET_LO_LOCK special control RCA
+    of the band and runs one hardware operation per pass of the async loop:
+        -# set the loop bandwidth and sideband lock polarity, clear the
+           unlock detect latch and null the loop integrator
+        -# step the YTO coarse tune through the requested range, waiting the
+           settle time at each step, until the lock detect voltage rises
+           above \ref LO_LOCK_DETECT_THRESHOLD
+        -# let the loop integrator operate and check that the lock holds,
+           otherwise null it again and resume the search
+        -# center the correction voltage within the requested window by
+           moving the YTO one count at the time
+    Every YTO step goes through limitSafeYtoTuning(), as a YTO coarse tune
+    control does, unless the front end is in troubleshooting mode.
+
+    SET_LO_LOCK payload:
+        - bytes 0-1:    lowest YTO coarse tune of the search
+        - bytes 2-3:    highest YTO coarse tune of the search
+        - byte 4:       YTO counts per search step, 0 for 1
+        - byte 5:       bit 0 alternate loop bandwidth, bit 1 USB lock polarity
+        - byte 6:       settle time in ms after each YTO step, 0 for the default
+        - byte 7:       correction voltage window in 0.1V, 0 for the default
+
+    Progress and result are returned by GET_LO_LOCK_STATE: state, band,
+    current YTO coarse tune and last correction voltage. */
+
+#ifndef _LOLOCK_H
+    #define _LOLOCK_H
+
+    /* Defines */
+    #define LO_LOCK_DETECT_THRESHOLD        3.0     //!< V. Lock detect voltage of a locked PLL
+    #define LO_LOCK_DEFAULT_SETTLE_TIME     10      //!< ms
+    #define LO_LOCK_DEFAULT_WINDOW          5       //!< 0.1V
+    #define LO_LOCK_CENTER_STEPS            32      //!< Most YTO counts moved while centering
+
+    /* Lock state */
+    #define LO_LOCK_IDLE                    0       //!< Never started
+    #define LO_LOCK_SEARCHING               1       //!< Stepping the YTO, integrator nulled
+    #define LO_LOCK_ACQUIRING               2       //!< Lock detected, integrator operating
+    #define LO_LOCK_CENTERING               3       //!< Locked, centering the correction voltage
+    #define LO_LOCK_LOCKED                  4       //!< Done: the PLL is locked
+    #define LO_LOCK_FAILED                  5       //!< Done: no lock in the range or hardware error
+    #define LO_LOCK_ABORTED                 6       //!< Done: stopped by SET_LO_LOCK_ABORT or the cartridge went off
+
+    /* Loop settings */
+    #define LO_LOCK_ALTERNATE_BANDWIDTH     0x01    //!< Byte 5 bit: alternate loop bandwidth
+    #define LO_LOCK_USB_POLARITY            0x02    //!< Byte 5 bit: USB sideband lock polarity
+
+    /* Typedefs */
+    //! Lock engine setup and state
+    typedef struct {
+        unsigned char   state;              //!< One of the LO_LOCK_* states
+        unsigned char   band;               //!< Cartridge 0-9 being locked
+        unsigned int    ytoLow;             //!< Lowest YTO coarse tune of the search
+        unsigned int    ytoHigh;            //!< Highest YTO coarse tune of the search
+        unsigned char   ytoStep;            //!< YTO counts per search step
+        unsigned char   loopSettings;       //!< LO_LOCK_ALTERNATE_BANDWIDTH and LO_LOCK_USB_POLARITY bits
+        unsigned char   settleTime;         //!< ms to wait after each YTO step
+        float           window;             //!< V. Correction voltage window
+        unsigned int    yto;                //!< Current YTO coarse tune
+        float           correctionVoltage;  //!< Last correction voltage read
+    } LO_LOCK;
+
+    /* Globals */
+    /* Externs */
+    extern LO_LOCK loLock; //!< Lock engine setup and state
+
+    /* Prototypes */
+    /* Statics */
+    static int loLockStep(void);
+    static int loLockSetYto(unsigned int yto);
+    static void loLockNextSearchStep(void);
+    /* Externs */
+    extern int loLockStart(unsigned char band, const unsigned char *settings);
+    //!< Start a lock sequence
+    extern void loLockAbort(void);
+    //!< Stop the lock sequence in progress
+    extern void loLockAsync(void);
+    //!< Run one step of the lock sequence
+
+#endif /* _LOLOCK_H */
@@ -0,0 +1,256 @@
+/*! \file   loPaSweep.c
+    \brief  On-board LO PA drain voltage sweep
+
+    See loPaSweep.h for a description of the sweep.
+*/
+
+/* Includes */
+#include <math.h>       /* fabs */
+#include <stdio.h>      /* printf */
+#include <stdlib.h>     /* abs */
+
+#include "loPaSweep.h"
+#include "frontend.h"
+#include "lastControl.h"
+#include "loSerialInterface.h"
+#include "biasSerialInterface.h"
+#include "handlerContext.h"
+#include "controlElision.h"
+#include "setpointQueue.h"
+#include "timer.h"
+#include "error.h"
+#include "memoryUsage.h"
+#include "debug.h"
+#include "globalDefinitions.h"
+
+/* Globals */
+LO_PA_SWEEP loPaSweep = {LO_PA_SWEEP_IDLE,
+                         0,
+                         0,
+                         LO_PA_SWEEP_READ_SIS_SB1,
+                         0,
+                         0,
+                         LO_PA_SWEEP_DEFAULT_SETTLE,
+                         0.0,
+                         0,
+                         0,
+                         0};
+
+/* Statics */
+static LO_PA_SWEEP_POINT *buffer = NULL;    // Allocated at the first sweep
+static int limited;                         // The last step was limited by the max safe LO PA table
+static enum {
+    LO_PA_SWEEP_PHASE_SET,      // Set the drain voltage of the next step
+    LO_PA_SWEEP_PHASE_READ      // Read the response
+} sweepPhase = LO_PA_SWEEP_PHASE_SET;
+
+/*! Start a sweep.
+    The previous results are discarded.
+    \param band             cartridge 0-9
+    \param polarization     polarization 0-1
+    \param *settings        the 8 bytes SET_LO_PA_SWEEP payload, see loPaSweep.h
+    \return
+        - \ref NO_ERROR -> if no error occurred
+        - \ref ERROR    -> if something wrong happened */
+int loPaSweepStart(unsigned char band, unsigned char polarization, const unsigned char *settings) {
+    CARTRIDGE *cartridge = &frontend.cartridge[band];
+    unsigned int start = ((unsigned int) settings[0] << 8) | settings[1];
+    unsigned int stop = ((unsigned int) settings[2] << 8) | settings[3];
+    unsigned int step = ((unsigned int) settings[4] << 8) | settings[5];
+    unsigned int points;
+
+    if (start > LO_PA_SWEEP_VD_MAX || stop > LO_PA_SWEEP_VD_MAX || step == 0
+        || settings[6] >= LO_PA_SWEEP_READ_NUMBER)
+    {
+        storeError(ERR_LO_PA_SWEEP, ERC_COMMAND_VAL); // Sweep settings out of range
+        return ERROR;
+    }
+
+    points = ((stop > start) ? stop - start : start - stop) / step + 1;
+    if (points > LO_PA_SWEEP_POINTS) {
+        storeError(ERR_LO_PA_SWEEP, ERC_COMMAND_VAL); // Too many points for the result buffer
+        return ERROR;
+    }
+
+    if ((*cartridge).available == UNAVAILABLE
+        || (settings[6] != LO_PA_SWEEP_READ_PHOTOMIXER
+            && (*cartridge).polarization[polarization].sideband[settings[6]].sis.available == UNAVAILABLE))
+    {
+        storeError(ERR_LO_PA_SWEEP, ERC_MODULE_ABSENT); // Cartridge or SIS mixer not installed
+        return ERROR;
+    }
+
+    if ((*cartridge).state != CARTRIDGE_READY || (*cartridge).standby2) {
+        storeError(ERR_LO_PA_SWEEP, ERC_MODULE_POWER); // Cartridge not ready
+        return ERROR;
+    }
+
+    if (!buffer) {
+        buffer = (LO_PA_SWEEP_POINT *) memoryAlloc(MEMORY_LO_PA_SWEEP, LO_PA_SWEEP_POINTS * sizeof(LO_PA_SWEEP_POINT));
+        if (!buffer) {
+            storeError(ERR_LO_PA_SWEEP, ERC_NO_MEMORY); // Out of memory for the result buffer
+            return ERROR;
+        }
+    }
+
+    stopAsyncTimer(TIMER_LO_PA_SWEEP);
+
+    loPaSweep.band = band;
+    loPaSweep.polarization = polarization;
+    loPaSweep.response = settings[6];
+    loPaSweep.start = start;
+    loPaSweep.step = (stop < start) ? -(int) step : (int) step;
+    loPaSweep.settleTime = (settings[7]) ? settings[7] : LO_PA_SWEEP_DEFAULT_SETTLE;
+    loPaSweep.points = points;
+    loPaSweep.measured = 0;
+    loPaSweep.readIndex = 0;
+
+    sweepPhase = LO_PA_SWEEP_PHASE_SET;
+    loPaSweep.state = LO_PA_SWEEP_RUNNING;
+
+    // The sweep changes the PA behind the last control message:
+    controlEpochAdvance(band);
+    setpointQueueCancel(PA_CHANNEL_DRAIN_VOLTAGE_RCA(band, polarization));
+
+    #ifdef DEBUG_LO_PA_SWEEP
+        printf("LO PA sweep: band %d pol %d, %u to %u mV, %u points\n",
+               band + 1, polarization, start, stop, points);
+    #endif /* DEBUG_LO_PA_SWEEP */
+
+    return NO_ERROR;
+}
+
+/*! Run one step of the sweep.
+    This is called at every pass of the async loop.  Nothing is done while
+    the LO power settles after a step. */
+void loPaSweepAsync(void) {
+    HANDLER_CONTEXT context;
+    CARTRIDGE *cartridge;
+
+    if (loPaSweep.state != LO_PA_SWEEP_RUNNING)
+        return;
+
+    // The cartridge was turned off or put in STANDBY2 in the meantime:
+    cartridge = &frontend.cartridge[loPaSweep.band];
+    if ((*cartridge).state != CARTRIDGE_READY || (*cartridge).standby2) {
+        stopAsyncTimer(TIMER_LO_PA_SWEEP);
+        loPaSweep.state = LO_PA_SWEEP_FAILED;
+        return;
+    }
+
+    if (queryAsyncTimer(TIMER_LO_PA_SWEEP) == TIMER_RUNNING)
+        return;
+
+    // Address the PA channel being swept without disturbing the other async functions:
+    handlerContextSave(&context);
+    currentModule = loPaSweep.band;
+    currentPaModule = loPaSweep.polarization;
+    currentPaChannelModule = PA_CHANNEL_DRAIN_VOLTAGE;
+
+    if (loPaSweepStep() == ERROR) {
+        storeError(ERR_LO_PA_SWEEP, ERC_HARDWARE_ERROR); // Hardware error during the sweep
+        loPaSweepEnd(LO_PA_SWEEP_FAILED);
+    }
+
+    handlerContextRestore(&context);
+}
+
+/*! Read out the next measured point.
+    Points can be read while the sweep is still running.
+    \param *point   receives the point
+    \return
+        - \ref NO_ERROR -> if a point was returned
+        - \ref ERROR    -> if there is nothing left to read */
+int loPaSweepReadPoint(LO_PA_SWEEP_POINT *point) {
+    if (loPaSweep.readIndex >= loPaSweep.measured)
+        return ERROR;
+
+    *point = buffer[loPaSweep.readIndex++];
+    return NO_ERROR;
+}
+
+/* Perform the hardware operation of the current phase */
+static int loPaSweepStep(void) {
+    LAST_CONTROL_MESSAGE *lastDrainVoltage;
+    float response;
+
+    switch (sweepPhase) {
+        case LO_PA_SWEEP_PHASE_SET:
+            // The dewar might have warmed up since the last step:
+            if (paDrainVoltageAllowed() == DISABLE) {
+                storeError(ERR_PA_CHANNEL, ERC_HARDWARE_BLOCKED); //PA temperature above the allowed range -> PAs disabled
+                loPaSweepEnd(LO_PA_SWEEP_FAILED);
+                break;
+            }
+
+            // The drain voltage in V, limited to the max safe level for the current YTO tuning:
+            CONV_FLOAT = 0.001 * ((long) loPaSweep.start + (long) loPaSweep.step * loPaSweep.measured);
+            limited = (frontend.mode == TROUBLESHOOTING_MODE) ? NO_ERROR : limitSafePaDrainVoltage(currentPaModule);
+            if (limited != NO_ERROR)
+                storeError(ERR_PA_CHANNEL, ERC_HARDWARE_BLOCKED); //Attempted to set LO PA above max safe power level.
+
+            if (setPaChannel() == ERROR)
+                return ERROR;
+            buffer[loPaSweep.measured].drainVoltage = CONV_FLOAT;
+
+            // Record it as the last commanded drain voltage, as the drain voltage control does:
+            lastDrainVoltage = lastControlMessage(PA_CHANNEL_DRAIN_VOLTAGE_RCA(currentModule, currentPaModule));
+            (*lastDrainVoltage).size = CAN_FLOAT_SIZE;
+            changeEndian((*lastDrainVoltage).data, CONV_CHR_ADD);
+            (*lastDrainVoltage).status = limited;
+
+            startAsyncTimer(TIMER_LO_PA_SWEEP, loPaSweep.settleTime, FALSE);
+            sweepPhase = LO_PA_SWEEP_PHASE_READ;
+            break;
+
+        case LO_PA_SWEEP_PHASE_READ:
+            if (loPaSweepRead(&response) == ERROR)
+                return ERROR;
+            buffer[loPaSweep.measured++].response = response;
+            sweepPhase = LO_PA_SWEEP_PHASE_SET;
+
+            if (limited != NO_ERROR)
+                loPaSweepEnd(LO_PA_SWEEP_LIMITED);
+            else if (loPaSweep.target != 0.0 && fabs(response) >= fabs(loPaSweep.target))
+                loPaSweepEnd(LO_PA_SWEEP_TARGET);
+            else if (loPaSweep.measured == loPaSweep.points)
+                loPaSweepEnd(LO_PA_SWEEP_DONE);
+            break;
+
+        default:
+            return ERROR;
+            break;
+    }
+
+    return NO_ERROR;
+}
+
+/* Read the selected response of the addressed polarization */
+static int loPaSweepRead(float *response) {
+    if (loPaSweep.response == LO_PA_SWEEP_READ_PHOTOMIXER) {
+        if (getPhotomixer(PHOTOMIXER_BIAS_C) == ERROR)
+            return ERROR;
+        *response = frontend.cartridge[currentModule].lo.photomixer.current;
+        return NO_ERROR;
+    }
+
+    currentBiasModule = loPaSweep.polarization;
+    currentPolarizationModule = loPaSweep.response;
+    if (getSisMixerBias(SIS_MIXER_BIAS_CURRENT) == ERROR)
+        return ERROR;
+    *response = frontend.cartridge[currentModule].
+                 polarization[currentBiasModule].
+                  sideband[currentPolarizationModule].
+                   sis.current;
+    return NO_ERROR;
+}
+
+/* End the sweep, leaving the drain voltage at the last step */
+static void loPaSweepEnd(unsigned char state) {
+    stopAsyncTimer(TIMER_LO_PA_SWEEP);
+    loPaSweep.state = state;
+
+    #ifdef DEBUG_LO_PA_SWEEP
+        printf("LO PA sweep: done (%d), %u points\n", state, loPaSweep.measured);
+    #endif /* DEBUG_LO_PA_SWEEP */
+}
@@ -0,0 +1,99 @@
+/*! \file   loPaSweep.h
+    \brief  On-board LO PA drain voltage sweep
+
+    The PA sweep sets the LO power of one polarization without a CAN round
+    trip per step.  It is started by the SET_LO_PA_SWEEP special control RCA
+    of the band and polarization and runs from the async loop, one hardware
+    operation per pass:
+        -# set the PA drain voltage of the next step and wait the settle time
+        -# read the selected response: an SIS mixer current of the same
+           polarization or the photomixer current
+    The drain voltage goes through the same checks as the PA drain voltage
+    control: the dewar temperature and, unless the front end is in
+    troubleshooting mode, the max safe LO PA table for the current YTO
+    tuning.  The sweep stops at the first step limited by the table.
+
+    If a target current was set with SET_LO_PA_SWEEP_TARGET, the sweep also
+    stops at the first step where the magnitude of the response reaches the
+    magnitude of the target, leaving the LO power there.
+
+    SET_LO_PA_SWEEP payload, unsigned big endian integers:
+        - bytes 0-1:    start drain voltage in mV
+        - bytes 2-3:    stop drain voltage in mV
+        - bytes 4-5:    step in mV.  The sign is taken from start and stop.
+        - byte 6:       response, one of the LO_PA_SWEEP_READ_* defines
+        - byte 7:       settle time in ms after each step, 0 for the default
+
+    The drain voltage is left at the last step and stored as the last
+    commanded drain voltage.  The curve is read back, from the first step
+    to the last, through the GET_LO_PA_SWEEP_POINT special monitor RCA:
+    drain voltage and response as two big endian floats. */
+
+#ifndef _LOPASWEEP_H
+    #define _LOPASWEEP_H
+
+    /* Extra includes */
+    /* POLARIZATIONS_NUMBER */
+    #ifndef _POLARIZATION_H
+        #include "polarization.h"
+    #endif /* _POLARIZATION_H */
+
+    /* Defines */
+    #define LO_PA_SWEEP_POINTS          256     //!< Size of the result buffer
+    #define LO_PA_SWEEP_VD_MAX          2500    //!< mV. Highest drain voltage of the sweep
+    #define LO_PA_SWEEP_DEFAULT_SETTLE  20      //!< ms
+
+    /* Response */
+    #define LO_PA_SWEEP_READ_SIS_SB1    0       //!< SIS mixer current, sideband 1
+    #define LO_PA_SWEEP_READ_SIS_SB2    1       //!< SIS mixer current, sideband 2
+    #define LO_PA_SWEEP_READ_PHOTOMIXER 2       //!< Photomixer current
+    #define LO_PA_SWEEP_READ_NUMBER     3
+
+    /* Sweep state */
+    #define LO_PA_SWEEP_IDLE            0       //!< Nothing measured
+    #define LO_PA_SWEEP_RUNNING         1       //!< Sweep in progress
+    #define LO_PA_SWEEP_DONE            2       //!< Done: reached the stop voltage
+    #define LO_PA_SWEEP_TARGET          3       //!< Done: reached the target current
+    #define LO_PA_SWEEP_LIMITED         4       //!< Done: stopped by the max safe LO PA table
+    #define LO_PA_SWEEP_FAILED          5       //!< Stopped by a hardware error, a warm dewar or the cartridge going off
+
+    /* Typedefs */
+    //! One step of the response curve
+    typedef struct {
+        float   drainVoltage;   //!< V. Drain voltage set
+        float   response;       //!< mA. Current read after the settle time
+    } LO_PA_SWEEP_POINT;
+
+    //! Sweep setup and state
+    typedef struct {
+        unsigned char   state;          //!< One of the LO_PA_SWEEP_* states
+        unsigned char   band;           //!< Cartridge 0-9
+        unsigned char   polarization;   //!< Polarization 0-1
+        unsigned char   response;       //!< One of the LO_PA_SWEEP_READ_* defines
+        unsigned int    start;          //!< mV
+        int             step;           //!< mV, signed
+        unsigned char   settleTime;     //!< ms to wait after each step
+        float           target;         //!< mA. Target response, 0.0 to sweep the whole range
+        unsigned int    points;         //!< Steps in the sweep
+        unsigned int    measured;       //!< Points in the buffer
+        unsigned int    readIndex;      //!< Next point to read out
+    } LO_PA_SWEEP;
+
+    /* Globals */
+    /* Externs */
+    extern LO_PA_SWEEP loPaSweep; //!< Sweep setup and state
+
+    /* Prototypes */
+    /* Statics */
+    static int loPaSweepStep(void);
+    static int loPaSweepRead(float *response);
+    static void loPaSweepEnd(unsigned char state);
+    /* Externs */
+    extern int loPaSweepStart(unsigned char band, unsigned char polarization, const unsigned char *settings);
+    //!< Start a sweep
+    extern void loPaSweepAsync(void);
+    //!< Run one step of the sweep
+    extern int loPaSweepReadPoint(LO_PA_SWEEP_POINT *point);
+    //!< Read out the next measured point
+
+#endif /* _LOPASWEEP_H */
@@ -24,6 +24,7 @@
 #include "error.h"
 #include "loSerialInterface.h"
 #include "serialInterface.h"
+#include "serialProfile.h"
 #include "frontend.h"
 #include "timer.h"
 
@@ -38,6 +39,19 @@ static unsigned long delayCounter;
 #define DELAY(MICROSECONDS) { \
     for (delayCounter = MICROSECONDS * 5; delayCounter > 0; delayCounter--) { _asm { nop } } }
 
+/* LO analog monitor request.
+   This function profiles the analog monitor cycle below. See serialProfile.h. */
+static int getLoAnalogMonitor(void){
+
+    int ret;
+
+    serialProfileBegin(SERIAL_PROFILE_LO_ANALOG);
+    ret=getLoAnalogMonitorCycle();
+    serialProfileEnd(SERIAL_PROFILE_LO_ANALOG, ret);
+
+    return ret;
+}
+
 /* LO analog monitor request core.
    This function performs the core operations that are common to all the analog
    monitor requests for the LO module:
@@ -50,7 +64,7 @@ static unsigned long delayCounter;
 
    If an error happens during the process it will return ERROR, otherwise
    NO_ERROR will be returned. */
-static int getLoAnalogMonitor(void){
+static int getLoAnalogMonitorCycle(void){
 
     /* A temporary variable to deal with the timer. */
     int timedOut;
@@ -499,6 +499,7 @@
     /* Prototypes */
     /* Statics */
     static int getLoAnalogMonitor(void); // Perform core analog monitor functions
+    static int getLoAnalogMonitorCycle(void); // Analog monitor cycle, without the profiling
     /* Externs */
     extern int setYtoCoarseTune(void); //!< This function set the YTO coarse tune
     extern int setPhotomixerEnable(unsigned char enable); //!< This function enables/disables the photomixer
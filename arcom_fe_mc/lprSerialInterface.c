@@ -25,6 +25,7 @@
 #include "lprSerialInterface.h"
 #include "error.h"
 #include "serialInterface.h"
+#include "serialProfile.h"
 #include "timer.h"
 #include "frontend.h"
 #include "debug.h"
@@ -36,6 +37,19 @@
 LPR_REGISTERS lprRegisters;
 
 
+/* LPR analog monitor request.
+   This function profiles the analog monitor cycle below. See serialProfile.h. */
+static int getLprAnalogMonitor(void){
+
+    int ret;
+
+    serialProfileBegin(SERIAL_PROFILE_LPR_ANALOG);
+    ret=getLprAnalogMonitorCycle();
+    serialProfileEnd(SERIAL_PROFILE_LPR_ANALOG, ret);
+
+    return ret;
+}
+
 /* LPR analog monitor request core.
    This function performs the core operations that are common to all the analog
    monitor request for the LPR module:
@@ -48,7 +62,7 @@ LPR_REGISTERS lprRegisters;
 
    If an error happens during the process it will return ERROR, otherwise
    NO_ERROR will be returned. */
-static int getLprAnalogMonitor(void){
+static int getLprAnalogMonitorCycle(void){
 
     /* A temporary variable to deal with the timer. */
     int timedOut;
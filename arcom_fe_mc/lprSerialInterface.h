@@ -354,6 +354,7 @@
     /* Prototypes */
     /* Statics */
     static int getLprAnalogMonitor(void); // Perform core analog monitor functions
+    static int getLprAnalogMonitorCycle(void); // Analog monitor cycle, without the profiling
 
     /* Externs */
     extern int getLprTemp(void); //!< This function monitors the LPR temperature sensors
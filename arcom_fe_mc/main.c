@@ -16,8 +16,11 @@
 #include "pegasus.h"
 #include "console.h"
 #include "async.h"
+#include "tcpMC.h"
 #include "timer.h"
 #include "ppcomm.h"
+#include "ambsiEmulator.h"
+#include "memoryUsage.h"
 
 /* Globals */
 /* Externs */
@@ -28,6 +31,9 @@ unsigned char restart = 0; /*!< This global can be set by any module and will
                                 received. */
 
 int main(void) {
+    /* Paint the stack for the high-water mark, while it is at its shallowest */
+    memoryStackPaint();
+
     /* Print version information */
     displayVersion();
 
@@ -56,6 +62,10 @@ int main(void) {
             }
             /* Perform the required asynchronous operations */
             async();
+            /* Serve the TCP M&C clients */
+            tcpMCService();
+            /* Inject the emulated AMBSI traffic, if running */
+            ambsiEmulatorService();
         }
         /* If the software was stopped via console, don't handle the message */
         if (stop == TRUE) {
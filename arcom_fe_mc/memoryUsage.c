@@ -0,0 +1,184 @@
+/*! \file   memoryUsage.c
+    \brief  Memory usage instrumentation
+
+    See memoryUsage.h for a description of the instrumentation.
+*/
+
+/* Includes */
+#include <dos.h>        /* _dos_allocmem, _dos_freemem */
+#include <malloc.h>     /* malloc, free, _msize, _heapwalk, stackavail */
+#include <stdio.h>      /* printf */
+#include <string.h>     /* memset */
+
+#include "memoryUsage.h"
+#include "error.h"
+#include "debug.h"
+#include "globalDefinitions.h"
+
+/* Globals */
+MEMORY_ACCOUNT memoryAccount[MEMORY_ACCOUNTS_NUMBER];
+MEMORY_HEAP memoryHeap;
+MEMORY_STACK memoryStack = {0,
+                            0,
+                            0};
+
+/* Statics */
+static unsigned char *stackBottom = NULL;   // Lowest painted stack byte, NULL if not painted
+static const char *accountNames[MEMORY_ACCOUNTS_NUMBER] = {
+    "Error history",
+    "LO PA limits",
+    "Last control",
+    "Flight recorder",
+    "SIS sweep",
+    "LO PA sweep",
+    "CAN trace"
+};
+
+/*! Paint the unused stack.
+    This must be called first thing in main(), while the stack is at its
+    shallowest.  The painted bytes are the ones below the caller frame. */
+void memoryStackPaint(void) {
+    unsigned char marker;
+    unsigned char *top = &marker;   // In the stack segment with the large memory model
+    unsigned int avail = stackavail();
+    unsigned int cnt;
+
+    if (avail <= 2 * MEMORY_STACK_MARGIN)
+        return;
+
+    stackBottom = top - avail + MEMORY_STACK_MARGIN;
+    memoryStack.painted = avail - 2 * MEMORY_STACK_MARGIN;
+    for (cnt = 0; cnt < memoryStack.painted; cnt++)
+        stackBottom[cnt] = MEMORY_STACK_PATTERN;
+
+    #ifdef DEBUG_MEMORY_USAGE
+        printf("Memory usage: %u stack bytes painted\n",
+               memoryStack.painted);
+    #endif /* DEBUG_MEMORY_USAGE */
+}
+
+/*! Allocate a block for a subsystem.
+    The caller reports a failure as it did before.
+    \param account  one of the MEMORY_* accounts
+    \param size     bytes to allocate
+    \return the block, NULL if there is not enough memory */
+void *memoryAlloc(unsigned char account, unsigned int size) {
+    MEMORY_ACCOUNT *entry = &memoryAccount[account];
+    void *block = malloc(size);
+
+    if (block == NULL) {
+        entry -> failures++;
+
+        #ifdef DEBUG_MEMORY_USAGE
+            printf("Memory usage: %s, %u bytes not available\n",
+                   accountNames[account],
+                   size);
+        #endif /* DEBUG_MEMORY_USAGE */
+
+        return NULL;
+    }
+
+    entry -> bytes += _msize(block);
+    entry -> blocks++;
+    if (entry -> bytes > entry -> peak)
+        entry -> peak = entry -> bytes;
+
+    return block;
+}
+
+/*! Free a block of a subsystem.
+    \param account  the account the block was allocated for
+    \param *block   the block, NULL does nothing */
+void memoryFree(unsigned char account, void *block) {
+    MEMORY_ACCOUNT *entry = &memoryAccount[account];
+
+    if (block == NULL)
+        return;
+
+    entry -> bytes -= _msize(block);
+    entry -> blocks--;
+    free(block);
+}
+
+/*! Update the heap state in \ref memoryHeap.
+    \return
+        - \ref NO_ERROR -> if no error occurred
+        - \ref ERROR    -> if the heap is damaged */
+int memoryHeapWalk(void) {
+    struct _heapinfo entry;
+    unsigned short dosParagraphs;
+    int status;
+
+    memset(&memoryHeap, 0, sizeof(memoryHeap));
+
+    entry._pentry = NULL;
+    while ((status = _heapwalk(&entry)) == _HEAPOK) {
+        if (entry._useflag == _FREEENTRY) {
+            memoryHeap.freeBytes += entry._size;
+            memoryHeap.freeBlocks++;
+            if (entry._size > memoryHeap.largestFree)
+                memoryHeap.largestFree = entry._size;
+        } else {
+            memoryHeap.usedBytes += entry._size;
+            memoryHeap.usedBlocks++;
+        }
+    }
+
+    // A request DOS can't meet returns the largest block it has:
+    if (_dos_allocmem(0xFFFF, &dosParagraphs) == 0) {
+        _dos_freemem(dosParagraphs);
+        dosParagraphs = 0xFFFF;
+    }
+    memoryHeap.dosFree = dosParagraphs;
+
+    if (status != _HEAPEND && status != _HEAPEMPTY) {
+        storeError(ERR_MEMORY_USAGE, ERC_DEBUG_ME); // Heap damaged
+        return ERROR;
+    }
+    return NO_ERROR;
+}
+
+/*! Update the stack state in \ref memoryStack.
+    The painted bytes are scanned from the bottom up to the first one
+    overwritten. */
+void memoryStackCheck(void) {
+    unsigned int cnt = 0;
+
+    if (stackBottom != NULL) {
+        while (cnt < memoryStack.painted && stackBottom[cnt] == MEMORY_STACK_PATTERN)
+            cnt++;
+    }
+    memoryStack.leastFree = cnt;
+    memoryStack.free = stackavail();
+}
+
+/*! Print the memory usage on the console. */
+void memoryUsageReport(void) {
+    unsigned char cnt;
+
+    memoryHeapWalk();
+    memoryStackCheck();
+
+    printf("Heap: free:%lu largest free:%lu free blocks:%u fragmentation:%lu%% used:%lu in %u blocks\n",
+           memoryHeap.freeBytes,
+           memoryHeap.largestFree,
+           memoryHeap.freeBlocks,
+           (memoryHeap.freeBytes) ? 100L - 100L * memoryHeap.largestFree / memoryHeap.freeBytes : 0L,
+           memoryHeap.usedBytes,
+           memoryHeap.usedBlocks);
+    printf(" DOS memory the heap can grow into:%lu\n",
+           16L * memoryHeap.dosFree);
+    printf("Stack: painted:%u least free:%u free now:%u\n",
+           memoryStack.painted,
+           memoryStack.leastFree,
+           memoryStack.free);
+    printf("account,bytes,blocks,peak,failures\n");
+    for (cnt = 0; cnt < MEMORY_ACCOUNTS_NUMBER; cnt++) {
+        printf("%s,%lu,%u,%lu,%u\n",
+               accountNames[cnt],
+               memoryAccount[cnt].bytes,
+               memoryAccount[cnt].blocks,
+               memoryAccount[cnt].peak,
+               memoryAccount[cnt].failures);
+    }
+}
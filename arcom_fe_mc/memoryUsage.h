@@ -0,0 +1,97 @@
+/*! \file   memoryUsage.h
+    \brief  Memory usage instrumentation
+
+    The heap holds the error history, the LO PA limits tables, the last
+    control messages and the buffers of the flight recorder, the sweeps and
+    the CAN trace, some of them allocated or grown at run time.  To tell how
+    close the firmware is to running out of memory before ERC_NO_MEMORY
+    shows up:
+        - every allocation of these subsystems goes through memoryAlloc()
+          and memoryFree(), which keep the bytes and blocks held by each
+          \ref MEMORY_ACCOUNT and its peak.  The bytes are the size of the
+          heap blocks, which may be a little more than requested.
+        - memoryHeapWalk() walks the heap for the free bytes, the largest
+          free block and the number of free blocks, as a measure of the
+          fragmentation, and asks DOS how much memory the heap can still
+          grow into.
+        - the stack is painted with \ref MEMORY_STACK_PATTERN at the start
+          of main() and memoryStackCheck() finds the deepest byte ever
+          overwritten, giving the least free stack seen since startup.  The
+          \ref MEMORY_STACK_MARGIN bytes at both ends are not painted.
+
+    Monitor, through the special RCAs:
+        - GET_MEMORY_HEAP:      free bytes in the heap (3 bytes), largest free
+                                block (3 bytes), free blocks (2 bytes)
+        - GET_MEMORY_STACK:     painted stack, least free stack, free stack
+                                now, memory DOS can still give to the heap in
+                                16 bytes paragraphs (2 bytes each)
+        - GET_MEMORY_ACCOUNT:   bytes held by one account (3 bytes), blocks
+                                (2 bytes), peak bytes (3 bytes)
+
+    The 'u' console command prints all of it. */
+
+#ifndef _MEMORYUSAGE_H
+    #define _MEMORYUSAGE_H
+
+    /* Defines */
+    #define MEMORY_STACK_PATTERN    0xA5    //!< Byte painted on the unused stack
+    #define MEMORY_STACK_MARGIN     64      //!< Bytes not painted at each end of the unused stack
+
+    /* Allocation accounts */
+    #define MEMORY_ACCOUNTS_NUMBER  7       // See list below
+    #define MEMORY_ERROR_HISTORY    0       //!< Error history
+    #define MEMORY_LO_PA_LIMITS     1       //!< LO PA limits tables of all the bands
+    #define MEMORY_LAST_CONTROL     2       //!< Last control message store
+    #define MEMORY_FLIGHT_RECORDER  3       //!< Flight recorder capture buffer
+    #define MEMORY_SIS_SWEEP        4       //!< SIS I-V sweep points
+    #define MEMORY_LO_PA_SWEEP      5       //!< LO PA sweep points
+    #define MEMORY_CAN_TRACE        6       //!< CAN trace ring
+
+    /* Typedefs */
+    //! Heap held by one subsystem
+    typedef struct {
+        unsigned long   bytes;      //!< Bytes held now
+        unsigned int    blocks;     //!< Blocks held now
+        unsigned long   peak;       //!< Most bytes held at once
+        unsigned int    failures;   //!< Allocations that failed
+    } MEMORY_ACCOUNT;
+
+    //! Heap state, as of the last walk
+    typedef struct {
+        unsigned long   freeBytes;      //!< Free bytes in the heap
+        unsigned long   largestFree;    //!< Largest free block
+        unsigned int    freeBlocks;     //!< Free blocks
+        unsigned long   usedBytes;      //!< Bytes in use, by the firmware and the libraries
+        unsigned int    usedBlocks;     //!< Blocks in use
+        unsigned int    dosFree;        //!< Paragraphs DOS can still give to the heap
+    } MEMORY_HEAP;
+
+    //! Stack state
+    typedef struct {
+        unsigned int    painted;    //!< Bytes painted at startup
+        unsigned int    leastFree;  //!< Painted bytes never overwritten
+        unsigned int    free;       //!< Free bytes at the last check
+    } MEMORY_STACK;
+
+    /* Globals */
+    /* Externs */
+    extern MEMORY_ACCOUNT memoryAccount[MEMORY_ACCOUNTS_NUMBER]; //!< Heap held by each subsystem
+    extern MEMORY_HEAP memoryHeap;      //!< Heap state, as of the last walk
+    extern MEMORY_STACK memoryStack;    //!< Stack state, as of the last check
+
+    /* Prototypes */
+    /* Externs */
+    extern void memoryStackPaint(void);
+    //!< Paint the unused stack
+    extern void *memoryAlloc(unsigned char account, unsigned int size);
+    //!< Allocate a block for a subsystem
+    extern void memoryFree(unsigned char account, void *block);
+    //!< Free a block of a subsystem
+    extern int memoryHeapWalk(void);
+    //!< Update the heap state
+    extern void memoryStackCheck(void);
+    //!< Update the stack state
+    extern void memoryUsageReport(void);
+    //!< Print the memory usage on the console
+
+#endif /* _MEMORYUSAGE_H */
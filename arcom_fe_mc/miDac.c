@@ -12,6 +12,7 @@
 #include <stdio.h>      /* printf */
 
 #include "frontend.h"
+#include "lastControl.h"
 #include "error.h"
 #include "lprSerialInterface.h"
 #include "debug.h"
@@ -53,25 +54,12 @@ static void resetStrobeHandler(void){
     /* Check direction and perform the required operation */
     if(CAN_SIZE){ // If control (size !=0)
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.
-                                   lpr.
-                                    edfa.
-                                     modulationInput.
-                                      miSpecialMsgs.
-                                       miDac.
-                                        lastResetStrobe)
+        SAVE_LAST_CONTROL_MESSAGE()
 
         /* Send the strobe */
         if(setLprDacStrobe()==ERROR){
             /* Store the ERROR state in the last control message variable */
-            frontend.
-             lpr.
-              edfa.
-               modulationInput.
-                miSpecialMsgs.
-                 miDac.
-                  lastResetStrobe.
-                   status=ERROR;
+            CAN_LAST_CONTROL.status=ERROR;
 
             return;
         }
@@ -81,13 +69,7 @@ static void resetStrobeHandler(void){
     /* If it's a monitor message on a control RCA */
     if(currentClass==CONTROL_CLASS){ // If monitor on a control RCA
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.
-                                     lpr.
-                                      edfa.
-                                       modulationInput.
-                                        miSpecialMsgs.
-                                         miDac.
-                                          lastResetStrobe)
+        RETURN_LAST_CONTROL_MESSAGE()
         return;
 
     }
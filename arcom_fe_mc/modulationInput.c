@@ -13,6 +13,7 @@
 
 #include "error.h"
 #include "frontend.h"
+#include "lastControl.h"
 #include "lprSerialInterface.h"
 #include "debug.h"
 
@@ -50,6 +51,8 @@ void modulationInputHandler(void){
 
 /* EDFA modulation input value handler */
 static void valueHandler(void){
+    LAST_CONTROL_MESSAGE *lastValue;
+
     #ifdef DEBUG
         printf("    Value\n");
     #endif /* DEBUG */
@@ -57,11 +60,7 @@ static void valueHandler(void){
     /* If control (size !=0) */
     if(CAN_SIZE){
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.
-                                   lpr.
-                                    edfa.
-                                     modulationInput.
-                                      lastValue)
+        SAVE_LAST_CONTROL_MESSAGE()
 
         /* Extract the float from the can message. */
         changeEndian(CONV_CHR_ADD,
@@ -71,12 +70,7 @@ static void valueHandler(void){
            then return. */
         if(setModulationInputValue()==ERROR){
             /* Store the ERROR state in the last control message varibale */
-            frontend.
-             lpr.
-              edfa.
-               modulationInput.
-                lastValue.
-                 status=ERROR;
+            CAN_LAST_CONTROL.status=ERROR;
 
             return;
         }
@@ -88,11 +82,7 @@ static void valueHandler(void){
     /* If monitor on control RCA */
     if(currentClass==CONTROL_CLASS){
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.
-                                     lpr.
-                                      edfa.
-                                       modulationInput.
-                                        lastValue)
+        RETURN_LAST_CONTROL_MESSAGE()
         return;
     }
 
@@ -101,14 +91,14 @@ static void valueHandler(void){
        the current status that is stored in memory. The memory status is
        updated when a new modulation input value is sent with a control
        message. */
-    /* Extract the float from the last CAN message data. */
-    changeEndian(CONV_CHR_ADD,
-                 frontend.
-                  lpr.
-                   edfa.
-                    modulationInput.
-                     lastValue.
-                      data);
+    /* Extract the float from the last CAN message data, stored under the
+       control RCA. */
+    lastValue=lastControlFind(CAN_ADDRESS|BASE_CONTROL_RCA);
+    CONV_FLOAT=0.0;
+    if(lastValue!=NULL){
+        changeEndian(CONV_CHR_ADD,
+                     (*lastValue).data);
+    }
     /* Copy the last issued message to the current value */
     frontend.
      lpr.
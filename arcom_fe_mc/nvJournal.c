@@ -0,0 +1,239 @@
+/*! \file   nvJournal.c
+    \brief  Append-only non-volatile journal for counters
+
+    See nvJournal.h for a description of the journal format.
+*/
+
+/* Includes */
+#include <stdio.h>      /* fopen, fread, fwrite, remove, rename */
+#include <stddef.h>     /* offsetof */
+
+#include "nvJournal.h"
+#include "error.h"
+#include "debug.h"
+#include "globalDefinitions.h"
+
+/* Statics */
+static unsigned long journalValue[NV_JOURNAL_KEYS_NUMBER];  // Last value recovered or written for each key
+static unsigned char journalValid[NV_JOURNAL_KEYS_NUMBER];  // TRUE if the key has a record in the journal
+static unsigned int journalSequence = 0;                    // Sequence number for the next record
+static unsigned int journalRecords = 0;                     // Number of records currently in the file
+
+// Fletcher-16 checksum over the record, excluding the checksum field itself:
+static unsigned int nvJournalChecksum(const NV_JOURNAL_RECORD *record) {
+    const unsigned char *data = (const unsigned char *) record;
+    unsigned int sum1 = 0, sum2 = 0;
+    unsigned char cnt;
+
+    for (cnt = 0; cnt < offsetof(NV_JOURNAL_RECORD, checksum); cnt++) {
+        sum1 = (sum1 + data[cnt]) % 255;
+        sum2 = (sum2 + sum1) % 255;
+    }
+    return (sum2 << 8) | sum1;
+}
+
+// Fill in a record for the given key and value:
+static void nvJournalBuildRecord(NV_JOURNAL_RECORD *record, unsigned char key, unsigned long value) {
+    record -> magic = NV_JOURNAL_MAGIC;
+    record -> key = key;
+    record -> sequence = journalSequence++;
+    record -> value = value;
+    record -> checksum = nvJournalChecksum(record);
+}
+
+/*! Scan the journal file and recover the last valid value for each key.
+    Scanning stops at the first record with a bad magic byte or checksum.  That
+    can only be the tail of an interrupted append, so the journal is compacted
+    right away to drop it before any new records are appended.
+    \return
+        - \ref NO_ERROR -> if no error occurred
+        - \ref ERROR    -> if something wrong happened */
+int nvJournalInit(void) {
+    FILE *file, *temp;
+    NV_JOURNAL_RECORD record;
+    unsigned char key, torn = FALSE;
+
+    for (key = 0; key < NV_JOURNAL_KEYS_NUMBER; key++) {
+        journalValue[key] = 0;
+        journalValid[key] = FALSE;
+    }
+    journalSequence = 0;
+    journalRecords = 0;
+
+    // Recover from a power loss in the middle of nvJournalCompact():
+    temp = fopen(NV_JOURNAL_TEMP_FILE, "rb");
+    if (temp) {
+        fclose(temp);
+        file = fopen(NV_JOURNAL_FILE, "rb");
+        if (file) {
+            // The old journal was not removed yet so it is still complete:
+            fclose(file);
+            remove(NV_JOURNAL_TEMP_FILE);
+        } else {
+            // The compacted journal was fully written before the old one was removed:
+            rename(NV_JOURNAL_TEMP_FILE, NV_JOURNAL_FILE);
+        }
+    }
+
+    file = fopen(NV_JOURNAL_FILE, "rb");
+    if (!file) {
+        // No journal yet.  It will be created by the first nvJournalWrite().
+        #ifdef DEBUG_STARTUP
+            printf("NV journal: %s not found\n", NV_JOURNAL_FILE);
+        #endif /* DEBUG_STARTUP */
+        return NO_ERROR;
+    }
+
+    while (fread(&record, sizeof(record), 1, file) == 1) {
+        if (record.magic != NV_JOURNAL_MAGIC
+            || record.key >= NV_JOURNAL_KEYS_NUMBER
+            || record.checksum != nvJournalChecksum(&record))
+        {
+            torn = TRUE;
+            break;
+        }
+        // Records are appended in order, so the last valid one wins:
+        journalValue[record.key] = record.value;
+        journalValid[record.key] = TRUE;
+        journalSequence = record.sequence + 1;
+        journalRecords++;
+    }
+    // A partial record at the end of the file is also a torn write:
+    if (!torn && ftell(file) != (long) journalRecords * sizeof(record))
+        torn = TRUE;
+
+    fclose(file);
+
+    #ifdef DEBUG_STARTUP
+        printf("NV journal: %u records recovered%s\n", journalRecords, torn ? " (torn tail)" : "");
+    #endif /* DEBUG_STARTUP */
+
+    if (torn) {
+        storeError(ERR_INI, ERC_FLASH_ERROR); // Journal had a damaged record
+        return nvJournalCompact();
+    }
+    return NO_ERROR;
+}
+
+/*! Get the last journaled value of a key.
+    \param key      one of the NV_KEY_* defines
+    \param *value   receives the value if found
+    \return
+        - \ref NO_ERROR -> if the key was found in the journal
+        - \ref ERROR    -> if the key is out of range or was never written */
+int nvJournalRead(unsigned char key, unsigned long *value) {
+    if (key >= NV_JOURNAL_KEYS_NUMBER || !journalValid[key])
+        return ERROR;
+
+    *value = journalValue[key];
+    return NO_ERROR;
+}
+
+/*! Append a new value for a key to the journal.
+    Nothing is written if the value is the same as the last journaled one.
+    \param key      one of the NV_KEY_* defines
+    \param value    the new value
+    \return
+        - \ref NO_ERROR -> if no error occurred
+        - \ref ERROR    -> if something wrong happened */
+int nvJournalWrite(unsigned char key, unsigned long value) {
+    FILE *file;
+    NV_JOURNAL_RECORD record;
+
+    if (key >= NV_JOURNAL_KEYS_NUMBER) {
+        storeError(ERR_INI, ERC_MODULE_RANGE); // Journal key out of range
+        return ERROR;
+    }
+
+    if (journalValid[key] && journalValue[key] == value)
+        return NO_ERROR;
+
+    // Bound the file size before appending:
+    if (journalRecords >= NV_JOURNAL_COMPACT_RECORDS) {
+        if (nvJournalCompact() == ERROR)
+            return ERROR;
+    }
+
+    nvJournalBuildRecord(&record, key, value);
+
+    // Open, append and close every time so DOS commits the new file length:
+    file = fopen(NV_JOURNAL_FILE, "ab");
+    if (!file) {
+        storeError(ERR_INI, ERC_FLASH_ERROR); // Error opening the journal
+        return ERROR;
+    }
+    if (fwrite(&record, sizeof(record), 1, file) != 1) {
+        fclose(file);
+        storeError(ERR_INI, ERC_FLASH_ERROR); // Error appending to the journal
+        return ERROR;
+    }
+    if (fclose(file) != 0) {
+        storeError(ERR_INI, ERC_FLASH_ERROR); // Error closing the journal
+        return ERROR;
+    }
+
+    journalValue[key] = value;
+    journalValid[key] = TRUE;
+    journalRecords++;
+
+    #ifdef DEBUG_INI
+        printf("NV journal: key %d = %lu (record %u)\n", key, value, journalRecords);
+    #endif /* DEBUG_INI */
+
+    return NO_ERROR;
+}
+
+/*! Rewrite the journal with only the latest record of each key.
+    The new journal is completely written to a temporary file before the old
+    one is removed.  nvJournalInit() handles a power loss at any point.
+    \return
+        - \ref NO_ERROR -> if no error occurred
+        - \ref ERROR    -> if something wrong happened */
+int nvJournalCompact(void) {
+    FILE *temp;
+    NV_JOURNAL_RECORD record;
+    unsigned char key;
+    unsigned int records = 0;
+
+    temp = fopen(NV_JOURNAL_TEMP_FILE, "wb");
+    if (!temp) {
+        storeError(ERR_INI, ERC_FLASH_ERROR); // Error creating the compacted journal
+        return ERROR;
+    }
+
+    // Restart the sequence numbers with the compacted journal:
+    journalSequence = 0;
+
+    for (key = 0; key < NV_JOURNAL_KEYS_NUMBER; key++) {
+        if (journalValid[key]) {
+            nvJournalBuildRecord(&record, key, journalValue[key]);
+            if (fwrite(&record, sizeof(record), 1, temp) != 1) {
+                fclose(temp);
+                remove(NV_JOURNAL_TEMP_FILE);
+                storeError(ERR_INI, ERC_FLASH_ERROR); // Error writing the compacted journal
+                return ERROR;
+            }
+            records++;
+        }
+    }
+
+    if (fclose(temp) != 0) {
+        remove(NV_JOURNAL_TEMP_FILE);
+        storeError(ERR_INI, ERC_FLASH_ERROR); // Error closing the compacted journal
+        return ERROR;
+    }
+
+    remove(NV_JOURNAL_FILE);
+    if (rename(NV_JOURNAL_TEMP_FILE, NV_JOURNAL_FILE) != 0) {
+        storeError(ERR_INI, ERC_FLASH_ERROR); // Error replacing the journal
+        return ERROR;
+    }
+
+    journalRecords = records;
+
+    #ifdef DEBUG_INI
+        printf("NV journal: compacted to %u records\n", records);
+    #endif /* DEBUG_INI */
+
+    return NO_ERROR;
+}
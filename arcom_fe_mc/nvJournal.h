@@ -0,0 +1,48 @@
+/*! \file   nvJournal.h
+    \brief  Append-only non-volatile journal for counters
+
+    This module keeps small counters (like the cryostat cold head hours) on the
+    flash disk as a journal of fixed-size, checksummed records.  Each update is
+    a single small append instead of a full INI file rewrite.  The journal is
+    compacted down to one record per key once it grows past
+    NV_JOURNAL_COMPACT_RECORDS.  At startup the file is scanned up to the last
+    valid record so that a torn write at power loss only loses that one update.
+*/
+
+#ifndef _NVJOURNAL_H
+    #define _NVJOURNAL_H
+
+    /* Defines */
+    #define NV_JOURNAL_FILE             "NVJOURNL.DAT"  // Journal file on the flash disk
+    #define NV_JOURNAL_TEMP_FILE        "NVJOURNL.TMP"  // Temporary file used while compacting
+    #define NV_JOURNAL_MAGIC            0xA5            // First byte of every valid record
+    #define NV_JOURNAL_COMPACT_RECORDS  256             // Compact the journal after this many records
+    #define NV_JOURNAL_KEYS_NUMBER      8               // Number of distinct counters supported
+
+    /* Journal keys */
+    #define NV_KEY_COLD_HEAD_HOURS      0               // frontend.cryostat.coldHeadHours
+
+    /* Typedefs */
+    //! Journal record as stored on the flash disk
+    /*! All the fields are naturally aligned so the 10 byte layout is the same
+        regardless of the structure packing option. */
+    typedef struct {
+        unsigned char   magic;      //!< Always NV_JOURNAL_MAGIC
+        unsigned char   key;        //!< Which counter this record updates
+        unsigned int    sequence;   //!< Incremented for every record appended
+        unsigned long   value;      //!< The counter value
+        unsigned int    checksum;   //!< Fletcher-16 of the preceding 8 bytes
+    } NV_JOURNAL_RECORD;
+
+    /* Prototypes */
+    /* Externs */
+    extern int nvJournalInit(void);
+    //!< Scan the journal and recover the last valid value of each key
+    extern int nvJournalRead(unsigned char key, unsigned long *value);
+    //!< Get the last journaled value of a key
+    extern int nvJournalWrite(unsigned char key, unsigned long value);
+    //!< Append a new value for a key to the journal
+    extern int nvJournalCompact(void);
+    //!< Rewrite the journal with only the latest record of each key
+
+#endif /* _NVJOURNAL_H */
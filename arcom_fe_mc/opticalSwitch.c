@@ -14,6 +14,7 @@
 #include "error.h"
 #include "can.h"
 #include "frontend.h"
+#include "lastControl.h"
 #include "lprSerialInterface.h"
 #include "debug.h"
 
@@ -59,10 +60,7 @@ static void portHandler(void){
     /* If control (size!=0) */
     if(CAN_SIZE){
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.
-                                   lpr.
-                                    opticalSwitch.
-                                     lastPort)
+        SAVE_LAST_CONTROL_MESSAGE()
 
         /* Since the payload is just a byte, there is no need to convert the
            received data from the CAN message to any particular format, the
@@ -71,11 +69,7 @@ static void portHandler(void){
             storeError(ERR_OPTICAL_SWITCH, ERC_COMMAND_VAL); //Selected port set value out of range
 
             /* Store error in the last control message variable */
-            frontend.
-             lpr.
-              opticalSwitch.
-               lastPort.
-                status=CON_ERROR_RNG;
+            CAN_LAST_CONTROL.status=CON_ERROR_RNG;
 
             return;
         }
@@ -84,11 +78,7 @@ static void portHandler(void){
            return. */
         if(setOpticalSwitchPort()==ERROR){
             /* Store the error state in the last control message variable. */
-            frontend.
-             lpr.
-              opticalSwitch.
-               lastPort.
-                status=ERROR;
+            CAN_LAST_CONTROL.status=ERROR;
 
             return;
         }
@@ -110,10 +100,7 @@ static void portHandler(void){
     /* If monitor on control RCA */
     if(currentClass==CONTROL_CLASS){ // If monitor on control RCA
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.
-                                     lpr.
-                                      opticalSwitch.
-                                       lastPort)
+        RETURN_LAST_CONTROL_MESSAGE()
         return;
     }
 
@@ -139,20 +126,13 @@ static void shutterHandler(void){
     /* If it's a control message (size!=0) */
     if(CAN_SIZE){
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.
-                                   lpr.
-                                    opticalSwitch.
-                                     lastShutter)
+        SAVE_LAST_CONTROL_MESSAGE()
 
         /* The shutter is enable everytime a message is received independently
            of the payload. */
         if(setOpticalSwitchShutter(STANDARD)==ERROR){
             /* Store the ERROR state in the last control message variable */
-            frontend.
-             lpr.
-              opticalSwitch.
-               lastShutter.
-                status=ERROR;
+            CAN_LAST_CONTROL.status=ERROR;
 
             return;
         }
@@ -170,10 +150,7 @@ static void shutterHandler(void){
     /* If it's a monitor message on a control RCA */
     if(currentClass==CONTROL_CLASS){
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.
-                                     lpr.
-                                      opticalSwitch.
-                                       lastShutter)
+        RETURN_LAST_CONTROL_MESSAGE()
         return;
     }
 
@@ -198,20 +175,13 @@ static void forceShutterHandler(void){
     /* If it's a control message (size!=0) */
     if(CAN_SIZE){
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.
-                                   lpr.
-                                    opticalSwitch.
-                                     lastForceShutter)
+        SAVE_LAST_CONTROL_MESSAGE()
 
         /* The shutter is enable everytime a message is received independently
            of the payload. */
         if(setOpticalSwitchShutter(FORCED)==ERROR){
             /* Store the ERROR state in the last control message variable */
-            frontend.
-             lpr.
-              opticalSwitch.
-               lastForceShutter.
-                status=ERROR;
+            CAN_LAST_CONTROL.status=ERROR;
 
             return;
         }
@@ -229,10 +199,7 @@ static void forceShutterHandler(void){
     /* If it's a monitor message on a control RCA */
     if(currentClass==CONTROL_CLASS){
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.
-                                     lpr.
-                                      opticalSwitch.
-                                       lastForceShutter)
+        RETURN_LAST_CONTROL_MESSAGE()
         return;
     }
 
@@ -48,8 +48,6 @@
                                     is \em not a read-back from the hardware but
                                     just a register holding the last issued
                                     control.
-        \param      lastPort        This contains a copy of the last issued
-                                    control message to the port selection.
         \param      shutter     This contains the current state of the
                                     shutter.
                                     It has to be remembered that this is \em not
@@ -57,10 +55,6 @@
                                     register holding the last issued control:
                                         - \ref SHUTTER_ENABLE   -> Enable/ON
                                         - \ref SHUTTER_DISABLE  -> Disable/OFF
-        \param      lastShutter     This contains a copy of the last issed
-                                    control message to the shutter.
-        \param      lastForceShutter    This contains a copy of the last issed
-                                        control message to the force shutter.
         \param      state       This contains the current error state for
                                     the optical switch:
                                         - \ref NO_ERROR -> No error
@@ -76,10 +70,6 @@
                         value is the one stored by the software after a control
                         command has been issued. */
         unsigned char           port;
-        //! Last control message: port
-        /*! This is the content of the last control message sent to the port
-            select of the optical switch. */
-        LAST_CONTROL_MESSAGE    lastPort;
         //! Shutter
         /*! This is the current state of the shutter:
                 - \ref SHUTTER_ENABLE   -> Enable/ON
@@ -88,14 +78,6 @@
                         value is the one stored by the software after a control
                         command has been issued. */
         unsigned char           shutter;
-        //! Last control message: shutter
-        /*! This is the content of the last control message sent to the shutter
-            of the optical switch. */
-        LAST_CONTROL_MESSAGE    lastShutter;
-        //! Last control message: forceShutter
-        /*! This is the content of the last control message sent to the force
-            shutter of the optical switch. */
-        LAST_CONTROL_MESSAGE    lastForceShutter;
         //! Optical switch error state
         /*! This is the error state of the optical switch:
                 - \ref NO_ERROR -> no error
@@ -12,6 +12,7 @@
 #include <stdio.h>      /* printf */
 #include <stdlib.h>     /* rand, srand */
 #include <time.h>       /* clock, time */
+#include <string.h>     /* memcpy, memcmp, strlen */
 
 #include "serialMux.h"
 #include "timer.h"
@@ -21,9 +22,13 @@
 #include "debug.h"
 #include "iniWrapper.h"
 #include "pegasus.h"
+#include "async.h"
 
 /* Globals */
 /* Static */
+static unsigned char searchEsns[MAX_DEVICES_NUMBER][SERIAL_NUMBER_SIZE]; // ESNs found by the search in progress
+static unsigned char searchRequested = FALSE;   // A background search was requested
+static unsigned char esnsKnown = FALSE;         // ESNS[] holds a stored or searched list
 /* Externs */
 unsigned char esnDevicesFound;
 unsigned char ESNS[MAX_DEVICES_NUMBER][SERIAL_NUMBER_SIZE];
@@ -44,240 +49,366 @@ int owbInit(void){
     return NO_ERROR;
 }
 
-/*! This fuction actually gather the ESNs from the OWB. If a simulator is used
-    it will generate the ESN from the information contained in the configuration
-    file.
+/*! This fuction actually gather the ESNs from the OWB. It runs the same
+    search as the background task, but waits for it to complete.
     \return
         - \ref NO_ERROR -> if no error occurred
         - \ref ERROR    -> if something wrong happened */
 int owbGetEsn(void){
 
-    /* A few local to deal with the initialization */
-    unsigned char device;
-    unsigned char loop;
-    int TData[SEARCH_BYTES_LENGTH];
-    int RData[SEARCH_BYTES_LENGTH];
-    int timedOut=0; // A local to keep track of time out errors
+    int ret;
 
     #ifdef DEBUG_OWB
         printf("Gathering ESN... ");
     #endif
 
-    /* Enable the section of the bus extending outside the FEMC */
-    #ifdef DEBUG_OWB
-        printf(" - Enabling external OWB...");
-    #endif /* DEBUG_OWB */
-
-    outp(MUX_OWB_ENABLE, ENABLE);
+    owbRequestSearch();
 
-    #ifdef DEBUG_OWB
-        printf("done!\n");
-    #endif /* DEBUG_OWB */
+    do {
+        ret = owbAsync();
+    } while(ret == NO_ERROR);
 
-    /* Reset the one wire master in the FPGA. The data sent is not important */
     #ifdef DEBUG_OWB
-        printf(" - Reset the one wire master...");
-    #endif /* DEBUG_OWB */
-
-    outp(MUX_OWB_RESET, 0);
+        printf("done!\n\n");
+    #endif
 
-    #ifdef DEBUG_OWB
-        printf("done!\n"); // Reset one wire master
-    #endif /* DEBUG_OWB */
+    return (ret == ERROR) ? ERROR : NO_ERROR;
+}
 
-    /* Select 10-12 MHz clock */
-    #ifdef DEBUG_OWB
-        printf(" - Set up clock rate...");
-    #endif /* DEBUG_OWB */
+/*! This function loads the ESN list saved by the last search from ESNS.INI so
+    that it is available right away at startup.
+    \return
+        - \ref NO_ERROR -> if a non empty list was loaded
+        - \ref ERROR    -> if there is no usable list */
+int owbLoadEsns(void){
+
+    CFG_STRUCT dataIn;
+    unsigned char devices=0, device, loop;
+    char key[10];
+    char text[50];
+    char *str;
+    unsigned int value;
+
+    /* Configure read array */
+    dataIn.Name=ESNS_DEVICES_KEY;
+    dataIn.VarType=Cfg_Byte;
+    dataIn.DataPtr=&devices;
+
+    /* Access configuration file. If not found or empty, a search is needed. */
+    if(ReadCfg(ESNS_CONF_FILE,
+               ESNS_SECTION,
+               &dataIn) != ESNS_DEVICES_EXPECTED
+       || devices == 0
+       || devices > MAX_DEVICES_NUMBER)
+    {
+        return ERROR;
+    }
 
-    outp(MUX_OWB_CLK_DIV, OWB_10_12MHZ);
+    for(device = 0;
+        device < devices;
+        device++)
+    {
+        sprintf(key, ESNS_ESN_KEY, device);
+
+        /* Configure read array */
+        dataIn.Name=key;
+        dataIn.VarType=Cfg_String;
+        dataIn.DataPtr=text;
+
+        if(ReadCfg(ESNS_CONF_FILE,
+                   ESNS_SECTION,
+                   &dataIn) != ESNS_ESN_EXPECTED
+           || strlen(text) != 2 * SERIAL_NUMBER_SIZE)
+        {
+            return ERROR;
+        }
 
-    #ifdef DEBUG_OWB
-        printf("done!\n"); // Setup clock
-    #endif /* DEBUG_OWB */
+        /* Parse the hex digits into the search buffer */
+        str = text;
+        for(loop = 0; loop < SERIAL_NUMBER_SIZE; loop++) {
+            sscanf(str, "%2x", &value);
+            searchEsns[device][loop] = (unsigned char) value;
+            str += 2;
+        }
+    }
 
-    /* Select Long Line Mode and Presence Pulse Masking Mode */
-    #ifdef DEBUG_OWB
-        printf(" - Set up LLM and PPM mode...");
-    #endif /* DEBUG_OWB */
+    /* The whole list was read. Make it current. */
+    memcpy(ESNS, searchEsns, devices * SERIAL_NUMBER_SIZE);
+    esnDevicesFound = devices;
+    esnsKnown = TRUE;
 
-    outp(MUX_OWB_CONTROL, OWB_LLM | OWB_PPM);
+    printf("OWB - Devices loaded from %s: %d\n",
+           ESNS_CONF_FILE,
+           esnDevicesFound);
 
-    #ifdef DEBUG_OWB
-        printf("done!\n"); // Setup LLM+PPM
-    #endif /* DEBUG_OWB */
+    return NO_ERROR;
+}
 
-    /* Initialize the device discovery algorithm */
-    #ifdef DEBUG_OWB
-        printf(" - Initializing device search algorithm...");
-    #endif /* DEBUG_OWB */
+/* Save the current ESN list in the [ESNS] section of ESNS.INI. Only the keys
+   of the list are updated: the other sections and the comments are kept. The
+   count is cleared first and written last, so a list only partly updated is
+   never loaded. Keys left over from a longer list are ignored. */
+int owbSaveEsns(void){
+
+    FILE *file;
+    unsigned char device, loop;
+    char key[10];
+    char text[50];
+
+    /* UpdateCfg() exits the program if the file doesn't exist: create an empty one */
+    file = fopen(ESNS_CONF_FILE, "r");
+    if(!file){
+        file = fopen(ESNS_CONF_FILE, "w");
+    }
+    if(!file){
+        storeError(ERR_OWB, ERC_FLASH_ERROR); // Error creating the ESN list file
+        return ERROR;
+    }
+    fclose(file);
 
-    RecoverROM(NULL, TData, NULL);
+    if(UpdateCfg(ESNS_CONF_FILE,
+                 ESNS_SECTION,
+                 ESNS_DEVICES_KEY,
+                 "0") != 0)
+    {
+        storeError(ERR_OWB, ERC_FLASH_ERROR); // Error writing the ESN list file
+        return ERROR;
+    }
 
-    #ifdef DEBUG_OWB
-        printf("done!\n"); // Initialize search algorithm
+    for(device = 0;
+        device < esnDevicesFound;
+        device++)
+    {
+        sprintf(key, ESNS_ESN_KEY, device);
+        for(loop = 0; loop < SERIAL_NUMBER_SIZE; loop++) {
+            sprintf(&text[2 * loop], "%02X", ESNS[device][loop]);
+        }
 
-        /* Find available devices */
-        printf(" - Searching devices...\n");
-    #endif /* DEBUG_OWB */
+        if(UpdateCfg(ESNS_CONF_FILE,
+                     ESNS_SECTION,
+                     key,
+                     text) != 0)
+        {
+            storeError(ERR_OWB, ERC_FLASH_ERROR); // Error writing the ESN list file
+            return ERROR;
+        }
+    }
 
-    for(device = 0;
-        device < MAX_DEVICES_NUMBER;
-        device++){
+    sprintf(text, "%d", esnDevicesFound);
+    if(UpdateCfg(ESNS_CONF_FILE,
+                 ESNS_SECTION,
+                 ESNS_DEVICES_KEY,
+                 text) != 0)
+    {
+        storeError(ERR_OWB, ERC_FLASH_ERROR); // Error writing the ESN list file
+        return ERROR;
+    }
 
-            #ifdef DEBUG_OWB
-                printf("   - Searching device %d...\n",
-                       device);
-            #endif /* DEBUG_OWB */
+    return NO_ERROR;
+}
 
-        /* Send the bus reset and check for presence pulse. */
-        #ifdef DEBUG_OWB
-            printf("     - Send bus reset...\n");
-        #endif /* DEBUG_OWB */
+/*! This function schedules a new search of the OWB. The search is performed
+    by owbAsync() while the FEMC is idle, so the caller doesn't have to wait
+    for the bus resets. ESNS[] is only updated once the search is complete. */
+void owbRequestSearch(void){
+    searchRequested = TRUE;
+}
 
-        /* Set up for 10 seconds and start the asynchronous timer */
-        if(startAsyncTimer(TIMER_OWB_RESET,
-                           TIMER_TO_OWB_RESET,
-                           FALSE)==ERROR){
-            return ERROR;
-        }
+/*! This function performs the OWB search one step at a time. It is called by
+    the async loop and by owbGetEsn(). Each call handles at most one bus reset
+    attempt or one device.
+    When the search is complete, the list found replaces ESNS[]. If it differs
+    from the list known before, the change is reported and ESNS.INI is updated.
+    \return
+        - \ref NO_ERROR     -> if the search is in progress
+        - \ref ASYNC_DONE   -> if there is nothing left to do
+        - \ref ERROR        -> if the search failed. ESNS[] is not changed. */
+int owbAsync(void){
+
+    /* A static enum to track the state of the search */
+    static enum {
+        ASYNC_OWB_IDLE,
+        ASYNC_OWB_START,
+        ASYNC_OWB_RESET_START,
+        ASYNC_OWB_RESET_WAIT,
+        ASYNC_OWB_SEARCH,
+        ASYNC_OWB_END
+    } asyncOwbState = ASYNC_OWB_IDLE;
+
+    static unsigned char device;
+    static unsigned char searchError;
+    static int TData[SEARCH_BYTES_LENGTH];
+    int RData[SEARCH_BYTES_LENGTH];
+    unsigned char loop, found;
+    int timedOut;
 
-        /* Wait for the one wire bus to be resetted or for the timer to
-           expire. */
-        do {
-            timedOut=queryAsyncTimer(TIMER_OWB_RESET);
-            if(timedOut==ERROR){
-                return ERROR;
+    switch(asyncOwbState){
+        case ASYNC_OWB_IDLE:
+            if(!searchRequested){
+                return ASYNC_DONE;
             }
-        } while(owbReset()&&!timedOut);
+            searchRequested = FALSE;
+            asyncOwbState = ASYNC_OWB_START;
+            break;
 
-        /* If the timer has expired signal the error */
-        if(timedOut==TIMER_EXPIRED){
-            storeError(ERR_OWB, ERC_HARDWARE_TIMEOUT); //Timeout while waiting for the bus reset
-            return ERROR;
-        }
+        case ASYNC_OWB_START:
+            /* Enable the section of the bus extending outside the FEMC */
+            outp(MUX_OWB_ENABLE, ENABLE);
 
-        /* In case of no error, clear the asynchronous timer. */
-        if(stopAsyncTimer(TIMER_OWB_RESET)==ERROR){
-            return ERROR;
-        }
+            /* Reset the one wire master in the FPGA. The data sent is not important */
+            outp(MUX_OWB_RESET, 0);
 
-        #ifdef DEBUG_OWB
-            printf("       done!\n"); // Bus reset
-        #endif /* DEBUG_OWB */
+            /* Select 10-12 MHz clock */
+            outp(MUX_OWB_CLK_DIV, OWB_10_12MHZ);
 
-        /* Send "search ROM" command to the bus */
-        #ifdef DEBUG_OWB
-            printf("     - Send search ROM code...\n");
-        #endif /* DEBUG_OWB */
+            /* Select Long Line Mode and Presence Pulse Masking Mode */
+            outp(MUX_OWB_CONTROL, OWB_LLM | OWB_PPM);
 
-        writeOwb(SEARCH_ROM_CODE);
+            /* Initialize the device discovery algorithm */
+            RecoverROM(NULL, TData, NULL);
 
-        #ifdef DEBUG_OWB
-            printf("       done!\n"); // Search ROM code
-        #endif /* DEBUG_OWB */
+            device = 0;
+            searchError = FALSE;
+            asyncOwbState = ASYNC_OWB_RESET_START;
+            break;
 
-        /* Enter accelerated search mode */
-        #ifdef DEBUG_OWB
-            printf("     - Enter accelerated search mode...");
-        #endif /* DEBUG_OWB */
+        case ASYNC_OWB_RESET_START:
+            #ifdef DEBUG_OWB
+                printf("   - Searching device %d...\n",
+                       device);
+            #endif /* DEBUG_OWB */
 
-        outp(MUX_OWB_COMMAND, ACC_SEARCH_MODE);
+            /* Set up for 10 seconds and start the asynchronous timer */
+            if(startAsyncTimer(TIMER_OWB_RESET,
+                               TIMER_TO_OWB_RESET,
+                               FALSE)==ERROR){
+                searchError = TRUE;
+                asyncOwbState = ASYNC_OWB_END;
+                break;
+            }
+            asyncOwbState = ASYNC_OWB_RESET_WAIT;
+            break;
 
-        #ifdef DEBUG_OWB
-            printf("done!\n"); // Enter accelerated search
-        #endif /* DEBUG_OWB */
+        case ASYNC_OWB_RESET_WAIT:
+            /* One attempt to reset the bus per call, until the timer expires */
+            timedOut=queryAsyncTimer(TIMER_OWB_RESET);
+            if(timedOut==ERROR){
+                searchError = TRUE;
+                asyncOwbState = ASYNC_OWB_END;
+                break;
+            }
 
-        /* Transmit first set of search data */
-        #ifdef DEBUG_OWB
-            printf("     - Sending search data...\n");
-        #endif /* DEBUG_OWB */
+            if(owbReset()==NO_ERROR){
+                /* In case of no error, clear the asynchronous timer. */
+                stopAsyncTimer(TIMER_OWB_RESET);
+                asyncOwbState = ASYNC_OWB_SEARCH;
+                break;
+            }
 
-        for(loop=0;
-            loop<SEARCH_BYTES_LENGTH;
-            loop++){
-            RData[loop]=writeOwb(TData[loop]);
-        }
+            /* If the timer has expired signal the error */
+            if(timedOut==TIMER_EXPIRED){
+                storeError(ERR_OWB, ERC_HARDWARE_TIMEOUT); //Timeout while waiting for the bus reset
+                searchError = TRUE;
+                asyncOwbState = ASYNC_OWB_END;
+            }
+            break;
 
-        #ifdef DEBUG_OWB
-            printf("       done!\n"); // Send search data
-        #endif /* DEBUG_OWB */
+        case ASYNC_OWB_SEARCH:
+            /* Send "search ROM" command to the bus */
+            writeOwb(SEARCH_ROM_CODE);
 
-        /* Check state of search tree */
-        #ifdef DEBUG_OWB
-            printf("     - Check state of search tree...");
-        #endif /* DEBUG_OWB */
+            /* Enter accelerated search mode */
+            outp(MUX_OWB_COMMAND, ACC_SEARCH_MODE);
 
-        if(RecoverROM(RData,
-                      TData,
-                      ESNS[device])==TRUE){
+            /* Transmit the search data */
+            for(loop=0;
+                loop<SEARCH_BYTES_LENGTH;
+                loop++){
+                RData[loop]=writeOwb(TData[loop]);
+            }
 
-            #ifdef DEBUG_OWB
-                printf("done!\n"); // Search tree state
-                printf("     done!\n"); // Searching device No.x
-            #endif /* DEBUG_OWB */
+            /* Check state of search tree */
+            if(RecoverROM(RData,
+                          TData,
+                          searchEsns[device])==TRUE){
+                asyncOwbState = ASYNC_OWB_END;
+                break;
+            }
 
+            device++;
+            asyncOwbState = (device == MAX_DEVICES_NUMBER) ? ASYNC_OWB_END :
+                                                             ASYNC_OWB_RESET_START;
             break;
-        }
 
-        #ifdef DEBUG_OWB
-            printf("done!\n"); // Search tree state
-            printf("     done!\n"); // Searching device No.x
-        #endif /* DEBUG_OWB */
+        case ASYNC_OWB_END:
+            /* Disable the section of the bus extending outside the FEMC */
+            outp(MUX_OWB_ENABLE, DISABLE);
 
-    }
-    #ifdef DEBUG_OWB
-        printf("   done!\n"); // Search devices
-    #endif
+            asyncOwbState = ASYNC_OWB_IDLE;
 
-    /* Disable the section of the bus extending outside the FEMC */
-    #ifdef DEBUG_OWB
-        printf("   - Disabling external OWB...");
-    #endif /* DEBUG_OWB */
+            /* Keep the current list if the search didn't complete */
+            if(searchError){
+                return ERROR;
+            }
 
-    outp(MUX_OWB_ENABLE, DISABLE);
+            /* If the maximum number of devices was reached, it is likely that
+               there is a problem with the bus. Notify the system and set the
+               number of found devices to 0. */
+            if(device==MAX_DEVICES_NUMBER){
+                #ifdef DEBUG_STARTUP
+                    printf("\n\nWARNING - Maximum number of ESN devices reached.\n\n");
+                #endif /* DEBUG_STARTUP */
+
+                storeError(ERR_OWB, ERC_NO_MEMORY); //Maximum number of devices reached
+                found = 0;
+            } else {
+                /* If not, store the number of devices found. */
+                found = device+1;
+            }
 
-    #ifdef DEBUG_OWB
-        printf("done!\n");
-    #endif /* DEBUG_OWB */
+            /* Nothing else to do if the list didn't change */
+            if(esnsKnown
+               && found == esnDevicesFound
+               && memcmp(ESNS, searchEsns, found * SERIAL_NUMBER_SIZE) == 0)
+            {
+                return ASYNC_DONE;
+            }
 
-    /* If the maximum number of devices was reached, it is likely that there is
-       a problem with the bus. Notify the system and set the number of found
-       devices to 0. */
-    if(device==MAX_DEVICES_NUMBER){
-        #ifdef DEBUG_STARTUP
-            printf("\n\nWARNING - Maximum number of ESN devices reached.\n\n");
-        #endif /* DEBUG_STARTUP */
-
-        storeError(ERR_OWB, ERC_NO_MEMORY); //Maximum number of devices reached
-        esnDevicesFound = 0;
-    } else {
-        /* If not, store the number of devices found. */
-        esnDevicesFound = device+1;
-    }
+            if(esnsKnown){
+                storeError(ERR_OWB, ERC_HARDWARE_CHANGED); //The ESNs found differ from the stored list
+            }
 
-    printf("OWB - Devices found: %d\n",
-           esnDevicesFound);
+            memcpy(ESNS, searchEsns, found * SERIAL_NUMBER_SIZE);
+            esnDevicesFound = found;
+            esnsKnown = TRUE;
+
+            printf("OWB - Devices found: %d\n",
+                   esnDevicesFound);
+
+            /* Print devices list */
+            for(device = 0;
+                device < esnDevicesFound;
+                device++)
+            {
+                printf("    - ESN%d: %02X %02X %02X %02X %02X %02X %02X %02X\n",
+                       device,
+                       ESNS[device][0],
+                       ESNS[device][1],
+                       ESNS[device][2],
+                       ESNS[device][3],
+                       ESNS[device][4],
+                       ESNS[device][5],
+                       ESNS[device][6],
+                       ESNS[device][7]);
+            }
 
-    /* Print devices list */
-    for(device = 0;
-        device < esnDevicesFound;
-        device++)
-    {
-        printf("    - ESN%d: %02X %02X %02X %02X %02X %02X %02X %02X\n",
-               device,
-               ESNS[device][0],
-               ESNS[device][1],
-               ESNS[device][2],
-               ESNS[device][3],
-               ESNS[device][4],
-               ESNS[device][5],
-               ESNS[device][6],
-               ESNS[device][7]);
+            owbSaveEsns();
+            return ASYNC_DONE;
+
+        default:
+            asyncOwbState = ASYNC_OWB_IDLE;
+            break;
     }
-    #ifdef DEBUG_OWB
-        printf("done!\n\n");
-    #endif
 
     return NO_ERROR;
 }
@@ -35,6 +35,14 @@
 
     #define SEARCH_BYTES_LENGTH 16      // Lenght in bytes of the search
 
+    /* ESN list stored on the flash disk */
+    #define ESNS_CONF_FILE          "ESNS.INI"  // File containing the ESNs found by the last search
+    #define ESNS_SECTION            "ESNS"      // Section containing the ESNs
+    #define ESNS_DEVICES_KEY        "DEVICES"   // Key containing the number of ESNs
+    #define ESNS_DEVICES_EXPECTED   1           // Expected keys containing the number of ESNs
+    #define ESNS_ESN_KEY            "ESN%d"     // Key containing the n-th ESN as 16 hex digits
+    #define ESNS_ESN_EXPECTED       1           // Expected keys containing the n-th ESN
+
     /* Dallas Maxim Chips Defines */
 
     /* Family codes */
@@ -76,8 +84,12 @@
     static int waitIrq(unsigned char irq); // Check on the state of the selected irq signal
     static int RecoverROM(int* ReceiveData, int* TransmitData, unsigned char* ROMCode); // Algorithm to discover the available devices
     static int writeOwb(int data); // Writes data to the one wire bus
+    static int owbSaveEsns(void); // Save the ESN list on the flash disk
     /* Externs */
     extern int owbInit(void); //!< Performs the initialization of the one wire bus
     extern int owbGetEsn(void); //!< Gather the available ESN from the OWB
+    extern int owbLoadEsns(void); //!< Load the ESN list found by the last search
+    extern void owbRequestSearch(void); //!< Search the OWB again in the background
+    extern int owbAsync(void); //!< Background OWB search, one step at a time
 
 #endif /* _OWB_H */
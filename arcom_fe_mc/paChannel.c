@@ -16,7 +16,10 @@
 
 #include "error.h"
 #include "frontend.h"
+#include "lastControl.h"
 #include "loSerialInterface.h"
+#include "setpointQueue.h"
+#include "controlElision.h"
 #include "debug.h"
 #include "globalDefinitions.h"
 
@@ -69,8 +72,12 @@ static void gateVoltageHandler(void) {
 
     /* If control (size !=0) */
     if (CAN_SIZE) {
+        /* Skip the command if the same voltage is already applied */
+        if (controlElide())
+            return;
+
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lo.pa.paChannel[currentPaChannel()].lastGateVoltage)
+        SAVE_LAST_CONTROL_MESSAGE()
 
         /* Extract the float from the can message */
         changeEndian(CONV_CHR_ADD, CAN_DATA_ADD);
@@ -79,7 +86,7 @@ static void gateVoltageHandler(void) {
            state and return the error state then return. */
         if (setPaChannel() == ERROR) {
             /* Store the ERROR state in the last control message variable */
-            frontend.cartridge[currentModule].lo.pa.paChannel[currentPaChannel()].lastGateVoltage.status = ERROR;
+            CAN_LAST_CONTROL.status = ERROR;
             return;
         }
         /* If everything went fine, it's a control message, we're done. */
@@ -89,7 +96,7 @@ static void gateVoltageHandler(void) {
     /* If monitor on control RCA */
     if (currentClass == CONTROL_CLASS) { // If monitor on a control RCA
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lo.pa.paChannel[currentPaChannel()].lastGateVoltage)
+        RETURN_LAST_CONTROL_MESSAGE()
         return;
     }
 
@@ -111,13 +118,40 @@ static void gateVoltageHandler(void) {
     CAN_SIZE = CAN_FLOAT_SIZE;
 }
 
+/* Apply a coalesced drain voltage */
+/* The YTO may have been retuned, or the dewar warmed up, since the drain
+   voltage was posted: the checks of the handler are repeated with the
+   setpoint about to be written. */
+static int applyDrainVoltage(void) {
+
+    signed char ret;
+
+    if (paDrainVoltageAllowed()==DISABLE) {
+        //PA temperature above the allowed range -> PAs disabled:
+        storeError(ERR_PA_CHANNEL, ERC_HARDWARE_BLOCKED);
+        CAN_LAST_CONTROL.status = HARDW_BLKD_ERR;
+        return NO_ERROR;
+    }
+
+    if (frontend.mode == TROUBLESHOOTING_MODE)
+        ret = NO_ERROR;
+    else
+        ret = limitSafePaDrainVoltage(currentPaModule);
+
+    if (ret != NO_ERROR) {
+        storeError(ERR_PA_CHANNEL, ERC_HARDWARE_BLOCKED); //Attempted to set LO PA above max safe power level.
+        changeEndian(CAN_LAST_CONTROL.data, CONV_CHR_ADD);
+        CAN_LAST_CONTROL.status = ret;
+    }
+
+    return setPaChannel();
+}
+
 /* Drain Voltage Handler */
 /* This function will deal with monitor and control requests to the drain
    voltage. */
 static void drainVoltageHandler(void) {
 
-    float temp4K,temp12K;
-    unsigned int state=DISABLE;
     signed char ret;
 
     #ifdef DEBUG
@@ -126,53 +160,18 @@ static void drainVoltageHandler(void) {
 
     /* If control (size !=0) */
     if (CAN_SIZE) {
-        /* If the temperature of the dewar is >30K, don't allow the use of the
-           PAs as too much power at this temperature could damage the
-           multipliers. In the LO async loop, the PAs will be turned off if the
-           dewar temepratures grows to above 30K. */
-        temp4K=frontend.cryostat.cryostatTemp[CRYOCOOLER_4K].temp;
-        temp12K=frontend.cryostat.cryostatTemp[CRYOCOOLER_12K].temp;
-
-        /* We check the 4K sensor first and if that doesn't allow the command,
-           we check the 12K sensor next.   Previous algorithm in 2.6.1 checked
-           the 12K sensor first and would always reject if that one sensor 
-           was above PA_MAX_ALLOWED_TEMP. */
-
-        // start by assuming the command will be blocked:
-        state=DISABLE;
-
-        // is the 4K cryostat sensor reading valid and below the threshold indicating cryocooling?
-        if (CRYOSTAT_TEMP_BELOW_MAX(temp4K, PA_MAX_ALLOWED_TEMP)) {
-            state=ENABLE;   // yes.
-        }
-
-        // may need to use the 12K sensor instead:
-        if (state == DISABLE) {
-            if (CRYOSTAT_TEMP_BELOW_MAX(temp12K, PA_MAX_ALLOWED_TEMP)) {
-                state=ENABLE;   // yes.
-            }
-        }
-
-        // if band 1 or band 2, enable:
-        if (currentModule == BAND1 || currentModule == BAND2)
-            state=ENABLE;
-
-        // If we are in TROUBLESHOOTING mode, ignore all the above safety checks and allow the voltage to be set:
-        if (frontend.mode == TROUBLESHOOTING_MODE)
-            state=ENABLE;
-
-        if (state==DISABLE) {
+        if (paDrainVoltageAllowed()==DISABLE) {
             //PA temperature above the allowed range -> PAs disabled:
             storeError(ERR_PA_CHANNEL, ERC_HARDWARE_BLOCKED);
 
             // Store the status in the last control message:
-            frontend.cartridge[currentModule].lo.pa.paChannel[currentPaChannel()].lastDrainVoltage.status = HARDW_BLKD_ERR;
+            CAN_LAST_CONTROL.status = HARDW_BLKD_ERR;
 
             return;
         }
 
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lo.pa.paChannel[currentPaChannel()].lastDrainVoltage)
+        SAVE_LAST_CONTROL_MESSAGE()
 
         /* Extract the float from the can message */
         changeEndian(CONV_CHR_ADD, CAN_DATA_ADD);
@@ -191,19 +190,26 @@ static void drainVoltageHandler(void) {
             storeError(ERR_PA_CHANNEL, ERC_HARDWARE_BLOCKED); //Attempted to set LO PA above max safe power level.
 
             /* save the modified command setting to the "last control message" location */
-            changeEndian(frontend.cartridge[currentModule].lo.pa.paChannel[currentPaChannel()].lastDrainVoltage.data, CONV_CHR_ADD);
+            changeEndian(CAN_LAST_CONTROL.data, CONV_CHR_ADD);
+        }
+
+        /* If coalescing, the drain voltage is limited again and applied from
+           the async loop */
+        if (setpointQueuePost(applyDrainVoltage)) {
+            CAN_LAST_CONTROL.status = ret;
+            return;
         }
 
         /* Set the PA channel drain voltage. If an error occurs then store the
            state and then return. */
         if (setPaChannel() == ERROR) {
             /* Store the ERROR state in the last control message variable */
-            frontend.cartridge[currentModule].lo.pa.paChannel[currentPaChannel()].lastDrainVoltage.status = ERROR;
+            CAN_LAST_CONTROL.status = ERROR;
             return;
         }
         
         /* if limitSafePaDrainVoltage() above returned a problem, we want to save that error status */
-        frontend.cartridge[currentModule].lo.pa.paChannel[currentPaChannel()].lastDrainVoltage.status = ret;
+        CAN_LAST_CONTROL.status = ret;
 
         /* If everything went fine, it's a control message, we're done. */
         return;
@@ -212,7 +218,7 @@ static void drainVoltageHandler(void) {
     /* If monitor on control RCA */
     if (currentClass == CONTROL_CLASS) { // If monitor on a control RCA
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lo.pa.paChannel[currentPaChannel()].lastDrainVoltage)
+        RETURN_LAST_CONTROL_MESSAGE()
         return;
     }
 
@@ -311,3 +317,43 @@ int currentPaChannel(void) {
             break;
     }
 }
+
+/* PA drain voltage allowed */
+/*! If the temperature of the dewar is >30K, don't allow the use of the PAs of
+    the currently addressed cartridge as too much power at this temperature
+    could damage the multipliers. In the LO async loop, the PAs will be turned
+    off if the dewar temepratures grows to above 30K.
+
+    \return
+        - \ref ENABLE   -> if the drain voltage can be set
+        - \ref DISABLE  -> if the dewar is too warm */
+int paDrainVoltageAllowed(void) {
+
+    float temp4K,temp12K;
+
+    temp4K=frontend.cryostat.cryostatTemp[CRYOCOOLER_4K].temp;
+    temp12K=frontend.cryostat.cryostatTemp[CRYOCOOLER_12K].temp;
+
+    /* We check the 4K sensor first and if that doesn't allow the command,
+       we check the 12K sensor next.   Previous algorithm in 2.6.1 checked
+       the 12K sensor first and would always reject if that one sensor 
+       was above PA_MAX_ALLOWED_TEMP. */
+
+    // is the 4K cryostat sensor reading valid and below the threshold indicating cryocooling?
+    if (CRYOSTAT_TEMP_BELOW_MAX(temp4K, PA_MAX_ALLOWED_TEMP))
+        return ENABLE;
+
+    // may need to use the 12K sensor instead:
+    if (CRYOSTAT_TEMP_BELOW_MAX(temp12K, PA_MAX_ALLOWED_TEMP))
+        return ENABLE;
+
+    // if band 1 or band 2, enable:
+    if (currentModule == BAND1 || currentModule == BAND2)
+        return ENABLE;
+
+    // If we are in TROUBLESHOOTING mode, ignore all the above safety checks and allow the voltage to be set:
+    if (frontend.mode == TROUBLESHOOTING_MODE)
+        return ENABLE;
+
+    return DISABLE;
+}
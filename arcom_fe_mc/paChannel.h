@@ -36,6 +36,10 @@
                                                       1 -> drainVoltage
                                                       2 -> drainCurrent */
 
+    //! Control RCA of the drain voltage of a PA channel, for the last control message
+    #define PA_CHANNEL_DRAIN_VOLTAGE_RCA(band, channel) \
+        (BASE_CONTROL_RCA+((unsigned long)(band)<<MODULES_MASK_SHIFT)+0x00841L+((channel)<<PA_MODULES_MASK_SHIFT))
+
     /* Typedefs */
     //! Current state of the PA channel
      typedef struct {
@@ -48,14 +52,6 @@
         //! A channel Drain  Current
         /*! This is the PA channel drain current (in mA). */
         float   drainCurrent;
-        //! Last control message: PA channel Gate Voltage
-        /*! This is the content of the last control message sent to the PA
-            channel gate voltage. */
-        LAST_CONTROL_MESSAGE    lastGateVoltage;
-        //! Last control message: A channel Drain  Voltage
-        /*! This is the content of the last control message sent to the PA
-            channel drain voltage. */
-        LAST_CONTROL_MESSAGE    lastDrainVoltage;
     } PA_CHANNEL;
 
     /* Globals */
@@ -67,8 +63,10 @@
     static void gateVoltageHandler(void);
     static void drainVoltageHandler(void);
     static void drainCurrentHandler(void);
+    static int applyDrainVoltage(void);
     /* Externs */
     extern void paChannelHandler(void); //!< This function deals with the incoming can message
     extern int currentPaChannel(void); //!< This function returns the current PA channel
+    extern int paDrainVoltageAllowed(void); //!< This function checks that the dewar is cold enough to use the PAs
 
 #endif /* _PACHANNEL_H */
@@ -74,18 +74,20 @@ static void voltageHandler(void){
            CAN message state. */
         CAN_STATUS = ERROR;
         /* Store the last known value in the outgoing message */
-        CONV_FLOAT=frontend.
-                   powerDistribution.
-                    pdModule[currentPowerDistributionModule].
-                     pdChannel[currentPdModuleModule].
-                      voltage;
+        CONV_FLOAT=adcScaleFloat(frontend.
+                                  powerDistribution.
+                                   pdModule[currentPowerDistributionModule].
+                                    pdChannel[currentPdModuleModule].
+                                     voltage,
+                                 &pdVoltageScale[currentPdModuleModule]);
     } else {
         /* If no error during monitor pocess, gather the stored data */
-        CONV_FLOAT=frontend.
-                   powerDistribution.
-                    pdModule[currentPowerDistributionModule].
-                     pdChannel[currentPdModuleModule].
-                      voltage;
+        CONV_FLOAT=adcScaleFloat(frontend.
+                                  powerDistribution.
+                                   pdModule[currentPowerDistributionModule].
+                                    pdChannel[currentPdModuleModule].
+                                     voltage,
+                                 &pdVoltageScale[currentPdModuleModule]);
     }
     /* Load the CAN message payload with the returned value and set the
        size. The value has to be converted from little endian (Intel) to
@@ -124,18 +126,20 @@ static void currentHandler(void){
            CAN message state. */
         CAN_STATUS = ERROR;
         /* Store the last known value in the outgoing message */
-        CONV_FLOAT=frontend.
-                   powerDistribution.
-                    pdModule[currentPowerDistributionModule].
-                     pdChannel[currentPdModuleModule].
-                      current;
+        CONV_FLOAT=adcScaleFloat(frontend.
+                                  powerDistribution.
+                                   pdModule[currentPowerDistributionModule].
+                                    pdChannel[currentPdModuleModule].
+                                     current,
+                                 &pdCurrentScale[currentPdModuleModule]);
     } else {
         /* If no error during monitor pocess, gather the stored data */
-        CONV_FLOAT=frontend.
-                   powerDistribution.
-                    pdModule[currentPowerDistributionModule].
-                     pdChannel[currentPdModuleModule].
-                      current;
+        CONV_FLOAT=adcScaleFloat(frontend.
+                                  powerDistribution.
+                                   pdModule[currentPowerDistributionModule].
+                                    pdChannel[currentPdModuleModule].
+                                     current,
+                                 &pdCurrentScale[currentPdModuleModule]);
     }
     /* Load the CAN message payload with the returned value and set the
        size. The value has to be converted from little endian (Intel) to
@@ -47,16 +47,20 @@
         channel system.
         \ingroup    pdModule
         \param      voltage     This contains the most recent read-back
-                                    value for this channel voltage.
+                                    value for this channel voltage, in ADC
+                                    counts.
         \param      current     This contains the most recent read-back
-                                    value for this channel current. */
+                                    value for this channel current, in ADC
+                                    counts. */
     typedef struct {
         //! Channel voltage
-        /*! This is the voltage provided by this channel. */
-        float   voltage;
+        /*! This is the voltage provided by this channel, as raw ADC counts.
+            See \ref pdVoltageScale for the conversion. */
+        unsigned int    voltage;
         //! Channel current
-        /*! This is the current drawn by this channel. */
-        float   current;
+        /*! This is the current drawn by this channel, as raw ADC counts.
+            See \ref pdCurrentScale for the conversion. */
+        unsigned int    current;
     } PD_CHANNEL;
 
     /* Globals */
@@ -13,10 +13,12 @@
 
 #include "debug.h"
 #include "frontend.h"
+#include "lastControl.h"
 #include "error.h"
 #include "pdSerialInterface.h"
 #include "timer.h"
 #include "async.h"
+#include "controlElision.h"
 
 /* Globals */
 /* Externs */
@@ -122,10 +124,7 @@ static void enableHandler(void) {
     /* If it's a control message (size !=0) */
     if (CAN_SIZE) {
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.
-                                   powerDistribution.
-                                    pdModule[currentPowerDistributionModule].
-                                     lastEnable)
+        SAVE_LAST_CONTROL_MESSAGE()
 
         // If the command is to one of the powered on states:
         if(CAN_BYTE) {
@@ -143,11 +142,7 @@ static void enableHandler(void) {
             if((frontend.
                  cartridge[currentPowerDistributionModule].
                   state==CARTRIDGE_ERROR)) {
-                frontend.
-                 powerDistribution.
-                  pdModule[currentPowerDistributionModule].
-                   lastEnable.
-                    status = HARDW_ERROR; // Store in the last CAN message variable
+                CAN_LAST_CONTROL.status = HARDW_ERROR; // Store in the last CAN message variable
                 return;
             }
 
@@ -166,11 +161,7 @@ static void enableHandler(void) {
                         storeError(ERR_PD_MODULE, ERC_COMMAND_VAL);
 
                         // Store error in the last CAN message variable:
-                        frontend.
-                         powerDistribution.
-                          pdModule[currentPowerDistributionModule].
-                           lastEnable.
-                            status = HARDW_BLKD_ERR;
+                        CAN_LAST_CONTROL.status = HARDW_BLKD_ERR;
                         return;
                     }
                     break;
@@ -181,11 +172,7 @@ static void enableHandler(void) {
 
                     // Store error in the last CAN message variable:
                     // Its not a HARDW_BLKD_ERR just an illegal value so ERROR.
-                    frontend.
-                     powerDistribution.
-                      pdModule[currentPowerDistributionModule].
-                       lastEnable.
-                        status = ERROR;                        
+                    CAN_LAST_CONTROL.status = ERROR;                        
                     return;
             }
 
@@ -250,11 +237,7 @@ static void enableHandler(void) {
                     storeError(ERR_PD_MODULE, ERC_HARDWARE_BLOCKED);
 
                     // Store error in the last CAN message variable:
-                    frontend.
-                     powerDistribution.
-                      pdModule[currentPowerDistributionModule].
-                       lastEnable.
-                        status = HARDW_BLKD_ERR;
+                    CAN_LAST_CONTROL.status = HARDW_BLKD_ERR;
 
                     return;
                 }
@@ -262,11 +245,7 @@ static void enableHandler(void) {
                 // Turn on the cartridge:
                 if (setPdModuleEnable(PD_MODULE_ENABLE) == ERROR) {
                     // Store error in the last CAN message variable:                        
-                    frontend.
-                     powerDistribution.
-                      pdModule[currentPowerDistributionModule].
-                       lastEnable.
-                        status = ERROR;
+                    CAN_LAST_CONTROL.status = ERROR;
 
                     return;
                 }
@@ -332,11 +311,7 @@ static void enableHandler(void) {
                         storeError(ERR_PD_MODULE, ERC_HARDWARE_BLOCKED);
 
                         // Store error in the last CAN message variable:
-                        frontend.
-                         powerDistribution.
-                          pdModule[currentPowerDistributionModule].
-                           lastEnable.
-                            status = HARDW_BLKD_ERR;
+                        CAN_LAST_CONTROL.status = HARDW_BLKD_ERR;
 
                         return;
                     }
@@ -346,6 +321,9 @@ static void enableHandler(void) {
                      cartridge[currentPowerDistributionModule].
                       standby2 = FALSE;
 
+                    // The commands received in STANDBY2 were not applied:
+                    controlEpochAdvance(currentPowerDistributionModule);
+
                     // Decrease the number of STANDBY2 cartridges:
                     frontend.
                      powerDistribution.
@@ -375,11 +353,7 @@ static void enableHandler(void) {
                         storeError(ERR_PD_MODULE, ERC_HARDWARE_BLOCKED);
 
                         // Store error in the last CAN message variable:
-                        frontend.
-                         powerDistribution.
-                          pdModule[currentPowerDistributionModule].
-                           lastEnable.
-                            status = HARDW_BLKD_ERR;
+                        CAN_LAST_CONTROL.status = HARDW_BLKD_ERR;
 
                         return;
                     }
@@ -388,6 +362,9 @@ static void enableHandler(void) {
                      cartridge[currentPowerDistributionModule].
                       standby2 = TRUE;
 
+                    // STANDBY2 shuts down the cold electronics:
+                    controlEpochAdvance(currentPowerDistributionModule);
+
                     // Increase the number of STANDBY2 cartridges:
                     frontend.
                      powerDistribution.
@@ -443,22 +420,14 @@ static void enableHandler(void) {
             if (cartridgeStop(currentPowerDistributionModule) == ERROR) {
                 // If an error occurs while stopping
                 //  store the Error state in the last control message variable:
-                frontend.
-                 powerDistribution.
-                  pdModule[currentPowerDistributionModule].
-                   lastEnable.
-                    status = ERROR;
+                CAN_LAST_CONTROL.status = ERROR;
             }
 
             // Turn off the power distributrion module.
             if (setPdModuleEnable(PD_MODULE_DISABLE) == ERROR) {
                 // If an error occurs while stopping
                 //  store the Error state in the last control message variable:
-                frontend.
-                 powerDistribution.
-                  pdModule[currentPowerDistributionModule].
-                   lastEnable.
-                    status=ERROR;
+                CAN_LAST_CONTROL.status=ERROR;
 
                 /* Set the state of the cartridge to 'error'. If this occurs then
                    the knowledge of the state of the hardware is compromised and
@@ -494,10 +463,7 @@ static void enableHandler(void) {
     /* If it's a monitor message on a control RCA */
     if(currentClass==CONTROL_CLASS){
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.
-                                     powerDistribution.
-                                      pdModule[currentPowerDistributionModule].
-                                       lastEnable)
+        RETURN_LAST_CONTROL_MESSAGE()
         return;
     }
 
@@ -55,7 +55,34 @@
                                                        6 -> enable */
     #define PD_MODULE_MODULES_MASK_SHIFT     1       // Bits right shift for the submodule mask
 
+    //! Control RCA of the enable of a power distribution module, for the last control message
+    #define PD_MODULE_ENABLE_RCA(module) \
+        (BASE_CONTROL_RCA+((unsigned long)POWER_DIST_MODULE<<MODULES_MASK_SHIFT)+((module)<<POWER_DISTRIBUTION_MODULES_MASK_SHIFT)+0x0000CL)
+
+    /* Async rails cache readout */
+    #define PD_RAILS_PER_BLOCK              2       // Channels returned by each GET_PD_RAILS message
+    #define PD_RAILS_BLOCKS                 (PD_CHANNELS_NUMBER/PD_RAILS_PER_BLOCK+1) // Channel blocks plus the age block
+
     /* Typedefs */
+    //! Rails of a power distribution module read by the async process
+    /*! This is a copy of the voltage and current of every channel of the
+        module, taken at the end of a complete async sweep of the module.
+        \ingroup    powerDistribution
+        \param      rail[Ch]    This contains the channels as in \ref PD_MODULE
+        \param      time        This contains the clock() time in ms of the end
+                                    of the sweep, 0 if the module was never
+                                    swept.
+        \param      status      This contains \ref NO_ERROR if all the
+                                    readings of the sweep succeeded. */
+    typedef struct {
+        //! Channel readings
+        PD_CHANNEL      rail[PD_CHANNELS_NUMBER];
+        //! Time of the end of the sweep in ms
+        unsigned long   time;
+        //! Status of the sweep
+        int             status;
+    } PD_RAILS_CACHE;
+
     //! Current state of the power distribution module system
     /*! This structure represent the current state of the power distribution
         module system.
@@ -72,11 +99,7 @@
                                         register holding the last issued
                                         control:
                                             - \ref PD_MODULE_DISABLE -> Disable/OFF
-                                            - \ref PD_MODULE_ENABLE -> Enable/ON
-        \param      lastEnable          This contains a copy of the last issued
-                                        control message to enable the state of
-                                        this module of the power distribution
-                                        system. */
+                                            - \ref PD_MODULE_ENABLE -> Enable/ON */
     typedef struct {
         //! Current state of the power distribution module channel
         /*! In every power distribution module there is one channel available
@@ -100,10 +123,10 @@
                         value is the one stored by the software after a control
                         command has been issued. */
         unsigned char   enable;
-        //! Last control message: pdModule state
-        /*! This is the content of the last control message sent to the power
-            distribution module state. */
-        LAST_CONTROL_MESSAGE    lastEnable;
+        //! Async rail readings
+        /*! This is the latest complete async sweep of the channels of this
+            module. Please see \ref PD_RAILS_CACHE for more information. */
+        PD_RAILS_CACHE          railsCache;
     } PD_MODULE;
 
     /* Globals */
@@ -25,13 +25,41 @@
 #include "error.h"
 #include "frontend.h"
 #include "serialInterface.h"
+#include "serialProfile.h"
 #include "timer.h"
 
 /* Globals */
 /* Externs */
+/* Conversion of the ADC counts of each channel, in the order of the
+   PLUS_6...PLUS_8 defines */
+const ADC_SCALE pdCurrentScale[PD_CHANNELS_NUMBER]={{ADC_SCALE_MILLI(PD_ADC_PLUS_6I_SCALE), 0L},
+                                                    {ADC_SCALE_MILLI(PD_ADC_MINUS_6I_SCALE), 0L},
+                                                    {ADC_SCALE_MILLI(PD_ADC_PLUS_15I_SCALE), 0L},
+                                                    {ADC_SCALE_MILLI(PD_ADC_MINUS_15I_SCALE), 0L},
+                                                    {ADC_SCALE_MILLI(PD_ADC_PLUS_24I_SCALE), 0L},
+                                                    {ADC_SCALE_MILLI(PD_ADC_PLUS_8I_SCALE), 0L}};
+const ADC_SCALE pdVoltageScale[PD_CHANNELS_NUMBER]={{ADC_SCALE_MILLI(PD_ADC_PLUS_6V_SCALE), 0L},
+                                                    {ADC_SCALE_MILLI(PD_ADC_MINUS_6V_SCALE), 0L},
+                                                    {ADC_SCALE_MILLI(PD_ADC_PLUS_15V_SCALE), 0L},
+                                                    {ADC_SCALE_MILLI(PD_ADC_MINUS_15V_SCALE), 0L},
+                                                    {ADC_SCALE_MILLI(PD_ADC_PLUS_24V_SCALE), 0L},
+                                                    {ADC_SCALE_MILLI(PD_ADC_PLUS_8V_SCALE), 0L}};
 /* Statics */
 PD_REGISTERS pdRegisters;
 
+/* Power distribution analog monitor request.
+   This function profiles the analog monitor cycle below. See serialProfile.h. */
+static int getPdAnalogMonitor(void){
+
+    int ret;
+
+    serialProfileBegin(SERIAL_PROFILE_PD_ANALOG);
+    ret=getPdAnalogMonitorCycle();
+    serialProfileEnd(SERIAL_PROFILE_PD_ANALOG, ret);
+
+    return ret;
+}
+
 /* Power distribution analog monitor request core.
    This function performs the core operations that are common to all the analog
    monitor request for the power distribution module:
@@ -44,7 +72,7 @@ PD_REGISTERS pdRegisters;
 
    If an error happens during the process it will return ERROR, otherwise
    NO_ERROR will be returned. */
-static int getPdAnalogMonitor(void){
+static int getPdAnalogMonitorCycle(void){
 
     /* A temporary variable to deal with the timer. */
     int timedOut;
@@ -236,15 +264,16 @@ int setPdModuleEnable(unsigned char enable){
             - updating BREG
         -# Execute the core get functions common to all the analog monitor
            requests for the power distribution module.
-        -# Scale the raw binary data with the correct unit and store the results
-           in the \ref frontend variable.
+        -# Store the raw ADC counts in the \ref frontend variable. They are
+           converted with \ref pdCurrentScale or \ref pdVoltageScale when the
+           value is returned.
 
     \return
         - \ref NO_ERROR -> if no error occurred
         - \ref ERROR    -> if something wrong happened */
 int getPdChannel(void){
 
-    /* A float to hold the scaling factor */
+    /* A float to hold the simulated voltage */
     float scale=0.0;
 
     if (frontend.mode != SIMULATION_MODE) {
@@ -270,67 +299,24 @@ int getPdChannel(void){
             return ERROR;
         }
 
-        /* 6 - Scale the data */
+        /* 6 - Store the raw counts. They are scaled with pdCurrentScale or
+               pdVoltageScale only when a value is returned. */
         switch(currentPdChannelModule){
             case PD_CHANNEL_CURRENT:
-                switch(currentPdModuleModule){
-                    case PLUS_6:
-                        scale=PD_ADC_PLUS_6I_SCALE;
-                        break;
-                    case MINUS_6:
-                        scale=PD_ADC_MINUS_6I_SCALE;
-                        break;
-                    case PLUS_15:
-                        scale=PD_ADC_PLUS_15I_SCALE;
-                        break;
-                    case MINUS_15:
-                        scale=PD_ADC_MINUS_15I_SCALE;
-                        break;
-                    case PLUS_24:
-                        scale=PD_ADC_PLUS_24I_SCALE;
-                        break;
-                    case PLUS_8:
-                        scale=PD_ADC_PLUS_8I_SCALE;
-                        break;
-                    default:
-                        break;
-                }
                 frontend.
                  powerDistribution.
                   pdModule[currentPowerDistributionModule].
                    pdChannel[currentPdModuleModule].
-                    current=(scale*pdRegisters.
-                                                   adcData)/PD_ADC_RANGE;
+                    current=pdRegisters.
+                             adcData;
                 break;
             case PD_CHANNEL_VOLTAGE:
-                switch(currentPdModuleModule){
-                    case PLUS_6:
-                        scale=PD_ADC_PLUS_6V_SCALE;
-                        break;
-                    case MINUS_6:
-                        scale=PD_ADC_MINUS_6V_SCALE;
-                        break;
-                    case PLUS_15:
-                        scale=PD_ADC_PLUS_15V_SCALE;
-                        break;
-                    case MINUS_15:
-                        scale=PD_ADC_MINUS_15V_SCALE;
-                        break;
-                    case PLUS_24:
-                        scale=PD_ADC_PLUS_24V_SCALE;
-                        break;
-                    case PLUS_8:
-                        scale=PD_ADC_PLUS_8V_SCALE;
-                        break;
-                    default:
-                        break;
-                }
                 frontend.
                  powerDistribution.
                   pdModule[currentPowerDistributionModule].
                    pdChannel[currentPdModuleModule].
-                    voltage=(scale*pdRegisters.
-                                                   adcData)/PD_ADC_RANGE;
+                    voltage=pdRegisters.
+                             adcData;
                 break;
             default:
                 break;
@@ -341,8 +327,9 @@ int getPdChannel(void){
             case PD_CHANNEL_CURRENT:
                 frontend.powerDistribution.pdModule[currentPowerDistributionModule].
                         pdChannel[currentPdModuleModule].current =
-                    (float) frontend.powerDistribution.pdModule[currentPowerDistributionModule].
-                        enable * 1.0 + (float) currentPdModuleModule * 0.01;
+                    adcScaleCounts((float) frontend.powerDistribution.pdModule[currentPowerDistributionModule].
+                                       enable * 1.0 + (float) currentPdModuleModule * 0.01,
+                                   &pdCurrentScale[currentPdModuleModule]);
                 break;
             case PD_CHANNEL_VOLTAGE:
                 switch(currentPdModuleModule) {
@@ -369,7 +356,8 @@ int getPdChannel(void){
                 }
                 frontend.powerDistribution.pdModule[currentPowerDistributionModule]
                         .pdChannel[currentPdModuleModule].voltage =
-                        (float) frontend.powerDistribution.pdModule[currentPowerDistributionModule].enable * scale;
+                    adcScaleCounts((float) frontend.powerDistribution.pdModule[currentPowerDistributionModule].enable * scale,
+                                   &pdVoltageScale[currentPdModuleModule]);
                 break;
             default:
                 break;
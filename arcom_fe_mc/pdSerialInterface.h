@@ -19,6 +19,17 @@
 #ifndef _PDSERIALINTERFACE_H
     #define _PDSERIALINTERFACE_H
 
+    /* Extra includes */
+    /* ADC_SCALE */
+    #ifndef _ADCSCALE_H
+        #include "adcScale.h"
+    #endif /* _ADCSCALE_H */
+
+    /* PD_CHANNELS_NUMBER */
+    #ifndef _PDCHANNEL_H
+        #include "pdChannel.h"
+    #endif /* _PDCHANNEL_H */
+
     /* Defines */
     /* General */
     #define PD_AREG             0
@@ -272,9 +283,15 @@
     /* Externs */
     extern PD_REGISTERS pdRegisters; //!< Power Distribution Registers
 
+    /* Globals */
+    /* Externs */
+    extern const ADC_SCALE pdCurrentScale[PD_CHANNELS_NUMBER]; //!< Conversion of the channel current counts to A
+    extern const ADC_SCALE pdVoltageScale[PD_CHANNELS_NUMBER]; //!< Conversion of the channel voltage counts to V
+
     /* Prototypes */
     /* Statics */
     static int getPdAnalogMonitor(void); // Perform core analog monitor functions
+    static int getPdAnalogMonitorCycle(void); // Analog monitor cycle, without the profiling
 
     /* Externs */
     extern int setPdModuleEnable(unsigned char enable); //!< This function enables/disables the selected power distribution module
@@ -13,6 +13,7 @@
 
 #include "debug.h"
 #include "frontend.h"
+#include "lastControl.h"
 #include "error.h"
 #include "lprSerialInterface.h"
 
@@ -97,7 +98,7 @@ void conversionCoeffHandler(void) {
     /* If control (size !=0) */
     if(CAN_SIZE) {
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.lpr.edfa.photoDetector.lastCoeff)
+        SAVE_LAST_CONTROL_MESSAGE()
 
         /* Extract the float from the can message. */
         changeEndian(CONV_CHR_ADD, CAN_DATA_ADD);
@@ -110,7 +111,7 @@ void conversionCoeffHandler(void) {
     /* If monitor on a control RCA */
     if(currentClass==CONTROL_CLASS){
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.lpr.edfa.photoDetector.lastCoeff)
+        RETURN_LAST_CONTROL_MESSAGE()
         return;
     }
     
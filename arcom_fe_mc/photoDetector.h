@@ -48,10 +48,6 @@
             photodetector. */
         float   coeff;
 
-        //! Last control message: conversion coefficient
-        /*! This is the content of the last control message sent to the LNA led
-            state. */
-        LAST_CONTROL_MESSAGE    lastCoeff;
 
     } PHOTO_DETECTOR;
 
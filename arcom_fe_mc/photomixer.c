@@ -13,6 +13,7 @@
 
 #include "error.h"
 #include "frontend.h"
+#include "lastControl.h"
 #include "loSerialInterface.h"
 #include "debug.h"
 
@@ -59,23 +60,14 @@ static void enableHandler(void){
     /* Check direction and perform the required operation */
     if(CAN_SIZE){ // If control (size !=0)
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.
-                                   cartridge[currentModule].
-                                    lo.
-                                     photomixer.
-                                      lastEnable)
+        SAVE_LAST_CONTROL_MESSAGE()
 
         /* Change the status of the photomixer according to the content of the
            CAN message. */
         if(setPhotomixerEnable(CAN_BYTE?PHOTOMIXER_ENABLE:
                                         PHOTOMIXER_DISABLE)==ERROR){
             /* Store the ERROR state in the last control message variable */
-            frontend.
-             cartridge[currentModule].
-              lo.
-               photomixer.
-                lastEnable.
-                 status=ERROR;
+            CAN_LAST_CONTROL.status=ERROR;
 
             return;
         }
@@ -87,11 +79,7 @@ static void enableHandler(void){
     /* If monitor on control RCA */
     if(currentClass==CONTROL_CLASS){
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.
-                                     cartridge[currentModule].
-                                      lo.
-                                       photomixer.
-                                        lastEnable)
+        RETURN_LAST_CONTROL_MESSAGE()
         return;
     }
 
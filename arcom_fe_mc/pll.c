@@ -12,6 +12,7 @@
 
 #include "error.h"
 #include "frontend.h"
+#include "lastControl.h"
 #include "loSerialInterface.h"
 #include "debug.h"
 
@@ -449,22 +450,13 @@ static void clearUnlockDetectLatchHandler(void){
     /* Check direction and perform the required operation */
     if(CAN_SIZE){ // If control (size !=0)
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.
-                                   cartridge[currentModule].
-                                    lo.
-                                     pll.
-                                      lastClearUnlockDetectLatch)
+        SAVE_LAST_CONTROL_MESSAGE()
 
         /* Change the status of the PLL unlock detect latch according to the
            content of the CAN message. */
         if(setClearUnlockDetectLatch()==ERROR){
             /* Store the ERROR state in the last control message variable */
-            frontend.
-             cartridge[currentModule].
-              lo.
-               pll.
-                lastClearUnlockDetectLatch.
-                 status=ERROR;
+            CAN_LAST_CONTROL.status=ERROR;
 
             return;
         }
@@ -476,11 +468,7 @@ static void clearUnlockDetectLatchHandler(void){
     /* If monitor on control RCA */
     if(currentClass==CONTROL_CLASS){
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.
-                                     cartridge[currentModule].
-                                      lo.
-                                       pll.
-                                        lastClearUnlockDetectLatch)
+        RETURN_LAST_CONTROL_MESSAGE()
         return;
     }
 
@@ -502,22 +490,13 @@ static void loopBandwidthSelectHandler(void){
     /* Check direction and perform the required operation */
     if(CAN_SIZE){ // If control (size !=0)
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.
-                                   cartridge[currentModule].
-                                    lo.
-                                     pll.
-                                      lastLoopBandwidthSelect)
+        SAVE_LAST_CONTROL_MESSAGE()
 
         /* Change the status of the PLL loop BW according to the content of the CAN message. */
         if(setLoopBandwidthSelect(CAN_BYTE?PLL_LOOP_BANDWIDTH_ALTERNATE:
                                            PLL_LOOP_BANDWIDTH_DEFAULT)==ERROR){
             /* Store the ERROR state in the last control message variable */
-            frontend.
-             cartridge[currentModule].
-              lo.
-               pll.
-                lastLoopBandwidthSelect.
-                 status=ERROR;
+            CAN_LAST_CONTROL.status=ERROR;
 
             return;
         }
@@ -529,11 +508,7 @@ static void loopBandwidthSelectHandler(void){
     /* If monitor on control RCA */
     if(currentClass==CONTROL_CLASS){
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.
-                                     cartridge[currentModule].
-                                      lo.
-                                       pll.
-                                        lastLoopBandwidthSelect)
+        RETURN_LAST_CONTROL_MESSAGE()
         return;
     }
 
@@ -562,23 +537,14 @@ static void sidebandLockPolaritySelectHandler(void){
     /* Check direction and perform the required operation */
     if(CAN_SIZE){ // If control (size !=0)
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.
-                                   cartridge[currentModule].
-                                    lo.
-                                     pll.
-                                      lastSidebandLockPolaritySelect)
+        SAVE_LAST_CONTROL_MESSAGE()
 
         /* Change the status of the PLL unlock detect latch according to the
            content of the CAN message. */
            if(setSidebandLockPolaritySelect(CAN_BYTE?PLL_SIDEBAND_LOCK_POLARITY_USB:
                                                      PLL_SIDEBAND_LOCK_POLARITY_LSB)==ERROR){
             /* Store the ERROR state in the last control message variable */
-            frontend.
-             cartridge[currentModule].
-              lo.
-               pll.
-                lastSidebandLockPolaritySelect.
-                 status=ERROR;
+            CAN_LAST_CONTROL.status=ERROR;
 
             return;
         }
@@ -590,11 +556,7 @@ static void sidebandLockPolaritySelectHandler(void){
     /* If monitor on control RCA */
     if(currentClass==CONTROL_CLASS){
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.
-                                     cartridge[currentModule].
-                                      lo.
-                                       pll.
-                                        lastSidebandLockPolaritySelect)
+        RETURN_LAST_CONTROL_MESSAGE()
         return;
     }
 
@@ -624,23 +586,14 @@ static void nullLoopIntegratorHandler(void){
     /* Check direction and perform the required operation */
     if(CAN_SIZE){ // If control (size !=0)
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.
-                                   cartridge[currentModule].
-                                    lo.
-                                     pll.
-                                      lastNullLoopIntegrator)
+        SAVE_LAST_CONTROL_MESSAGE()
 
         /* Change the status of the PLL unlock detect latch according to the
            content of the CAN message. */
            if(setNullLoopIntegrator(CAN_BYTE?PLL_NULL_LOOP_INTEGRATOR_NULL:
                                              PLL_NULL_LOOP_INTEGRATOR_OPERATE)==ERROR){
             /* Store the ERROR state in the last control message variable */
-            frontend.
-             cartridge[currentModule].
-              lo.
-               pll.
-                lastNullLoopIntegrator.
-                 status=ERROR;
+            CAN_LAST_CONTROL.status=ERROR;
 
             return;
         }
@@ -652,11 +605,7 @@ static void nullLoopIntegratorHandler(void){
     /* If monitor on control RCA */
     if(currentClass==CONTROL_CLASS){
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.
-                                     cartridge[currentModule].
-                                      lo.
-                                       pll.
-                                        lastNullLoopIntegrator)
+        RETURN_LAST_CONTROL_MESSAGE()
         return;
     }
 
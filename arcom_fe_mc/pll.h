@@ -79,22 +79,6 @@
         //! Null the loop integrator
         /*! This bit controls the operation of the PLL loop integrator. */
         char    nullLoopIntegrator;
-        //! Last control message: clear unlock latched bit
-        /*! This is the content of the last control message sent to the PLL
-            clear unlock latched bit. */
-        LAST_CONTROL_MESSAGE    lastClearUnlockDetectLatch;
-        //! Last control message: loop bandwidth select
-        /*! This is the content of the last control message sent to the PLL
-            select lock polarity register. */
-        LAST_CONTROL_MESSAGE    lastLoopBandwidthSelect;
-        //! Last control message: sideband lock polarity select
-        /*! This is the content of the last control message sent to the PLL
-            sideband lock polarity select. */
-        LAST_CONTROL_MESSAGE    lastSidebandLockPolaritySelect;
-        //! Last control message: null loop integrator
-        /*! This is the content of the last control message sent to the PLL
-            null loop integrator. */
-        LAST_CONTROL_MESSAGE    lastNullLoopIntegrator;
     } PLL;
 
     /* Globals */
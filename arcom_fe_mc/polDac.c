@@ -12,6 +12,7 @@
 #include <stdio.h>      /* printf */
 
 #include "frontend.h"
+#include "lastControl.h"
 #include "error.h"
 #include "biasSerialInterface.h"
 #include "debug.h"
@@ -58,23 +59,12 @@ static void resetStrobeHandler(void){
     /* Check direction and perform the required operation */
     if(CAN_SIZE){ // If control (size !=0)
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.
-                                   cartridge[currentModule].
-                                    polarization[currentBiasModule].
-                                     polSpecialMsgs.
-                                      polDac[currentPolSpecialMsgsModule].
-                                       lastResetStrobe)
+        SAVE_LAST_CONTROL_MESSAGE()
 
         /* Send the strobe */
         if(setBiasDacStrobe()==ERROR){
             /* Store the ERROR state in the last control message variable */
-            frontend.
-             cartridge[currentModule].
-              polarization[currentBiasModule].
-               polSpecialMsgs.
-                polDac[currentPolSpecialMsgsModule].
-                 lastResetStrobe.
-                  status=ERROR;
+            CAN_LAST_CONTROL.status=ERROR;
 
             return;
         }
@@ -84,12 +74,7 @@ static void resetStrobeHandler(void){
     /* If it's a monitor message on a control RCA */
     if(currentClass==CONTROL_CLASS){ // If monitor on a control RCA
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.
-                                     cartridge[currentModule].
-                                      polarization[currentBiasModule].
-                                       polSpecialMsgs.
-                                        polDac[currentPolSpecialMsgsModule].
-                                         lastResetStrobe)
+        RETURN_LAST_CONTROL_MESSAGE()
         return;
 
     }
@@ -121,23 +106,12 @@ static void clearStrobeHandler(void){
     /* Check direction and perform the required operation */
     if(CAN_SIZE){ // If control (size !=0)
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.
-                                   cartridge[currentModule].
-                                    polarization[currentBiasModule].
-                                     polSpecialMsgs.
-                                      polDac[currentPolSpecialMsgsModule].
-                                       lastClearStrobe)
+        SAVE_LAST_CONTROL_MESSAGE()
 
         /* Send the strobe */
         if(setBiasDacStrobe()==ERROR){
             /* Store the ERROR state in the last control message variable. */
-            frontend.
-             cartridge[currentModule].
-              polarization[currentBiasModule].
-               polSpecialMsgs.
-                polDac[currentPolSpecialMsgsModule].
-                 lastClearStrobe.
-                  status=ERROR;
+            CAN_LAST_CONTROL.status=ERROR;
 
             return;
         }
@@ -147,12 +121,7 @@ static void clearStrobeHandler(void){
     /* If it's a monitor message on a control RCA */
     if(currentClass==CONTROL_CLASS){ // If monitor on a control RCA
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.
-                                     cartridge[currentModule].
-                                      polarization[currentBiasModule].
-                                       polSpecialMsgs.
-                                        polDac[currentPolSpecialMsgsModule].
-                                         lastClearStrobe)
+        RETURN_LAST_CONTROL_MESSAGE()
     }
 
     /* If monitor on monitor RCA: this should never happen because there are
@@ -46,20 +46,8 @@
         by the reception of the message independently from the payload, this
         structure is necessary exclusively to prevent monitor messages on these
         control addresses from timing out. The returned payload has no meaning.
-        \ingroup    polSpecialMsgs
-        \param      lastResetStrobe     This contains a copy of the last issued
-                                        control message to the reset strobe.
-        \param      lastClearStrobe     This contains a copy of the last issued
-                                        control message to the clear strobe. */
+        \ingroup    polSpecialMsgs */
     typedef struct {
-        //! Last control message: DAC reset strobe
-        /*! This is the content of the last control message sent to the dac
-            reset strobe. */
-        LAST_CONTROL_MESSAGE    lastResetStrobe;
-        //! Last control message: DAC clear strobe
-        /*! This is the content of the last control message sent to the dac
-            clear strobe. */
-        LAST_CONTROL_MESSAGE    lastClearStrobe;
     } POL_DAC;
 
     /* Globals */
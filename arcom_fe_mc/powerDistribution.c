@@ -9,11 +9,15 @@
 
 /* Includes */
 #include <stdio.h>      /* printf */
+#include <string.h>     /* memcpy */
+#include <time.h>       /* clock */
 
 #include "debug.h"
 #include "frontend.h"
 #include "error.h"
+#include "async.h"
 #include "pdSerialInterface.h"
+#include "sensorStats.h"
 
 
 /* Globals */
@@ -31,6 +35,10 @@ static HANDLER powerDistributionModulesHandler[POWER_DISTRIBUTION_MODULES_NUMBER
                                                                                    pdModuleHandler,
                                                                                    pdModuleHandler,
                                                                                    poweredModulesHandler};
+/* Async sweep of the rails */
+static unsigned char currentAsyncPdModule=0;    // Module being swept
+static unsigned char currentAsyncPdPoint=0;     // Next monitor point: channel*2+current/voltage
+static int asyncPdRailsError=NO_ERROR;          // Status of the sweep in progress
 
 /* Power distribution handler */
 /*! This function will be called by the CAN message handler when the received
@@ -159,3 +167,81 @@ int powerDistributionStop(void){
 
     return NO_ERROR;
 }
+
+/* Power distribution async */
+/*! This function reads one voltage or current of the enabled power
+    distribution modules at every call. When all the channels of a module have
+    been read, they are copied with a time stamp into the module \ref
+    PD_RAILS_CACHE, which is returned by the GET_PD_RAILS special monitor RCAs.
+    Each current read is also added to the running statistics of its rail.
+    \return
+        - \ref NO_ERROR     -> if more monitor points are left to read
+        - \ref ASYNC_DONE   -> if all the enabled modules were swept */
+int powerDistributionAsync(void){
+
+    PD_MODULE *pdModule;
+
+    /* Skip the modules that are not powered */
+    while(frontend.
+           powerDistribution.
+            pdModule[currentAsyncPdModule].
+             enable==PD_MODULE_DISABLE){
+        currentAsyncPdPoint=0;
+        asyncPdRailsError=NO_ERROR;
+        if(++currentAsyncPdModule==PD_MODULES_NUMBER){
+            currentAsyncPdModule=0;
+            return ASYNC_DONE;
+        }
+    }
+
+    /* Address the monitor point */
+    currentModule=POWER_DIST_MODULE;
+    currentPowerDistributionModule=currentAsyncPdModule;
+    currentPdModuleModule=currentAsyncPdPoint/PD_CHANNEL_MODULES_NUMBER;
+    currentPdChannelModule=currentAsyncPdPoint%PD_CHANNEL_MODULES_NUMBER;
+
+    if(getPdChannel()==ERROR){
+        asyncPdRailsError=ERROR;
+    } else if(currentPdChannelModule==PD_CHANNEL_CURRENT){
+        sensorStatsUpdate(STATS_PD_CURRENT+currentAsyncPdModule*PD_CHANNELS_NUMBER+currentPdModuleModule,
+                          adcScaleFloat(frontend.
+                                         powerDistribution.
+                                          pdModule[currentAsyncPdModule].
+                                           pdChannel[currentPdModuleModule].
+                                            current,
+                                        &pdCurrentScale[currentPdModuleModule]));
+    }
+
+    /* Next monitor point */
+    if(++currentAsyncPdPoint<PD_CHANNELS_NUMBER*PD_CHANNEL_MODULES_NUMBER){
+        return NO_ERROR;
+    }
+
+    /* Module done: store the sweep in the cache */
+    pdModule=&frontend.
+               powerDistribution.
+                pdModule[currentAsyncPdModule];
+    memcpy((*pdModule).railsCache.rail,
+           (*pdModule).pdChannel,
+           sizeof((*pdModule).railsCache.rail));
+    (*pdModule).railsCache.time=clock();
+    (*pdModule).railsCache.status=asyncPdRailsError;
+
+    #ifdef DEBUG_POWERDIS_ASYNC
+        printf("Async -> Power Distribution -> Module %d swept at %lu ms (%d)\n",
+               currentAsyncPdModule,
+               (*pdModule).railsCache.time,
+               asyncPdRailsError);
+    #endif /* DEBUG_POWERDIS_ASYNC */
+
+    currentAsyncPdPoint=0;
+    asyncPdRailsError=NO_ERROR;
+
+    /* Next module, if wrap around, we're done */
+    if(++currentAsyncPdModule==PD_MODULES_NUMBER){
+        currentAsyncPdModule=0;
+        return ASYNC_DONE;
+    }
+
+    return NO_ERROR;
+}
@@ -101,5 +101,6 @@
     extern int powerDistributionStartup(void); //!< This function deals with the initialization of the power distribution system
     extern void powerDistributionHandler(void); //!< This function deals with the incoming can message
     extern int powerDistributionStop(void); //!< This function deals with the shut down of the power distribution system
+    extern int powerDistributionAsync(void); //!< This function deals with the asynchronous monitor of the power distribution rails
 
 #endif /* _POWERDISTRIBUTION_H */
@@ -19,6 +19,7 @@
 #include "error.h"
 #include "timer.h"
 #include "ppComm.h"
+#include "ambsiEmulator.h"
 #include "pegasus.h"
 #include "debug.h"
 #include "globalDefinitions.h"
@@ -36,12 +37,59 @@ static unsigned int headerTimeout, payloadTimeout, writeTimeout;
 /* Externs */
 unsigned char PPRxBuffer[CAN_RX_MESSAGE_SIZE];
 unsigned char PPTxBuffer[CAN_TX_MAX_PAYLOAD_SIZE];
+volatile unsigned long PPRxTicks;
+
+#ifdef PP_BENCHMARK
+    //! Time spent in the interrupt handler and in PPWrite(), in readFineTimer() counts
+    static unsigned long isrCalls, isrTime, isrMax, writeCalls, writeTime, writeMax;
+#endif /* PP_BENCHMARK */
 
 /* Helper macros */
 
-/*! Set a bit in the control port */
-#define SETCONTROL(WHAT, VAL) { \
-    outp(SPPControlPort, VAL ? (inp(SPPControlPort) | WHAT) : (inp(SPPControlPort) &~ WHAT)); }
+#ifdef PP_BYTE_IO
+    /*! Set a bit in the control port */
+    #define SETCONTROL(WHAT, VAL) { \
+        outp(SPPControlPort, VAL ? (inp(SPPControlPort) | WHAT) : (inp(SPPControlPort) &~ WHAT)); }
+
+    /*! Read and write the EPP data port one byte at a time */
+    #define PP_READ_BLOCK(BUF, N) { \
+        unsigned char _cnt; for (_cnt = 0; _cnt < (N); _cnt++) (BUF)[_cnt] = inp(EPPDataPort); }
+    #define PP_WRITE_BLOCK(BUF, N) { \
+        unsigned char _cnt; for (_cnt = 0; _cnt < (N); _cnt++) outp(EPPDataPort, (BUF)[_cnt]); }
+
+    /*! Detect and clear an EPP timeout */
+    #define PP_TIMEOUT() PPClearTimeout()
+#else
+    /* Fast path */
+    static unsigned char controlShadow; // Last value written to the control port
+
+    /*! Set a bit in the control port.  The port is never read back: the
+        shadow holds the value last written. */
+    #define SETCONTROL(WHAT, VAL) { \
+        controlShadow = VAL ? (controlShadow | WHAT) : (controlShadow &~ WHAT); \
+        outp(SPPControlPort, controlShadow); }
+
+    /*! Read and write the EPP data port with a single string I/O instruction */
+    #define PP_READ_BLOCK(BUF, N)   PPInBlock(BUF, EPPDataPort, N)
+    #define PP_WRITE_BLOCK(BUF, N)  PPOutBlock(BUF, EPPDataPort, N)
+
+    /*! Detect an EPP timeout with a single status read, and only go through
+        PPClearTimeout() when the hardware flags one */
+    #define PP_TIMEOUT() ((inp(SPPStatusPort) & EPPS_TIMEOUT) ? PPClearTimeout() : 0)
+
+    /* The direction flag is cleared because the handler can interrupt any code */
+    #pragma aux PPInBlock = \
+        "cld" \
+        "rep insb" \
+        parm [es di] [dx] [cx] \
+        modify exact [di cx];
+
+    #pragma aux PPOutBlock = \
+        "cld" \
+        "rep outs dx, byte ptr es:[si]" \
+        parm [es si] [dx] [cx] \
+        modify exact [si cx];
+#endif /* PP_BYTE_IO */
 
 /*! Get a bit from the control port */
 #define GETCONTROL(WHAT) (inp(SPPControlPort) & WHAT) ? 1 : 0
@@ -137,6 +185,11 @@ int PPOpen(void) {
     SPPControlPort = SPPDataPort + 2; // Define SPP Control Port
     EPPDataPort = SPPDataPort + 4;    // Define EPP Data Port
 
+    #ifndef PP_BYTE_IO
+        /* Start the shadow from the current state of the control port */
+        controlShadow = inp(SPPControlPort);
+    #endif /* PP_BYTE_IO */
+
     /* Text below is from:
      * Peacock, C. (2000). Interfacing the parallel port.
      * Retrieved December 17, 2021, from http://wearcam.org/seatsale/programs/www.beyondlogic.org/epp/epp.htm
@@ -253,7 +306,13 @@ int PPClose(void) {
 /*! This function will transmit \p length bytes of data on the parallel port.
     \param  length  an unsigned char */
 void PPWrite(unsigned char length) {
-    unsigned char i;
+    #ifdef PP_BENCHMARK
+        unsigned long start = readFineTimer();
+    #endif /* PP_BENCHMARK */
+
+    // The reply to an emulated message stays off the port:
+    if (ambsiEmulatorReply(length))
+        return;
 
     // Set direction to output:
     SETCONTROL(SPPC_DATADIR, 0)
@@ -262,22 +321,51 @@ void PPWrite(unsigned char length) {
     outp(EPPDataPort, length);
 
     // Write the data bytes:
-    for (i = 0; i < length; i++) {
-        outp(EPPDataPort, PPTxBuffer[i]);
-    }
+    PP_WRITE_BLOCK(PPTxBuffer, length);
 
     // Set direction to input for next message:
     SETCONTROL(SPPC_DATADIR, 1)
 
     // Detect and clear EPP timeout:
-    if (PPClearTimeout())
+    if (PP_TIMEOUT())
         writeTimeout++;
+
+    #ifdef PP_BENCHMARK
+        start = readFineTimer() - start;
+        writeCalls++;
+        writeTime += start;
+        if (start > writeMax)
+            writeMax = start;
+    #endif /* PP_BENCHMARK */
 }
 
 /* Interrupt function receives CAN_MESSAGE_SIZE bytes from the parallel port and stores them in message */
 static void interrupt far PPIntHandler(void) {
+    #ifdef PP_BENCHMARK
+        unsigned long start = readFineTimer();
+    #endif /* PP_BENCHMARK */
+
+    // Arrival time for the CAN trace:
+    PPRxTicks = PP_BIOS_TICKS;
+
+    PPReceive();
+
+    #ifdef PP_BENCHMARK
+        start = readFineTimer() - start;
+        isrCalls++;
+        isrTime += start;
+        if (start > isrMax)
+            isrMax = start;
+    #endif /* PP_BENCHMARK */
+}
+
+/* Read the message announced by the interrupt into PPRxBuffer */
+static void PPReceive(void) {
 
-    unsigned char i, payloadSize;
+    unsigned char payloadSize;
+    #ifdef DEBUG_PPCOM
+        unsigned char i;
+    #endif /* DEBUG_PPCOM */
 
     #ifdef DEBUG_PPCOM
         printf("Interrupt Received!\n");
@@ -287,9 +375,7 @@ static void interrupt far PPIntHandler(void) {
     #ifdef DEBUG_PPCOM
         printf("  CAN Header:\n");
     #endif /* DEBUG_PPCOM */
-    for (i = 0; i < CAN_RX_HEADER_SIZE; i++) {
-        PPRxBuffer[i] = inp(EPPDataPort);
-    }
+    PP_READ_BLOCK(PPRxBuffer, CAN_RX_HEADER_SIZE);
 
     #ifdef DEBUG_PPCOM
         for (i = 0; i < CAN_RX_HEADER_SIZE; i++) {
@@ -298,13 +384,17 @@ static void interrupt far PPIntHandler(void) {
     #endif /* DEBUG_PPCOM */
 
     // Detect and clear EPP timeout:
-    if (PPClearTimeout()) {
+    if (PP_TIMEOUT()) {
         headerTimeout++;
         return;
     }
 
     payloadSize = PPRxBuffer[CAN_RX_HEADER_SIZE - 1];
 
+    // Never read past the end of the buffer:
+    if (payloadSize > CAN_RX_MAX_PAYLOAD_SIZE)
+        payloadSize = PPRxBuffer[CAN_RX_HEADER_SIZE - 1] = CAN_RX_MAX_PAYLOAD_SIZE;
+
     /* If the payload size is 0 then it is a monitor message */
     if (payloadSize == CAN_MONITOR) {
         #ifdef DEBUG_PPCOM
@@ -320,9 +410,7 @@ static void interrupt far PPIntHandler(void) {
     }
 
     /* If it's a control message, load the payload */
-    for (i = 0; i < payloadSize; i++) {
-        PPRxBuffer[CAN_RX_HEADER_SIZE + i] = inp(EPPDataPort);
-    }
+    PP_READ_BLOCK(&PPRxBuffer[CAN_RX_HEADER_SIZE], payloadSize);
 
     #ifdef DEBUG_PPCOM
         printf("  Control message\n");
@@ -333,7 +421,7 @@ static void interrupt far PPIntHandler(void) {
     #endif /* DEBUG_PPCOM */
 
     // Detect and clear EPP timeout:
-    if (PPClearTimeout())
+    if (PP_TIMEOUT())
         payloadTimeout++;
 
     /* Notify program of new message */
@@ -348,6 +436,10 @@ static void interrupt far PPIntHandler(void) {
     to receive another message. Until the IRQ is cleared, all the other incoming
     messages will be ignored. */
 void PPClear(void) {
+    /* An emulated message raised no interrupt */
+    if (ambsiEmulatorDone())
+        return;
+
     outp(PPPICAddr, PIC_INT_CLR);
 }
 
@@ -371,6 +463,20 @@ void PPStatusReport(void) {
     printf("    nWait: %d     Data-dir: %d\n", GETSTATUS(EPPS_NWAIT), GETCONTROL(SPPC_DATADIR));
     printf(" Timeouts: header: %u  payload: %u  write: %u\n\n", headerTimeout, payloadTimeout, writeTimeout);
 
+    #ifdef PP_BENCHMARK
+        #ifdef PP_BYTE_IO
+            printf(" Byte I/O, times in us (mean/max):\n");
+        #else
+            printf(" String I/O, times in us (mean/max):\n");
+        #endif /* PP_BYTE_IO */
+        printf("  interrupt: %lu calls %lu/%lu\n",
+               isrCalls, (isrCalls) ? FINE_TIMER_TO_US(isrTime) / isrCalls : 0L, FINE_TIMER_TO_US(isrMax));
+        printf("  PPWrite:   %lu calls %lu/%lu\n\n",
+               writeCalls, (writeCalls) ? FINE_TIMER_TO_US(writeTime) / writeCalls : 0L, FINE_TIMER_TO_US(writeMax));
+        isrCalls = isrTime = isrMax = 0;
+        writeCalls = writeTime = writeMax = 0;
+    #endif /* PP_BENCHMARK */
+
     for (i = 0; i < CAN_RX_MESSAGE_SIZE; i++) {
         sprintf(buf + (3 * i), "%02X ", PPRxBuffer[i]);
     }
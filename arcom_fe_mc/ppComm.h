@@ -36,14 +36,22 @@
 
     #define PP_DEFAULT_IRQ_NO       0x07    //!< IRQ to be assigned to parallel port
 
+    /*! BIOS timer ticks since midnight, 18.2 per second.  A plain memory read,
+        safe in the interrupt handler. Needs i86.h for MK_FP. */
+    #define PP_BIOS_TICKS           (*((volatile unsigned long far *) MK_FP(0x0040, 0x006C)))
+
     /* Globals */
     /* Externs */
     extern unsigned char PPRxBuffer[CAN_RX_MESSAGE_SIZE];   //!< Parallel port received message buffer
     extern unsigned char PPTxBuffer[CAN_TX_MAX_PAYLOAD_SIZE];   //!< Parallel port transmitted message buffer
+    extern volatile unsigned long PPRxTicks;                //!< BIOS timer ticks at the last message interrupt
 
     /* Prototypes */
     /* Statics */
     static void interrupt far PPIntHandler(void); // Interrupt function to handle incoming messages
+    static void PPReceive(void);                  // Read the incoming message into PPRxBuffer
+    static void PPInBlock(unsigned char *buffer, unsigned int port, unsigned int count);        // rep insb, see the pragma in ppComm.c
+    static void PPOutBlock(const unsigned char *buffer, unsigned int port, unsigned int count); // rep outsb, see the pragma in ppComm.c
     /* Externs */
     extern int PPOpen(void);                        //!< Configure parallel port
     extern int PPClose(void);                       //!< Close parallel port
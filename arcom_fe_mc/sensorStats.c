@@ -0,0 +1,112 @@
+/*! \file   sensorStats.c
+    \brief  Running statistics of the async monitored sensors
+
+    See sensorStats.h for a description of the statistics.
+*/
+
+/* Includes */
+#include <math.h>       /* sqrt */
+#include <time.h>       /* clock */
+
+#include "sensorStats.h"
+#include "timer.h"
+#include "error.h"
+#include "globalDefinitions.h"
+
+/* Globals */
+SENSOR_STATS sensorStats;
+
+/* Statics */
+static STATS_ACCUMULATOR accumulator[STATS_CHANNELS_NUMBER];
+static clock_t windowStart = 0;
+
+/*! Add a sample to the current window.
+    Error and uninitialized values are not counted.
+    \param channel  one of the STATS_* channels
+    \param value    the new sample */
+void sensorStatsUpdate(unsigned char channel, float value) {
+    STATS_ACCUMULATOR *stats;
+    float delta;
+
+    if (channel >= STATS_CHANNELS_NUMBER || value == FLOAT_ERROR || value == FLOAT_UNINIT)
+        return;
+
+    stats = &accumulator[channel];
+
+    if (stats -> count == 0) {
+        stats -> min = value;
+        stats -> max = value;
+    } else if (value < stats -> min) {
+        stats -> min = value;
+    } else if (value > stats -> max) {
+        stats -> max = value;
+    }
+
+    // Welford's update:
+    stats -> count++;
+    delta = value - stats -> mean;
+    stats -> mean += delta / stats -> count;
+    stats -> m2 += delta * (value - stats -> mean);
+}
+
+/*! Close the current window and start a new one.
+    The results of the closed window are latched in \ref sensorStats. */
+void sensorStatsLatch(void) {
+    STATS_ACCUMULATOR *stats;
+    STATS_RESULT *result;
+    unsigned char channel;
+    clock_t now = clock();
+
+    for (channel = 0; channel < STATS_CHANNELS_NUMBER; channel++) {
+        stats = &accumulator[channel];
+        result = &sensorStats.result[channel];
+
+        result -> count = stats -> count;
+        if (stats -> count) {
+            result -> min = stats -> min;
+            result -> max = stats -> max;
+            result -> mean = stats -> mean;
+        } else {
+            result -> min = FLOAT_UNINIT;
+            result -> max = FLOAT_UNINIT;
+            result -> mean = FLOAT_UNINIT;
+        }
+        result -> stdDev = (stats -> count > 1) ? sqrt(stats -> m2 / (stats -> count - 1)) : 0.0;
+
+        stats -> count = 0;
+        stats -> mean = 0.0;
+        stats -> m2 = 0.0;
+    }
+
+    sensorStats.windowLength = now - windowStart;
+    windowStart = now;
+}
+
+/*! Set the automatic window period.
+    The current window is closed and the next one starts now.
+    \param period   window length in s, 0 to close windows on request only */
+void sensorStatsSetWindow(unsigned int period) {
+    stopAsyncTimer(TIMER_SENSOR_STATS);
+    sensorStats.windowPeriod = period;
+    sensorStatsLatch();
+}
+
+/*! Close the window when the window period expires.
+    This is called at every pass of the async loop. */
+void sensorStatsAsync(void) {
+    if (sensorStats.windowPeriod == 0)
+        return;
+
+    switch (queryAsyncTimer(TIMER_SENSOR_STATS)) {
+        case TIMER_RUNNING:
+            return;
+        case TIMER_EXPIRED:
+            sensorStatsLatch();
+            break;
+        default:
+            // First window after setting the period:
+            break;
+    }
+
+    startAsyncTimer(TIMER_SENSOR_STATS, 1000L * sensorStats.windowPeriod, TRUE);
+}
@@ -0,0 +1,91 @@
+/*! \file   sensorStats.h
+    \brief  Running statistics of the async monitored sensors
+
+    Every value stored by cryostatAsync() and fetimAsync(), and every rail
+    current read by the power distribution sweep of powerDistributionAsync(),
+    updates the running count, minimum, maximum, mean and variance of its sensor, with
+    Welford's single pass update.  The values are accumulated over a window.
+    Closing the window, on request or automatically every window period,
+    latches the results for readout through the GET_STATS_* special monitor
+    RCAs and starts a new window.  A single read per sensor per window then
+    replaces polling the raw value.
+
+    The rail voltages of the power distribution modules are not channels:
+    the GET_STATS_* RCAs hold 128 channels and the regulated voltages are
+    read from the GET_PD_RAILS cache. */
+
+#ifndef _SENSORSTATS_H
+    #define _SENSORSTATS_H
+
+    /* Extra includes */
+    /* CRYOSTAT_TEMP_SENSORS_NUMBER */
+    #ifndef _CRYOSTATTEMP_H
+        #include "cryostatTemp.h"
+    #endif /* _CRYOSTATTEMP_H */
+
+    /* VACUUM_SENSORS_NUMBER */
+    #ifndef _VACUUMSENSOR_H
+        #include "vacuumSensor.h"
+    #endif /* _VACUUMSENSOR_H */
+
+    /* FETIM_EXT_SENSORS_NUMBER */
+    #ifndef _FETIM_EXT_TEMP_H
+        #include "fetimExtTemp.h"
+    #endif /* _FETIM_EXT_TEMP_H */
+
+    /* PD_MODULES_NUMBER and PD_CHANNELS_NUMBER */
+    #ifndef _PDMODULE_H
+        #include "pdModule.h"
+    #endif /* _PDMODULE_H */
+
+    /* Defines */
+    /* Statistics channels */
+    #define STATS_CRYO_TEMP             0                                                   //!< Cryostat temperature sensors
+    #define STATS_VACUUM                (STATS_CRYO_TEMP+CRYOSTAT_TEMP_SENSORS_NUMBER)      //!< Cryostat and vacuum port pressures
+    #define STATS_FETIM_EXT_TEMP        (STATS_VACUUM+VACUUM_SENSORS_NUMBER)                //!< FETIM external temperatures
+    #define STATS_HE2_PRESS             (STATS_FETIM_EXT_TEMP+FETIM_EXT_SENSORS_NUMBER)     //!< FETIM He2 buffer tank pressure
+    #define STATS_PD_CURRENT            (STATS_HE2_PRESS+1)                                 //!< Power distribution rail currents, PD_CHANNELS_NUMBER per module
+    #define STATS_CHANNELS_NUMBER       (STATS_PD_CURRENT+PD_MODULES_NUMBER*PD_CHANNELS_NUMBER)
+
+    /* Typedefs */
+    //! Running statistics of one sensor over the current window
+    typedef struct {
+        unsigned long   count;  //!< Samples in the window
+        float           min;    //!< Smallest sample
+        float           max;    //!< Largest sample
+        float           mean;   //!< Running mean
+        float           m2;     //!< Running sum of the squared differences from the mean
+    } STATS_ACCUMULATOR;
+
+    //! Statistics of one sensor over the last closed window
+    typedef struct {
+        unsigned long   count;  //!< Samples in the window
+        float           min;    //!< Smallest sample, FLOAT_UNINIT without samples
+        float           max;    //!< Largest sample, FLOAT_UNINIT without samples
+        float           mean;   //!< Mean, FLOAT_UNINIT without samples
+        float           stdDev; //!< Sample standard deviation, 0 with less than 2 samples
+    } STATS_RESULT;
+
+    //! Statistics of all the channels
+    typedef struct {
+        unsigned int    windowPeriod;                       //!< Automatic window length in s, 0 to close windows on request only
+        unsigned long   windowLength;                       //!< Length of the last closed window in ms
+        STATS_RESULT    result[STATS_CHANNELS_NUMBER];      //!< Results of the last closed window
+    } SENSOR_STATS;
+
+    /* Globals */
+    /* Externs */
+    extern SENSOR_STATS sensorStats; //!< Latched sensor statistics
+
+    /* Prototypes */
+    /* Externs */
+    extern void sensorStatsUpdate(unsigned char channel, float value);
+    //!< Add a sample to the current window
+    extern void sensorStatsLatch(void);
+    //!< Close the current window and start a new one
+    extern void sensorStatsSetWindow(unsigned int period);
+    //!< Set the automatic window period
+    extern void sensorStatsAsync(void);
+    //!< Close the window when the window period expires
+
+#endif /* _SENSORSTATS_H */
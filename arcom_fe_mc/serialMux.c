@@ -25,6 +25,7 @@
 #include "timer.h"
 #include "debug.h"
 #include "globalDefinitions.h"
+#include "serialProfile.h"
 
 /* Globals */
 /* Externs */
@@ -96,6 +97,7 @@ int writeMux(void){
     outpw(MUX_COMMAND_ADD,
           frame.
            command);
+    serialMuxTransactions++;
 
     #ifdef DEBUG_SERIAL_WRITE
         if (LATCH_DEBUG_SERIAL_WRITE) {
@@ -184,6 +186,7 @@ int readMux(void){
     outpw(MUX_COMMAND_ADD,
           frame.
            command);
+    serialMuxTransactions++;
 
     #ifdef DEBUG_SERIAL_READ
         printf("            (0x%04X) <- Frame.port: 0x%04X\n",
@@ -256,6 +259,7 @@ static int waitOnBusy(void){
         if(timedOut==ERROR){
             return ERROR;
         }
+        serialMuxBusyPolls++;
     } while((inpw(MUX_BUSY_ADD)&MUX_BUSY_MASK)&&!timedOut);
 
 
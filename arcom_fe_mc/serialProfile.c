@@ -0,0 +1,88 @@
+/*! \file   serialProfile.c
+    \brief  Serial interface operation profiler
+
+    See serialProfile.h for a description of the profiler.
+*/
+
+/* Includes */
+#include <stdio.h>      /* printf */
+#include <string.h>     /* memset */
+#include <time.h>       /* clock */
+
+#include "serialProfile.h"
+#include "error.h"
+#include "globalDefinitions.h"
+
+/* Globals */
+SERIAL_PROFILE_ENTRY serialProfile[SERIAL_PROFILE_OPERATIONS];
+unsigned long serialMuxTransactions = 0;
+unsigned long serialMuxBusyPolls = 0;
+
+/* Statics */
+// Counters at the start of the operation in progress. The operations don't nest.
+static unsigned char startOperation = SERIAL_PROFILE_OPERATIONS;    // None in progress
+static unsigned long startTransactions;
+static unsigned long startBusyPolls;
+static clock_t startTime;
+
+static const char *operationNames[SERIAL_PROFILE_OPERATIONS] = {"biasAnalog",
+                                                                "loAnalog",
+                                                                "pdAnalog",
+                                                                "ifAnalog",
+                                                                "lprAnalog",
+                                                                "cryoAnalog",
+                                                                "fetimParallel",
+                                                                "fetimSerial"};
+
+/*! Record the start of an operation.
+    \param operation    one of the SERIAL_PROFILE_* defines */
+void serialProfileBegin(unsigned char operation) {
+    startOperation = operation;
+    startTransactions = serialMuxTransactions;
+    startBusyPolls = serialMuxBusyPolls;
+    startTime = clock();
+}
+
+/*! Record the end of an operation.
+    An end that doesn't match the operation started is not counted, since the
+    counters at the start belong to another operation.
+    \param operation    one of the SERIAL_PROFILE_* defines
+    \param result       the value returned by the operation */
+void serialProfileEnd(unsigned char operation, int result) {
+    SERIAL_PROFILE_ENTRY *entry;
+
+    if (operation >= SERIAL_PROFILE_OPERATIONS || operation != startOperation)
+        return;
+    startOperation = SERIAL_PROFILE_OPERATIONS;
+
+    entry = &serialProfile[operation];
+    entry -> calls++;
+    if (result == ERROR)
+        entry -> errors++;
+    entry -> transactions += serialMuxTransactions - startTransactions;
+    entry -> busyPolls += serialMuxBusyPolls - startBusyPolls;
+    entry -> time += clock() - startTime;
+}
+
+/*! Clear the profile counters. */
+void serialProfileReset(void) {
+    memset(serialProfile, 0, sizeof(serialProfile));
+}
+
+/*! Print the profile counters, one comma separated line per operation. */
+void serialProfileReport(void) {
+    unsigned char cnt;
+    SERIAL_PROFILE_ENTRY *entry;
+
+    printf("operation,calls,errors,transactions,busyPolls,timeMs\n");
+    for (cnt = 0; cnt < SERIAL_PROFILE_OPERATIONS; cnt++) {
+        entry = &serialProfile[cnt];
+        printf("%s,%lu,%lu,%lu,%lu,%lu\n",
+               operationNames[cnt],
+               entry -> calls,
+               entry -> errors,
+               entry -> transactions,
+               entry -> busyPolls,
+               entry -> time);
+    }
+}
@@ -0,0 +1,70 @@
+/*! \file   serialProfile.h
+    \brief  Serial interface operation profiler
+
+    Each analog monitor cycle of the serial interfaces, and each FETIM ADC
+    read, is counted with the serial mux traffic it caused.  The cryostat and
+    FETIM serial ADC readouts run one step per async pass, so for them a call
+    is one step:
+        - calls:        number of operations
+        - transactions: mux read and write frames, including the ADC ready polls
+        - busy polls:   reads of the mux busy flag, the time spent waiting on
+                        the synchronous serial bus
+        - time:         total time in ms, as returned by clock()
+
+    The time has the resolution of the DOS timer tick, so it is only
+    meaningful over many calls.  With the transactions and busy polls it tells
+    the firmware overhead of an operation apart from the hardware wait.
+
+    The counters are read through the GET_SERIAL_PROFILE special monitor RCAs,
+    cleared with SET_SERIAL_PROFILE_RESET and printed as comma separated
+    values by the 'b' console command.
+
+    This profiles the firmware on the ARCOM board against the real serial
+    mux.  There is no host build with a simulated mux: a comparison of two
+    versions of an operation is made by profiling each on the hardware. */
+
+#ifndef _SERIALPROFILE_H
+    #define _SERIALPROFILE_H
+
+    /* Defines */
+    /* Profiled operations */
+    #define SERIAL_PROFILE_BIAS_ANALOG      0   // getBiasAnalogMonitor()
+    #define SERIAL_PROFILE_LO_ANALOG        1   // getLoAnalogMonitor()
+    #define SERIAL_PROFILE_PD_ANALOG        2   // getPdAnalogMonitor()
+    #define SERIAL_PROFILE_IF_ANALOG        3   // getIfAnalogMonitor()
+    #define SERIAL_PROFILE_LPR_ANALOG       4   // getLprAnalogMonitor()
+    #define SERIAL_PROFILE_CRYO_ANALOG      5   // getCryoAnalogMonitor(), one step
+    #define SERIAL_PROFILE_FETIM_PARALLEL   6   // getFetimParallelMonitor()
+    #define SERIAL_PROFILE_FETIM_SERIAL     7   // getFetimSerialMonitor(), one step
+    #define SERIAL_PROFILE_OPERATIONS       8
+
+    #define SERIAL_PROFILE_BLOCKS           3   // GET_SERIAL_PROFILE messages for each operation
+
+    /* Typedefs */
+    //! Counters of one profiled operation
+    typedef struct {
+        unsigned long   calls;          //!< Number of operations
+        unsigned long   errors;         //!< Operations that returned ERROR
+        unsigned long   transactions;   //!< Serial mux frames sent or received
+        unsigned long   busyPolls;      //!< Reads of the serial mux busy flag
+        unsigned long   time;           //!< Total time in ms
+    } SERIAL_PROFILE_ENTRY;
+
+    /* Globals */
+    /* Externs */
+    extern SERIAL_PROFILE_ENTRY serialProfile[SERIAL_PROFILE_OPERATIONS]; //!< The profile counters
+    extern unsigned long serialMuxTransactions;  //!< Serial mux frames since startup
+    extern unsigned long serialMuxBusyPolls;     //!< Serial mux busy flag reads since startup
+
+    /* Prototypes */
+    /* Externs */
+    extern void serialProfileBegin(unsigned char operation);
+    //!< Record the start of an operation
+    extern void serialProfileEnd(unsigned char operation, int result);
+    //!< Record the end of an operation
+    extern void serialProfileReset(void);
+    //!< Clear the profile counters
+    extern void serialProfileReport(void);
+    //!< Print the profile counters
+
+#endif /* _SERIALPROFILE_H */
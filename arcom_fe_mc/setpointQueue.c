@@ -0,0 +1,151 @@
+/*! \file   setpointQueue.c
+    \brief  Coalescing of analog setpoint controls
+
+    See setpointQueue.h for a description of the queue.
+*/
+
+/* Includes */
+#include <stdio.h>      /* printf */
+#include <string.h>     /* memmove */
+
+#include "setpointQueue.h"
+#include "frontend.h"
+#include "lastControl.h"
+#include "error.h"
+#include "debug.h"
+#include "globalDefinitions.h"
+
+/* Globals */
+SETPOINT_QUEUE setpointQueue = {FALSE,
+                                0,
+                                0L,
+                                0L,
+                                0L,
+                                0L};
+
+/* Statics */
+static SETPOINT_QUEUE_ENTRY queue[SETPOINT_QUEUE_SIZE];  // Pending setpoints, the oldest first
+
+/*! Post the setpoint of the control message being handled.
+    This is called by the handler of an analog setpoint RCA once the command
+    is checked and saved, with the value to write in \ref CONV_FLOAT and the
+    hardware addressed by the handler globals, in place of the call that
+    writes it.  A setpoint pending for the same RCA is replaced.
+    \param apply    function writing the setpoint to the hardware
+    \return
+        - TRUE  -> if the setpoint was posted
+        - FALSE -> if the handler has to apply it now: coalescing is
+                   disabled or the queue is full */
+int setpointQueuePost(SETPOINT_APPLY apply) {
+    int slot = setpointQueueFind(CAN_ADDRESS);
+
+    if (slot >= 0) {
+        // The pending setpoint is superseded either way:
+        setpointQueue.coalesced++;
+        if (!setpointQueue.enable) {
+            setpointQueueRemove(slot);
+            return FALSE;
+        }
+    } else {
+        if (!setpointQueue.enable || setpointQueue.pending == SETPOINT_QUEUE_SIZE)
+            return FALSE;
+        slot = setpointQueue.pending++;
+    }
+
+    handlerContextSave(&queue[slot].context);
+    queue[slot].apply = apply;
+    queue[slot].state = frontend.cartridge[currentModule].state;
+    queue[slot].standby2 = frontend.cartridge[currentModule].standby2;
+    setpointQueue.posted++;
+
+    return TRUE;
+}
+
+/*! Cancel the setpoint pending for an RCA.
+    This is called by an async engine when it takes over the control point.
+    The setpoint is counted as dropped.
+    \param rca      the control RCA */
+void setpointQueueCancel(unsigned long rca) {
+    int slot = setpointQueueFind(rca);
+    LAST_CONTROL_MESSAGE *last;
+
+    if (slot < 0)
+        return;
+
+    last = lastControlFind(rca);
+    if (last != NULL)
+        (*last).status = HARDW_BLKD_ERR;
+    setpointQueue.dropped++;
+    setpointQueueRemove(slot);
+
+    #ifdef DEBUG_SETPOINT_QUEUE
+        printf("Setpoint queue: 0x%lX cancelled\n", rca);
+    #endif /* DEBUG_SETPOINT_QUEUE */
+}
+
+/*! Apply the pending setpoints.
+    This is called at the start of every async pass, in the async handler
+    context.  It returns as soon as a CAN message is waiting.  The status of
+    a setpoint goes to the last control message of its RCA, restored with
+    the handler context. */
+void setpointQueueAsync(void) {
+    HANDLER_CONTEXT asyncContext;
+    SETPOINT_QUEUE_ENTRY *entry = &queue[0];
+
+    if (!setpointQueue.pending)
+        return;
+
+    handlerContextSave(&asyncContext);
+
+    while (setpointQueue.pending && !newCANMsg) {
+        handlerContextRestore(&entry -> context);
+
+        if (frontend.cartridge[currentModule].state != entry -> state
+            || frontend.cartridge[currentModule].standby2 != entry -> standby2)
+        {
+            // The cartridge was switched off, reinitialized or put in STANDBY2:
+            CAN_LAST_CONTROL.status = HARDW_BLKD_ERR;
+            setpointQueue.dropped++;
+        } else {
+            if ((entry -> apply)() == ERROR)
+                CAN_LAST_CONTROL.status = ERROR;
+            setpointQueue.applied++;
+        }
+
+        setpointQueueRemove(0);
+    }
+
+    handlerContextRestore(&asyncContext);
+}
+
+/*! Enable or disable coalescing.
+    The setpoints already pending are applied in any case.
+    \param enable   TRUE to post the analog setpoints, FALSE to apply them at once */
+void setpointQueueEnable(unsigned char enable) {
+    setpointQueue.enable = (enable) ? TRUE : FALSE;
+
+    #ifdef DEBUG_SETPOINT_QUEUE
+        printf("Setpoint queue: coalescing %s, %d pending\n",
+               (setpointQueue.enable) ? "enabled" : "disabled",
+               setpointQueue.pending);
+    #endif /* DEBUG_SETPOINT_QUEUE */
+}
+
+/* Return the slot of the setpoint pending for an RCA, -1 if none */
+static int setpointQueueFind(unsigned long rca) {
+    unsigned char slot;
+
+    for (slot = 0; slot < setpointQueue.pending; slot++) {
+        if (queue[slot].context.message.address == rca)
+            return slot;
+    }
+    return -1;
+}
+
+/* Remove a setpoint, keeping the others in order */
+static void setpointQueueRemove(unsigned char slot) {
+    setpointQueue.pending--;
+    memmove(&queue[slot],
+            &queue[slot + 1],
+            (setpointQueue.pending - slot) * sizeof(SETPOINT_QUEUE_ENTRY));
+}
@@ -0,0 +1,98 @@
+/*! \file   setpointQueue.h
+    \brief  Coalescing of analog setpoint controls
+
+    A host ramping an analog setpoint can send the control messages faster
+    than the serial interface applies them, and each message holds up the
+    message loop until its setpoint is written.  When coalescing is enabled,
+    the handlers of the analog setpoint RCAs:
+        - PA channel drain voltage
+        - SIS mixer bias voltage
+        - SIS magnet current
+    check and record the command as usual, \ref LAST_CONTROL_MESSAGE
+    included, then post it to this queue instead of writing the hardware.
+    A setpoint posted for an RCA that already has one pending replaces it, so
+    only the latest value of a ramp reaches the hardware.
+
+    The pending setpoints are applied, the oldest RCA first, at the start of
+    the async pass and before any other async operation, each one in the
+    \ref HANDLER_CONTEXT it was posted with.  The queue yields to a new CAN
+    message between two setpoints.  A setpoint whose cartridge changed power
+    state meanwhile, STANDBY2 included, is dropped and its last control
+    message status set to HARDW_BLKD_ERR; a hardware error sets it to ERROR,
+    as the handler would have.  Until it is applied, a monitor request on
+    the control RCA returns the new setpoint while the monitor RCA still
+    reads back the old one.
+
+    A sweep, ramp or deflux engine taking over an RCA cancels the setpoint
+    pending for it, so that the queue doesn't write it under the engine.  Its
+    last control message status is set to HARDW_BLKD_ERR, as for a dropped
+    setpoint.
+
+    A PA drain voltage is limited again to the max safe level of the YTO
+    tuning when it is applied, since a YTO control or the LO lock engine may
+    have retuned the YTO after it was posted.
+
+    When the queue is full the setpoint is applied at once, as with
+    coalescing disabled.
+
+    Control and monitor, through the special RCAs:
+        - SET_SETPOINT_COALESCE:    1 to enable coalescing, 0 to disable it.
+                                    The setpoints already pending are still
+                                    applied.
+        - GET_SETPOINT_COALESCE:    enabled, pending setpoints, setpoints
+                                    replaced before they were applied (3
+                                    bytes), setpoints applied (3 bytes) */
+
+#ifndef _SETPOINTQUEUE_H
+    #define _SETPOINTQUEUE_H
+
+    /* Extra includes */
+    /* HANDLER_CONTEXT */
+    #ifndef _HANDLERCONTEXT_H
+        #include "handlerContext.h"
+    #endif /* _HANDLERCONTEXT_H */
+
+    /* Defines */
+    #define SETPOINT_QUEUE_SIZE     16      //!< Setpoints that can be pending at once
+
+    /* Typedefs */
+    //! Function writing the setpoint addressed by the handler globals to the hardware
+    typedef int (*SETPOINT_APPLY)(void);
+
+    //! A setpoint waiting to be applied
+    typedef struct {
+        HANDLER_CONTEXT context;    //!< Addressing and value, as left by the handler
+        SETPOINT_APPLY  apply;      //!< applyDrainVoltage, setSisMixerBias or setSisMagnetBias
+        unsigned char   state;      //!< Cartridge state when posted
+        unsigned char   standby2;   //!< Cartridge STANDBY2 mode when posted
+    } SETPOINT_QUEUE_ENTRY;
+
+    //! Setpoint coalescing setup and counters
+    typedef struct {
+        unsigned char   enable;     //!< Post the analog setpoints instead of applying them
+        unsigned char   pending;    //!< Setpoints waiting to be applied
+        unsigned long   posted;     //!< Setpoints posted
+        unsigned long   coalesced;  //!< Setpoints replaced by a newer one before they were applied
+        unsigned long   applied;    //!< Setpoints written to the hardware from the queue
+        unsigned long   dropped;    //!< Setpoints dropped because the cartridge was no longer ready or an engine took over
+    } SETPOINT_QUEUE;
+
+    /* Globals */
+    /* Externs */
+    extern SETPOINT_QUEUE setpointQueue; //!< Setpoint coalescing setup and counters
+
+    /* Prototypes */
+    /* Statics */
+    static int setpointQueueFind(unsigned long rca);
+    static void setpointQueueRemove(unsigned char slot);
+    /* Externs */
+    extern int setpointQueuePost(SETPOINT_APPLY apply);
+    //!< Post the setpoint of the current control message
+    extern void setpointQueueCancel(unsigned long rca);
+    //!< Cancel the setpoint pending for an RCA
+    extern void setpointQueueAsync(void);
+    //!< Apply the pending setpoints
+    extern void setpointQueueEnable(unsigned char enable);
+    //!< Enable or disable coalescing
+
+#endif /* _SETPOINTQUEUE_H */
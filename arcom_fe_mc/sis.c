@@ -42,7 +42,10 @@
 
 #include "error.h"
 #include "frontend.h"
+#include "lastControl.h"
 #include "biasSerialInterface.h"
+#include "setpointQueue.h"
+#include "controlElision.h"
 #include "debug.h"
 
 /* Globals */
@@ -96,8 +99,7 @@ static void senseResistorHandler(void) {
     /* If control message (size !=0) */
     if(CAN_SIZE){
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].polarization[currentBiasModule].
-            sideband[currentPolarizationModule].sis.lastSenseResistor)
+        SAVE_LAST_CONTROL_MESSAGE()
 
         /* Extract the floating data from the CAN message */
         changeEndian(CONV_CHR_ADD, CAN_DATA_ADD);
@@ -117,8 +119,7 @@ static void senseResistorHandler(void) {
     /* If monitor on control RCA */
     if(currentClass==CONTROL_CLASS){
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].polarization[currentBiasModule].
-            sideband[currentPolarizationModule].sis.lastSenseResistor)
+        RETURN_LAST_CONTROL_MESSAGE()
         return;
     }
 
@@ -145,9 +146,13 @@ static void voltageHandler(void){
 
     /* If control message (size !=0) */
     if(CAN_SIZE) {
+        /* Skip the command if the same voltage is already applied */
+        if(controlElide()){
+            return;
+        }
+
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].polarization[currentBiasModule].
-            sideband[currentPolarizationModule].sis.lastVoltage)
+        SAVE_LAST_CONTROL_MESSAGE()
 
         /* Extract the floating data from the CAN message */
         changeEndian(CONV_CHR_ADD, CAN_DATA_ADD);
@@ -155,8 +160,12 @@ static void voltageHandler(void){
         // If we are in STANDBY2 mode, return HARDW_BLKD_ERR
         if (frontend.cartridge[currentModule].standby2) {
             /* Store the ERROR state in the last control message variable */
-            frontend.cartridge[currentModule].polarization[currentBiasModule].
-               sideband[currentPolarizationModule].sis.lastVoltage.status=HARDW_BLKD_ERR;
+            CAN_LAST_CONTROL.status=HARDW_BLKD_ERR;
+            return;
+        }
+
+        /* If coalescing, the voltage is applied from the async loop */
+        if(setpointQueuePost(setSisMixerBias)){
             return;
         }
 
@@ -164,8 +173,7 @@ static void voltageHandler(void){
            and then return. */
         if(setSisMixerBias()==ERROR){
             /* Store the ERROR state in the last control message variable */
-            frontend.cartridge[currentModule].polarization[currentBiasModule].
-                sideband[currentPolarizationModule].sis.lastVoltage.status=ERROR;
+            CAN_LAST_CONTROL.status=ERROR;
             return;
         }
         /* If everything went fine, it's a control message, we're done. */
@@ -175,8 +183,7 @@ static void voltageHandler(void){
     /* If monitor on control RCA */
     if(currentClass==CONTROL_CLASS) {
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].polarization[currentBiasModule].
-                                        sideband[currentPolarizationModule].sis.lastVoltage)
+        RETURN_LAST_CONTROL_MESSAGE()
         return;
     }
 
@@ -257,14 +264,12 @@ static void openLoopHandler(void){
     /* If control message (size !=0) */
     if(CAN_SIZE){
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].polarization[currentBiasModule].
-            sideband[currentPolarizationModule].sis.lastOpenLoop)
+        SAVE_LAST_CONTROL_MESSAGE()
 
         // If we are in STANDBY2 mode, return HARDW_BLKD_ERR
         if (frontend.cartridge[currentModule].standby2) {
             /* Store the ERROR state in the last control message variable */
-            frontend.cartridge[currentModule].polarization[currentBiasModule].
-                sideband[currentPolarizationModule].sis.lastOpenLoop.status=HARDW_BLKD_ERR;
+            CAN_LAST_CONTROL.status=HARDW_BLKD_ERR;
             return;
         }
 
@@ -272,8 +277,7 @@ static void openLoopHandler(void){
            message. */
         if(setSisMixerLoop(CAN_BYTE ? SIS_MIXER_BIAS_MODE_OPEN : SIS_MIXER_BIAS_MODE_CLOSE) == ERROR) {
             /* Store the ERROR state in the last control message variable */
-            frontend.cartridge[currentModule].polarization[currentBiasModule].
-                sideband[currentPolarizationModule].sis.lastOpenLoop.status=ERROR;
+            CAN_LAST_CONTROL.status=ERROR;
             return;
         }
         /* If everything went fine, it's a control message, we're done. */
@@ -283,8 +287,7 @@ static void openLoopHandler(void){
     /* If monitor on control RCA */
     if(currentClass==CONTROL_CLASS){ // If monitor on a control RCA
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].polarization[currentBiasModule].
-            sideband[currentPolarizationModule].sis.lastOpenLoop)
+        RETURN_LAST_CONTROL_MESSAGE()
         return;
     }
 
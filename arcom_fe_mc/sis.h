@@ -38,6 +38,10 @@
                                                 3 -> openLoopHandler */
     #define SIS_MODULES_MASK_SHIFT   3       // Bits right shift for the submodules mask
 
+    //! Control RCA of the bias voltage of a SIS mixer, for the last control message
+    #define SIS_VOLTAGE_RCA(band, pol, sb) \
+        (BASE_CONTROL_RCA+((unsigned long)(band)<<MODULES_MASK_SHIFT)+((pol)<<BIAS_MODULES_MASK_SHIFT)+((sb)<<POLARIZATION_MODULES_MASK_SHIFT)+0x00008L)
+
 
     /* Typedefs */
     typedef struct {
@@ -62,18 +66,6 @@
                         value is the one stored by the software after a control
                         command has been issued.*/
         unsigned char   openLoop;
-        //! Last control message: SIS sense resister
-        /*! This is the content of the last control message sent to the SIS
-            sense resistor. */
-        LAST_CONTROL_MESSAGE    lastSenseResistor;
-        //! Last control message: SIS mixer voltage
-        /*! This is the content of the last control message sent to the SIS
-            mixer voltage. */
-        LAST_CONTROL_MESSAGE    lastVoltage;
-        //! Last control message: SIS mixer mode
-        /*! This is the content of the last control message sent to the SIS
-            mixer mode. */
-        LAST_CONTROL_MESSAGE    lastOpenLoop;
     } SIS;
 
     /* Globals */
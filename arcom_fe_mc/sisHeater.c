@@ -13,6 +13,7 @@
 
 #include "error.h"
 #include "frontend.h"
+#include "lastControl.h"
 #include "biasSerialInterface.h"
 #include "debug.h"
 #include "timer.h"
@@ -64,11 +65,7 @@ static void enableHandler(void){
     /* If control (size !=0) */
     if(CAN_SIZE){
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.
-                                   cartridge[currentModule].
-                                    polarization[currentBiasModule].
-                                     sisHeater.
-                                      lastEnable)
+        SAVE_LAST_CONTROL_MESSAGE()
 
         // If we are in STANDBY2 mode, return HARDW_BLKD_ERR
         if (frontend.
@@ -76,12 +73,7 @@ static void enableHandler(void){
               standby2) 
         {
             /* Store the ERROR state in the last control message variable */
-            frontend.
-             cartridge[currentModule].
-              polarization[currentBiasModule].
-               sisHeater.
-                lastEnable.
-                 status=HARDW_BLKD_ERR;
+            CAN_LAST_CONTROL.status=HARDW_BLKD_ERR;
             
             return;
         }
@@ -106,23 +98,13 @@ static void enableHandler(void){
                     break;
                 case TIMER_RUNNING:
                     /* Mark hardware as blocked */
-                    frontend.
-                     cartridge[currentModule].
-                      polarization[currentBiasModule].
-                       sisHeater.
-                        lastEnable.
-                         status=HARDW_BLKD_ERR;
+                    CAN_LAST_CONTROL.status=HARDW_BLKD_ERR;
                     /* Signal error and bail out */
                     storeError(ERR_SIS_HEATER, ERC_HARDWARE_BLOCKED); //Hardware blocked error
                     return;
                     break;
                 default:
-                    frontend.
-                     cartridge[currentModule].
-                      polarization[currentBiasModule].
-                       sisHeater.
-                        lastEnable.
-                         status=ERROR;
+                    CAN_LAST_CONTROL.status=ERROR;
                     return;
                     break;
             }
@@ -134,12 +116,7 @@ static void enableHandler(void){
         if(setSisHeaterEnable(CAN_BYTE?SIS_HEATER_ENABLE:
                                        SIS_HEATER_DISABLE)==ERROR){
             /* Store the ERROR state in the last control message variable */
-            frontend.
-             cartridge[currentModule].
-              polarization[currentBiasModule].
-               sisHeater.
-                lastEnable.
-                 status=ERROR;
+            CAN_LAST_CONTROL.status=ERROR;
 
             return;
         }
@@ -150,11 +127,7 @@ static void enableHandler(void){
     /* If monitor on a control RCA */
     if(currentClass==CONTROL_CLASS){
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.
-                                     cartridge[currentModule].
-                                      polarization[currentBiasModule].
-                                       sisHeater.
-                                        lastEnable)
+        RETURN_LAST_CONTROL_MESSAGE()
         return;
     }
 
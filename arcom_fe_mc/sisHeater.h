@@ -51,9 +51,7 @@
                                     - \ref SIS_HEATER_DISABLE -> OFF
                                     - \ref SIS_HEATER_ENABLE -> ON
         \param      current This contains the most recent read-back value
-                                for the heater current.
-        \param      lastEnable  This contains a copy of the last issued control
-                                message for the current. */
+                                for the heater current. */
     typedef struct {
         //! SIS heater availability
         unsigned char   available;
@@ -68,10 +66,6 @@
         //! SIS heater current
         /*! This is the current (in mA) across the SIS heater. */
         float           current;
-        //! Last control message: SIS heater state
-        /*! This is the content of the last control message sent to the SIS
-            heater state. */
-        LAST_CONTROL_MESSAGE    lastEnable;
     } SIS_HEATER;
 
     /* Globals */
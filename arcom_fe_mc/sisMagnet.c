@@ -10,15 +10,29 @@
 /* Includes */
 #include <string.h>     /* memcpy */
 #include <stdio.h>      /* printf */
+#include <math.h>       /* fabs */
 
 #include "frontend.h"
+#include "lastControl.h"
 #include "error.h"
 #include "biasSerialInterface.h"
+#include "handlerContext.h"
+#include "setpointQueue.h"
+#include "controlElision.h"
+#include "timer.h"
 #include "debug.h"
 
 /* Globals */
 /* Externs */
 unsigned char   currentSisMagnetModule=0;
+SIS_MAGNET_RAMP sisMagnetRamp={SIS_MAGNET_RAMP_IDLE,
+                               0,
+                               0,
+                               0.0,
+                               0.0,
+                               0.0,
+                               0,
+                               SIS_MAGNET_RAMP_DEFAULT_STEP};
 /* Statics */
 static HANDLER  sisMagnetModulesHandler[SIS_MAGNET_MODULES_NUMBER]={voltageHandler,
                                                                     currentHandler};
@@ -122,13 +136,18 @@ static void currentHandler(void){
 
     /* If control (size !=0) */
     if(CAN_SIZE){
+        /* Skip the command if the same current is already applied */
+        if(controlElide()){
+            return;
+        }
+
+        /* A control takes over from the ramp of this magnet, if any */
+        if(sisMagnetRampAddressed()){
+            sisMagnetRampAbort();
+        }
+
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.
-                                   cartridge[currentModule].
-                                    polarization[currentBiasModule].
-                                     sideband[currentPolarizationModule].
-                                      sisMagnet.
-                                       lastCurrent)
+        SAVE_LAST_CONTROL_MESSAGE()
 
         /* Extract the floating data from the CAN message */
         changeEndian(CONV_CHR_ADD,
@@ -140,28 +159,21 @@ static void currentHandler(void){
               standby2) 
         {
             /* Store the ERROR state in the last control message variable */
-            frontend.
-             cartridge[currentModule].
-              polarization[currentBiasModule].
-               sideband[currentPolarizationModule].
-                sisMagnet.
-                 lastCurrent.
-                  status=HARDW_BLKD_ERR;
+            CAN_LAST_CONTROL.status=HARDW_BLKD_ERR;
             
             return;
         }
-        
+
+        /* If coalescing, the current is applied from the async loop */
+        if(setpointQueuePost(setSisMagnetBias)){
+            return;
+        }
+
         /* Set the SIS magnet bias current. If an error occurs, then store the
            state and report the error. */
         if(setSisMagnetBias()==ERROR){
             /* Store the ERROR state in the last control message variable */
-            frontend.
-             cartridge[currentModule].
-              polarization[currentBiasModule].
-               sideband[currentPolarizationModule].
-                sisMagnet.
-                 lastCurrent.
-                  status=ERROR;
+            CAN_LAST_CONTROL.status=ERROR;
 
             return;
         }
@@ -174,12 +186,7 @@ static void currentHandler(void){
     /* If Monitor on Control RCA */
     if(currentClass==CONTROL_CLASS){
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.
-                                     cartridge[currentModule].
-                                      polarization[currentBiasModule].
-                                       sideband[currentPolarizationModule].
-                                        sisMagnet.
-                                         lastCurrent)
+        RETURN_LAST_CONTROL_MESSAGE()
         return;
     }
 
@@ -230,6 +237,10 @@ void sisMagnetGoStandby2() {
         printf(" - sisMagnetGoStandby2 pol=%d sb=%d\n", currentBiasModule, currentPolarizationModule);
     #endif // DEBUG_GO_STANDBY2
 
+    // stop the ramp of this magnet, if any:
+    if (sisMagnetRampAddressed())
+        sisMagnetRampAbort();
+
     // set the SIS magnet current to 0:
     CONV_FLOAT = 0.0;
     ret = setSisMagnetBias();
@@ -239,3 +250,275 @@ void sisMagnetGoStandby2() {
             printf(" -- ret=%d\n", ret);
     #endif // DEBUG_GO_STANDBY2
 }
+
+/* Start a ramp */
+/*! This function starts ramping the addressed magnet from its last commanded
+    current to the target current, at the requested rate.
+
+    \param band     This is the cartridge 0-9
+    \param magnet   This is the magnet: polarization*2+sideband
+    \param settings This is the 8 bytes SET_SIS_MAGNET_RAMP payload
+
+    \return
+        - \ref NO_ERROR -> if no error occurred
+        - \ref ERROR    -> if something wrong happened */
+int sisMagnetRampStart(unsigned char band, unsigned char magnet, const unsigned char *settings){
+    unsigned int rate=((unsigned int)settings[4]<<8)|settings[5];
+    const LAST_CONTROL_MESSAGE *lastCurrent;
+
+    if(sisMagnetRampCheck(band, magnet)==ERROR){
+        return ERROR;
+    }
+
+    /* Extract the target current from the payload */
+    changeEndian(CONV_CHR_ADD,
+                 (unsigned char *)settings);
+    if(fabs(CONV_FLOAT)>SIS_MAGNET_CURRENT_LIMIT || rate==0){
+        storeError(ERR_SIS_MAGNET, ERC_COMMAND_VAL); //Ramp target or rate out of range
+        return ERROR;
+    }
+
+    stopAsyncTimer(TIMER_SIS_MAGNET_RAMP);
+
+    sisMagnetRamp.magnet=band*SIS_MAGNET_JUNCTIONS+magnet;
+    sisMagnetRamp.target=CONV_FLOAT;
+    sisMagnetRamp.stepTime=((unsigned int)settings[6]<<8)|settings[7];
+    if(sisMagnetRamp.stepTime==0){
+        sisMagnetRamp.stepTime=SIS_MAGNET_RAMP_DEFAULT_STEP;
+    }
+    /* The rate is in 0.01 mA/s */
+    sisMagnetRamp.step=0.00001*rate*sisMagnetRamp.stepTime;
+    sisMagnetRamp.steps=0;
+
+    /* Start from the last commanded current, zero if never commanded */
+    lastCurrent=lastControlFind(SIS_MAGNET_CURRENT_RCA(band,
+                                                       magnet/SIDEBANDS_NUMBER,
+                                                       magnet%SIDEBANDS_NUMBER));
+    sisMagnetRamp.setpoint=0.0;
+    if(lastCurrent!=NULL){
+        changeEndian(CONV_CHR_ADD,
+                     (unsigned char *)(*lastCurrent).data);
+        sisMagnetRamp.setpoint=CONV_FLOAT;
+    }
+
+    sisMagnetRamp.state=SIS_MAGNET_RAMP_RUNNING;
+
+    /* The ramp changes the current behind the last control message */
+    controlEpochAdvance(band);
+    setpointQueueCancel(SIS_MAGNET_CURRENT_RCA(band,
+                                               magnet/SIDEBANDS_NUMBER,
+                                               magnet%SIDEBANDS_NUMBER));
+
+    #ifdef DEBUG_SIS_MAGNET_RAMP
+        printf("SIS magnet ramp: magnet %d, %.3f to %.3f mA, %.4f mA per step\n",
+               sisMagnetRamp.magnet,
+               sisMagnetRamp.setpoint,
+               sisMagnetRamp.target,
+               sisMagnetRamp.step);
+    #endif /* DEBUG_SIS_MAGNET_RAMP */
+
+    return NO_ERROR;
+}
+
+/* Start a deflux */
+/*! This function starts defluxing the addressed magnet with steps of
+    alternating sign and decaying amplitude, ending at 0 mA.
+
+    \param band     This is the cartridge 0-9
+    \param magnet   This is the magnet: polarization*2+sideband
+    \param settings This is the 8 bytes SET_SIS_MAGNET_DEFLUX payload
+
+    \return
+        - \ref NO_ERROR -> if no error occurred
+        - \ref ERROR    -> if something wrong happened */
+int sisMagnetDefluxStart(unsigned char band, unsigned char magnet, const unsigned char *settings){
+
+    if(sisMagnetRampCheck(band, magnet)==ERROR){
+        return ERROR;
+    }
+
+    /* Extract the first step current from the payload */
+    changeEndian(CONV_CHR_ADD,
+                 (unsigned char *)settings);
+    if(fabs(CONV_FLOAT)>SIS_MAGNET_CURRENT_LIMIT || settings[4]==0 || settings[4]>=100 || settings[5]==0){
+        storeError(ERR_SIS_MAGNET, ERC_COMMAND_VAL); //Deflux profile out of range
+        return ERROR;
+    }
+
+    stopAsyncTimer(TIMER_SIS_MAGNET_RAMP);
+
+    sisMagnetRamp.magnet=band*SIS_MAGNET_JUNCTIONS+magnet;
+    sisMagnetRamp.setpoint=CONV_FLOAT;
+    sisMagnetRamp.target=0.0;
+    sisMagnetRamp.step=0.01*settings[4];
+    sisMagnetRamp.defluxSteps=settings[5];
+    sisMagnetRamp.stepTime=((unsigned int)settings[6]<<8)|settings[7];
+    if(sisMagnetRamp.stepTime==0){
+        sisMagnetRamp.stepTime=SIS_MAGNET_RAMP_DEFAULT_STEP;
+    }
+    sisMagnetRamp.steps=0;
+
+    sisMagnetRamp.state=SIS_MAGNET_RAMP_DEFLUXING;
+
+    /* The deflux changes the current behind the last control message */
+    controlEpochAdvance(band);
+    setpointQueueCancel(SIS_MAGNET_CURRENT_RCA(band,
+                                               magnet/SIDEBANDS_NUMBER,
+                                               magnet%SIDEBANDS_NUMBER));
+
+    #ifdef DEBUG_SIS_MAGNET_RAMP
+        printf("SIS magnet deflux: magnet %d, %.3f mA, decay %d%%, %d steps\n",
+               sisMagnetRamp.magnet,
+               sisMagnetRamp.setpoint,
+               settings[4],
+               settings[5]);
+    #endif /* DEBUG_SIS_MAGNET_RAMP */
+
+    return NO_ERROR;
+}
+
+/* Stop the ramp */
+/*! This function stops the ramp or deflux in progress. The magnet current is
+    left at the last step. */
+void sisMagnetRampAbort(void){
+    if(sisMagnetRamp.state!=SIS_MAGNET_RAMP_RUNNING &&
+       sisMagnetRamp.state!=SIS_MAGNET_RAMP_DEFLUXING){
+        return;
+    }
+
+    stopAsyncTimer(TIMER_SIS_MAGNET_RAMP);
+    sisMagnetRamp.state=SIS_MAGNET_RAMP_ABORTED;
+}
+
+/* Ramp async */
+/*! This function is called at every pass of the async loop. It sets the
+    magnet current of the next step when the step time expired. */
+void sisMagnetRampAsync(void){
+    HANDLER_CONTEXT context;
+    CARTRIDGE *cartridge;
+
+    if(sisMagnetRamp.state!=SIS_MAGNET_RAMP_RUNNING &&
+       sisMagnetRamp.state!=SIS_MAGNET_RAMP_DEFLUXING){
+        return;
+    }
+
+    /* Check if the cartridge was turned off or put in STANDBY2 in the meantime */
+    cartridge=&frontend.cartridge[sisMagnetRamp.magnet/SIS_MAGNET_JUNCTIONS];
+    if((*cartridge).state!=CARTRIDGE_READY || (*cartridge).standby2){
+        sisMagnetRampAbort();
+        return;
+    }
+
+    if(queryAsyncTimer(TIMER_SIS_MAGNET_RAMP)==TIMER_RUNNING){
+        return;
+    }
+
+    /* Address the magnet being ramped without disturbing the other async
+       functions */
+    handlerContextSave(&context);
+    currentModule=sisMagnetRamp.magnet/SIS_MAGNET_JUNCTIONS;
+    currentBiasModule=(sisMagnetRamp.magnet%SIS_MAGNET_JUNCTIONS)/SIDEBANDS_NUMBER;
+    currentPolarizationModule=sisMagnetRamp.magnet%SIDEBANDS_NUMBER;
+
+    if(sisMagnetRampStep()==ERROR){
+        storeError(ERR_SIS_MAGNET, ERC_HARDWARE_ERROR); //Hardware error during the ramp
+        stopAsyncTimer(TIMER_SIS_MAGNET_RAMP);
+        sisMagnetRamp.state=SIS_MAGNET_RAMP_FAILED;
+    }
+
+    handlerContextRestore(&context);
+}
+
+/* Set the current of the next step of the addressed magnet */
+static int sisMagnetRampStep(void){
+    LAST_CONTROL_MESSAGE *lastCurrent;
+
+    /* Move toward the target by at most one step */
+    if(sisMagnetRamp.state==SIS_MAGNET_RAMP_RUNNING){
+        if(sisMagnetRamp.setpoint<sisMagnetRamp.target){
+            sisMagnetRamp.setpoint+=sisMagnetRamp.step;
+            if(sisMagnetRamp.setpoint>sisMagnetRamp.target){
+                sisMagnetRamp.setpoint=sisMagnetRamp.target;
+            }
+        } else {
+            sisMagnetRamp.setpoint-=sisMagnetRamp.step;
+            if(sisMagnetRamp.setpoint<sisMagnetRamp.target){
+                sisMagnetRamp.setpoint=sisMagnetRamp.target;
+            }
+        }
+    }
+
+    CONV_FLOAT=sisMagnetRamp.setpoint;
+    if(setSisMagnetBias()==ERROR){
+        return ERROR;
+    }
+    sisMagnetRamp.steps++;
+
+    /* Record the step as the last commanded current */
+    lastCurrent=lastControlMessage(SIS_MAGNET_CURRENT_RCA(currentModule,
+                                                          currentBiasModule,
+                                                          currentPolarizationModule));
+    (*lastCurrent).size=CAN_FLOAT_SIZE;
+    changeEndian((*lastCurrent).data,
+                 CONV_CHR_ADD);
+    (*lastCurrent).status=NO_ERROR;
+
+    if(sisMagnetRamp.setpoint==sisMagnetRamp.target &&
+       (sisMagnetRamp.state==SIS_MAGNET_RAMP_RUNNING || sisMagnetRamp.defluxSteps==0)){
+        sisMagnetRamp.state=SIS_MAGNET_RAMP_DONE;
+
+        #ifdef DEBUG_SIS_MAGNET_RAMP
+            printf("SIS magnet ramp: done after %u steps\n",
+                   sisMagnetRamp.steps);
+        #endif /* DEBUG_SIS_MAGNET_RAMP */
+
+        return NO_ERROR;
+    }
+
+    /* Next deflux step: opposite sign and smaller, or the final 0 mA */
+    if(sisMagnetRamp.state==SIS_MAGNET_RAMP_DEFLUXING){
+        if(sisMagnetRamp.defluxSteps>0){
+            sisMagnetRamp.defluxSteps--;
+        }
+        sisMagnetRamp.setpoint*=-sisMagnetRamp.step;
+        if(sisMagnetRamp.defluxSteps==0 ||
+           fabs(sisMagnetRamp.setpoint)<SIS_MAGNET_DEFLUX_MIN_CURRENT){
+            sisMagnetRamp.setpoint=0.0;
+            sisMagnetRamp.defluxSteps=0;
+        }
+    }
+
+    startAsyncTimer(TIMER_SIS_MAGNET_RAMP,
+                    sisMagnetRamp.stepTime,
+                    FALSE);
+
+    return NO_ERROR;
+}
+
+/* Check if the ramp in progress is on the addressed magnet */
+static int sisMagnetRampAddressed(void){
+    return (sisMagnetRamp.state==SIS_MAGNET_RAMP_RUNNING ||
+            sisMagnetRamp.state==SIS_MAGNET_RAMP_DEFLUXING) &&
+           sisMagnetRamp.magnet==currentModule*SIS_MAGNET_JUNCTIONS+
+                                 currentBiasModule*SIDEBANDS_NUMBER+
+                                 currentPolarizationModule;
+}
+
+/* Check that a magnet can be ramped */
+static int sisMagnetRampCheck(unsigned char band, unsigned char magnet){
+    CARTRIDGE *cartridge=&frontend.cartridge[band];
+
+    if((*cartridge).available==UNAVAILABLE ||
+       (*cartridge).polarization[magnet/SIDEBANDS_NUMBER].
+           sideband[magnet%SIDEBANDS_NUMBER].sisMagnet.available==UNAVAILABLE){
+        storeError(ERR_SIS_MAGNET, ERC_MODULE_ABSENT); //SIS magnet not installed
+        return ERROR;
+    }
+
+    if((*cartridge).state!=CARTRIDGE_READY || (*cartridge).standby2){
+        storeError(ERR_SIS_MAGNET, ERC_MODULE_POWER); //Cartridge not ready to bias the magnet
+        return ERROR;
+    }
+
+    return NO_ERROR;
+}
@@ -37,6 +37,39 @@
                                                        1 -> currentHandler */
     #define SIS_MAGNET_MODULES_MASK_SHIFT   4       // Bits right shift for the submodules mask
 
+    //! Control RCA of the current of a SIS magnet, for the last control message
+    #define SIS_MAGNET_CURRENT_RCA(band, pol, sb) \
+        (BASE_CONTROL_RCA+((unsigned long)(band)<<MODULES_MASK_SHIFT)+((pol)<<BIAS_MODULES_MASK_SHIFT)+((sb)<<POLARIZATION_MODULES_MASK_SHIFT)+0x00030L)
+
+    /* Ramp and deflux engine */
+    /* One magnet at the time is ramped to a target current at a limited rate,
+       or defluxed with alternating steps of decaying amplitude ending at 0 mA,
+       from the async loop. Each step is timed by TIMER_SIS_MAGNET_RAMP.
+
+       SET_SIS_MAGNET_RAMP payload:
+            - bytes 0-3:    target current in mA, big endian float
+            - bytes 4-5:    ramp rate in 0.01 mA/s
+            - bytes 6-7:    time between steps in ms, 0 for the default
+       SET_SIS_MAGNET_DEFLUX payload:
+            - bytes 0-3:    first step current in mA, big endian float
+            - byte 4:       amplitude of each step in % of the previous one
+            - byte 5:       most steps before the final 0 mA
+            - bytes 6-7:    time between steps in ms, 0 for the default
+       The magnets are numbered band*4+polarization*2+sideband. A control of
+       the magnet current, or STANDBY2, stops the ramp of that magnet. */
+    #define SIS_MAGNET_CURRENT_LIMIT        125.0   // mA. Range of the magnet current DAC
+    #define SIS_MAGNET_RAMP_DEFAULT_STEP    50      // ms
+    #define SIS_MAGNET_DEFLUX_MIN_CURRENT   0.05    // mA. The deflux ends below this amplitude
+    #define SIS_MAGNET_JUNCTIONS            4       // Magnets per cartridge
+
+    /* Ramp state */
+    #define SIS_MAGNET_RAMP_IDLE            0       // Never started
+    #define SIS_MAGNET_RAMP_RUNNING         1       // Ramping to the target
+    #define SIS_MAGNET_RAMP_DEFLUXING       2       // Stepping through the deflux profile
+    #define SIS_MAGNET_RAMP_DONE            3       // Done: the current is at the target
+    #define SIS_MAGNET_RAMP_ABORTED         4       // Done: stopped by a control, STANDBY2 or the cartridge going off
+    #define SIS_MAGNET_RAMP_FAILED          5       // Done: hardware error
+
     /* Typedefs */
     //! Current state of the SIS magnetic coil
     /*! This structure represent the current state of the SIS magnetic coil.
@@ -48,9 +81,7 @@
         \param      voltage     This contains the most recent read-back value
                                 for the magnet voltage.
         \param      current     This contains the most recent read-back value
-                                for the magnet current.
-        \param      lastCurrent This contains a copy of the last issued control
-                                message for the current. */
+                                for the magnet current. */
     typedef struct {
         //! SIS magnet availability
         unsigned char   available;
@@ -60,24 +91,64 @@
         //! SIS magnetic coil current
         /*! This is the current (in mA) across the magnetic coils. */
         float   current;
-        //! Last control message: SIS magnetic coil current
-        /*! This is the content of the last control message sent to the SIS
-            magnetic coil current. */
-        LAST_CONTROL_MESSAGE    lastCurrent;
     } SIS_MAGNET;
 
+    //! Current state of the SIS magnet ramp and deflux engine
+    /*! This structure represent the current state of the ramp or deflux in
+        progress. Only one magnet at the time is ramped.
+        \ingroup    sideband */
+    typedef struct {
+        //! Ramp state
+        /*! One of the SIS_MAGNET_RAMP_* states. */
+        unsigned char   state;
+        //! Magnet
+        /*! The magnet being ramped: band*4+polarization*2+sideband. */
+        unsigned char   magnet;
+        //! Steps done
+        unsigned int    steps;
+        //! Current setpoint
+        /*! This is the current (in mA) set at the last step. */
+        float           setpoint;
+        //! Ramp target
+        /*! This is the current (in mA) the ramp ends at. */
+        float           target;
+        //! Ramp step
+        /*! This is the current change (in mA) at each step of a ramp or the
+            decay factor of the deflux steps. */
+        float           step;
+        //! Deflux steps
+        /*! This is the number of deflux steps left before the final 0 mA. */
+        unsigned char   defluxSteps;
+        //! Step time
+        /*! This is the time (in ms) between two steps. */
+        unsigned int    stepTime;
+    } SIS_MAGNET_RAMP;
+
     /* Globals */
     /* Externs */
     extern unsigned char currentSisMagnetModule; //!< Current addressed SIS magnet submodule
+    extern SIS_MAGNET_RAMP sisMagnetRamp; //!< Current state of the ramp and deflux engine
 
     /* Prototypes */
     /* Statics */
     static void voltageHandler(void);
     static void currentHandler(void);
+    static int sisMagnetRampStep(void);
+    static int sisMagnetRampAddressed(void);
+    static int sisMagnetRampCheck(unsigned char band, unsigned char magnet);
     /* Externs */
     extern void sisMagnetHandler(void); //!< This function deals with the incoming can message
 
     extern void sisMagnetGoStandby2();
     //!< set the specified SIS magnet to STANDBY2 mode.
 
+    extern int sisMagnetRampStart(unsigned char band, unsigned char magnet, const unsigned char *settings);
+    //!< Start ramping a magnet to a target current
+    extern int sisMagnetDefluxStart(unsigned char band, unsigned char magnet, const unsigned char *settings);
+    //!< Start defluxing a magnet
+    extern void sisMagnetRampAbort(void);
+    //!< Stop the ramp or deflux in progress
+    extern void sisMagnetRampAsync(void);
+    //!< Run one step of the ramp or deflux
+
 #endif /* _SISMAGNET_H */
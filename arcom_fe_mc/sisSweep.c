@@ -0,0 +1,231 @@
+/*! \file   sisSweep.c
+    \brief  On-board SIS I-V curve sweep
+
+    See sisSweep.h for a description of the sweep.
+*/
+
+/* Includes */
+#include <stdio.h>      /* printf */
+#include <stdlib.h>     /* abs, labs */
+
+#include "sisSweep.h"
+#include "frontend.h"
+#include "lastControl.h"
+#include "biasSerialInterface.h"
+#include "handlerContext.h"
+#include "controlElision.h"
+#include "setpointQueue.h"
+#include "timer.h"
+#include "error.h"
+#include "memoryUsage.h"
+#include "debug.h"
+#include "globalDefinitions.h"
+
+/* Globals */
+SIS_SWEEP sisSweep = {SIS_SWEEP_IDLE,
+                      0,
+                      0,
+                      0,
+                      0,
+                      0,
+                      0,
+                      0,
+                      0};
+
+/* Statics */
+static SIS_SWEEP_POINT *buffer = NULL;  // Allocated at the first sweep
+static enum {
+    SIS_SWEEP_PHASE_SET,        // Set the bias voltage of the next point
+    SIS_SWEEP_PHASE_VOLTAGE,    // Read the junction voltage
+    SIS_SWEEP_PHASE_CURRENT     // Read the junction current
+} sweepPhase = SIS_SWEEP_PHASE_SET;
+
+/*! Start a sweep.
+    The previous results are discarded.
+    \param band         cartridge 0-9
+    \param junction     polarization*2+sideband
+    \param *settings    the 8 bytes SET_SIS_SWEEP payload, see sisSweep.h
+    \return
+        - \ref NO_ERROR -> if no error occurred
+        - \ref ERROR    -> if something wrong happened */
+int sisSweepStart(unsigned char band, unsigned char junction, const unsigned char *settings) {
+    CARTRIDGE *cartridge = &frontend.cartridge[band];
+    int start = (int) (((unsigned int) settings[0] << 8) | settings[1]);
+    int stop = (int) (((unsigned int) settings[2] << 8) | settings[3]);
+    int step = abs((int) (((unsigned int) settings[4] << 8) | settings[5]));
+    unsigned long points;
+
+    if (start < -SIS_SWEEP_VOLTAGE_LIMIT || start > SIS_SWEEP_VOLTAGE_LIMIT
+        || stop < -SIS_SWEEP_VOLTAGE_LIMIT || stop > SIS_SWEEP_VOLTAGE_LIMIT
+        || step == 0)
+    {
+        storeError(ERR_SIS_SWEEP, ERC_COMMAND_VAL); // Sweep voltages out of range
+        return ERROR;
+    }
+
+    points = (unsigned long) labs((long) stop - start) / step + 1;
+    if (points > SIS_SWEEP_POINTS) {
+        storeError(ERR_SIS_SWEEP, ERC_COMMAND_VAL); // Too many points for the result buffer
+        return ERROR;
+    }
+
+    if ((*cartridge).available == UNAVAILABLE
+        || (*cartridge).polarization[junction / SIDEBANDS_NUMBER].
+               sideband[junction % SIDEBANDS_NUMBER].sis.available == UNAVAILABLE)
+    {
+        storeError(ERR_SIS_SWEEP, ERC_MODULE_ABSENT); // SIS mixer not installed
+        return ERROR;
+    }
+
+    if ((*cartridge).state != CARTRIDGE_READY || (*cartridge).standby2) {
+        storeError(ERR_SIS_SWEEP, ERC_MODULE_POWER); // Cartridge not ready to bias the SIS
+        return ERROR;
+    }
+
+    if (!buffer) {
+        buffer = (SIS_SWEEP_POINT *) memoryAlloc(MEMORY_SIS_SWEEP, SIS_SWEEP_POINTS * sizeof(SIS_SWEEP_POINT));
+        if (!buffer) {
+            storeError(ERR_SIS_SWEEP, ERC_NO_MEMORY); // Out of memory for the result buffer
+            return ERROR;
+        }
+    }
+
+    stopAsyncTimer(TIMER_SIS_SWEEP);
+
+    sisSweep.band = band;
+    sisSweep.junction = junction;
+    sisSweep.start = start;
+    sisSweep.step = (stop < start) ? -step : step;
+    sisSweep.settleTime = ((unsigned int) settings[6] << 8) | settings[7];
+    sisSweep.points = (unsigned int) points;
+    sisSweep.measured = 0;
+    sisSweep.readIndex = 0;
+
+    sweepPhase = SIS_SWEEP_PHASE_SET;
+    sisSweep.state = SIS_SWEEP_RUNNING;
+
+    // The sweep changes the bias voltage behind the last control message:
+    controlEpochAdvance(band);
+    setpointQueueCancel(SIS_VOLTAGE_RCA(band, junction / SIDEBANDS_NUMBER, junction % SIDEBANDS_NUMBER));
+
+    #ifdef DEBUG_SIS_SWEEP
+        printf("SIS sweep: band %d junction %d, %d to %d uV, %u points\n",
+               band + 1, junction, start, stop, sisSweep.points);
+    #endif /* DEBUG_SIS_SWEEP */
+
+    return NO_ERROR;
+}
+
+/*! Run one step of the sweep.
+    This is called at every pass of the async loop.  Nothing is done while
+    the bias settles after a step. */
+void sisSweepAsync(void) {
+    HANDLER_CONTEXT context;
+    CARTRIDGE *cartridge;
+
+    if (sisSweep.state != SIS_SWEEP_RUNNING)
+        return;
+
+    // The cartridge was turned off or put in STANDBY2 in the meantime:
+    cartridge = &frontend.cartridge[sisSweep.band];
+    if ((*cartridge).state != CARTRIDGE_READY || (*cartridge).standby2) {
+        stopAsyncTimer(TIMER_SIS_SWEEP);
+        sisSweep.state = SIS_SWEEP_FAILED;
+        return;
+    }
+
+    if (queryAsyncTimer(TIMER_SIS_SWEEP) == TIMER_RUNNING)
+        return;
+
+    // Address the junction being measured without disturbing the other async functions:
+    handlerContextSave(&context);
+    currentModule = sisSweep.band;
+    currentBiasModule = sisSweep.junction / SIDEBANDS_NUMBER;
+    currentPolarizationModule = sisSweep.junction % SIDEBANDS_NUMBER;
+
+    if (sisSweepStep() == ERROR) {
+        storeError(ERR_SIS_SWEEP, ERC_HARDWARE_ERROR); // Hardware error during the sweep
+        sisSweepEnd(SIS_SWEEP_FAILED);
+    }
+
+    handlerContextRestore(&context);
+}
+
+/*! Read out the next measured point.
+    Points can be read while the sweep is still running.
+    \param *point   receives the point
+    \return
+        - \ref NO_ERROR -> if a point was returned
+        - \ref ERROR    -> if there is nothing left to read */
+int sisSweepRead(SIS_SWEEP_POINT *point) {
+    if (sisSweep.readIndex >= sisSweep.measured)
+        return ERROR;
+
+    *point = buffer[sisSweep.readIndex++];
+    return NO_ERROR;
+}
+
+/* Perform the hardware operation of the current phase */
+static int sisSweepStep(void) {
+    SIDEBAND *sideband = &frontend.cartridge[currentModule].
+                           polarization[currentBiasModule].
+                            sideband[currentPolarizationModule];
+
+    switch (sweepPhase) {
+        case SIS_SWEEP_PHASE_SET:
+            // The bias voltage in mV:
+            CONV_FLOAT = 0.001 * ((long) sisSweep.start + (long) sisSweep.step * sisSweep.measured);
+            if (setSisMixerBias() == ERROR)
+                return ERROR;
+            if (sisSweep.settleTime)
+                startAsyncTimer(TIMER_SIS_SWEEP, sisSweep.settleTime, FALSE);
+            sweepPhase = SIS_SWEEP_PHASE_VOLTAGE;
+            break;
+
+        case SIS_SWEEP_PHASE_VOLTAGE:
+            if (getSisMixerBias(SIS_MIXER_BIAS_VOLTAGE) == ERROR)
+                return ERROR;
+            buffer[sisSweep.measured].voltage = (*sideband).sis.voltage;
+            sweepPhase = SIS_SWEEP_PHASE_CURRENT;
+            break;
+
+        case SIS_SWEEP_PHASE_CURRENT:
+            if (getSisMixerBias(SIS_MIXER_BIAS_CURRENT) == ERROR)
+                return ERROR;
+            buffer[sisSweep.measured].current = (*sideband).sis.current;
+            sweepPhase = SIS_SWEEP_PHASE_SET;
+
+            if (++sisSweep.measured == sisSweep.points)
+                sisSweepEnd(SIS_SWEEP_DONE);
+            break;
+
+        default:
+            return ERROR;
+            break;
+    }
+
+    return NO_ERROR;
+}
+
+/* Put the bias voltage back to its last commanded value and end the sweep */
+static void sisSweepEnd(unsigned char state) {
+    const LAST_CONTROL_MESSAGE *lastVoltage;
+
+    stopAsyncTimer(TIMER_SIS_SWEEP);
+
+    // Zero if the bias voltage was never commanded
+    lastVoltage = lastControlFind(SIS_VOLTAGE_RCA(currentModule,
+                                                  currentBiasModule,
+                                                  currentPolarizationModule));
+    CONV_FLOAT = 0.0;
+    if (lastVoltage != NULL)
+        changeEndian(CONV_CHR_ADD, (unsigned char *) lastVoltage -> data);
+    if (setSisMixerBias() == ERROR)
+        storeError(ERR_SIS_SWEEP, ERC_HARDWARE_ERROR); // Bias voltage not restored after the sweep
+
+    sisSweep.state = state;
+
+    #ifdef DEBUG_SIS_SWEEP
+        printf("SIS sweep: done, %u points\n", sisSweep.measured);
+    #endif /* DEBUG_SIS_SWEEP */
+}
@@ -0,0 +1,80 @@
+/*! \file   sisSweep.h
+    \brief  On-board SIS I-V curve sweep
+
+    The sweep engine measures the I-V curve of one SIS mixer junction
+    without a CAN round trip per point.  It is started by the SET_SIS_SWEEP
+    special control RCA of the junction and runs from the async loop, one
+    hardware operation per pass:
+        -# set the bias voltage of the next point and wait the settle time
+        -# read back the junction voltage
+        -# read the junction current and store the point
+    At the end of the sweep the bias voltage is set back to the last value
+    commanded through the SIS voltage control RCA.
+
+    SET_SIS_SWEEP payload, signed big endian integers:
+        - bytes 0-1:    start voltage in uV
+        - bytes 2-3:    stop voltage in uV
+        - bytes 4-5:    step in uV.  The sign is taken from start and stop.
+        - bytes 6-7:    settle time in ms after each step
+
+    The points are read back, from the first to the last, through the
+    GET_SIS_SWEEP_POINT special monitor RCA: voltage in mV and current in mA
+    as two big endian floats, as the SIS monitor RCAs return them. */
+
+#ifndef _SISSWEEP_H
+    #define _SISSWEEP_H
+
+    /* Extra includes */
+    /* POLARIZATIONS_NUMBER and SIDEBANDS_NUMBER */
+    #ifndef _POLARIZATION_H
+        #include "polarization.h"
+    #endif /* _POLARIZATION_H */
+
+    /* Defines */
+    #define SIS_SWEEP_POINTS            512     //!< Size of the result buffer
+    #define SIS_SWEEP_VOLTAGE_LIMIT     25000   //!< uV. Range of the SIS mixer bias DAC
+    #define SIS_SWEEP_JUNCTIONS         (POLARIZATIONS_NUMBER*SIDEBANDS_NUMBER) //!< Junctions per cartridge
+
+    /* Sweep state */
+    #define SIS_SWEEP_IDLE              0       //!< Nothing measured
+    #define SIS_SWEEP_RUNNING           1       //!< Sweep in progress
+    #define SIS_SWEEP_DONE              2       //!< Sweep complete, ready for readout
+    #define SIS_SWEEP_FAILED            3       //!< Stopped by a hardware error or the cartridge going off
+
+    /* Typedefs */
+    //! One measured point of the I-V curve
+    typedef struct {
+        float   voltage;    //!< mV
+        float   current;    //!< mA
+    } SIS_SWEEP_POINT;
+
+    //! Sweep setup and state
+    typedef struct {
+        unsigned char   state;          //!< One of the SIS_SWEEP_* states
+        unsigned char   band;           //!< Cartridge 0-9
+        unsigned char   junction;       //!< polarization*2+sideband
+        int             start;          //!< uV
+        int             step;           //!< uV, signed
+        unsigned int    settleTime;     //!< ms to wait after each step
+        unsigned int    points;         //!< Points in the sweep
+        unsigned int    measured;       //!< Points in the buffer
+        unsigned int    readIndex;      //!< Next point to read out
+    } SIS_SWEEP;
+
+    /* Globals */
+    /* Externs */
+    extern SIS_SWEEP sisSweep; //!< Sweep setup and state
+
+    /* Prototypes */
+    /* Statics */
+    static int sisSweepStep(void);
+    static void sisSweepEnd(unsigned char state);
+    /* Externs */
+    extern int sisSweepStart(unsigned char band, unsigned char junction, const unsigned char *settings);
+    //!< Start a sweep
+    extern void sisSweepAsync(void);
+    //!< Run one step of the sweep
+    extern int sisSweepRead(SIS_SWEEP_POINT *point);
+    //!< Read out the next measured point
+
+#endif /* _SISSWEEP_H */
@@ -13,6 +13,7 @@
 
 #include "debug.h"
 #include "frontend.h"
+#include "lastControl.h"
 #include "globalDefinitions.h"
 #include "error.h"
 #include "cryostatSerialInterface.h"
@@ -51,10 +52,7 @@ static void stateHandler(void) {
     if(CAN_SIZE) {
 
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.
-                                   cryostat.
-                                    solenoidValve.
-                                     lastState)
+        SAVE_LAST_CONTROL_MESSAGE()
 
         /* Check if the backing pump is enabled. If it's not then the electronics to
            control the solenoid valve is off. In that case, return the
@@ -65,11 +63,7 @@ static void stateHandler(void) {
               enable == BACKING_PUMP_DISABLE) {
             storeError(ERR_SOLENOID_VALVE, ERC_MODULE_POWER); //Backing Pump off -> Solenoid valve disabled
             
-            frontend.
-             cryostat.
-              solenoidValve.
-               lastState.
-                status=HARDW_BLKD_ERR;
+            CAN_LAST_CONTROL.status=HARDW_BLKD_ERR;
             return;
         }
 
@@ -78,11 +72,7 @@ static void stateHandler(void) {
         if(setSolenoidValveState(CAN_BYTE?SOLENOID_VALVE_OPEN:
                                           SOLENOID_VALVE_CLOSE)==ERROR){
             /* Store the ERROR state in the last control message variable */
-            frontend.
-             cryostat.
-              solenoidValve.
-               lastState.
-                status=ERROR;
+            CAN_LAST_CONTROL.status=ERROR;
 
             return;
         }
@@ -93,10 +83,7 @@ static void stateHandler(void) {
     /* If monitor on a control RCA */
     if(currentClass==CONTROL_CLASS){
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.
-                                     cryostat.
-                                      solenoidValve.
-                                       lastState)
+        RETURN_LAST_CONTROL_MESSAGE()
         return;
     }
 
@@ -42,9 +42,7 @@
                                     - \ref SOLENOID_VALVE_CLOSE -> Valve is
                                       close
                                     - \ref SOLENOID_VALVE_UNKNOWN -> Valve is in
-                                      an unknown state.
-        \param      lastState   This contains a copy of the last issued control
-                                message to the state of the solenoid valve. */
+                                      an unknown state. */
     typedef struct {
         //! Solenoid valve state
         /*! This is the solenoid valve state as monitored through two limit
@@ -55,10 +53,6 @@
                 - \ref SOLENOID_VALVE_UNKNOWN -> Valve is in an unknown
                   state. */
         unsigned char   state;
-        //! Last control message: solenoid valve state
-        /*! This is the content of the last control message sent to the solenoid
-            valve state. */
-        LAST_CONTROL_MESSAGE    lastState;
     } SOLENOID_VALVE;
 
     /* Globals */
@@ -0,0 +1,101 @@
+/*! \file   startupProfile.c
+    \brief  Startup phase profiler
+
+    See startupProfile.h for a description of the profiler.
+*/
+
+/* Includes */
+#include <stdio.h>      /* printf */
+#include <time.h>       /* clock */
+
+#include "startupProfile.h"
+#include "globalDefinitions.h"
+
+/* Globals */
+STARTUP_PROFILE_ENTRY startupProfile[STARTUP_PROFILE_ENTRIES];
+unsigned char startupProfileEntries = 0;
+
+/* Statics */
+static clock_t profileOrigin;       // clock() at the first startupProfileBegin()
+static unsigned char profileDepth = 0;
+
+static const char *phaseNames[STARTUP_PHASES_NUMBER] = {"initialization",
+                                                        "errorInit",
+                                                        "nvJournalInit",
+                                                        "serialMuxInit",
+                                                        "owbInit",
+                                                        "owbGetEsn",
+                                                        "frontendInit",
+                                                        "configImageLoad",
+                                                        "cartridgeStartup",
+                                                        "CARTn.INI",
+                                                        "loStartup",
+                                                        "WCAn.INI",
+                                                        "lprStartup",
+                                                        "cryostatStartup",
+                                                        "CRYO.INI",
+                                                        "powerDistributionStartup",
+                                                        "ifSwitchStartup",
+                                                        "fetimStartup",
+                                                        "configImageWrite",
+                                                        "PPOpen"};
+
+/*! Record the start of a phase.
+    Phases begun before the matching startupProfileEnd() of another phase are
+    recorded as its sub-phases.
+    \param phase    one of the STARTUP_PHASE_* defines
+    \param band     band 0-9 or STARTUP_PROFILE_NO_BAND
+    \return the entry to pass to startupProfileEnd() */
+unsigned char startupProfileBegin(unsigned char phase, unsigned char band) {
+    STARTUP_PROFILE_ENTRY *entry;
+
+    if (startupProfileEntries == 0)
+        profileOrigin = clock();
+
+    // Table full: further phases are not recorded
+    if (startupProfileEntries >= STARTUP_PROFILE_ENTRIES)
+        return STARTUP_PROFILE_ENTRIES;
+
+    entry = &startupProfile[startupProfileEntries];
+    entry -> phase = phase;
+    entry -> band = band;
+    entry -> depth = profileDepth++;
+    entry -> start = clock() - profileOrigin;
+    entry -> duration = STARTUP_PROFILE_RUNNING;
+
+    return startupProfileEntries++;
+}
+
+/*! Record the end of a phase.
+    \param entry    the value returned by startupProfileBegin() */
+void startupProfileEnd(unsigned char entry) {
+    if (profileDepth)
+        profileDepth--;
+
+    if (entry >= startupProfileEntries)
+        return;
+
+    startupProfile[entry].duration = (clock() - profileOrigin) - startupProfile[entry].start;
+}
+
+/*! Print the profile table. */
+void startupProfileReport(void) {
+    unsigned char cnt, indent;
+    STARTUP_PROFILE_ENTRY *entry;
+
+    printf("Startup profile (ms):\n");
+    for (cnt = 0; cnt < startupProfileEntries; cnt++) {
+        entry = &startupProfile[cnt];
+        for (indent = 0; indent <= entry -> depth; indent++)
+            printf(" ");
+
+        printf("%s", (entry -> phase < STARTUP_PHASES_NUMBER) ? phaseNames[entry -> phase] : "?");
+        if (entry -> band != STARTUP_PROFILE_NO_BAND)
+            printf(" band%d", entry -> band + 1);
+
+        if (entry -> duration == STARTUP_PROFILE_RUNNING)
+            printf(" start:%lu not finished\n", entry -> start);
+        else
+            printf(" start:%lu duration:%lu\n", entry -> start, entry -> duration);
+    }
+}
@@ -0,0 +1,68 @@
+/*! \file   startupProfile.h
+    \brief  Startup phase profiler
+
+    Each phase of the boot, from errorInit() to PPOpen(), records its start
+    time and duration in a fixed table.  Per band phases and the INI file
+    parsing inside them are recorded as nested sub-phases.  The table is
+    printed by feAndCartridgesConfigurationReport() and can be read through
+    the GET_STARTUP_PROFILE special monitor RCAs.
+
+    Times are in milliseconds from the start of initialization(), as returned
+    by clock(), so they have the resolution of the DOS timer tick. */
+
+#ifndef _STARTUPPROFILE_H
+    #define _STARTUPPROFILE_H
+
+    /* Defines */
+    #define STARTUP_PROFILE_ENTRIES     64              // Size of the profile table
+    #define STARTUP_PROFILE_NO_BAND     0xFF            // Phase is not specific to a band
+    #define STARTUP_PROFILE_RUNNING     0xFFFFFFFFUL    // Duration of a phase that never ended
+
+    /* Phases */
+    #define STARTUP_PHASE_INITIALIZATION        0   // initialization()
+    #define STARTUP_PHASE_ERROR_INIT            1   // errorInit()
+    #define STARTUP_PHASE_NV_JOURNAL_INIT       2   // nvJournalInit()
+    #define STARTUP_PHASE_SERIAL_MUX_INIT       3   // serialMuxInit()
+    #define STARTUP_PHASE_OWB_INIT              4   // owbInit()
+    #define STARTUP_PHASE_OWB_GET_ESN           5   // owbGetEsn()
+    #define STARTUP_PHASE_FRONTEND_INIT         6   // frontendInit()
+    #define STARTUP_PHASE_CONFIG_IMAGE_LOAD     7   // configImageLoad()
+    #define STARTUP_PHASE_CARTRIDGE_STARTUP     8   // cartridgeStartup(), per band
+    #define STARTUP_PHASE_CARTRIDGE_INI         9   // CARTn.INI parsing, per band
+    #define STARTUP_PHASE_LO_STARTUP            10  // loStartup(), per band
+    #define STARTUP_PHASE_LO_INI                11  // WCAn.INI parsing, per band
+    #define STARTUP_PHASE_LPR_STARTUP           12  // lprStartup()
+    #define STARTUP_PHASE_CRYOSTAT_STARTUP      13  // cryostatStartup()
+    #define STARTUP_PHASE_CRYOSTAT_INI          14  // CRYO.INI parsing
+    #define STARTUP_PHASE_POWER_DIS_STARTUP     15  // powerDistributionStartup()
+    #define STARTUP_PHASE_IF_SWITCH_STARTUP     16  // ifSwitchStartup()
+    #define STARTUP_PHASE_FETIM_STARTUP         17  // fetimStartup()
+    #define STARTUP_PHASE_CONFIG_IMAGE_WRITE    18  // configImageWrite()
+    #define STARTUP_PHASE_PP_OPEN               19  // PPOpen()
+    #define STARTUP_PHASES_NUMBER               20
+
+    /* Typedefs */
+    //! One entry of the startup profile table
+    typedef struct {
+        unsigned char   phase;      //!< One of the STARTUP_PHASE_* defines
+        unsigned char   band;       //!< Band 0-9 or STARTUP_PROFILE_NO_BAND
+        unsigned char   depth;      //!< Nesting level, 0 for initialization()
+        unsigned long   start;      //!< Start time in ms from the start of the profile
+        unsigned long   duration;   //!< Duration in ms or STARTUP_PROFILE_RUNNING
+    } STARTUP_PROFILE_ENTRY;
+
+    /* Globals */
+    /* Externs */
+    extern STARTUP_PROFILE_ENTRY startupProfile[STARTUP_PROFILE_ENTRIES];  //!< The profile table
+    extern unsigned char startupProfileEntries;                             //!< Entries used in the table
+
+    /* Prototypes */
+    /* Externs */
+    extern unsigned char startupProfileBegin(unsigned char phase, unsigned char band);
+    //!< Record the start of a phase
+    extern void startupProfileEnd(unsigned char entry);
+    //!< Record the end of a phase
+    extern void startupProfileReport(void);
+    //!< Print the profile table
+
+#endif /* _STARTUPPROFILE_H */
@@ -0,0 +1,221 @@
+/*! \file   tcpMC.c
+    \brief  TCP monitor and control service
+
+    See tcpMC.h for a description of the service and of the record format.
+*/
+
+/* Includes */
+#include <stdio.h>      /* printf */
+#include <string.h>     /* memcpy, memmove, memset */
+
+#include "tcpMC.h"
+#include "error.h"
+#include "debug.h"
+#include "globalDefinitions.h"
+
+#include "sockets/include/compiler.h"
+#include "sockets/include/capi.h"
+
+/* Globals */
+unsigned long tcpMCRequests = 0;
+
+/* Statics */
+static int mcSocket = -1;                               // Listening or connected socket, -1 if the service is stopped
+static unsigned char rxBuffer[TCP_MC_RX_BUFFER_SIZE];   // Received bytes not parsed yet
+static unsigned int rxLength = 0;
+static unsigned char txBuffer[TCP_MC_TX_BUFFER_SIZE];   // Reply bytes not sent yet
+static unsigned int txLength = 0;
+
+/*! Start listening for a client on \ref TCP_MC_PORT.
+    The SOCKETS kernel must be loaded.  If it isn't, the service stays off
+    and the rest of the software is not affected.
+    \return
+        - \ref NO_ERROR -> if no error occurred
+        - \ref ERROR    -> if something wrong happened */
+int tcpMCStart(void) {
+    if (tcpMCListen() == ERROR) {
+        printf("TCP M&C: not available\n");
+        return ERROR;
+    }
+
+    printf("TCP M&C: listening on port %d\n", TCP_MC_PORT);
+    return NO_ERROR;
+}
+
+/*! Stop the service and drop the client, if any. */
+void tcpMCStop(void) {
+    if (mcSocket < 0)
+        return;
+
+    ReleaseSocket(mcSocket);
+    mcSocket = -1;
+}
+
+/*! Serve the requests received since the last call.
+    This is called from the main loop while no CAN message is pending.  It
+    never blocks: it returns as soon as there is nothing to read, the replies
+    can't be sent, a CAN message arrives or \ref TCP_MC_REQUESTS_PER_POLL
+    requests were handled. */
+void tcpMCService(void) {
+    long readable, writable;
+    int received;
+
+    if (mcSocket < 0)
+        return;
+
+    // Send the replies left over from the previous pass first:
+    if (txLength > 0 && tcpMCFlush() == ERROR)
+        return;
+
+    // Only read if there is something to read, or to notice the client hanging up:
+    if (SelectSocket(mcSocket + 1, &readable, &writable) < 0)
+        return;
+
+    if ((readable & (1L << mcSocket)) && rxLength < TCP_MC_RX_BUFFER_SIZE) {
+        received = ReadSocket(mcSocket,
+                              (char *) &rxBuffer[rxLength],
+                              TCP_MC_RX_BUFFER_SIZE - rxLength,
+                              NULL,
+                              NET_FLG_NON_BLOCKING);
+        if (received < 0) {
+            switch (iNetErrNo) {
+                case ERR_WOULD_BLOCK:
+                case ERR_NOT_ESTAB:
+                    break;
+                default:
+                    // The client closed or reset the connection:
+                    #ifdef DEBUG_TCP_MC
+                        printf("TCP M&C: client gone (%d)\n", iNetErrNo);
+                    #endif /* DEBUG_TCP_MC */
+                    tcpMCDisconnect();
+                    return;
+            }
+        } else {
+            rxLength += received;
+        }
+    }
+
+    tcpMCHandleRequests();
+
+    if (mcSocket >= 0 && txLength > 0)
+        tcpMCFlush();
+}
+
+/* Get a socket and wait for a client in the background */
+static int tcpMCListen(void) {
+    NET_ADDR address;
+
+    mcSocket = GetSocket();
+    if (mcSocket < 0) {
+        storeError(ERR_TCP_MC, ERC_NO_MEMORY); // No socket available for the TCP M&C service
+        return ERROR;
+    }
+
+    // The main loop must never wait on the socket:
+    SetSocketOption(mcSocket, 0, NET_OPT_NON_BLOCKING, 1, 1);
+
+    memset(&address, 0, sizeof(address));
+    address.wLocalPort = TCP_MC_PORT;
+
+    if (ListenSocket(mcSocket, STREAM, &address) < 0) {
+        storeError(ERR_TCP_MC, ERC_HARDWARE_ERROR); // Error listening for TCP M&C clients
+        ReleaseSocket(mcSocket);
+        mcSocket = -1;
+        return ERROR;
+    }
+
+    rxLength = 0;
+    txLength = 0;
+
+    return NO_ERROR;
+}
+
+/* Drop the current client and wait for the next one */
+static void tcpMCDisconnect(void) {
+    ReleaseSocket(mcSocket);
+    mcSocket = -1;
+    rxLength = 0;
+    txLength = 0;
+    tcpMCListen();
+}
+
+/* Send as much of the pending replies as the stack accepts.
+   Returns ERROR if some are still pending or the client is gone. */
+static int tcpMCFlush(void) {
+    int sent;
+
+    sent = WriteSocket(mcSocket, (char *) txBuffer, txLength, NET_FLG_PUSH | NET_FLG_NON_BLOCKING);
+    if (sent < 0) {
+        if (iNetErrNo == ERR_WOULD_BLOCK)
+            return ERROR;
+
+        tcpMCDisconnect();
+        return ERROR;
+    }
+
+    // Keep what didn't fit for the next pass:
+    txLength -= sent;
+    if (txLength > 0) {
+        memmove(txBuffer, &txBuffer[sent], txLength);
+        return ERROR;
+    }
+
+    return NO_ERROR;
+}
+
+/* Handle the complete request records in the receive buffer */
+static void tcpMCHandleRequests(void) {
+    unsigned int parsed = 0;
+    unsigned char handled = 0, size;
+    unsigned char *record;
+
+    while (handled < TCP_MC_REQUESTS_PER_POLL
+           && !newCANMsg
+           && rxLength - parsed >= TCP_MC_HEADER_SIZE
+           && TCP_MC_TX_BUFFER_SIZE - txLength >= TCP_MC_RECORD_MAX_SIZE)
+    {
+        record = &rxBuffer[parsed];
+        size = record[4];
+
+        if (size > CAN_MESSAGE_PAYLOAD_SIZE) {
+            // Out of sync with the client.  There is no way to recover the framing:
+            storeError(ERR_TCP_MC, ERC_COMMAND_VAL); // TCP M&C request payload too long
+            tcpMCDisconnect();
+            return;
+        }
+
+        // Wait for the rest of the record:
+        if (rxLength - parsed < TCP_MC_HEADER_SIZE + size)
+            break;
+
+        CAN_ADDRESS = ((unsigned long) record[0] << 24) |
+                      ((unsigned long) record[1] << 16) |
+                      ((unsigned long) record[2] << 8) |
+                      (unsigned long) record[3];
+        CAN_SIZE = size;
+        memcpy(CAN_DATA_ADD, &record[TCP_MC_HEADER_SIZE], size);
+
+        CANRequestHandler();
+
+        // Reply with the same RCA.  Only monitor requests return a payload:
+        memcpy(&txBuffer[txLength], record, 4);
+        if (size == CAN_MONITOR) {
+            txBuffer[txLength + 4] = CAN_SIZE;
+            memcpy(&txBuffer[txLength + TCP_MC_HEADER_SIZE], CAN_DATA_ADD, CAN_SIZE);
+            txLength += TCP_MC_HEADER_SIZE + CAN_SIZE;
+        } else {
+            txBuffer[txLength + 4] = 0;
+            txLength += TCP_MC_HEADER_SIZE;
+        }
+
+        parsed += TCP_MC_HEADER_SIZE + size;
+        handled++;
+        tcpMCRequests++;
+    }
+
+    // Move the incomplete or unhandled records to the start of the buffer:
+    if (parsed > 0) {
+        rxLength -= parsed;
+        memmove(rxBuffer, &rxBuffer[parsed], rxLength);
+    }
+}
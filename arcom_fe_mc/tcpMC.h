@@ -0,0 +1,61 @@
+/*! \file   tcpMC.h
+    \brief  TCP monitor and control service
+
+    Serves the same monitor and control RCAs as the CAN bus over a TCP
+    connection on the Datalight SOCKETS stack, without the one-request-per-CAN
+    -frame limit of the AMBSI path.  One client at a time is accepted on
+    \ref TCP_MC_PORT.
+
+    The client sends any number of request records back to back, and gets one
+    reply record for each, in the same order.  Both have the same format, with
+    multi-byte fields in big endian order as on the CAN bus:
+        - RCA:  4 bytes
+        - size: 1 byte, the number of payload bytes following
+        - payload: 0 to 8 bytes
+
+    A request with size 0 is a monitor request.  Its reply carries the payload
+    and the status byte, exactly as returned on the CAN bus.  A request with a
+    payload is a control request and its reply has size 0.
+
+    Requests are passed to the handler tree through CANRequestHandler(), so
+    they are subject to the same checks and modes as CAN messages.  The service
+    is polled from the main loop and handles at most \ref TCP_MC_REQUESTS_PER_POLL
+    requests per pass, returning early when a CAN message arrives, so it
+    doesn't delay the CAN bus. */
+
+#ifndef _TCPMC_H
+    #define _TCPMC_H
+
+    /* Extra includes */
+    /* CAN_MESSAGE_PAYLOAD_SIZE */
+    #ifndef _CAN_H
+        #include "can.h"
+    #endif /* _CAN_H */
+
+    /* Defines */
+    #define TCP_MC_PORT                 2000    //!< TCP port of the service
+    #define TCP_MC_HEADER_SIZE          5       //!< RCA and size bytes of a record
+    #define TCP_MC_RECORD_MAX_SIZE      (TCP_MC_HEADER_SIZE+CAN_MESSAGE_PAYLOAD_SIZE) //!< Largest request or reply record
+    #define TCP_MC_RX_BUFFER_SIZE       512     //!< Received bytes waiting to be parsed
+    #define TCP_MC_TX_BUFFER_SIZE       512     //!< Reply bytes waiting to be sent
+    #define TCP_MC_REQUESTS_PER_POLL    32      //!< Requests handled in one pass of the main loop
+
+    /* Globals */
+    /* Externs */
+    extern unsigned long tcpMCRequests; //!< Number of requests handled since startup
+
+    /* Prototypes */
+    /* Statics */
+    static int tcpMCListen(void);
+    static void tcpMCDisconnect(void);
+    static int tcpMCFlush(void);
+    static void tcpMCHandleRequests(void);
+    /* Externs */
+    extern int tcpMCStart(void);
+    //!< Start listening for a client
+    extern void tcpMCStop(void);
+    //!< Stop the service
+    extern void tcpMCService(void);
+    //!< Serve the requests received since the last call
+
+#endif /* _TCPMC_H */
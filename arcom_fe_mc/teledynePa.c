@@ -5,6 +5,7 @@
 #include "teledynePa.h"
 #include "error.h"
 #include "frontend.h"
+#include "lastControl.h"
 #include "debug.h"
 
 unsigned char currentTeledynePaModule;
@@ -32,13 +33,13 @@ void teledynePaHandler() {
 static void hasTeledynePaHandler(void) {
     if (CAN_SIZE) { // If control (size !=0)
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lo.pa.lastHasTeledynePa)
+        SAVE_LAST_CONTROL_MESSAGE()
 
         // Check for other than band 7:
         if (currentModule != 6) {
             /* Store the HARDW_BLKD_ERR state in the last control message variable */
             storeError(ERR_PA_CHANNEL, ERC_COMMAND_VAL);
-            frontend.cartridge[currentModule].lo.pa.lastHasTeledynePa.status = HARDW_BLKD_ERR;
+            CAN_LAST_CONTROL.status = HARDW_BLKD_ERR;
             return;
         }
 
@@ -50,7 +51,7 @@ static void hasTeledynePaHandler(void) {
     /* If monitor on control RCA */
     if (currentClass == CONTROL_CLASS) {
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lo.pa.lastHasTeledynePa)
+        RETURN_LAST_CONTROL_MESSAGE()
         return;
     }
 
@@ -65,13 +66,13 @@ static void collectorByteHandler() {
     /* If control (size !=0) */
     if (CAN_SIZE) {
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lo.pa.lastTeledyneCollectorByte[pol])
+        SAVE_LAST_CONTROL_MESSAGE()
 
         // Check for other than band 7:
         if (currentModule != 6) {
             /* Store the HARDW_BLKD_ERR state in the last control message variable */
             storeError(ERR_PA_CHANNEL, ERC_COMMAND_VAL);
-            frontend.cartridge[currentModule].lo.pa.lastHasTeledynePa.status = HARDW_BLKD_ERR;
+            CAN_LAST_CONTROL.status = HARDW_BLKD_ERR;
             return;
         }
 
@@ -83,7 +84,7 @@ static void collectorByteHandler() {
     /* If monitor on control RCA */
     if (currentClass == CONTROL_CLASS) {
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.cartridge[currentModule].lo.pa.lastTeledyneCollectorByte[pol])
+        RETURN_LAST_CONTROL_MESSAGE()
         return;
     }
 
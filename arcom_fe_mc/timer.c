@@ -13,13 +13,18 @@
           asynchronous timer. In this case the timer is started and the status
           can be queried to figure out if the timer is expired or not. This is
           useful to implement timeouts which do not have stringent requirements
-          on the precision of the timer. */
+          on the precision of the timer.
+        - \ref readFineTimer  This reads a free running counter with the
+          0.84 us resolution of the PC timer chip, to measure short
+          intervals. \ref fineTimerInit must be called first. */
 
 /* Includes */
 #include <time.h>   /* clock */
-#include <i86.h>    /* delay */
+#include <i86.h>    /* delay, MK_FP, _disable, _enable */
+#include <conio.h>  /* inp, outp */
 
 #include "timer.h"
+#include "pegasus.h"
 #include "error.h"
 #include "globalDefinitions.h"
 
@@ -28,6 +33,30 @@ static clock_t asyncStartTime[MAX_TIMERS_NUMBER]; // A global for the async time
 static unsigned char asyncRunning[MAX_TIMERS_NUMBER]; // A global for the async timer current state
 static unsigned long asyncMSeconds[MAX_TIMERS_NUMBER]; // A global for the async timer wait time
 
+/* 8254 PIT channel 0 drives the BIOS tick: it counts down from 65536 at
+   FINE_TIMER_HZ and raises IRQ0 when it wraps. */
+#define PIT_COUNTER0        0x40    // Channel 0 counter port
+#define PIT_CONTROL         0x43    // Mode and command port
+#define PIT_LATCH0          0x00    // Latch the channel 0 count
+#define PIT_MODE2_0         0x34    // Channel 0, low then high byte, mode 2 (rate generator), binary
+#define PIC_READ_IRR        0x0A    // OCW3: read the interrupt request register
+#define BIOS_TICKS          (*((volatile unsigned long far *) MK_FP(0x0040, 0x006C)))
+
+/* The interrupt flag is restored as it was, not set, so the fine timer can be
+   read with interrupts disabled */
+#pragma aux fineTimerLock = \
+    "pushf" \
+    "pop ax" \
+    "cli" \
+    value [ax] \
+    modify exact [ax];
+
+#pragma aux fineTimerUnlock = \
+    "push ax" \
+    "popf" \
+    parm [ax] \
+    modify exact [];
+
 /*! This function will wait \p milliseconds seconds before returning.
     \param  milliSeconds     The amount of milliseconds to wait */
 void waitMilliseconds(unsigned int milliseconds){
@@ -126,3 +155,53 @@ int stopAsyncTimer(unsigned char timerNo){
     asyncRunning[timerNo]=TIMER_OFF;
     return NO_ERROR;
 }
+
+/*! This function programs the PC timer chip channel 0 for the fine timer.
+    The BIOS sets it to mode 3 (square wave), where the count goes down by 2
+    at each clock and runs twice per tick, which \ref readFineTimer can't tell
+    apart. In mode 2 (rate generator) the count goes down by 1 at each clock
+    from 65536, read as 0, once per tick: the BIOS tick rate doesn't change.
+    This must be called at startup, before any \ref readFineTimer. */
+void fineTimerInit(void){
+    _disable();
+    outp(PIT_CONTROL, PIT_MODE2_0);
+    outp(PIT_COUNTER0, 0x00);
+    outp(PIT_COUNTER0, 0x00);
+    _enable();
+}
+
+/*! This function reads a free running counter that increases by
+    \ref FINE_TIMER_HZ counts per second. It wraps about every 60 minutes, so
+    only differences between two readings are meaningful. Convert them with
+    \ref FINE_TIMER_TO_US.
+    Interrupts are disabled around the latch and the two byte reads, so
+    another reader, such as an interrupt handler, can't latch the count in
+    between. The interrupt flag is then restored as it was, so it can be
+    called from an interrupt handler.
+    \return the counter */
+unsigned long readFineTimer(void){
+    unsigned long ticks;
+    unsigned int count;
+    unsigned int flags;
+    unsigned char irr;
+
+    do {
+        ticks=BIOS_TICKS;
+        flags=fineTimerLock();
+        outp(PIT_CONTROL, PIT_LATCH0);
+        count=inp(PIT_COUNTER0);
+        count|=(unsigned int)inp(PIT_COUNTER0)<<8;
+        outp(PIC_ADDR1, PIC_READ_IRR);
+        irr=inp(PIC_ADDR1);
+        fineTimerUnlock(flags);
+    } while(ticks!=BIOS_TICKS);
+
+    /* The counter wrapped but the tick is not counted yet, because IRQ0 is
+       pending or interrupts are disabled: count it here */
+    if((irr&0x01) && count>0x8000){
+        ticks++;
+    }
+
+    /* The count goes down from 65536, read as 0 */
+    return (ticks<<16)+((0x10000UL-count)&0xFFFFUL);
+}
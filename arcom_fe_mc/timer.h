@@ -76,10 +76,41 @@
     #define TIMER_OWB_RESET             81      // Timer number
     #define TIMER_TO_OWB_RESET          10000   // Timeout in milliseconds
 
+    /*** Flight recorder ***/
+    /* Sample period, set by SET_RECORDER_PERIOD */
+    #define TIMER_FLIGHT_RECORDER       90      // Timer number
+
+    /*** Sensor statistics ***/
+    /* Window period, set by SET_STATS_WINDOW */
+    #define TIMER_SENSOR_STATS          91      // Timer number
+
+    /*** LO lock engine ***/
+    /* Settle time after each YTO step, set by SET_LO_LOCK */
+    #define TIMER_LO_LOCK               92      // Timer number
+
+    /*** SIS I-V sweep ***/
+    /* Settle time after each step, set by SET_SIS_SWEEP */
+    #define TIMER_SIS_SWEEP             93      // Timer number
+
+    /*** LO PA sweep ***/
+    /* Settle time after each step, set by SET_LO_PA_SWEEP */
+    #define TIMER_LO_PA_SWEEP           94      // Timer number
+
+    /*** SIS magnet ramp and deflux ***/
+    /* Time between steps, set by SET_SIS_MAGNET_RAMP and SET_SIS_MAGNET_DEFLUX */
+    #define TIMER_SIS_MAGNET_RAMP       95      // Timer number
+
     /* Timer control */
     #define TIMER_ON                    1
     #define TIMER_OFF                   0
 
+    /* Fine timer */
+    #define FINE_TIMER_HZ               1193182UL   //!< Fine timer counts per second, the 8254 PIT input clock
+    //! Convert a difference of fine timer counts to microseconds
+    #define FINE_TIMER_TO_US(counts)    (((counts) / 1193UL) * 1000UL + (((counts) % 1193UL) * 1000UL) / 1193UL)
+    //! Convert microseconds to fine timer counts
+    #define FINE_TIMER_FROM_US(us)      (((us) / 1000UL) * 1193UL + (((us) % 1000UL) * 1193UL) / 1000UL)
+
     /* Timer status */
     #define TIMER_RUNNING               0       //!< Signal for timer running
     #define TIMER_EXPIRED               1       //!< Signal for timer expired
@@ -87,6 +118,9 @@
     #define TIMER_NO_OUT_OF_RANGE       (-3)    //!< Signal for timer number out of range
 
     /* Prototypes */
+    /* Statics */
+    static unsigned int fineTimerLock(void);        // Save the flags and disable interrupts, see the pragma in timer.c
+    static void fineTimerUnlock(unsigned int flags); // Restore the flags saved by fineTimerLock()
     /* Externs */
     extern void waitMilliseconds(unsigned int milliseconds);  //!< Wait a defined number of milliseconds
     extern int startAsyncTimer(unsigned char timerNo,
@@ -94,4 +128,6 @@
                                unsigned char reload); //!< Setup and start the asynchronous timer
     extern int queryAsyncTimer(unsigned char timerNo); //!< Query the state of the asynchronous timer
     extern int stopAsyncTimer(unsigned char timerNo); //!< Clear the state of the asynchronous timer
+    extern void fineTimerInit(void); //!< Program the PC timer chip for the fine timer
+    extern unsigned long readFineTimer(void); //!< Read the 0.84 us resolution timer
 #endif /* _TIMER_H */
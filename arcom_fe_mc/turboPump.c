@@ -13,6 +13,7 @@
 
 #include "debug.h"
 #include "frontend.h"
+#include "lastControl.h"
 #include "globalDefinitions.h"
 #include "error.h"
 #include "cryostatSerialInterface.h"
@@ -64,10 +65,7 @@ static void enableHandler(void){
     if(CAN_SIZE) {
         
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.
-                                   cryostat.
-                                    turboPump.
-                                     lastEnable)
+        SAVE_LAST_CONTROL_MESSAGE()
 
         /* Check if the backing pump is enabled. If it's not then the electronics to
            control the turbo pump are off.  Store HARDW_BLKD_ERR and return. */
@@ -77,11 +75,7 @@ static void enableHandler(void){
               backingPump.
                enable == BACKING_PUMP_DISABLE) 
         {
-            frontend.
-             cryostat.
-              turboPump.
-               lastEnable.
-                status=HARDW_BLKD_ERR; // Store the status in the last control message
+            CAN_LAST_CONTROL.status=HARDW_BLKD_ERR; // Store the status in the last control message
 
             // if the command was to enable, register an error too:
             if (CAN_BYTE) {
@@ -108,11 +102,7 @@ static void enableHandler(void){
                    temp > TURBO_PUMP_MAX_TEMPERATURE)) 
             {
                 storeError(ERR_TURBO_PUMP, ERC_HARDWARE_BLOCKED); //Temperature below allowed range -> Turbo pump disabled
-                frontend.
-                 cryostat.
-                  turboPump.
-                   lastEnable.
-                    status=HARDW_BLKD_ERR; // Store the status in the last control message
+                CAN_LAST_CONTROL.status=HARDW_BLKD_ERR; // Store the status in the last control message
              
                 frontend.
                  cryostat.
@@ -128,11 +118,7 @@ static void enableHandler(void){
                                        TURBO_PUMP_DISABLE)==ERROR)
         {
             /* Store the ERROR state in the last control message variable */
-            frontend.
-             cryostat.
-              turboPump.
-               lastEnable.
-                status=ERROR;
+            CAN_LAST_CONTROL.status=ERROR;
 
             return;
         }
@@ -143,10 +129,7 @@ static void enableHandler(void){
     /* If monitor on a control RCA */
     if(currentClass==CONTROL_CLASS){
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.
-                                     cryostat.
-                                      turboPump.
-                                       lastEnable)
+        RETURN_LAST_CONTROL_MESSAGE()
         return;
     }
 
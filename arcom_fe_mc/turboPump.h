@@ -59,9 +59,7 @@
         \param      speed   This contains the current speed state for the
                                 turbo pump:
                                     - \ref SPEED_OK -> Speed OK
-                                    - \ref SPEED_LOW -> Speed Low
-        \param      lastEnable  This contains a copy of the last issued control
-                                message to the state of the turbo pump. */
+                                    - \ref SPEED_LOW -> Speed Low */
     typedef struct {
         //! Turbo pump state
         /*! This is the state of the turbo pump:
@@ -81,10 +79,6 @@
                 - \ref SPEED_LOW -> not up to speed
                 - \ref SPEED_OK -> up to speed */
         unsigned char   speed;
-        //! Last control message: turbo pump state
-        /*! This is the content of the last control message sent to the turbo
-            pump state. */
-        LAST_CONTROL_MESSAGE    lastEnable;
     } TURBO_PUMP;
 
     /* Globals */
@@ -13,6 +13,7 @@
 
 #include "debug.h"
 #include "frontend.h"
+#include "lastControl.h"
 #include "globalDefinitions.h"
 #include "error.h"
 #include "cryostatSerialInterface.h"
@@ -64,21 +65,14 @@ static void enableHandler(void){
     /* If control (size !=0) */
     if(CAN_SIZE){
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.
-                                   cryostat.
-                                    vacuumController.
-                                     lastEnable)
+        SAVE_LAST_CONTROL_MESSAGE()
 
         /* Change the status of the vacuum controller according to the content of
           the CAN message. */
         if(setVacuumControllerEnable(CAN_BYTE?VACUUM_CONTROLLER_ENABLE:
                                               VACUUM_CONTROLLER_DISABLE)==ERROR){
             /* Store the ERROR state in the last control message variable */
-            frontend.
-             cryostat.
-              vacuumController.
-               lastEnable.
-                status=ERROR;
+            CAN_LAST_CONTROL.status=ERROR;
 
             return;
         }
@@ -90,10 +84,7 @@ static void enableHandler(void){
     /* If monitor on a control RCA */
     if(currentClass==CONTROL_CLASS){
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.
-                                     cryostat.
-                                      vacuumController.
-                                       lastEnable)
+        RETURN_LAST_CONTROL_MESSAGE()
         return;
     }
 
@@ -65,10 +65,7 @@
         \param      state           This contains the current state of the
                                         vacuum controller:
                                             - \ref NO_ERROR -> No Error
-                                            - \ref ERROR -> Error
-        \param      lastEnable          This contains a copu of the last issued
-                                        control message to the state of the
-                                        vacuum controller. */
+                                            - \ref ERROR -> Error */
     typedef struct {
         //! Current pressure reading
         /*! There are \ref VACUUM_SENSOR_NUMBERS attached to the vacuum
@@ -91,10 +88,6 @@
                 - \ref NO_ERROR -> no error
                 - \ref ERROR -> error */
         unsigned char   state;
-        //! Last control message: vacuum controller state
-        /*! This is the content of the last control message sent to the vacuum
-            controller state. */
-        LAST_CONTROL_MESSAGE    lastEnable;
     } VACUUM_CONTROLLER;
 
     /* Globals */
@@ -11,6 +11,8 @@
 #include <stdio.h>      /* printf */
 
 #include "version.h"
+#include "frontend.h"
+#include "lastControl.h"
 
 /* Display version information */
 /*! This function will display the version information to the console. */
@@ -27,6 +29,12 @@ void displayVersion(void){
            VERSION_NOTES);
     printf("Bug report: %s\n\n",
            BUGZILLA);
+    printf("Memory: FRONTEND %lu bytes, last control messages %u bytes for %u/%u RCAs (%lu bytes embedded before)\n\n",
+           (unsigned long) sizeof(FRONTEND),
+           lastControlFootprint(),
+           lastControlStore.entries,
+           LAST_CONTROL_SLOTS - 1,
+           (unsigned long) LAST_CONTROL_EMBEDDED*sizeof(LAST_CONTROL_MESSAGE));
 }
 
 
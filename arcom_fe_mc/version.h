@@ -10,6 +10,71 @@
 
     REVISION HISTORY
 
+    2026-10-18 3.7.0
+        Store cold head hours in an append-only NV journal NVJOURNL.DAT instead of rewriting CRYO_HRS.INI.
+          CRYO_HRS.INI is only read once to seed the journal.  Hours are journaled as soon as they are logged.
+        Compile the values loaded from the INI files into the binary image FECONFIG.BIN.  Later boots load
+          the image instead of parsing the INI files, unless any INI file changed size or modification time.
+        Profile the startup phases, per band and per INI file.  Printed by the 't' console command and
+          read with GET_STARTUP_PROFILE_SIZE 0x2001A and GET_STARTUP_PROFILE_ENTRY 0x20040-0x2007F.
+        Load the ESN list saved in ESNS.INI at startup and verify it with a background OWB search.
+          A changed list is reported as ERC_HARDWARE_CHANGED and saved.  SET_READ_ESN no longer blocks.
+        Run the async functions in their own saved handler context (handlerContext.c) so CAN messages
+          handled between async steps and the async work don't overwrite each other's addressing globals.
+        Serve batched monitor and control requests over TCP port 2000 (tcpMC.c), polled from the main loop.
+          Requests go through the same handlers as CAN messages with the new CANRequestHandler().
+        Flight recorder (flightRecorder.c): samples up to 4 monitor RCAs into a 1024 sample RAM ring buffer
+          from the async loop, with an optional trigger and post-trigger count.  Set up with SET_RECORDER_*
+          0x21040-0x21047, read with GET_RECORDER_STATE 0x2001B and GET_RECORDER_SAMPLE 0x2001C.
+        Running min/max/mean/standard deviation (sensorStats.c) of the cryostat temperatures and pressures,
+          FETIM external temperatures, He2 pressure and power distribution rail currents, over a window closed by SET_STATS_LATCH 0x21048 or
+          every SET_STATS_WINDOW 0x21049 seconds.  Read with GET_STATS_* 0x2001D and 0x20100-0x2027F.
+        Deadband change notification (deadband.c): GET_NEXT_CHANGE 0x2001E returns the next statistics channel
+          that moved beyond its deadband, SET_DEADBAND 0x21080-0x210FF, GET_DEADBAND 0x20280-0x202FF.
+        On-board LO lock engine (loLock.c): SET_LO_LOCK 0x21050-0x21059 searches the YTO range for lock, closes
+          the loop and centers the correction voltage from the async loop.  GET_LO_LOCK_STATE 0x2001F.
+        On-board SIS I-V sweep (sisSweep.c): SET_SIS_SWEEP 0x21100-0x21127 sweeps one junction from the async
+          loop into a RAM buffer.  GET_SIS_SWEEP_STATE 0x20020, points read with GET_SIS_SWEEP_POINT 0x20021.
+        On-board LO PA sweep (loPaSweep.c): SET_LO_PA_SWEEP 0x21060-0x21073 steps the drain voltage within the
+          max safe LO PA table, recording the SIS or photomixer current, optionally stopping at
+          SET_LO_PA_SWEEP_TARGET 0x2104C.  GET_LO_PA_SWEEP_STATE 0x20022, GET_LO_PA_SWEEP_POINT 0x20023.
+        The PA dewar temperature check is shared by the drain voltage control and the sweep (paChannel.c).
+        SIS magnet ramp and deflux engine (sisMagnet.c): SET_SIS_MAGNET_RAMP 0x21140-0x21167 ramps a magnet at
+          a limited rate, SET_SIS_MAGNET_DEFLUX 0x21180-0x211A7 runs decaying alternating steps to 0 mA.
+          GET_SIS_MAGNET_RAMP_STATE 0x20024, SET_SIS_MAGNET_RAMP_ABORT 0x2104D.
+        ifSwitch: allChannelsHandler range checks all four attenuations before setting any, and only writes
+          the registers that change.  New allChannelsTempHandler returns the four IF channel temperatures
+          from a snapshot kept by the new ASYNC_IF_SWITCH async step, with 0x8000 for a channel without a
+          valid reading.
+        Power distribution rails cache: the new ASYNC_POWER_DIS async step sweeps the voltage and current of
+          every enabled module.  GET_PD_RAILS 0x20080-0x200A7 return the cached rails of a band in four blocks.
+        Fixed point ADC scaling (adcScale.c): the power distribution channels store raw ADC counts and a
+          per channel integer scale, converted to float only when a CAN reply is built.
+        Serial profiler (serialProfile.c): calls, mux transactions, busy polls and time of every analog
+          monitor cycle and FETIM ADC read.  GET_SERIAL_PROFILE 0x200B0-0x200C7, SET_SERIAL_PROFILE_RESET
+          0x2104E, 'b' console command.
+        CAN trace (canTrace.c): ring of the CAN messages handled, with inter-arrival, wait and handler
+          times, written to CANTRACE.BIN on request or on error.  GET_CAN_TRACE_STATE 0x20025,
+          SET_CAN_TRACE_ARM 0x2104F, SET_CAN_TRACE_DUMP 0x2105A.  Host replay via the TCP M&C service
+          with can_trace_python/FEMCCanTraceReplay.py.
+        AMBSI link emulator (ambsiEmulator.c): injects monitor and control messages in place of the
+          parallel port at a set rate and burst pattern, measures sustained rate, latency percentiles and
+          timeouts.  GET_AMBSI_EMU_* 0x20026-0x20028, SET_AMBSI_EMU_RATE 0x2105B, SET_AMBSI_EMU_RUN
+          0x2105C, SET_AMBSI_EMU_MESSAGE 0x21074-0x2107B, 'l' console command.  Fine timer readFineTimer().
+        Parallel port fast path: shadowed control register, rep insb/outsb transfers, status port
+          read only once per transfer.  PP_BYTE_IO restores byte I/O, PP_BENCHMARK times the interrupt
+          and PPWrite() in the 'o' console report.
+        Setpoint coalescing for PA drain voltage, SIS bias voltage and SIS magnet current: when enabled
+          with SET_SETPOINT_COALESCE, a newer setpoint replaces a pending one and only the latest is
+          applied, from the async loop.  GET_SETPOINT_COALESCE returns the counters.
+        Control elision: when enabled with SET_CONTROL_ELISION, a repeated SIS, LNA, LO PA gate or IF
+          attenuation command is not written again unless the module was power cycled or reset since.
+          GET_CONTROL_ELISION and GET_CONTROL_ELIDED return the counters.
+        Last control messages kept in a table keyed by RCA, allocated as controls are received, instead
+          of one record per control point in FRONTEND.  The footprint is shown with the version info.
+        Memory usage: GET_MEMORY_HEAP, GET_MEMORY_STACK and GET_MEMORY_ACCOUNT return the heap free bytes
+          and fragmentation, the stack high-water mark and the heap held by each subsystem. Console 'u'.
+
     2022-12-22 3.6.5
         Don't store cryostat timeout errors when in Troubleshooting mode
 
@@ -408,12 +473,12 @@
 
     /* Defines */
     #define VERSION_MAJOR   3
-    #define VERSION_MINOR   6
-    #define VERSION_PATCH   5
+    #define VERSION_MINOR   7
+    #define VERSION_PATCH   0
 
-    #define VERSION_DATE    "2022-12-22"
-    #define VERSION_NOTES   "3.6.5: Implement Teledyne PA control.\n" \
-                            "Don't store cryostat timeout errors when in Troubleshooting mode"
+    #define VERSION_DATE    "2026-10-18"
+    #define VERSION_NOTES   "3.7.0: Performance and diagnostics features.\n" \
+                            "See version.h for the list of changes"
 
     #define PRODUCT_TREE    "FEND-40.04.03.03-011-A-FRM"
     #define AUTHOR          "Morgan McLeod - NRAO (mmcleod@nrao.edu)"
@@ -13,6 +13,7 @@
 
 #include "error.h"
 #include "frontend.h"
+#include "lastControl.h"
 #include "loSerialInterface.h"
 #include "debug.h"
 
@@ -58,11 +59,7 @@ static void ytoCoarseTuneHandler(void){
     /* If control (size !=0) */
     if(CAN_SIZE){
         // save the incoming message:
-        SAVE_LAST_CONTROL_MESSAGE(frontend.
-                                   cartridge[currentModule].
-                                    lo.
-                                     yto.
-                                      lastYtoCoarseTune)
+        SAVE_LAST_CONTROL_MESSAGE()
 
         /* Extract the unsigned int from the CAN message. */
         changeEndianInt(CONV_CHR_ADD,
@@ -73,8 +70,7 @@ static void ytoCoarseTuneHandler(void){
             storeError(ERR_YTO, ERC_COMMAND_VAL); //YTO coarse tune set value out of range
 
             /* Store the error in the last control message variable */
-            frontend.cartridge[currentModule].lo.yto.lastYtoCoarseTune.
-                status=CON_ERROR_RNG;
+            CAN_LAST_CONTROL.status=CON_ERROR_RNG;
 
             return;
         }
@@ -92,33 +88,18 @@ static void ytoCoarseTuneHandler(void){
 
         if (ret == ERROR) {
             // some other error.   Don't retune!
-            frontend.
-             cartridge[currentModule].
-              lo.
-               yto.
-                lastYtoCoarseTune.
-                 status=ERROR;
+            CAN_LAST_CONTROL.status=ERROR;
             return;
         }
 
         /* Set the YTO coarse tune. If an error occurs then store the state and return. */
         if(setYtoCoarseTune()==ERROR){
             /* Store the ERROR state in the last control message variable */
-            frontend.
-             cartridge[currentModule].
-              lo.
-               yto.
-                lastYtoCoarseTune.
-                 status=ERROR;
+            CAN_LAST_CONTROL.status=ERROR;
         
         /* if limitSafeYtoTuning() above returned a problem, we want to save that error status */
         } else {
-            frontend.
-             cartridge[currentModule].
-              lo.
-               yto.
-                lastYtoCoarseTune.
-                 status=ret;
+            CAN_LAST_CONTROL.status=ret;
         }
 
         /* If everything went fine, it's a control message, we're done. */
@@ -128,11 +109,7 @@ static void ytoCoarseTuneHandler(void){
     /* If monitor on control RCA */
     if(currentClass==CONTROL_CLASS){
         // return the last control message and status
-        RETURN_LAST_CONTROL_MESSAGE(frontend.
-                                     cartridge[currentModule].
-                                      lo.
-                                       yto.
-                                        lastYtoCoarseTune)
+        RETURN_LAST_CONTROL_MESSAGE()
         return;
     }
 
@@ -44,9 +44,7 @@
                                     YTO. It has to be stored because this is \em
                                     not a read-back value from the hardware but
                                     just a register holding the last issued
-                                    control.
-        \param      lastCoarseTune  This contains a copy of the last issued
-                                    control to the YTO coarse tune. */
+                                    control. */
     typedef struct {
         //! Current YTO counts
         /*! These are the counts as set by the operator with the last issued
@@ -55,10 +53,6 @@
                         value is the one stored by the software after a control
                         command has been issued.*/
         unsigned int    ytoCoarseTune;
-        //! Last control message: Current YTO counts
-        /*! This is the content of the last control message sent to the current
-            YTO counts. */
-        LAST_CONTROL_MESSAGE    lastYtoCoarseTune;
     } YTO;
 
     /* Globals */
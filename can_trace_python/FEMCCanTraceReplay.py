@@ -0,0 +1,216 @@
+# -*- coding: utf-8 -*-
+"""
+class FEMCCanTrace
+Reads a CAN trace file written by the FEMC module (CANTRACE.BIN, see canTrace.h).
+The file can be downloaded with FEMCFirmwareUpdate.getFile('CANTRACE.BIN').
+
+class FEMCCanTraceReplay
+Replays a CAN trace through the TCP M&C service of an FEMC module, at the original
+speed or accelerated, and reports the latency and queueing of each RCA.
+Control requests are only replayed to a module in SIMULATION_MODE.
+
+Usage:
+ python FEMCCanTraceReplay.py <host> CANTRACE.BIN [speed] [--monitors-only]
+ speed 1 replays at the original rate, 10 ten times faster, 0 as fast as possible.
+"""
+
+import socket
+import struct
+import sys
+import threading
+import time
+from collections import deque
+
+class FEMCCanTrace:
+    """A CAN trace file written by the FEMC module."""
+
+    MAGIC = 0x43545243      # "CTRC"
+    VERSION = 2
+    HEADER = struct.Struct('>LHHLB')
+    RECORD = struct.Struct('>LBB8sBHHH')
+    TIME_MAX = 0xFFFF
+    REASONS = {0: 'none', 1: 'request', 2: 'error'}
+
+    def __init__(self, filename=''):
+        """Constructor
+        If 'filename' is provided, this will automatically call load()
+        """
+        self.records = []
+        self.recorded = 0
+        self.reason = 0
+        if filename:
+            self.load(filename)
+
+    def load(self, filename):
+        """Read the trace file.
+        Each record is a dict with keys:
+         rca, size, replySize, payload, status, interArrival, wait, duration
+        Times are in ms, the duration recorded in us is converted.  The payload is the request for a control and the reply for a monitor.
+        """
+        with open(filename, 'rb') as fp:
+            data = fp.read()
+        magic, version, count, self.recorded, self.reason = self.HEADER.unpack_from(data, 0)
+        if magic != self.MAGIC or version != self.VERSION:
+            raise ValueError(filename + ' is not a version ' + str(self.VERSION) + ' CAN trace')
+        self.records = []
+        offset = self.HEADER.size
+        for _ in range(count):
+            rca, size, replySize, payload, status, interArrival, wait, duration = self.RECORD.unpack_from(data, offset)
+            self.records.append({'rca': rca, 'size': size, 'replySize': replySize,
+                                 'payload': payload[:size] if size else payload[:replySize],
+                                 'status': status, 'interArrival': interArrival,
+                                 'wait': wait, 'duration': duration / 1000.0})
+            offset += self.RECORD.size
+
+    def summary(self):
+        """Return a one-line description of the trace."""
+        return '%d records of %d messages recorded, written on %s' % \
+            (len(self.records), self.recorded, self.REASONS.get(self.reason, '?'))
+
+class FEMCCanTraceReplay:
+    """Replays a CAN trace through the TCP M&C service of an FEMC module."""
+
+    PORT = 2000             # TCP_MC_PORT
+    GET_FE_MODE = 0x2000E
+    SIMULATION_MODE = 3
+
+    def __init__(self, host=''):
+        """Constructor
+        If 'host' is provided, this will automatically call connect()
+        """
+        self.host = host
+        self.sock = None
+        self.stats = {}
+        self.maxOutstanding = 0
+        if self.host:
+            self.connect()
+
+    def __del__(self):
+        """ Destructor
+        Calls disconnect()
+        """
+        self.disconnect()
+
+    def connect(self, host=''):
+        """Connect to the TCP M&C service.
+        Parameter 'host' can be provided here whether or not it was provided in the constructor.
+        """
+        if host:
+            self.host = host
+        self.sock = socket.create_connection((self.host, self.PORT))
+        self.sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+
+    def disconnect(self):
+        """Disconnect from the TCP M&C service."""
+        if self.sock:
+            self.sock.close()
+            self.sock = None
+
+    def getMode(self):
+        """Return the FE operating mode of the module."""
+        self._send(self.GET_FE_MODE, b'')
+        rca, payload = self._receive()
+        return payload[0]
+
+    def replay(self, trace, speed=1.0, monitorsOnly=False):
+        """Replay the records of 'trace', a FEMCCanTrace.
+        Requests are sent at the recorded inter-arrival times divided by 'speed', without
+        waiting for the replies, so a slow handler delays the following requests as it
+        would on the CAN bus.  Speed 0 sends every request as soon as the previous one is sent.
+        Control requests are skipped if 'monitorsOnly' is set; otherwise the module must be
+        in SIMULATION_MODE.
+        """
+        if not monitorsOnly and any(record['size'] for record in trace.records):
+            if self.getMode() != self.SIMULATION_MODE:
+                raise RuntimeError('The trace has control requests and the module is not in SIMULATION_MODE')
+
+        self.stats = {}
+        self.maxOutstanding = 0
+        pending = deque()
+        lock = threading.Lock()
+        records = [record for record in trace.records if record['size'] == 0 or not monitorsOnly]
+
+        def receiver():
+            for _ in range(len(records)):
+                rca, payload = self._receive()
+                now = time.perf_counter()
+                with lock:
+                    record, sent, late = pending.popleft()
+                self._account(record, (now - sent) * 1000.0, late)
+
+        thread = threading.Thread(target=receiver)
+        thread.start()
+
+        start = time.perf_counter()
+        due = 0.0
+        for record in records:
+            if speed > 0 and record['interArrival'] != FEMCCanTrace.TIME_MAX:
+                due += record['interArrival'] / 1000.0 / speed
+            if speed > 0:
+                delay = start + due - time.perf_counter()
+                if delay > 0:
+                    time.sleep(delay)
+            sent = time.perf_counter()
+            late = max(0.0, (sent - start - due) * 1000.0) if speed > 0 else 0.0
+            with lock:
+                pending.append((record, sent, late))
+                self.maxOutstanding = max(self.maxOutstanding, len(pending))
+            self._send(record['rca'], record['payload'] if record['size'] else b'')
+
+        thread.join()
+
+    def report(self):
+        """Print the latency and queueing of each RCA replayed, along with the wait and
+        handler times recorded on the module.  Times are in ms.
+        """
+        print('rca,count,latency_mean,latency_max,late_mean,late_max,recorded_wait_mean,recorded_wait_max,recorded_duration_mean,recorded_duration_max')
+        for rca in sorted(self.stats):
+            s = self.stats[rca]
+            n = s['count']
+            print('0x%05X,%d,%.2f,%.2f,%.2f,%.2f,%.1f,%d,%.1f,%d' %
+                  (rca, n, s['latency'] / n, s['latencyMax'], s['late'] / n, s['lateMax'],
+                   s['wait'] / n, s['waitMax'], s['duration'] / n, s['durationMax']))
+        print('max outstanding requests,%d' % self.maxOutstanding)
+
+    def _account(self, record, latency, late):
+        s = self.stats.setdefault(record['rca'], {'count': 0, 'latency': 0.0, 'latencyMax': 0.0,
+                                                  'late': 0.0, 'lateMax': 0.0,
+                                                  'wait': 0, 'waitMax': 0,
+                                                  'duration': 0, 'durationMax': 0})
+        s['count'] += 1
+        s['latency'] += latency
+        s['latencyMax'] = max(s['latencyMax'], latency)
+        s['late'] += late
+        s['lateMax'] = max(s['lateMax'], late)
+        s['wait'] += record['wait']
+        s['waitMax'] = max(s['waitMax'], record['wait'])
+        s['duration'] += record['duration']
+        s['durationMax'] = max(s['durationMax'], record['duration'])
+
+    def _send(self, rca, payload):
+        self.sock.sendall(struct.pack('>LB', rca, len(payload)) + payload)
+
+    def _receive(self):
+        header = self._receiveExactly(5)
+        rca, size = struct.unpack('>LB', header)
+        return rca, self._receiveExactly(size)
+
+    def _receiveExactly(self, size):
+        data = b''
+        while len(data) < size:
+            chunk = self.sock.recv(size - len(data))
+            if not chunk:
+                raise ConnectionError('TCP M&C connection closed')
+            data += chunk
+        return data
+
+if __name__ == '__main__':
+    args = [arg for arg in sys.argv[1:] if not arg.startswith('--')]
+    if len(args) < 2:
+        print(__doc__)
+        sys.exit(1)
+    trace = FEMCCanTrace(args[1])
+    print(trace.summary())
+    replayer = FEMCCanTraceReplay(args[0])
+    replayer.replay(trace, float(args[2]) if len(args) > 2 else 1.0, '--monitors-only' in sys.argv)
+    replayer.report()